@@ -719,6 +719,26 @@ class BusAttachment : public MessageReceiver {
                                           const InterfaceDescription::Member* member,
                                           const char* matchRule);
 
+    /**
+     * Register a signal handler that reads the signal arguments with a MessageCursor.
+     *
+     * This is the same as RegisterSignalHandlerWithRule() except that a signal is not unmarshaled
+     * before the handlers are called if every handler it matches was registered this way. Only
+     * the signature of the signal is checked, so Message::GetArgs() returns no arguments.
+     * Encrypted signals are still unmarshaled because that is where they are decrypted. The
+     * handler is unregistered with UnregisterSignalHandlerWithRule().
+     *
+     * @param receiver       The object receiving the signal.
+     * @param signalHandler  The signal handler method.
+     * @param member         The interface/member of the signal.
+     * @param matchRule      A filter rule.
+     * @return #ER_OK
+     */
+    QStatus RegisterCursorSignalHandler(MessageReceiver* receiver,
+                                        MessageReceiver::SignalHandler signalHandler,
+                                        const InterfaceDescription::Member* member,
+                                        const char* matchRule);
+
     /**
      * Unregister a signal handler.
      *
@@ -823,7 +843,9 @@ class BusAttachment : public MessageReceiver {
 
     /**
      * Set a key store listener to listen for key store load and store requests.
-     * This overrides the internal key store listener.
+     * This overrides the internal key store listener. Changes to the key store may be stored
+     * in the background so the listener must remain valid until UnregisterKeyStoreListener()
+     * is called or the bus attachment has been stopped and joined.
      *
      * @param listener  The key store listener to set.
      *
@@ -386,6 +386,26 @@ class BusObject : public MessageReceiver {
                              MessageReceiver::MethodHandler handler,
                              void* context = NULL);
 
+    /**
+     * Add a method handler that reads the method arguments with a MessageCursor. Unlike handlers
+     * added with AddMethodHandler() the arguments are not unmarshaled before the handler is
+     * called, only the signature of the method call is checked, so Message::GetArgs() returns no
+     * arguments. Encrypted method calls are still unmarshaled before the handler is called
+     * because that is where they are decrypted.
+     *
+     * @param member   Interface member implemented by handler.
+     * @param handler  Method handler.
+     * @param context  An optional context. This is mainly intended for implementing language
+     *                 bindings and should normally be NULL.
+     *
+     * @return
+     *      - #ER_OK if the method handler was added.
+     *      - An error status otherwise
+     */
+    QStatus AddCursorMethodHandler(const InterfaceDescription::Member* member,
+                                   MessageReceiver::MethodHandler handler,
+                                   void* context = NULL);
+
     /**
      * Convenience method used to add a set of method handers at once.
      *
@@ -453,6 +473,10 @@ class BusObject : public MessageReceiver {
      * introspection XML presented to remote nodes. Note that to DTD description and
      * the root element are not generated.
      *
+     * The default implementation caches the XML it generates for each language tag. The cache
+     * is discarded when interfaces, children, descriptions or description translators are added
+     * to or removed from this object or its descendants.
+     *
      * @param requestedLanguageTag      Language reguested for <description>'s. NULL for no descriptions.
      * @param deep                      Include XML for all descendants rather than stopping at direct children.
      * @param indent                    Number of characters to indent the XML
@@ -576,6 +600,14 @@ class BusObject : public MessageReceiver {
      */
     void InstallMethods(MethodTable& methodTable);
 
+    /**
+     * Add a method handler for AddMethodHandler() and AddCursorMethodHandler().
+     */
+    QStatus AddMethodContext(const InterfaceDescription::Member* member,
+                             MessageReceiver::MethodHandler handler,
+                             void* context,
+                             bool cursor);
+
     /**
      * This utility method is called by the bus during object registration.
      * Do not call this object explicitly.
@@ -652,6 +684,12 @@ class BusObject : public MessageReceiver {
      */
     const char* GetDescription(const char* toLanguage, qcc::String& buffer) const;
 
+    /**
+     * Discard the cached introspection XML of this object and of its ancestors, which include
+     * this object in their introspection XML.
+     */
+    void InvalidateIntrospection();
+
     /**
      * the internal method to send signal.
      * @see Signal
@@ -98,6 +98,7 @@ typedef enum {
 class InterfaceDescription {
 
     friend class BusAttachment;
+    friend class BusObject;
     friend class XmlHelper;
 
     /** map containing description tables per argument name */
@@ -662,7 +663,8 @@ class InterfaceDescription {
 
     /**
      * Set the Translator that provides this InterfaceDescription's
-     * introspection description in multiple languages.
+     * introspection description in multiple languages. The Translator
+     * can be set or replaced after the interface has been activated.
      *
      * @param translator The Translator instance.
      */
@@ -718,6 +720,12 @@ class InterfaceDescription {
     const char* Translate(const char* toLanguage, const char* text, qcc::String& buffer, Translator* translator) const;
 
 
+    /**
+     * Incremented each time a description translator is set so that introspection XML
+     * generated with the previous translators is discarded.
+     */
+    static volatile int32_t translatorGeneration;
+
     struct Definitions;
     Definitions* defs;   /**< The definitions for this interface */
 
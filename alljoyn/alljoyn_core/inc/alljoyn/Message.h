@@ -33,6 +33,11 @@
 #include <alljoyn/Session.h>
 #include <alljoyn/Status.h>
 
+namespace qcc {
+/** @internal Forward references */
+class Sink;
+}
+
 namespace ajn {
 
 static const size_t ALLJOYN_MAX_NAME_LEN   =     255;  /*!<  The maximum length of certain bus names */
@@ -204,6 +209,7 @@ class _Message {
     friend class _PeerState;
     friend class PermissionMgmtObj;
     friend struct Rule;
+    friend class MessageCursor;
 
   public:
     /**
@@ -875,6 +881,21 @@ class _Message {
      */
     QStatus UnmarshalArgs(PeerStateTable* peerStateTable, const qcc::String& expectedSignature, const char* expectedReplySignature = NULL);
 
+    /**
+     * @internal
+     * Check the message signature without unmarshaling the message arguments. This is used
+     * instead of UnmarshalArgs() when the handler reads the arguments with a MessageCursor.
+     *
+     * @param expectedSignature       The expected signature for this message.
+     * @param expectedReplySignature  The expected reply signature for this message if it is a
+     *                                method call message or NULL otherwise.
+     *
+     * @return
+     *         - #ER_OK if the message has the expected signature
+     *         - Error status indicating why the check failed.
+     */
+    QStatus CheckArgsSignature(const qcc::String& expectedSignature, const char* expectedReplySignature = NULL);
+
     /**
      * @internal
      * Reads a message from a remote endpoint.
@@ -955,6 +976,18 @@ class _Message {
      *      - An error status otherwise
      */
     QStatus DeliverNonBlocking(RemoteEndpoint& endpoint);
+
+    /**
+     * @internal
+     * Deliver a marshaled message to a sink on behalf of a remote endpoint. Non-blocking
+     *
+     * @param endpoint   Endpoint the message is being sent to.
+     * @param sink       Sink to push the message bytes into.
+     * @return
+     *      - #ER_OK if successful
+     *      - An error status otherwise
+     */
+    QStatus DeliverNonBlocking(RemoteEndpoint& endpoint, qcc::Sink& sink);
     /**
      * @internal
      * Marshal the message again with the new sender name if one was provided.
@@ -1359,6 +1392,15 @@ class _Message {
      * @return the space required for the header fields
      */
     size_t ComputeHeaderLen();
+
+    /**
+     * Rewrite the header in front of the current body without moving or copying the body. Used
+     * by ReMarshal() when the buffer has room in front of the body for the new header.
+     *
+     * @param hdrRegionLen  Length of the new header including the fixed part and padding.
+     * @return #ER_OK
+     */
+    QStatus ReMarshalHeader(size_t hdrRegionLen);
     /// @}
     // end internal_methods_message_marshal defgroup
 
@@ -0,0 +1,187 @@
+#ifndef _ALLJOYN_MESSAGECURSOR_H
+#define _ALLJOYN_MESSAGECURSOR_H
+/**
+ * @file
+ * This file defines a class for reading the arguments of a message directly from the message
+ * body without unmarshaling them.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include MessageCursor.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/MsgArg.h>
+#include <alljoyn/Status.h>
+
+namespace ajn {
+
+/**
+ * A forward-only cursor over the body of a message. Values are decoded one at a time as the
+ * cursor reaches them rather than all at once as Message::UnmarshalArgs() does, and values the
+ * caller is not interested in are skipped without being decoded. Strings, signatures, object
+ * paths and arrays of scalars in the native byte order reference the message buffer, so reading a
+ * message this way does not allocate memory.
+ *
+ * Containers are entered with Recurse(), which positions a second cursor on the members of a
+ * struct or dictionary entry, the elements of an array, or the value of a variant. Arrays are
+ * skipped using their length so the elements of an array are only checked if they are read.
+ *
+ * The message must not be freed or re-marshaled while the cursor is in use. The body of an
+ * encrypted message can only be read after Message::UnmarshalArgs() has decrypted it.
+ *
+ * Handlers added with BusObject::AddCursorMethodHandler() or
+ * BusAttachment::RegisterCursorSignalHandler() are called with messages that have not been
+ * unmarshaled and read their arguments with a cursor.
+ */
+class MessageCursor {
+  public:
+
+    /**
+     * Constructor for a cursor positioned on the first argument of a message.
+     *
+     * @param msg  The message to read.
+     */
+    MessageCursor(const Message& msg);
+
+    /**
+     * Default constructor for a cursor to be set by Recurse().
+     */
+    MessageCursor();
+
+    /**
+     * Check if the cursor has reached the end of the values it covers.
+     *
+     * @return  Returns true if there are no more values to read.
+     */
+    bool AtEnd() const;
+
+    /**
+     * Get the type of the value the cursor is positioned on.
+     *
+     * @return  The type id of the next value, #ALLJOYN_STRUCT or #ALLJOYN_DICT_ENTRY for those
+     *          containers, or #ALLJOYN_INVALID if the cursor is at the end.
+     */
+    AllJoynTypeId GetTypeId() const;
+
+    /**
+     * Get the signature of the values from the current position to the end of the container.
+     * For an array this is the element signature.
+     *
+     * @return  The remaining signature.
+     */
+    qcc::String GetSignature() const;
+
+    /**
+     * Get the status of the cursor. Once a malformed value has been found all further operations
+     * fail with the same status.
+     *
+     * @return  ER_OK or the error that stopped the cursor.
+     */
+    QStatus GetStatus() const { return status; }
+
+    /**
+     * Decode the value the cursor is positioned on and advance to the next one. Basic types and
+     * arrays of scalars can be decoded, other containers must be read with Recurse().
+     *
+     * @param[out] arg  Returns the value.
+     *
+     * @return
+     *      - #ER_OK if the value was decoded
+     *      - #ER_EOF if the cursor is at the end
+     *      - #ER_BUS_BAD_VALUE_TYPE if the value is a container that must be read with Recurse()
+     *      - An error status if the value is malformed
+     */
+    QStatus Get(MsgArg& arg);
+
+    /**
+     * Advance past the value the cursor is positioned on without decoding it.
+     *
+     * @return
+     *      - #ER_OK if successful
+     *      - #ER_EOF if the cursor is at the end
+     *      - An error status if the value is malformed
+     */
+    QStatus Skip();
+
+    /**
+     * Enter the container the cursor is positioned on and advance past it.
+     *
+     * @param[out] sub  Returns a cursor over the contents of the container.
+     *
+     * @return
+     *      - #ER_OK if successful
+     *      - #ER_EOF if the cursor is at the end
+     *      - #ER_BUS_BAD_VALUE_TYPE if the value is not a container
+     *      - An error status if the value is malformed
+     */
+    QStatus Recurse(MessageCursor& sub);
+
+  private:
+
+    /**
+     * Read a basic type value.
+     */
+    QStatus ReadBasic(MsgArg& arg, AllJoynTypeId typeId, const uint8_t*& ptr) const;
+
+    /**
+     * Read an array of scalars.
+     */
+    QStatus ReadScalarArray(MsgArg& arg, AllJoynTypeId elemTypeId, const uint8_t*& ptr) const;
+
+    /**
+     * Read the length of an array and compute the bounds of the array data.
+     */
+    QStatus ReadArrayBounds(const char* elemSig, const uint8_t*& ptr, const uint8_t*& dataEnd) const;
+
+    /**
+     * Read the signature of a variant leaving ptr positioned on the variant value.
+     */
+    QStatus ReadVariantSignature(const uint8_t*& ptr, const char*& variantSig, size_t& len) const;
+
+    /**
+     * Advance past a single complete type.
+     */
+    QStatus SkipValue(const uint8_t*& ptr, const char*& sigPtr, bool arrayElem) const;
+
+    /**
+     * Move to the next value after a value has been read or skipped.
+     */
+    void Advance(const uint8_t* ptr, const char* sigPtr);
+
+    /**
+     * Record a malformed value, the cursor cannot be used after this.
+     */
+    QStatus Fail(QStatus error);
+
+    const _Message* message; ///< The message being read.
+    const uint8_t* pos;      ///< Current position in the message body.
+    const uint8_t* end;      ///< End of the data this cursor covers.
+    const char* sig;         ///< Current position in the signature.
+    const char* sigStart;    ///< Start of the signature, elements of an array restart here.
+    const char* sigEnd;      ///< End of the signature this cursor covers.
+    bool isArray;            ///< True if the cursor is over the elements of an array.
+    bool endianSwap;         ///< True if the body is not in the native byte order.
+    QStatus status;          ///< ER_OK until a malformed value is found.
+};
+
+}
+
+#endif
@@ -38,6 +38,10 @@ namespace ajn {
 
 /**
  * Abstract base class that provides translations of text.
+ *
+ * Introspection XML is cached after it has been generated, so a Translator must keep returning
+ * the same translations while it is in use. To change the translations set the Translator on
+ * the BusAttachment, BusObject or InterfaceDescription again.
  */
 class Translator {
   public:
@@ -70,7 +70,12 @@ using namespace qcc;
 namespace ajn {
 
 void* AllJoynObj::NameMapEntry::truthiness = reinterpret_cast<void*>(true);
-volatile int32_t AllJoynObj::JoinSessionThread::jstCount = 0;
+
+/*
+ * Default maximum number of threads handling JoinSession requests, and
+ * separately AttachSession requests, at once.
+ */
+static const uint32_t SESSION_SETUP_THREADS_DEFAULT = 16;
 struct AllJoynObj::PingAlarmContext {
     enum Type {
         TRANSPORT_CONTEXT,
@@ -110,6 +115,8 @@ AllJoynObj::AllJoynObj(Bus& bus, BusController* busController, DaemonRouter& rou
     daemonGuid(bus.GetInternal().GetGlobalGUID()),
     detachSessionSignal(NULL),
     timer("NameReaper"),
+    joinSessionQueue("JoinS", ConfigDB::GetConfigDB()->GetLimit("max_session_setup_threads", SESSION_SETUP_THREADS_DEFAULT)),
+    attachSessionQueue("AttachS", ConfigDB::GetConfigDB()->GetLimit("max_session_setup_threads", SESSION_SETUP_THREADS_DEFAULT)),
     isStopping(false),
     busController(busController)
 {
@@ -270,28 +277,32 @@ QStatus AllJoynObj::Init()
 
 QStatus AllJoynObj::Stop()
 {
-    /* Stop any outstanding JoinSessionThreads */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
+    /* Wake the idle session setup threads and alert the busy ones */
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
     isStopping = true;
-    vector<JoinSessionThread*>::iterator it = joinSessionThreads.begin();
-    while (it != joinSessionThreads.end()) {
-        (*it)->Stop();
-        ++it;
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    joinSessionQueue.requestQueued.Broadcast();
+    attachSessionQueue.requestQueued.Broadcast();
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
+    joinSessionQueue.pool.Stop();
+    attachSessionQueue.pool.Stop();
     return ER_OK;
 }
 
 QStatus AllJoynObj::Join()
 {
-    /* Wait for any outstanding JoinSessionThreads */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    while (!joinSessionThreads.empty()) {
-        joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
-        qcc::Sleep(50);
-        joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    /* Wait for the session setup threads and drop any requests they did not get to */
+    joinSessionQueue.pool.Join();
+    attachSessionQueue.pool.Join();
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
+    SessionSetupQueue* queues[] = { &joinSessionQueue, &attachSessionQueue };
+    for (size_t i = 0; i < ArraySize(queues); ++i) {
+        while (!queues[i]->requests.empty()) {
+            delete queues[i]->requests.front().task;
+            queues[i]->requests.pop_front();
+        }
+        queues[i]->stats.queued = 0;
+    }
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
 
@@ -513,17 +524,88 @@ void AllJoynObj::UnbindSessionPort(const InterfaceDescription::Member* member, M
     }
 }
 
-ThreadReturn STDCALL AllJoynObj::JoinSessionThread::Run(void* arg)
+void AllJoynObj::JoinSessionTask::Run()
 {
-    QCC_UNUSED(arg);
-
     if (isJoin) {
-        QCC_DbgTrace(("JoinSessionThread::RunJoin()"));
-        return RunJoin();
+        QCC_DbgTrace(("JoinSessionTask::RunJoin()"));
+        RunJoin();
     } else {
-        QCC_DbgTrace(("JoinSessionThread::RunAttach()"));
-        return RunAttach();
+        QCC_DbgTrace(("JoinSessionTask::RunAttach()"));
+        RunAttach();
+    }
+}
+
+AllJoynObj::SessionSetupQueue::SessionSetupQueue(const char* name, uint32_t maxThreads) :
+    pool(name, (maxThreads > 0) ? maxThreads : 1), idleThreads(0)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+void AllJoynObj::SessionSetupRunnable::Run()
+{
+    ajObj.sessionSetupLock.Lock(MUTEX_CONTEXT);
+    while (!ajObj.isStopping) {
+        if (queue.requests.empty()) {
+            ++queue.idleThreads;
+            queue.requestQueued.Wait(ajObj.sessionSetupLock);
+            --queue.idleThreads;
+            continue;
+        }
+        SessionSetupQueue::Request request = queue.requests.front();
+        queue.requests.pop_front();
+        --queue.stats.queued;
+        ++queue.stats.running;
+        uint64_t startTime = GetTimestamp64();
+        uint32_t waitMs = static_cast<uint32_t>(startTime - request.queuedTime);
+        queue.stats.totalWaitMs += waitMs;
+        queue.stats.maxWaitMs = max(queue.stats.maxWaitMs, waitMs);
+        ajObj.sessionSetupLock.Unlock(MUTEX_CONTEXT);
+
+        request.task->Run();
+        delete request.task;
+
+        uint32_t runMs = static_cast<uint32_t>(GetTimestamp64() - startTime);
+        ajObj.sessionSetupLock.Lock(MUTEX_CONTEXT);
+        --queue.stats.running;
+        ++queue.stats.handled;
+        queue.stats.totalRunMs += runMs;
+        queue.stats.maxRunMs = max(queue.stats.maxRunMs, runMs);
+    }
+    ajObj.sessionSetupLock.Unlock(MUTEX_CONTEXT);
+}
+
+void AllJoynObj::QueueSessionSetup(SessionSetupQueue& queue, const Message& msg, bool isJoin)
+{
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
+    if (!isStopping) {
+        queue.requests.push_back(SessionSetupQueue::Request(new JoinSessionTask(*this, msg, isJoin), GetTimestamp64()));
+        ++queue.stats.queued;
+        queue.stats.maxQueued = max(queue.stats.maxQueued, queue.stats.queued);
+        if (queue.idleThreads > 0) {
+            queue.requestQueued.Signal();
+        } else if (queue.stats.threads < queue.pool.GetConcurrency()) {
+            /*
+             * Session setup threads never exit before the object is stopped,
+             * so the pool always has room for another one here.
+             */
+            Ptr<Runnable> runnable(new SessionSetupRunnable(*this, queue));
+            QStatus status = queue.pool.Execute(runnable);
+            if (status == ER_OK) {
+                ++queue.stats.threads;
+            } else {
+                QCC_LogError(status, ("Failed to start session setup thread"));
+            }
+        }
     }
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
+}
+
+void AllJoynObj::GetSessionSetupStats(SessionSetupStats& joinStats, SessionSetupStats& attachStats)
+{
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
+    joinStats = joinSessionQueue.stats;
+    attachStats = attachSessionQueue.stats;
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
 }
 
 bool AllJoynObj::IsSelfJoinSupported(BusEndpoint& joinerEp) const {
@@ -543,7 +625,7 @@ bool AllJoynObj::IsSelfJoinSupported(BusEndpoint& joinerEp) const {
     return false;
 }
 
-QStatus AllJoynObj::JoinSessionThread::Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut)
+QStatus AllJoynObj::JoinSessionTask::Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut)
 {
     /* Reply to request */
     MsgArg replyArgs[3];
@@ -551,13 +633,13 @@ QStatus AllJoynObj::JoinSessionThread::Reply(uint32_t replyCode, SessionId id, S
     replyArgs[1].Set("u", id);
     SetSessionOpts(optsOut, replyArgs[2]);
     QStatus status = ajObj.MethodReply(msg, replyArgs, ArraySize(replyArgs));
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): JoinSession returned (%d,%u) (status=%s)", replyCode, id, QCC_StatusText(status)));
+    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): JoinSession returned (%d,%u) (status=%s)", replyCode, id, QCC_StatusText(status)));
     return status;
 }
 
-ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
+void AllJoynObj::JoinSessionTask::RunJoin()
 {
-    QCC_DbgTrace(("JoinSessionThread::RunJoin()"));
+    QCC_DbgTrace(("JoinSessionTask::RunJoin()"));
 
     uint32_t replyCode = ALLJOYN_JOINSESSION_REPLY_SUCCESS;
     SessionId id = 0;
@@ -569,7 +651,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     RemoteEndpoint b2bEp;
     BusEndpoint joinerEp = ajObj.FindEndpoint(sender);
 
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): joinerEp=\"%s\"", joinerEp->GetUniqueName().c_str()));
+    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): joinerEp=\"%s\"", joinerEp->GetUniqueName().c_str()));
 
     /* Parse the message args */
     msg->GetArgs(numArgs, args);
@@ -582,14 +664,14 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
     if (status == ER_OK) {
         status = GetSessionOpts(args[2], optsIn);
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): optsIn=\"%s\"", optsIn.ToString().c_str()));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): optsIn=\"%s\"", optsIn.ToString().c_str()));
     }
 
     if (status == ER_OK) {
         BusEndpoint srcEp = ajObj.FindEndpoint(sender);
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): srcEp=\"%s\"", srcEp->GetUniqueName().c_str()));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): srcEp=\"%s\"", srcEp->GetUniqueName().c_str()));
         if (srcEp->IsValid()) {
-            status = TransportPermission::FilterTransports(srcEp, sender, optsIn.transports, "JoinSessionThread.Run");
+            status = TransportPermission::FilterTransports(srcEp, sender, optsIn.transports, "JoinSessionTask.Run");
         }
     }
 
@@ -600,7 +682,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
         SessionMapType::iterator it = ajObj.SessionMapLowerBound(sender, 0);
         while ((it != ajObj.sessionMap.end()) && (it->first.first == sender) && (it->first.second == 0)) {
             if (ajObj.FindEndpoint(it->second.sessionHost) == hostEp) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): self-join!"));
+                QCC_DbgPrintf(("JoinSessionTask::RunJoin(): self-join!"));
                 isSelfJoin = true;
                 break;
             }
@@ -616,38 +698,38 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     if (status != ER_OK) {
         if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
             replyCode = ALLJOYN_JOINSESSION_REPLY_FAILED;
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): bad args"));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): bad args"));
         }
     } else if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin() sessionPort=%d, opts=<%u, 0x%x, 0x%x>)",
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin() sessionPort=%d, opts=<%u, 0x%x, 0x%x>)",
                        sessionPort, optsIn.traffic, optsIn.proximity, optsIn.transports));
 
         /* Decide how to proceed based on the session endpoint existence/type */
         VirtualEndpoint vSessionEp;
 
         assert(sessionHost);
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): sessionHost=\"%s\"", sessionHost));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): sessionHost=\"%s\"", sessionHost));
         BusEndpoint ep = ajObj.FindEndpoint(sessionHost);
         if (ep->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL) {
             vSessionEp = VirtualEndpoint::cast(ep);
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): vSessionEp=\"%s\"", sessionHost));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): vSessionEp=\"%s\"", sessionHost));
         } else if ((ep->GetEndpointType() == ENDPOINT_TYPE_REMOTE) || (ep->GetEndpointType() == ENDPOINT_TYPE_NULL) ||
                    (ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL)) {
             rSessionEp = ep;
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): rSessionEp=\"%s\"", rSessionEp->GetUniqueName().c_str()));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): rSessionEp=\"%s\"", rSessionEp->GetUniqueName().c_str()));
         }
 
         if (rSessionEp->IsValid()) {
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): session is with another locally connected attachment"));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): session is with another locally connected attachment"));
 
             /* Find creator in session map */
             String creatorName = rSessionEp->GetUniqueName();
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): creatorName=\"%s\"", creatorName.c_str()));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): creatorName=\"%s\"", creatorName.c_str()));
             bool foundSessionMapEntry = false;
             SessionMapType::iterator sit = ajObj.SessionMapLowerBound(creatorName, 0);
             while ((sit != ajObj.sessionMap.end()) && (creatorName == sit->first.first)) {
                 if ((sit->second.isActive) && (sit->second.sessionHost == creatorName) && (sit->second.sessionPort == sessionPort)) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): found \"%s\" in sessionMap with expected port %d.",
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): found \"%s\" in sessionMap with expected port %d.",
                                    creatorName.c_str(), sessionPort));
                     if (sit->first.second == 0) {
                         sme = sit->second;
@@ -660,7 +742,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                         vector<String>::iterator mit = sit->second.memberNames.begin();
                         while (mit != sit->second.memberNames.end()) {
                             if (*mit == sender) {
-                                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): joiner already joined"));
+                                QCC_DbgPrintf(("JoinSessionTask::RunJoin(): joiner already joined"));
                                 foundSessionMapEntry = false;
                                 replyCode = ALLJOYN_JOINSESSION_REPLY_ALREADY_JOINED;
                                 break;
@@ -684,7 +766,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                         newSessionId = qcc::Rand32();
                     }
 
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): newsessinoId=%d.", newSessionId));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): newsessinoId=%d.", newSessionId));
 
                     /* Add an entry to sessionMap here (before sending accept session) since accept session
                      * may trigger a call to GetSessionFd or LeaveSession which must be aware of the new session's
@@ -704,7 +786,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
                     /* Ask creator to accept session */
                     ajObj.ReleaseLocks();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendAcceptSession()"));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): SendAcceptSession()"));
                     status = ajObj.SendAcceptSession(sme.sessionPort, newSessionId, sessionHost, sender.c_str(), optsIn, isAccepted);
                     if (status != ER_OK) {
                         QCC_LogError(status, ("SendAcceptSession failed"));
@@ -725,10 +807,10 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                     if (!isAccepted) {
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Join session request rejected"));
+                        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Join session request rejected"));
                         replyCode = ALLJOYN_JOINSESSION_REPLY_REJECTED;
                     } else if (sme.opts.traffic == SessionOpts::TRAFFIC_MESSAGES) {
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Join session request accepted"));
+                        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Join session request accepted"));
                         /* setup the forward and reverse routes through the local daemon */
                         RemoteEndpoint tEp;
                         status = ajObj.AddSessionRoute(newSessionId, joinerEp, NULL, rSessionEp, tEp);
@@ -737,7 +819,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                             QCC_LogError(status, ("AddSessionRoute(%u, %s, NULL, %s, tEp) failed", newSessionId, sender.c_str(), rSessionEp->GetUniqueName().c_str()));
                         }
                         if (status == ER_OK) {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Add local joiner to member list"));
+                            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Add local joiner to member list"));
                             /* Add (local) joiner to list of session members since no AttachSession will be sent */
                             SessionMapEntry* smEntry = ajObj.SessionMapFind(sme.endpointName, newSessionId);
                             if (smEntry) {
@@ -765,7 +847,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                             sme.id = newSessionId;
                         }
                     } else if ((sme.opts.traffic != SessionOpts::TRAFFIC_MESSAGES) && !sme.opts.isMultipoint) {
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Raw socket"));
+                        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Raw socket"));
                         /* Create a raw socket pair for the two local session participants */
                         SocketFd fds[2];
                         status = SocketPair(fds);
@@ -811,7 +893,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
             }
         } else {
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): session is with a remote attachment"));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): session is with a remote attachment"));
             /* Session is with a connected or unconnected remote device */
 
             /*
@@ -820,7 +902,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
             /* Check for an existing multipoint session. */
             if (vSessionEp->IsValid()) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Existing virtual endpoint IsValid() and isMultipoint"));
+                QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Existing virtual endpoint IsValid() and isMultipoint"));
                 SessionMapType::iterator it = ajObj.sessionMap.begin();
                 while (it != ajObj.sessionMap.end()) {
                     if ((it->second.sessionHost == vSessionEp->GetUniqueName()) && (it->second.sessionPort == sessionPort)) {
@@ -829,13 +911,13 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                                 b2bEp = vSessionEp->GetBusToBusEndpoint(it->second.id);
                                 optsIn.nameTransfer = it->second.opts.nameTransfer;
                                 if (b2bEp->IsValid()) {
-                                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): IncrementRef() on existing mp session"));
+                                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): IncrementRef() on existing mp session"));
                                     b2bEp->IncrementRef();
                                     replyCode = ALLJOYN_JOINSESSION_REPLY_SUCCESS;
                                 }
                             }
                         } else {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Blocked multiple connections to same dest with same session ID"));
+                            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Blocked multiple connections to same dest with same session ID"));
                             /* Cannot support more than one connection to the same destination with the same sessionId */
                             replyCode = ALLJOYN_JOINSESSION_REPLY_BAD_SESSION_OPTS;
                         }
@@ -861,11 +943,11 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                     ajObj.AcquireLocks();
                 }
                 if (busAddrs.empty()) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): No advertisement. No existing route.  Nothing we can do."));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): No advertisement. No existing route.  Nothing we can do."));
                     /* No advertisment or existing route to session creator */
                     replyCode = ALLJOYN_JOINSESSION_REPLY_NO_SESSION;
                 } else {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Have busaddrs to try."));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Have busaddrs to try."));
                 }
             }
             vector<String>::const_iterator bit = busAddrs.begin();
@@ -879,7 +961,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 TransportMask transport = optsIn.transports;
                 if (bit != busAddrs.end()) {
                     ajObj.ReleaseLocks();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Trying busaddr=\"%s\"", bit->c_str()));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Trying busaddr=\"%s\"", bit->c_str()));
                     b2bEp = ConnectBusToBusEndpoint(*bit, optsIn, transport, replyCode);
                     if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                         busAddr = *bit;
@@ -895,7 +977,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                      * Step 2: Wait for the new b2b endpoint to have a virtual ep for nextController
                      * only while interacting with a remote routing node with protocol version < 12.
                      */
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Wait for virtual endpoint."));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Wait for virtual endpoint."));
                     uint64_t startTime = GetTimestamp64();
                     while (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                         /* Do we route through b2bEp? If so, we're done */
@@ -905,12 +987,12 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                             break;
                         }
 
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Remote name of new b2b endpoint is \"%s\"",
+                        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Remote name of new b2b endpoint is \"%s\"",
                                        b2bEp->GetRemoteName().c_str()));
 
                         VirtualEndpoint vep;
                         if (ajObj.FindEndpoint(b2bEp->GetRemoteName(), vep) && vep->CanUseRoute(b2bEp)) {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Found virtual endpoint for route"));
+                            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Found virtual endpoint for route"));
                             /* Got a virtual endpoint we can route through */
                             break;
                         }
@@ -924,7 +1006,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                         }
                         /* Give up the locks while waiting */
                         ajObj.ReleaseLocks();
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Sleep"));
+                        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Sleep"));
                         qcc::Sleep(10);
                         ajObj.AcquireLocks();
                     }
@@ -938,7 +1020,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 MsgArg membersArg;
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                     const String nextControllerName = b2bEp->GetRemoteName();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendAttachSession()"));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): SendAttachSession()"));
                     ajObj.ReleaseLocks();
                     SessionOpts opts = optsIn;
                     opts.transports = transport;
@@ -953,7 +1035,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                     }
                     /* Re-acquire locks */
                     ajObj.AcquireLocks();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): FindEndpoint(\"%s\")", sessionHost));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): FindEndpoint(\"%s\")", sessionHost));
                     ajObj.FindEndpoint(sessionHost, vSessionEp);
                     if (!vSessionEp->IsValid()) {
                         replyCode = ALLJOYN_JOINSESSION_REPLY_FAILED;
@@ -963,10 +1045,10 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
                 /* If session was successful, Add two-way session routes to the table */
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Attach session success(\"%s\")", sessionHost));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Attach session success(\"%s\")", sessionHost));
                     if (joinerEp->IsValid() && b2bEp->IsValid()) {
                         BusEndpoint busEndpoint = BusEndpoint::cast(vSessionEp);
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): AddSessionRoute() for session ID %d.", id));
+                        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): AddSessionRoute() for session ID %d.", id));
                         status = ajObj.AddSessionRoute(id, joinerEp, NULL, busEndpoint, b2bEp);
                         if (status != ER_OK) {
                             replyCode = ALLJOYN_JOINSESSION_REPLY_FAILED;
@@ -981,7 +1063,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 /* Create session map entry */
                 bool sessionMapEntryCreated = false;
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Add session map entry for sender=\"%s\", id=%d., sessionHost=\"%s\", sessionPort=%d.",
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Add session map entry for sender=\"%s\", id=%d., sessionHost=\"%s\", sessionPort=%d.",
                                    sender.c_str(), id, vSessionEp->GetUniqueName().c_str(), sessionPort));
                     const MsgArg* sessionMembers;
                     size_t numSessionMembers = 0;
@@ -1000,7 +1082,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
                 /* If a raw sesssion was requested, then teardown the new b2bEp to use it for a raw stream */
                 if ((replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && (optsOut.traffic != SessionOpts::TRAFFIC_MESSAGES)) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Raw session.  Tear down new endpoint"));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Raw session.  Tear down new endpoint"));
                     SessionMapEntry* smEntry = ajObj.SessionMapFind(sender, id);
                     if (smEntry) {
                         ajObj.ReleaseLocks();
@@ -1040,7 +1122,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     /* Send AttachSession to all other members of the multicast session */
     if ((replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && sme.opts.isMultipoint &&
         sme.sessionHost != sender /* test if we now just selfjoined */) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Multicast session joined."));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Multicast session joined."));
         for (size_t i = 0; i < sme.memberNames.size(); ++i) {
             const String& member = sme.memberNames[i];
             /* Skip this joiner since it is attached already */
@@ -1048,12 +1130,12 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 continue;
             }
 
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Member \"%s\"", sme.memberNames[i].c_str()));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Member \"%s\"", sme.memberNames[i].c_str()));
 
             BusEndpoint memberEp = ajObj.FindEndpoint(member);
             RemoteEndpoint memberB2BEp;
             if (memberEp->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Member \"%s\" is virtual", sme.memberNames[i].c_str()));
+                QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Member \"%s\" is virtual", sme.memberNames[i].c_str()));
                 /* Endpoint is not served directly by this daemon so forward the attach using existing b2bEp connection with session creator */
                 if (!b2bEp->IsValid()) {
                     VirtualEndpoint vMemberEp = VirtualEndpoint::cast(memberEp);
@@ -1085,7 +1167,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                      */
                     sme.opts.transports = TRANSPORT_ANY;
 
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendAttachSession()"));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): SendAttachSession()"));
                     status = ajObj.SendAttachSession(sessionPort,
                                                      sender.c_str(),
                                                      sessionHost,
@@ -1120,7 +1202,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
 
             } else if (memberEp->IsValid()) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Local (non-virtual) endpoint"));
+                QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Local (non-virtual) endpoint"));
                 /* Add joiner to any local member's sessionMap entry  since no AttachSession is sent */
                 SessionMapEntry* smEntry = ajObj.SessionMapFind(member, id);
                 if (smEntry) {
@@ -1128,7 +1210,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
                 /* Multipoint session member is local to this daemon. Send MPSessionChanged */
                 if (optsOut.isMultipoint) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Local (non-virtual) MPSessionChanged"));
+                    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Local (non-virtual) MPSessionChanged"));
                     ajObj.ReleaseLocks();
                     ajObj.SendMPSessionChanged(id, sender.c_str(), true, member.c_str(), ALLJOYN_MPSESSIONCHANGED_REMOTE_MEMBER_ADDED);
                     ajObj.AcquireLocks();
@@ -1136,7 +1218,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
             }
             /* Add session routing */
             if (memberEp->IsValid() && joinerEp->IsValid() && (status == ER_OK)) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): AddSessionRoute()"));
+                QCC_DbgPrintf(("JoinSessionTask::RunJoin(): AddSessionRoute()"));
                 status = ajObj.AddSessionRoute(id, joinerEp, NULL, memberEp, memberB2BEp);
                 if (status != ER_OK) {
                     QCC_LogError(status, ("AddSessionRoute(%u, %s, NULL, %s, %s) failed", id, sender.c_str(), memberEp->GetUniqueName().c_str(), memberB2BEp->GetUniqueName().c_str()));
@@ -1150,7 +1232,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     }
     ajObj.ReleaseLocks();
 
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Reply to request"));
+    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Reply to request"));
 
     /* Reply to request */
     status = Reply(replyCode, id, optsOut);
@@ -1162,7 +1244,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
     /* Send SessionJoined to creator if creator is local since RunAttach does not run in this case */
     if ((status == ER_OK) && (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && rSessionEp->IsValid()) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendSessionJoined() to local endpoint"));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): SendSessionJoined() to local endpoint"));
         ajObj.SendSessionJoined(sme.sessionPort, sme.id, sender.c_str(), sme.endpointName.c_str());
         /* If session is multipoint, send MPSessionChanged to sessionHost */
         if (sme.opts.isMultipoint) {
@@ -1172,7 +1254,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
     /* Send a series of MPSessionChanged to "catch up" the new joiner */
     if ((replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && optsOut.isMultipoint) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendMPSessionChanged() series to local endpoint"));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): SendMPSessionChanged() series to local endpoint"));
         ajObj.AcquireLocks();
         SessionMapEntry* smEntry = ajObj.SessionMapFind(sender, id);
         if (smEntry) {
@@ -1195,20 +1277,18 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
             ajObj.ReleaseLocks();
         }
     }
-
-    return 0;
 }
 
-void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* sessionHost, const SessionOpts& optsIn,
+void AllJoynObj::JoinSessionTask::GetBusAddrsFromAdvertisements(const char* sessionHost, const SessionOpts& optsIn,
                                                                   std::vector<qcc::String>& busAddrs)
 {
     /* Look for busAddr from advertisements first */
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Look for busaddr corresponding to sessionHost"));
+    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Look for busaddr corresponding to sessionHost"));
     set<JoinSessionEntry> advertisements;
     multimap<String, NameMapEntry>::iterator nmit = ajObj.nameMap.lower_bound(sessionHost);
     while (nmit != ajObj.nameMap.end() && (nmit->first == sessionHost)) {
         if (nmit->second.transport & optsIn.transports) {
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Found busaddr in name map: \"%s\"", nmit->second.busAddr.c_str()));
+            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Found busaddr in name map: \"%s\"", nmit->second.busAddr.c_str()));
             JoinSessionEntry joinSessionEntry(nmit->first, nmit->second.transport, nmit->second.busAddr);
             advertisements.insert(joinSessionEntry);
         }
@@ -1222,7 +1302,7 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* se
 
     /* If no busAddrs, see if any exist in the adv alias map */
     if (busAddrs.empty() && (sessionHost[0] == ':')) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): look for busaddr in adv alias map"));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): look for busaddr in adv alias map"));
         String rguidStr = String(sessionHost).substr(1, GUID128::SIZE_SHORT);
         map<String, set<AdvAliasEntry> >::iterator ait = ajObj.advAliasMap.find(rguidStr);
         if (ait != ajObj.advAliasMap.end()) {
@@ -1232,7 +1312,7 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* se
                     multimap<String, NameMapEntry>::iterator nmit2 = ajObj.nameMap.lower_bound((*bit).name);
                     while (nmit2 != ajObj.nameMap.end() && (nmit2->first == (*bit).name)) {
                         if ((nmit2->second.transport & (*bit).transport & optsIn.transports) != 0) {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Found busaddr in adv alias map: \"%s\"",
+                            QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Found busaddr in adv alias map: \"%s\"",
                                            nmit2->second.busAddr.c_str()));
                             busAddrs.push_back(nmit2->second.busAddr);
                         }
@@ -1245,10 +1325,10 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* se
     }
 }
 
-void AllJoynObj::JoinSessionThread::GetBusAddrsFromSession(const char* sessionHost, SessionPort sessionPort, const SessionOpts& optsIn,
+void AllJoynObj::JoinSessionTask::GetBusAddrsFromSession(const char* sessionHost, SessionPort sessionPort, const SessionOpts& optsIn,
                                                            std::vector<qcc::String>& busAddrs)
 {
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): no busaddr.  SendGetSessionInfo() directly."));
+    QCC_DbgPrintf(("JoinSessionTask::RunJoin(): no busaddr.  SendGetSessionInfo() directly."));
     QStatus status = ER_BUS_NO_ENDPOINT;
 
     BusEndpoint hostEp = ajObj.FindEndpoint(sessionHost);
@@ -1292,7 +1372,7 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromSession(const char* sessionHo
     }
 }
 
-RemoteEndpoint AllJoynObj::JoinSessionThread::ConnectBusToBusEndpoint(const qcc::String& busAddr, const SessionOpts& optsIn,
+RemoteEndpoint AllJoynObj::JoinSessionTask::ConnectBusToBusEndpoint(const qcc::String& busAddr, const SessionOpts& optsIn,
                                                                       TransportMask& transport, uint32_t& replyCode)
 {
     RemoteEndpoint b2bEp;
@@ -1301,7 +1381,7 @@ RemoteEndpoint AllJoynObj::JoinSessionThread::ConnectBusToBusEndpoint(const qcc:
     /* Ask the transport that provided the advertisement for an endpoint */
     Transport* trans = ajObj.GetTransport(busAddr);
     if (trans != NULL) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Connect(\"%s\")", busAddr.c_str()));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): Connect(\"%s\")", busAddr.c_str()));
 
         BusEndpoint newEp;
         QStatus status = trans->Connect(busAddr.c_str(), optsIn, newEp);
@@ -1316,68 +1396,24 @@ RemoteEndpoint AllJoynObj::JoinSessionThread::ConnectBusToBusEndpoint(const qcc:
             QCC_LogError(status, ("trans->Connect(%s) failed", busAddr.c_str()));
         }
     } else {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): No available transport for %s", busAddr.c_str()));
+        QCC_DbgPrintf(("JoinSessionTask::RunJoin(): No available transport for %s", busAddr.c_str()));
     }
 
     return b2bEp;
 }
 
-void AllJoynObj::JoinSessionThread::ThreadExit(Thread* thread)
-{
-    ajObj.joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    vector<JoinSessionThread*>::iterator it = ajObj.joinSessionThreads.begin();
-    JoinSessionThread* deleteMe = NULL;
-    while (it != ajObj.joinSessionThreads.end()) {
-        if (*it == thread) {
-            deleteMe = *it;
-            ajObj.joinSessionThreads.erase(it);
-            break;
-        }
-        ++it;
-    }
-    ajObj.joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
-    if (deleteMe) {
-        deleteMe->Join();
-        delete deleteMe;
-    } else {
-        QCC_LogError(ER_FAIL, ("Internal error: JoinSessionThread not found on list"));
-    }
-}
-
 void AllJoynObj::JoinSession(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
     /* Handle JoinSession on another thread since JoinThread can block waiting for NameOwnerChanged */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    if (!isStopping) {
-        JoinSessionThread* jst = new JoinSessionThread(*this, msg, true);
-        QStatus status = jst->Start(NULL, jst);
-        if (status == ER_OK) {
-            joinSessionThreads.push_back(jst);
-        } else {
-            QCC_LogError(status, ("Join: Failed to start JoinSessionThread"));
-            delete jst;
-        }
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    QueueSessionSetup(joinSessionQueue, msg, true);
 }
 
 void AllJoynObj::AttachSession(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
     /* Handle AttachSession on another thread since AttachSession can block when connecting through an intermediate node */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    if (!isStopping) {
-        JoinSessionThread* jst = new JoinSessionThread(*this, msg, false);
-        QStatus status = jst->Start(NULL, jst);
-        if (status == ER_OK) {
-            joinSessionThreads.push_back(jst);
-        } else {
-            QCC_LogError(status, ("Attach: Failed to start JoinSessionThread"));
-            delete jst;
-        }
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    QueueSessionSetup(attachSessionQueue, msg, false);
 }
 
 void AllJoynObj::LeaveHostedSession(const InterfaceDescription::Member* member, Message& msg)
@@ -1835,9 +1871,9 @@ bool AllJoynObj::NamesHandler(Message msg, MsgArg arg)
     return madeChanges;
 }
 
-qcc::ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunAttach()
+void AllJoynObj::JoinSessionTask::RunAttach()
 {
-    QCC_DbgTrace(("JoinSessionThread::RunAttach()"));
+    QCC_DbgTrace(("JoinSessionTask::RunAttach()"));
 
     SessionId id = 0;
     String creatorName;
@@ -1872,7 +1908,7 @@ qcc::ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunAttach()
     QStatus status = MsgArg::Get(args, 6, "qsssss", &sessionPort, &src, &sessionHost, &dest, &srcB2B, &busAddr);
     const String srcB2BStr = srcB2B;
 
-    QCC_DbgPrintf(("JoinSessionThread::RunAttach(): sessionPort=%d, src=\"%s\", sessionHost=\"%s\", dest=\"%s\", srcB2B=\"%s\", busAddr=\"%s\"",
+    QCC_DbgPrintf(("JoinSessionTask::RunAttach(): sessionPort=%d, src=\"%s\", sessionHost=\"%s\", dest=\"%s\", srcB2B=\"%s\", busAddr=\"%s\"",
                    sessionPort, src, sessionHost, dest, srcB2B, busAddr));
 
     bool sendSessionJoined = false;
@@ -2325,8 +2361,6 @@ qcc::ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunAttach()
     }
 
     QCC_DbgPrintf(("AllJoynObj::RunAttach(%d) returned (%d,%u) (status=%s)", sessionPort, replyCode, id, QCC_StatusText(status)));
-
-    return 0;
 }
 
 void AllJoynObj::AddAdvNameAlias(const String& guid, const TransportMask mask, const String& advName)
@@ -23,6 +23,7 @@
 #define _ALLJOYN_ALLJOYNOBJ_H
 
 #include <qcc/platform.h>
+#include <deque>
 #include <vector>
 #include <map>
 
@@ -30,6 +31,8 @@
 #include <qcc/StringUtil.h>
 #include <qcc/StringMapKey.h>
 #include <qcc/Thread.h>
+#include <qcc/ThreadPool.h>
+#include <qcc/Condition.h>
 #include <qcc/time.h>
 #include <qcc/SocketTypes.h>
 #include <qcc/Timer.h>
@@ -82,6 +85,22 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
         IncomingPingInfo();
     };
   public:
+    /**
+     * Counters describing the JoinSession or AttachSession requests handled
+     * by the session setup threads.
+     */
+    struct SessionSetupStats {
+        uint32_t queued;        /**< Requests currently waiting for a session setup thread */
+        uint32_t maxQueued;     /**< Largest number of requests that have been waiting at once */
+        uint32_t running;       /**< Requests currently being handled */
+        uint32_t threads;       /**< Session setup threads started */
+        uint64_t handled;       /**< Requests handled to completion */
+        uint64_t totalWaitMs;   /**< Total time handled requests spent waiting for a thread */
+        uint32_t maxWaitMs;     /**< Longest time a request spent waiting for a thread */
+        uint64_t totalRunMs;    /**< Total time spent handling requests */
+        uint32_t maxRunMs;      /**< Longest time spent handling a single request */
+    };
+
     typedef enum {
         LEAVE_HOSTED_SESSION,
         LEAVE_JOINED_SESSION,
@@ -122,6 +141,15 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     QStatus Join();
 
+    /**
+     * Get the counters for the JoinSession and AttachSession requests handled
+     * by this object.
+     *
+     * @param[out] joinStats    Counters for JoinSession requests from local clients.
+     * @param[out] attachStats  Counters for AttachSession requests from other routing nodes.
+     */
+    void GetSessionSetupStats(SessionSetupStats& joinStats, SessionSetupStats& attachStats);
+
     /**
      * Called when object is successfully registered.
      */
@@ -649,25 +677,22 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     /// @cond ALLJOYN_DEV
 
-    /** JoinSessionThread handles a JoinSession request from a local client on a separate thread */
-    class JoinSessionThread : public qcc::Thread, public qcc::ThreadListener {
+    /** JoinSessionTask handles a JoinSession or AttachSession request on a session setup thread */
+    class JoinSessionTask {
       public:
-        JoinSessionThread(AllJoynObj& ajObj, const Message& msg, bool isJoin) :
-            qcc::Thread(qcc::String("JoinS-") + qcc::U32ToString(qcc::IncrementAndFetch(&jstCount))),
+        JoinSessionTask(AllJoynObj& ajObj, const Message& msg, bool isJoin) :
             ajObj(ajObj),
             msg(msg),
             isJoin(isJoin) { }
 
-        qcc::ThreadReturn STDCALL RunJoin();
-        virtual QStatus Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut);
-        void ThreadExit(Thread* thread);
+        virtual ~JoinSessionTask() { }
 
-      protected:
-        qcc::ThreadReturn STDCALL Run(void* arg);
+        void Run();
+        void RunJoin();
+        virtual QStatus Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut);
 
       private:
-        static volatile int32_t jstCount;
-        qcc::ThreadReturn STDCALL RunAttach();
+        void RunAttach();
         /*
          * This must be called with the locks as it looks through the various advertisement maps.
          */
@@ -686,6 +711,44 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
         bool isJoin;
     };
 
+    /**
+     * Requests of one kind (JoinSession or AttachSession) waiting for, or
+     * being handled by, the threads of a bounded thread pool. Threads are
+     * added to the pool as requests arrive and then stay to handle
+     * subsequent requests until the object is stopped.
+     */
+    struct SessionSetupQueue {
+        SessionSetupQueue(const char* name, uint32_t maxThreads);
+
+        struct Request {
+            JoinSessionTask* task;
+            uint64_t queuedTime;
+            Request(JoinSessionTask* task, uint64_t queuedTime) : task(task), queuedTime(queuedTime) { }
+        };
+
+        std::deque<Request> requests;   /**< Requests waiting for a thread */
+        qcc::ThreadPool pool;           /**< Pool providing the session setup threads */
+        uint32_t idleThreads;           /**< Threads waiting for a request */
+        qcc::Condition requestQueued;   /**< Signaled when a request is queued or the object stops */
+        SessionSetupStats stats;        /**< Counters for this kind of request */
+    };
+
+    /** SessionSetupRunnable handles the requests of a SessionSetupQueue on a pool thread */
+    class SessionSetupRunnable : public qcc::Runnable {
+      public:
+        SessionSetupRunnable(AllJoynObj& ajObj, SessionSetupQueue& queue) : ajObj(ajObj), queue(queue) { }
+        void Run();
+      private:
+        AllJoynObj& ajObj;
+        SessionSetupQueue& queue;
+    };
+
+    /**
+     * Queue a JoinSession or AttachSession request to be handled by a
+     * session setup thread, starting a new thread if none is idle.
+     */
+    void QueueSessionSetup(SessionSetupQueue& queue, const Message& msg, bool isJoin);
+
     typedef enum {
         JOINER, /* AttachSession from new session joiner to Host */
         HOST,   /* AttachSession response from session host to new joiner */
@@ -988,8 +1051,15 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
 
-    std::vector<JoinSessionThread*> joinSessionThreads;  /**< List of outstanding join session requests */
-    qcc::Mutex joinSessionThreadsLock;                   /**< Lock that protects joinSessionThreads */
+    /*
+     * JoinSession and AttachSession requests are handled by separate threads
+     * so that AttachSession requests from other routing nodes never wait
+     * behind JoinSession requests that are themselves waiting for an
+     * AttachSession reply.
+     */
+    SessionSetupQueue joinSessionQueue;                  /**< JoinSession requests from local clients */
+    SessionSetupQueue attachSessionQueue;                /**< AttachSession requests from other routing nodes */
+    qcc::Mutex sessionSetupLock;                         /**< Lock that protects the session setup queues */
     bool isStopping;                                     /**< True while waiting for threads to exit */
     BusController* busController;                        /**< BusController that created this BusObject */
 
@@ -69,6 +69,12 @@ namespace ajn {
 
 #define UDP_HEADER_SIZE 8
 
+/* Largest number of datagrams ARDP_Run() will receive or send in one batch */
+#define ARDP_MAX_BATCH_SIZE 64
+
+/* Size of each receive buffer, a UDP datagram can be up to 64K long */
+#define ARDP_RX_BUFFER_SIZE 65536
+
 /* Marshal/Unmarshal ARDP header offsets */
 #define FLAGS_OFFSET   0
 #define HLEN_OFFSET    1
@@ -266,6 +272,15 @@ struct ARDP_CONN_RECORD {
     qcc::SendMsgFlags sndFlags; /* SendMsgFlags to underlying sockets call */
 };
 
+/*
+ * Open addressed (linear probing) hash table of connection records.
+ */
+typedef struct {
+    ArdpConnRecord** slots; /* Power of two sized array of slots, NULL if the table has never been used */
+    uint32_t mask;          /* Number of slots - 1 */
+    uint32_t count;         /* Number of occupied slots */
+} ArdpConnTable;
+
 struct ARDP_HANDLE {
     ArdpGlobalConfig config; /* The configurable items that affect this instance of ARDP as a whole */
     ArdpCallbacks cb;        /* The callbacks to allow the protocol to talk back to the client */
@@ -277,11 +292,22 @@ struct ARDP_HANDLE {
 #endif
     bool accepting;          /* If true the ArdpProtocol is accepting inbound connections */
     ListNode conns;          /* List of currently active connections */
+    ArdpConnTable connsByPort; /* The connections in conns indexed by local ARDP port */
+    ArdpConnTable connsByAddr; /* The connections in conns indexed by record address, to validate connection pointers */
     qcc::Timespec tbase;     /* Baseline time */
     ListNode dataTimers;     /* List of currently scheduled retransmit timers */
     uint32_t msnext;         /* To inform upper layer when to call into the protocol next time */
     bool trafficJam;         /* "Socket Write Block" indicator */
     void* context;           /* A client-defined context pointer */
+    uint32_t batchSize;      /* Number of datagrams received or sent per system call */
+    uint8_t* rxBatchBuf;     /* Receive buffers for rxBatch, ARDP_RX_BUFFER_SIZE bytes each */
+    qcc::Datagram* rxBatch;  /* Datagrams received by a single call to RecvFromBatch */
+    qcc::Datagram* txBatch;  /* Outbound segments waiting for a single call to SendToBatch */
+    size_t* txBatchCap;      /* Allocated size of each txBatch buffer */
+    uint32_t txBatchLen;     /* Number of segments in txBatch */
+    qcc::SocketFd txBatchSock; /* Socket the segments in txBatch go out on */
+    qcc::SendMsgFlags txBatchFlags; /* Flags the segments in txBatch go out with */
+    bool txBatching;         /* If true outbound segments are added to txBatch rather than sent immediately */
 };
 
 /*
@@ -302,6 +328,7 @@ struct ARDP_HANDLE {
 
 
 static ArdpConnRecord* FindConn(ArdpHandle* handle, uint16_t local, uint16_t foreign);
+static bool IsLocalPortInUse(ArdpHandle* handle, uint16_t local);
 static QStatus DoSendSyn(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint16_t len);
 
 /**************
@@ -340,6 +367,118 @@ static void DeList(ListNode* node)
     node->fwd = node->bwd = node;
 }
 
+/* Initial number of slots in a connection table */
+#define ARDP_CONN_TABLE_MIN_SIZE 64
+
+typedef uint32_t (*ArdpConnHash)(const ArdpConnRecord* conn);
+
+/*
+ * Connections are hashed on the local port only.  Local ports are allocated
+ * to be unique within a handle, and the foreign port of an active connection
+ * is not known until its SYN+ACK arrives.
+ */
+static inline uint32_t HashPort(uint16_t local)
+{
+    uint32_t h = static_cast<uint32_t>(local) * 0x9E3779B1;
+    return h ^ (h >> 15);
+}
+
+static uint32_t HashConnPort(const ArdpConnRecord* conn)
+{
+    return HashPort(conn->local);
+}
+
+static inline uint32_t HashAddr(const ArdpConnRecord* conn)
+{
+    uint64_t p = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(conn));
+    uint32_t h = static_cast<uint32_t>(p ^ (p >> 32)) * 0x9E3779B1;
+    return h ^ (h >> 15);
+}
+
+static void ConnTableInsert(ArdpConnTable* table, ArdpConnRecord* conn, ArdpConnHash hash);
+
+/* Rebuild the table with the given number of slots (a power of two) */
+static void ConnTableResize(ArdpConnTable* table, uint32_t size, ArdpConnHash hash)
+{
+    ArdpConnRecord** old = table->slots;
+    uint32_t oldSize = old ? table->mask + 1 : 0;
+
+    table->slots = new ArdpConnRecord*[size];
+    memset(table->slots, 0, size * sizeof(ArdpConnRecord*));
+    table->mask = size - 1;
+    table->count = 0;
+    for (uint32_t i = 0; i < oldSize; ++i) {
+        if (old[i]) {
+            ConnTableInsert(table, old[i], hash);
+        }
+    }
+    delete [] old;
+}
+
+static void ConnTableInsert(ArdpConnTable* table, ArdpConnRecord* conn, ArdpConnHash hash)
+{
+    /* Keep the load factor under 3/4 so that probe sequences stay short */
+    if (!table->slots) {
+        ConnTableResize(table, ARDP_CONN_TABLE_MIN_SIZE, hash);
+    } else if (((table->count + 1) * 4) > ((table->mask + 1) * 3)) {
+        ConnTableResize(table, (table->mask + 1) * 2, hash);
+    }
+
+    uint32_t i = hash(conn) & table->mask;
+    while (table->slots[i]) {
+        i = (i + 1) & table->mask;
+    }
+    table->slots[i] = conn;
+    ++table->count;
+}
+
+/*
+ * Remove a record from the table.  The fields the hash is computed from must
+ * not have changed since the record was inserted.
+ */
+static void ConnTableRemove(ArdpConnTable* table, ArdpConnRecord* conn, ArdpConnHash hash)
+{
+    if (!table->slots) {
+        return;
+    }
+
+    uint32_t i = hash(conn) & table->mask;
+    while (table->slots[i] != conn) {
+        if (!table->slots[i]) {
+            return;
+        }
+        i = (i + 1) & table->mask;
+    }
+
+    /*
+     * Close the gap by moving back any later entry in the probe run that
+     * would no longer be reachable from its home slot.
+     */
+    uint32_t j = i;
+    for (;;) {
+        j = (j + 1) & table->mask;
+        if (!table->slots[j]) {
+            break;
+        }
+        uint32_t home = hash(table->slots[j]) & table->mask;
+        bool reachable = (i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j));
+        if (!reachable) {
+            table->slots[i] = table->slots[j];
+            i = j;
+        }
+    }
+    table->slots[i] = NULL;
+    --table->count;
+}
+
+static void ConnTableFree(ArdpConnTable* table)
+{
+    delete [] table->slots;
+    table->slots = NULL;
+    table->mask = 0;
+    table->count = 0;
+}
+
 #ifndef NDEBUG
 static void DumpBitMask(ArdpConnRecord* conn, uint32_t* msk, uint16_t sz, bool convert)
 {
@@ -414,16 +553,14 @@ static uint32_t TimeNow(qcc::Timespec base)
 
 static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn)
 {
-    if (conn == NULL) {
-        return false;
-    }
+    ArdpConnTable* table = &handle->connsByAddr;
 
-    if (IsEmpty(&handle->conns)) {
+    if ((conn == NULL) || (table->count == 0)) {
         return false;
     }
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        if (conn == (ArdpConnRecord*)ln) {
+    for (uint32_t i = HashAddr(conn) & table->mask; table->slots[i]; i = (i + 1) & table->mask) {
+        if (table->slots[i] == conn) {
             return true;
         }
     }
@@ -432,20 +569,15 @@ static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn)
 
 static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId)
 {
-    if (conn == NULL) {
-        return false;
-    }
-
-    if (IsEmpty(&handle->conns)) {
-        return false;
-    }
+    return IsConnValid(handle, conn) && (conn->id == connId);
+}
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        if (conn == (ArdpConnRecord*)ln && (conn->id == connId)) {
-            return true;
-        }
-    }
-    return false;
+/* Add a connection record to the list of active connections and its indices */
+static void AddConnRecord(ArdpHandle* handle, ArdpConnRecord* conn)
+{
+    EnList(handle->conns.bwd, (ListNode*)conn);
+    ConnTableInsert(&handle->connsByPort, conn, HashConnPort);
+    ConnTableInsert(&handle->connsByAddr, conn, HashAddr);
 }
 
 static void moveAhead(ArdpHandle* handle, ArdpConnRecord* conn)
@@ -644,7 +776,6 @@ static uint32_t CheckTimers(ArdpHandle* handle)
 
 static void DelConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, bool forced)
 {
-    QCC_UNUSED(handle);
     QCC_DbgTrace(("DelConnRecord(handle=%p conn=%p forced=%s state=%s)",
                   handle, conn, forced ? "true" : "false", State2Text(conn->state)));
 
@@ -670,6 +801,8 @@ static void DelConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, bool forced)
         free(conn->rcv.buf);
     }
 
+    ConnTableRemove(&handle->connsByPort, conn, HashConnPort);
+    ConnTableRemove(&handle->connsByAddr, conn, HashAddr);
     DeList((ListNode*)conn);
 
     if (conn->synData.buf != NULL) {
@@ -779,10 +912,99 @@ static void MarshalSynHeader(uint32_t* buf32, ArdpSynHeader* h)
     *reinterpret_cast<uint16_t*>(txbuf + SYN_RSRV_OFFSET) = 0;
 }
 
+/*
+ * Hand the segments collected in the transmit batch to the socket.  Segments
+ * the socket refuses are dropped: data segments are still on the retransmit
+ * queue, and a lost ACK is repaired by the next ACK or by a retransmission
+ * from the remote.
+ */
+static QStatus FlushTxBatch(ArdpHandle* handle)
+{
+    QStatus status = ER_OK;
+    uint32_t done = 0;
+
+    while (done < handle->txBatchLen) {
+        size_t sent = 0;
+        status = qcc::SendToBatch(handle->txBatchSock, &handle->txBatch[done], handle->txBatchLen - done, sent, handle->txBatchFlags);
+#if ARDP_STATS
+        ++handle->stats.txSyscalls;
+        handle->stats.txDatagrams += sent;
+#endif
+        if (status != ER_OK) {
+            if (status == ER_WOULDBLOCK) {
+                QCC_DbgHLPrintf(("FlushTxBatch: ER_WOULDBLOCK"));
+                handle->trafficJam = true;
+            } else {
+                QCC_LogError(status, ("FlushTxBatch(): Dropped %u segments", handle->txBatchLen - done));
+            }
+            break;
+        }
+        done += sent;
+    }
+    handle->txBatchLen = 0;
+    return status;
+}
+
+/*
+ * Send a segment.  While ARDP_Run() is working through a batch of received
+ * datagrams the segment is copied into the transmit batch instead, so that the
+ * ACKs and data provoked by the whole batch go out in a single system call.
+ */
+static QStatus SendSegment(ArdpHandle* handle, ArdpConnRecord* conn, const qcc::ScatterGatherList& msgSG)
+{
+    QStatus status;
+
+    if (handle->txBatching) {
+        if ((handle->txBatchLen > 0) &&
+            ((handle->txBatchLen == handle->batchSize) || (handle->txBatchSock != conn->sock) || (handle->txBatchFlags != conn->sndFlags))) {
+            status = FlushTxBatch(handle);
+            if (status == ER_WOULDBLOCK) {
+                return status;
+            }
+        }
+
+        size_t len = 0;
+        for (qcc::ScatterGatherList::const_iterator iter = msgSG.Begin(); iter != msgSG.End(); ++iter) {
+            len += iter->len;
+        }
+
+        qcc::Datagram& dgram = handle->txBatch[handle->txBatchLen];
+        if (len > handle->txBatchCap[handle->txBatchLen]) {
+            delete [] reinterpret_cast<uint8_t*>(dgram.buf);
+            dgram.buf = new uint8_t[len];
+            handle->txBatchCap[handle->txBatchLen] = len;
+        }
+        uint8_t* p = reinterpret_cast<uint8_t*>(dgram.buf);
+        for (qcc::ScatterGatherList::const_iterator iter = msgSG.Begin(); iter != msgSG.End(); ++iter) {
+            memcpy(p, iter->buf, iter->len);
+            p += iter->len;
+        }
+        dgram.addr = conn->ipAddr;
+        dgram.port = conn->ipPort;
+        dgram.len = len;
+
+        if (handle->txBatchLen == 0) {
+            handle->txBatchSock = conn->sock;
+            handle->txBatchFlags = conn->sndFlags;
+        }
+        ++handle->txBatchLen;
+        return ER_OK;
+    }
+
+    size_t sent;
+    status = qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent, conn->sndFlags);
+#if ARDP_STATS
+    ++handle->stats.txSyscalls;
+    if (status == ER_OK) {
+        ++handle->stats.txDatagrams;
+    }
+#endif
+    return status;
+}
+
 static QStatus SendMsgHeader(ArdpHandle* handle, ArdpConnRecord* conn, ArdpHeader* h)
 {
     qcc::ScatterGatherList msgSG;
-    size_t sent;
     QStatus status;
     uint32_t buf32[ARDP_FIXED_HEADER_LEN >> 2];
     uint32_t len;
@@ -816,7 +1038,7 @@ static QStatus SendMsgHeader(ArdpHandle* handle, ArdpConnRecord* conn, ArdpHeade
     }
 #endif
 
-    status = SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent, conn->sndFlags);
+    status = SendSegment(handle, conn, msgSG);
     if (status == ER_WOULDBLOCK) {
         QCC_DbgHLPrintf(("SendMsgHeader: ER_WOULDBLOCK"));
         handle->trafficJam = true;
@@ -1019,7 +1241,6 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
     qcc::ScatterGatherList msgSG;
     uint32_t buf32[ARDP_FIXED_HEADER_LEN >> 2];
     uint32_t len;
-    size_t sent;
     QStatus status;
 
     QCC_DbgTrace(("SendMsgData(): handle=%p, conn=%p, hdr=%p, data=%p, datalen=%d, ttl=%u, tStart=%u",
@@ -1063,7 +1284,7 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
     }
 #endif
 
-    status = qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent, conn->sndFlags);
+    status = SendSegment(handle, conn, msgSG);
 
     if (status == ER_OK) {
         /* Piggyback ACKs with data. Cancel ACK timer. */
@@ -1369,6 +1590,18 @@ ArdpHandle* ARDP_AllocHandle(ArdpGlobalConfig* config)
     GetTimeNow(&handle->tbase);
     handle->msnext = ARDP_NO_TIMEOUT;
     memcpy(&handle->config, config, sizeof(ArdpGlobalConfig));
+
+    handle->batchSize = MIN(MAX(config->batchSize, 1), ARDP_MAX_BATCH_SIZE);
+    handle->rxBatchBuf = new uint8_t[handle->batchSize * ARDP_RX_BUFFER_SIZE];
+    handle->rxBatch = new qcc::Datagram[handle->batchSize];
+    handle->txBatch = new qcc::Datagram[handle->batchSize];
+    handle->txBatchCap = new size_t[handle->batchSize];
+    for (uint32_t i = 0; i < handle->batchSize; ++i) {
+        handle->rxBatch[i].buf = handle->rxBatchBuf + (i * ARDP_RX_BUFFER_SIZE);
+        handle->rxBatch[i].len = ARDP_RX_BUFFER_SIZE;
+        handle->txBatch[i].buf = NULL;
+        handle->txBatchCap[i] = 0;
+    }
     return handle;
 }
 
@@ -1383,6 +1616,15 @@ void ARDP_FreeHandle(ArdpHandle* handle)
             DelConnRecord(handle, (ArdpConnRecord*)tmp, false);
         }
     }
+    ConnTableFree(&handle->connsByPort);
+    ConnTableFree(&handle->connsByAddr);
+    for (uint32_t i = 0; i < handle->batchSize; ++i) {
+        delete [] reinterpret_cast<uint8_t*>(handle->txBatch[i].buf);
+    }
+    delete [] handle->txBatchCap;
+    delete [] handle->txBatch;
+    delete [] handle->rxBatch;
+    delete [] handle->rxBatchBuf;
     delete handle;
 }
 
@@ -1627,9 +1869,13 @@ static QStatus InitConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, qcc::Soc
     conn->state = CLOSED;                 /* Starting state is always CLOSED */
     local = (qcc::Rand32() % 65534) + 1;  /* Allocate an "ephemeral" source port */
 
-    /* Make sure this is a unique combiation of foreign/local */
-    while (FindConn(handle, local, foreign) != NULL) {
-        local++;
+    /*
+     * Make sure the local port is not in use by any other connection.  The
+     * remote end tells connection requests apart by our port number, so two
+     * connections to the same host must not share one.
+     */
+    while (IsLocalPortInUse(handle, local)) {
+        local = (local % 65534) + 1;
         count++;
         if (count == 65535) {
             /* Really? We exhausted all the connections?! */
@@ -1677,9 +1923,13 @@ static ArdpConnRecord* FindConn(ArdpHandle* handle, uint16_t local, uint16_t for
 {
     QCC_DbgTrace(("FindConn(handle=%p, local=%d, foreign=%d)", handle, local, foreign));
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        ArdpConnRecord* conn = (ArdpConnRecord*)ln;
-        QCC_DbgPrintf(("FindConn(): conn %p local = %d, foreign = %d", conn, conn->local, conn->foreign));
+    ArdpConnTable* table = &handle->connsByPort;
+    if (table->count == 0) {
+        return NULL;
+    }
+
+    for (uint32_t i = HashPort(local) & table->mask; table->slots[i]; i = (i + 1) & table->mask) {
+        ArdpConnRecord* conn = table->slots[i];
         if (conn->local == local && conn->foreign == foreign) {
             QCC_DbgPrintf(("FindConn(): Found conn %p", conn));
             return conn;
@@ -1688,6 +1938,21 @@ static ArdpConnRecord* FindConn(ArdpHandle* handle, uint16_t local, uint16_t for
     return NULL;
 }
 
+static bool IsLocalPortInUse(ArdpHandle* handle, uint16_t local)
+{
+    ArdpConnTable* table = &handle->connsByPort;
+    if (table->count == 0) {
+        return false;
+    }
+
+    for (uint32_t i = HashPort(local) & table->mask; table->slots[i]; i = (i + 1) & table->mask) {
+        if (table->slots[i]->local == local) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static QStatus SendData(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, uint32_t ttl)
 {
     QStatus status = ER_OK;
@@ -1899,9 +2164,18 @@ static QStatus DoSendSyn(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
 
 #if ARDP_STATS
     ++handle->stats.synSends;
+    ++handle->stats.txSyscalls;
 #endif
 
-    return qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent);
+    /* Keep the SYN behind any segments already waiting in the transmit batch */
+    FlushTxBatch(handle);
+    QStatus status = qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent);
+#if ARDP_STATS
+    if (status == ER_OK) {
+        ++handle->stats.txDatagrams;
+    }
+#endif
+    return status;
 }
 
 static QStatus SendSyn(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint16_t len)
@@ -1959,10 +2233,19 @@ static QStatus SendRst(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress ip
 
 #if ARDP_STATS
     ++handle->stats.rstSends;
+    ++handle->stats.txSyscalls;
 #endif
 
+    /* Keep the RST behind any segments already waiting in the transmit batch */
+    FlushTxBatch(handle);
     size_t sent;
-    return qcc::SendTo(sock, ipAddr, ipPort, &h, ARDP_FIXED_HEADER_LEN, sent);
+    QStatus status = qcc::SendTo(sock, ipAddr, ipPort, &h, ARDP_FIXED_HEADER_LEN, sent);
+#if ARDP_STATS
+    if (status == ER_OK) {
+        ++handle->stats.txDatagrams;
+    }
+#endif
+    return status;
 }
 
 static QStatus UpdateSndSegments(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t ack, uint32_t lcs) {
@@ -3103,7 +3386,7 @@ QStatus ARDP_Connect(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress ipAd
     if (status == ER_OK) {
         conn->context = context;
         conn->passive = false;
-        EnList(handle->conns.bwd, (ListNode*)conn);
+        AddConnRecord(handle, conn);
         status = SendSyn(handle, conn, buf, len);
     }
 
@@ -3356,14 +3639,98 @@ static bool IsDuplicateConnRequest(ArdpHandle* handle, uint16_t foreign, qcc::IP
     return false;
 }
 
+/*
+ * Process a single datagram received by ARDP_Run().  Returns false if the
+ * datagram is unusable, in which case ARDP_Run() stops reading the socket once
+ * the rest of the current batch has been handled.
+ */
+static bool ReceiveDatagram(ArdpHandle* handle, qcc::SocketFd sock, qcc::Datagram& dgram)
+{
+    uint8_t* buf = reinterpret_cast<uint8_t*>(dgram.buf);
+    qcc::IPAddress& address = dgram.addr;  /* The IP address of the foreign side */
+    uint16_t port = dgram.port;            /* The UDP port of the foreign side */
+    size_t nbytes = dgram.received;        /* The number of bytes actually received */
+    QStatus status = ER_OK;
+
+#if ARDP_TESTHOOKS
+    /*
+     * Call the inbound testhook in case the test team needs to munge the
+     * inbound data.
+     */
+    if (handle->th.RecvFrom) {
+        handle->th.RecvFrom(handle, NULL, ARDP_RUN, buf, nbytes);
+    }
+#endif
+
+    if (nbytes == 0 || nbytes >= ARDP_RX_BUFFER_SIZE) {
+        QCC_DbgHLPrintf(("ARDP_Run(): Socket read failed (nbytes = %d)", nbytes));
+        return false;
+    }
+
+    uint16_t local, foreign;
+    ProtocolDemux(buf, nbytes, &local, &foreign);
+    if (local == 0) {
+        if (handle->accepting && handle->cb.AcceptCb) {
+            if (!IsDuplicateConnRequest(handle, foreign, address)) {
+                ArdpConnRecord* conn = NewConnRecord();
+                status = InitConnRecord(handle, conn, sock, address, port, foreign);
+                if (status == ER_OK) {
+                    AddConnRecord(handle, conn);
+                    status = Accept(handle, conn, buf, nbytes);
+                }
+                if (status != ER_OK) {
+                    SetState(conn, CLOSED);
+                    DelConnRecord(handle, conn, false);
+                }
+            } /*
+               * Else the remote most likely timed out waiting for our SYN_ACK.
+               * We should rely on local connection retry mechanism to kick in
+               * and eventually establish the connection.
+               */
+
+        } else {
+            status = ER_ARDP_INVALID_STATE;
+        }
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Failed to accept incoming connection request from %s (ARDP port %u)", address.ToString().c_str(), foreign));
+            SendRst(handle, sock, address, port, local, foreign);
+        }
+    } else {
+        /* Is there an open connection? */
+        ArdpConnRecord* conn = FindConn(handle, local, foreign);
+        if (!conn) {
+            /* Is there a half open connection? */
+            conn = FindConn(handle, local, 0);
+        }
+
+        if (conn) {
+            if ((conn->state != CLOSED) && (conn->state != CLOSE_WAIT)) {
+                QCC_DbgHLPrintf(("ARDP_Run conn state %s", State2Text(conn->state)));
+                conn->lastSeen = TimeNow(handle->tbase);
+                conn->probeTimer.retry = handle->config.keepaliveRetries;
+                status = Receive(handle, conn, buf, nbytes);
+                if (status == ER_ARDP_INVALID_RESPONSE) {
+                    Disconnect(handle, conn, status);
+                }
+            } else {
+                uint8_t flags = *reinterpret_cast<uint8_t*>(buf + FLAGS_OFFSET);
+                /* Only send repeat RST if this is a NUL segment.
+                 * This is done to alleviate a situation when original RST has not reached
+                 * the remote. This can potentially cause the remote to keep the link
+                 * alive (sending pings and retransmit data) until it hits probe timeout
+                 */
+                if (flags & ARDP_FLAG_NUL) {
+                    SendRst(handle, sock, address, port, local, foreign);
+                }
+            }
+        }
+    }
+    return true;
+}
+
 QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool sockWrite, uint32_t* ms)
 {
-    const size_t bufferSize = 65536;      /* UDP packet can be up to 64K long */
-    uint32_t buf32[bufferSize >> 2];
-    uint8_t* buf = reinterpret_cast<uint8_t*>(buf32);
-    qcc::IPAddress address;               /* The IP address of the foreign side */
-    uint16_t port;                        /* Will be the UDP port of the foreign side */
-    size_t nbytes;                        /* The number of bytes actually received */
+    size_t count;                         /* The number of datagrams actually received */
     QStatus status = ER_OK;
 
     //QCC_DbgTrace(("ARDP_Run(handle=%p, sock=%d., socketRead=%d., socketWrite=%d., ms=%p)", handle, sock, sockRead, sockWrite, ms));
@@ -3372,78 +3739,26 @@ QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool soc
     }
 
     if (sockRead) {
-        while ((status = qcc::RecvFrom(sock, address, port, buf, bufferSize, nbytes)) == ER_OK) {
-#if ARDP_TESTHOOKS
-            /*
-             * Call the inbound testhook in case the test team needs to munge the
-             * inbound data.
-             */
-            if (handle->th.RecvFrom) {
-                handle->th.RecvFrom(handle, NULL, ARDP_RUN, buf, nbytes);
-            }
+        /*
+         * Drain the socket a batch at a time.  Segments sent while a batch is
+         * being processed (mostly ACKs) are collected and sent together once
+         * the whole batch has been handled.
+         */
+        while ((status = qcc::RecvFromBatch(sock, handle->rxBatch, handle->batchSize, count)) == ER_OK) {
+#if ARDP_STATS
+            ++handle->stats.rxSyscalls;
+            handle->stats.rxDatagrams += count;
 #endif
-
-            if (nbytes > 0 && nbytes < 65536) {
-                uint16_t local, foreign;
-                ProtocolDemux(buf, nbytes, &local, &foreign);
-                if (local == 0) {
-                    if (handle->accepting && handle->cb.AcceptCb) {
-                        if (!IsDuplicateConnRequest(handle, foreign, address)) {
-                            ArdpConnRecord* conn = NewConnRecord();
-                            status = InitConnRecord(handle, conn, sock, address, port, foreign);
-                            if (status == ER_OK) {
-                                EnList(handle->conns.bwd, (ListNode*)conn);
-                                status = Accept(handle, conn, buf, nbytes);
-                            }
-                            if (status != ER_OK) {
-                                SetState(conn, CLOSED);
-                                DelConnRecord(handle, conn, false);
-                            }
-                        } /*
-                           * Else the remote most likely timed out waiting for our SYN_ACK.
-                           * We should rely on local connection retry mechanism to kick in
-                           * and eventually establish the connection.
-                           */
-
-                    } else {
-                        status = ER_ARDP_INVALID_STATE;
-                    }
-                    if (status != ER_OK) {
-                        QCC_LogError(status, ("Failed to accept incoming connection request from %s (ARDP port %u)", address.ToString().c_str(), foreign));
-                        SendRst(handle, sock, address, port, local, foreign);
-                    }
-                } else {
-                    /* Is there an open connection? */
-                    ArdpConnRecord* conn = FindConn(handle, local, foreign);
-                    if (!conn) {
-                        /* Is there a half open connection? */
-                        conn = FindConn(handle, local, 0);
-                    }
-
-                    if (conn) {
-                        if ((conn->state != CLOSED) && (conn->state != CLOSE_WAIT)) {
-                            QCC_DbgHLPrintf(("ARDP_Run conn state %s", State2Text(conn->state)));
-                            conn->lastSeen = TimeNow(handle->tbase);
-                            conn->probeTimer.retry = handle->config.keepaliveRetries;
-                            status = Receive(handle, conn, buf, nbytes);
-                            if (status == ER_ARDP_INVALID_RESPONSE) {
-                                Disconnect(handle, conn, status);
-                            }
-                        } else {
-                            uint8_t flags = *reinterpret_cast<uint8_t*>(buf + FLAGS_OFFSET);
-                            /* Only send repeat RST if this is a NUL segment.
-                             * This is done to alleviate a situation when original RST has not reached
-                             * the remote. This can potentially cause the remote to keep the link
-                             * alive (sending pings and retransmit data) until it hits probe timeout
-                             */
-                            if (flags & ARDP_FLAG_NUL) {
-                                SendRst(handle, sock, address, port, local, foreign);
-                            }
-                        }
-                    }
+            bool more = (count == handle->batchSize);
+            handle->txBatching = (handle->batchSize > 1);
+            for (size_t i = 0; i < count; ++i) {
+                if (!ReceiveDatagram(handle, sock, handle->rxBatch[i])) {
+                    more = false;
                 }
-            } else {
-                QCC_DbgHLPrintf(("ARDP_Run(): Socket read failed (nbytes = %d)", nbytes));
+            }
+            handle->txBatching = false;
+            FlushTxBatch(handle);
+            if (!more) {
                 break;
             }
         }
@@ -64,6 +64,7 @@ typedef struct {
     uint32_t timewait;                  /**< udp_timewait configuration variable */
     uint32_t segbmax;                   /**< udp_segbmax configuration variable */
     uint32_t segmax;                    /**< udp_segmax configuration variable */
+    uint32_t batchSize;                 /**< udp_batch_size configuration variable */
 } ArdpGlobalConfig;
 
 /**
@@ -259,6 +260,10 @@ typedef struct {
     uint32_t rstRecvs;        /**< The number of RST packets we have received */
     uint32_t nulSends;        /**< The number of NUL packets we have sent */
     uint32_t nulRecvs;        /**< The number of NUL packets we have received */
+    uint32_t rxSyscalls;      /**< The number of system calls made to receive datagrams */
+    uint32_t rxDatagrams;     /**< The number of datagrams received (rxSyscalls / rxDatagrams is syscalls per datagram) */
+    uint32_t txSyscalls;      /**< The number of system calls made to send datagrams */
+    uint32_t txDatagrams;     /**< The number of datagrams sent (txSyscalls / txDatagrams is syscalls per datagram) */
 } ArdpStats;
 
 ArdpStats* ARDP_GetStats(ArdpHandle* handle);
@@ -24,6 +24,8 @@
 
 #include <assert.h>
 
+#include <set>
+
 #include <qcc/Debug.h>
 #include <qcc/Logger.h>
 #include <qcc/String.h>
@@ -134,10 +136,7 @@ bool DaemonRouter::AddCompatibilityOverride(bool add,
             const bool srcInSession = src->IsInSession(sessionId);
             const bool destInSession = dest->IsInSession(sessionId);
             const bool destIsVirtual = (dest->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL);
-            m_Lock.Lock(MUTEX_CONTEXT);
-            const bool selfJoin = selfJoinEps.find(pair<String, SessionId>(src->GetUniqueName(), sessionId)) != selfJoinEps.end();
-            m_Lock.Unlock(MUTEX_CONTEXT);
-            add = add || (srcInSession && destInSession && !destIsVirtual && ((src != dest) || selfJoin));
+            add = add || (srcInSession && destInSession && !destIsVirtual && ((src != dest) || IsSelfJoined(src, sessionId)));
         }
     }
 
@@ -183,21 +182,29 @@ QStatus DaemonRouter::StatusCompatibilityOverride(QStatus status,
 
 #endif
 
+bool DaemonRouter::IsSelfJoined(BusEndpoint& src, SessionId sessionId) const
+{
+    m_Lock.RDLock();
+    const bool selfJoin = !selfJoinEps.empty() &&
+                          (selfJoinEps.find(pair<String, SessionId>(src->GetUniqueName(), sessionId)) != selfJoinEps.end());
+    m_Lock.Unlock();
+    return selfJoin;
+}
+
 bool DaemonRouter::IsSessionDeliverable(SessionId sessionId, BusEndpoint& src, BusEndpoint& dest)
 {
     bool add = true;
     const bool srcInSession = src->IsInSession(sessionId);
     const bool destInSession = dest->IsInSession(sessionId);
     const bool destIsVirtual = (dest->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL);
-    m_Lock.Lock(MUTEX_CONTEXT);
-    const bool selfJoin = selfJoinEps.find(pair<String, SessionId>(src->GetUniqueName(), sessionId)) != selfJoinEps.end();
-    m_Lock.Unlock(MUTEX_CONTEXT);
     /*
      * Ideally, the client library should handle the self join case locally, but
      * we need to handle it here in case clients connect to us that don't handle
-     * self join in the client library.
+     * self join in the client library.  The self join set is only consulted
+     * when it matters (src == dest) since this runs for every candidate
+     * destination of every sessioncast message.
      */
-    add = add && srcInSession && destInSession && !destIsVirtual && ((src != dest) || selfJoin);
+    add = add && srcInSession && destInSession && !destIsVirtual && ((src != dest) || IsSelfJoined(src, sessionId));
 
     return add;
 }
@@ -220,7 +227,7 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
      * Make a local reference to localEndpoint since it could be altered under
      * us by another thread.
      */
-    m_Lock.Lock();
+    m_Lock.RDLock();
     LocalEndpoint lep = localEndpoint;
     m_Lock.Unlock();
 
@@ -325,6 +332,7 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
 
     vector<BusEndpoint> allEps;
     deque<BusEndpoint> destEps;
+    set<BusEndpoint> ruleMatchEps;
 
     bool blocked = false;
     bool blockedReply = false;
@@ -353,6 +361,14 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
         nameTable.GetAllBusEndpoints(allEps);
     }
 
+    if (isBroadcast) {
+        /*
+         * Look up the endpoints that have a match rule for this message once
+         * rather than scanning each endpoint's rules in the loop below.
+         */
+        ruleTable.GetMatchingEndpoints(msg, ruleMatchEps);
+    }
+
     if (!isUnicast || allEps.empty()) {
         /*
          * Here we get a list of all the known Bus-to-bus endpoints in the
@@ -369,10 +385,10 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
          * entries get added.  (This won't be an issue once ASACORE-1622 is
          * resolved.)
          */
+        m_Lock.RDLock();
         allEps.reserve(allEps.size() + m_b2bEndpoints.size());
-        m_Lock.Lock();
-        for (set<RemoteEndpoint>::iterator it = m_b2bEndpoints.begin(); it != m_b2bEndpoints.end(); ++it) {
-            RemoteEndpoint rep = *it;
+        for (B2BEndpointMap::iterator it = m_b2bEndpoints.begin(); it != m_b2bEndpoints.end(); ++it) {
+            RemoteEndpoint rep = it->second;
             BusEndpoint ep = BusEndpoint::cast(rep);
             allEps.push_back(ep);
         }
@@ -461,11 +477,11 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
          *               Can we deprecate the GlobalBroadcast flag?
          */
         add = add && (!isBroadcast || ((msgIsGlobalBroadcast && destIsB2b && (src != dest)) ||
-                                       ruleTable.OkToSend(msg, dest)));
+                                       (ruleMatchEps.find(dest) != ruleMatchEps.end())));
         if (isBroadcast) {
-            QCC_DbgPrintf(("    broadcast src = %s   dest = %s   global bcast = %d   dest epType = %d   ruleTable.OkToSend() => %d   add = %d",
+            QCC_DbgPrintf(("    broadcast src = %s   dest = %s   global bcast = %d   dest epType = %d   rule match => %d   add = %d",
                            src->GetUniqueName().c_str(), dest->GetUniqueName().c_str(),
-                           msgIsGlobalBroadcast, dest->GetEndpointType(), ruleTable.OkToSend(msg, dest), add));
+                           msgIsGlobalBroadcast, dest->GetEndpointType(), (ruleMatchEps.find(dest) != ruleMatchEps.end()), add));
         }
 
         add = add && (!isSessioncast || IsSessionDeliverable(sessionId, src, dest));
@@ -603,16 +619,15 @@ void DaemonRouter::GetBusNames(vector<qcc::String>& names) const
 BusEndpoint DaemonRouter::FindEndpoint(const qcc::String& busName)
 {
     BusEndpoint ep = nameTable.FindEndpoint(busName);
-    if (!ep->IsValid()) {
-        m_Lock.Lock(MUTEX_CONTEXT);
-        for (set<RemoteEndpoint>::const_iterator it = m_b2bEndpoints.begin(); it != m_b2bEndpoints.end(); ++it) {
-            if ((*it)->GetUniqueName() == busName) {
-                RemoteEndpoint rep = *it;
-                ep = BusEndpoint::cast(rep);
-                break;
-            }
+    if (!ep->IsValid() && (busName[0] == ':')) {
+        /* Bus-to-bus endpoints are only ever addressed by their unique name */
+        m_Lock.RDLock();
+        B2BEndpointMap::const_iterator it = m_b2bEndpoints.find(busName);
+        if (it != m_b2bEndpoints.end()) {
+            RemoteEndpoint rep = it->second;
+            ep = BusEndpoint::cast(rep);
         }
-        m_Lock.Unlock(MUTEX_CONTEXT);
+        m_Lock.Unlock();
     }
     return ep;
 }
@@ -646,7 +661,7 @@ QStatus DaemonRouter::RegisterEndpoint(BusEndpoint& endpoint)
 
     /* Keep track of local endpoint */
     if (endpoint->GetEndpointType() == ENDPOINT_TYPE_LOCAL) {
-        m_Lock.Lock();
+        m_Lock.WRLock();
         localEndpoint = LocalEndpoint::cast(endpoint);
         m_Lock.Unlock();
     }
@@ -657,9 +672,9 @@ QStatus DaemonRouter::RegisterEndpoint(BusEndpoint& endpoint)
         status = alljoynObj->AddBusToBusEndpoint(busToBusEndpoint);
 
         /* Add to list of bus-to-bus endpoints */
-        m_Lock.Lock(MUTEX_CONTEXT);
-        m_b2bEndpoints.insert(busToBusEndpoint);
-        m_Lock.Unlock(MUTEX_CONTEXT);
+        m_Lock.WRLock();
+        m_b2bEndpoints[busToBusEndpoint->GetUniqueName()] = busToBusEndpoint;
+        m_Lock.Unlock();
     } else {
         /* Bus-to-client endpoints appear directly on the bus */
         nameTable.AddUniqueName(endpoint);
@@ -695,17 +710,12 @@ void DaemonRouter::UnregisterEndpoint(const qcc::String& epName, EndpointType ep
         alljoynObj->RemoveBusToBusEndpoint(busToBusEndpoint);
 
         /* Remove the bus2bus endpoint from the list */
-        m_Lock.Lock(MUTEX_CONTEXT);
-        set<RemoteEndpoint>::iterator it = m_b2bEndpoints.begin();
-        while (it != m_b2bEndpoints.end()) {
-            RemoteEndpoint rep = *it;
-            if (rep == busToBusEndpoint) {
-                m_b2bEndpoints.erase(it);
-                break;
-            }
-            ++it;
+        m_Lock.WRLock();
+        B2BEndpointMap::iterator it = m_b2bEndpoints.find(busToBusEndpoint->GetUniqueName());
+        if ((it != m_b2bEndpoints.end()) && (it->second == busToBusEndpoint)) {
+            m_b2bEndpoints.erase(it);
         }
-        m_Lock.Unlock(MUTEX_CONTEXT);
+        m_Lock.Unlock();
 
     } else {
         /* Remove endpoint from names and rules */
@@ -716,7 +726,7 @@ void DaemonRouter::UnregisterEndpoint(const qcc::String& epName, EndpointType ep
     /*
      * If the local endpoint is being deregistered this indicates the router is being shut down.
      */
-    m_Lock.Lock();
+    m_Lock.WRLock();
     if (endpoint == localEndpoint) {
         localEndpoint->Invalidate();
         localEndpoint = LocalEndpoint();
@@ -26,6 +26,9 @@
 
 #include <vector>
 
+#include <qcc/RWLock.h>
+#include <qcc/STLContainer.h>
+#include <qcc/StringMapKey.h>
 #include <qcc/Thread.h>
 
 #include "Transport.h"
@@ -280,7 +283,7 @@ class DaemonRouter : public Router {
      */
     bool IsBusRunning(void) const
     {
-        m_Lock.Lock();
+        m_Lock.RDLock();
         bool valid = localEndpoint->IsValid();
         m_Lock.Unlock();
         return valid;
@@ -369,15 +372,15 @@ class DaemonRouter : public Router {
 
 
     void RegisterSelfJoin(qcc::String epName, SessionId id) {
-        m_Lock.Lock(MUTEX_CONTEXT);
+        m_Lock.WRLock();
         selfJoinEps.insert(std::pair<qcc::String, SessionId>(epName, id));
-        m_Lock.Unlock(MUTEX_CONTEXT);
+        m_Lock.Unlock();
 
     }
     void UnregisterSelfJoin(qcc::String epName, SessionId id) {
-        m_Lock.Lock(MUTEX_CONTEXT);
+        m_Lock.WRLock();
         selfJoinEps.erase(std::pair<qcc::String, SessionId>(epName, id));
-        m_Lock.Unlock(MUTEX_CONTEXT);
+        m_Lock.Unlock();
 
     }
 
@@ -390,10 +393,29 @@ class DaemonRouter : public Router {
     AllJoynObj* alljoynObj;               /**< AllJoyn bus object used with this router */
     SessionlessObj* sessionlessObj;       /**< Sessionless bus object used with this router */
 
-    std::set<RemoteEndpoint> m_b2bEndpoints; /**< Collection of Bus-to-bus endpoints */
+    typedef std::unordered_map<qcc::StringMapKey, RemoteEndpoint> B2BEndpointMap;
+    B2BEndpointMap m_b2bEndpoints;       /**< Bus-to-bus endpoints keyed by unique name */
 
     std::set<std::pair<qcc::String, SessionId> > selfJoinEps;  /**< set of EPs that "self joined" */
-    mutable qcc::Mutex m_Lock;           /**< Lock that protects internals of the DaemonRouter */
+
+    /**
+     * Lock that protects internals of the DaemonRouter.  Every message routed
+     * only reads these members so they are protected by a reader/writer lock
+     * that lets router threads forward messages concurrently; only endpoint
+     * (un)registration and self-join bookkeeping take the write lock.
+     */
+    mutable qcc::RWLock m_Lock;
+
+    /**
+     * Helper function to determine if the source endpoint has self-joined the
+     * given session.
+     *
+     * @param src   Source endpoint
+     * @param id    Session ID
+     *
+     * @return  true iff src has self-joined session id.
+     */
+    bool IsSelfJoined(BusEndpoint& src, SessionId id) const;
 
     /**
      * Helper function to determine if a message can be delivered over a given
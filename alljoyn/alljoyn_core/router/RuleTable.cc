@@ -22,6 +22,7 @@
 #include <qcc/platform.h>
 
 #include <algorithm>
+#include <assert.h>
 #include <cstring>
 
 #include "RuleTable.h"
@@ -40,7 +41,8 @@ QStatus RuleTable::AddRule(BusEndpoint& endpoint, const Rule& rule)
 {
     QCC_DbgPrintf(("AddRule for endpoint %s\n  %s", endpoint->GetUniqueName().c_str(), rule.ToString().c_str()));
     lock.Lock(MUTEX_CONTEXT);
-    rules.insert(std::pair<BusEndpoint, Rule>(endpoint, rule));
+    RuleIterator it = rules.insert(std::pair<BusEndpoint, Rule>(endpoint, rule));
+    AddToIndex(it);
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
@@ -52,9 +54,8 @@ QStatus RuleTable::RemoveRule(BusEndpoint& endpoint, Rule& rule)
     std::pair<RuleIterator, RuleIterator> range = rules.equal_range(endpoint);
     while (range.first != range.second) {
         if (range.first->second == rule) {
-            const RuleIterator begin = range.first;
-            const RuleIterator end = ++range.first;
-            rules.erase(begin, end);
+            RemoveFromIndex(range.first);
+            rules.erase(range.first);
             status = ER_OK;
             break;
         }
@@ -68,9 +69,10 @@ QStatus RuleTable::RemoveAllRules(BusEndpoint& endpoint)
 {
     lock.Lock(MUTEX_CONTEXT);
     std::pair<RuleIterator, RuleIterator> range = rules.equal_range(endpoint);
-    if (range.first != rules.end()) {
-        rules.erase(range.first, range.second);
+    for (RuleIterator it = range.first; it != range.second; ++it) {
+        RemoveFromIndex(it);
     }
+    rules.erase(range.first, range.second);
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
@@ -106,5 +108,116 @@ bool RuleTable::OkToSend(const Message& msg, BusEndpoint& endpoint) const
     return match;
 }
 
+void RuleTable::GetMatchingEndpoints(const Message& msg, std::set<BusEndpoint>& endpoints) const
+{
+    FirstMatchMap firstMatch;
+    lock.Lock(MUTEX_CONTEXT);
+    MatchIndex(memberIndex, msg->GetMemberName(), msg, firstMatch);
+    MatchIndex(ifaceIndex, msg->GetInterface(), msg, firstMatch);
+    MatchIndex(pathIndex, msg->GetObjectPath(), msg, firstMatch);
+    MatchIndex(senderIndex, msg->GetSender(), msg, firstMatch);
+    MatchBucket(wildcardRules, msg, firstMatch);
+
+    /*
+     * OkToSend() only considers the first rule (in insertion order) of an
+     * endpoint that matches the message and rejects the endpoint if that rule
+     * specifies sessionless='t'.  The same is done here so that both give the
+     * same answer.
+     */
+    for (FirstMatchMap::const_iterator it = firstMatch.begin(); it != firstMatch.end(); ++it) {
+        if (it->second->rule->second.sessionless != Rule::SESSIONLESS_TRUE) {
+            endpoints.insert(endpoints.end(), it->first);
+        }
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void RuleTable::AddToIndex(RuleIterator rule)
+{
+    const Rule& r = rule->second;
+    IndexEntry entry(rule, nextSeq++);
+    if (!r.member.empty()) {
+        memberIndex[StringMapKey(r.member)].push_back(entry);
+    } else if (!r.iface.empty()) {
+        ifaceIndex[StringMapKey(r.iface)].push_back(entry);
+    } else if (!r.path.empty()) {
+        pathIndex[StringMapKey(r.path)].push_back(entry);
+    } else if (!r.sender.empty()) {
+        senderIndex[StringMapKey(r.sender)].push_back(entry);
+    } else {
+        wildcardRules.push_back(entry);
+    }
+}
+
+void RuleTable::RemoveFromIndex(RuleIterator rule)
+{
+    const Rule& r = rule->second;
+    RuleIndex* index = NULL;
+    const char* key = NULL;
+    if (!r.member.empty()) {
+        index = &memberIndex;
+        key = r.member.c_str();
+    } else if (!r.iface.empty()) {
+        index = &ifaceIndex;
+        key = r.iface.c_str();
+    } else if (!r.path.empty()) {
+        index = &pathIndex;
+        key = r.path.c_str();
+    } else if (!r.sender.empty()) {
+        index = &senderIndex;
+        key = r.sender.c_str();
+    }
+
+    RuleIndex::iterator iit;
+    IndexBucket* bucket = &wildcardRules;
+    if (index) {
+        iit = index->find(StringMapKey(key));
+        assert(iit != index->end());
+        bucket = &iit->second;
+    }
+
+    /* Order within a bucket is irrelevant (entries carry their own sequence number) */
+    for (IndexBucket::iterator it = bucket->begin(); it != bucket->end(); ++it) {
+        if (it->rule == rule) {
+            *it = bucket->back();
+            bucket->pop_back();
+            break;
+        }
+    }
+
+    if (index && bucket->empty()) {
+        index->erase(iit);
+    }
+}
+
+void RuleTable::MatchBucket(const IndexBucket& bucket, const Message& msg, FirstMatchMap& firstMatch)
+{
+    for (IndexBucket::const_iterator it = bucket.begin(); it != bucket.end(); ++it) {
+        const BusEndpoint& ep = it->rule->first;
+        FirstMatchMap::iterator fit = firstMatch.find(ep);
+        if ((fit != firstMatch.end()) && (fit->second->seq < it->seq)) {
+            /* An earlier rule for this endpoint already matched */
+            continue;
+        }
+        if (it->rule->second.IsMatch(msg)) {
+            if (fit != firstMatch.end()) {
+                fit->second = &(*it);
+            } else {
+                firstMatch.insert(pair<BusEndpoint, const IndexEntry*>(ep, &(*it)));
+            }
+        }
+    }
+}
+
+void RuleTable::MatchIndex(const RuleIndex& index, const char* key, const Message& msg, FirstMatchMap& firstMatch)
+{
+    if (key && *key) {
+        RuleIndex::const_iterator it = index.find(StringMapKey(key));
+        if (it != index.end()) {
+            MatchBucket(it->second, msg, firstMatch);
+        }
+    }
+}
+
 
 }
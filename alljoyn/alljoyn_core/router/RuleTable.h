@@ -26,6 +26,12 @@
 
 #include <qcc/platform.h>
 #include <qcc/Mutex.h>
+#include <qcc/StringMapKey.h>
+#include <qcc/STLContainer.h>
+
+#include <map>
+#include <set>
+#include <vector>
 
 #include "BusEndpoint.h"
 #include "Rule.h"
@@ -40,10 +46,21 @@ typedef std::multimap<BusEndpoint, Rule>::const_iterator RuleConstIterator;
 /**
  * RuleTable is a thread-safe store used for storing
  * and retrieving message bus routing rules.
+ *
+ * In addition to the per-endpoint multimap, every rule is filed in an index
+ * bucket keyed on the most selective exact-match field it specifies (member,
+ * interface, path or sender, in that order).  Rules that specify none of
+ * these fields are kept in a separate wildcard bucket.  This allows the set
+ * of endpoints interested in a broadcast message to be found by examining
+ * only the rules that could possibly match it rather than every rule in the
+ * table.
  */
 class RuleTable {
   public:
 
+    /** Constructor */
+    RuleTable() : nextSeq(0) { }
+
     /**
      * Add a rule for an endpoint.
      *
@@ -132,9 +149,44 @@ class RuleTable {
      */
     bool OkToSend(const Message& msg, BusEndpoint& endpoint) const;
 
+    /**
+     * Get the set of endpoints that have a match rule for the message.  This
+     * is equivalent to calling OkToSend() for every endpoint in the rule
+     * table, but only the rules that can possibly match the message are
+     * evaluated.
+     *
+     * @param   msg         Message that may be delivered.
+     * @param[out] endpoints    Endpoints for which OkToSend() would return true.
+     */
+    void GetMatchingEndpoints(const Message& msg, std::set<BusEndpoint>& endpoints) const;
+
   private:
+    /** Index entry referring to a rule stored in the rule table */
+    struct IndexEntry {
+        RuleIterator rule;   /**< Rule (and endpoint) in the rule table */
+        uint64_t seq;        /**< Insertion order of the rule */
+        IndexEntry(RuleIterator rule, uint64_t seq) : rule(rule), seq(seq) { }
+    };
+
+    typedef std::vector<IndexEntry> IndexBucket;
+    typedef std::unordered_map<qcc::StringMapKey, IndexBucket> RuleIndex;
+
+    /** Earliest matching rule found so far for each endpoint */
+    typedef std::map<BusEndpoint, const IndexEntry*> FirstMatchMap;
+
+    void AddToIndex(RuleIterator rule);
+    void RemoveFromIndex(RuleIterator rule);
+    static void MatchBucket(const IndexBucket& bucket, const Message& msg, FirstMatchMap& firstMatch);
+    static void MatchIndex(const RuleIndex& index, const char* key, const Message& msg, FirstMatchMap& firstMatch);
+
     mutable qcc::Mutex lock;                   /**< Lock protecting rule table */
     std::multimap<BusEndpoint, Rule> rules;    /**< Rule table */
+    RuleIndex memberIndex;                     /**< Rules indexed by member name */
+    RuleIndex ifaceIndex;                      /**< Rules with no member indexed by interface */
+    RuleIndex pathIndex;                       /**< Rules with no member or interface indexed by object path */
+    RuleIndex senderIndex;                     /**< Rules with no member, interface or path indexed by sender */
+    IndexBucket wildcardRules;                 /**< Rules that specify none of the indexed fields */
+    uint64_t nextSeq;                          /**< Insertion order of the next rule added */
 };
 
 }
@@ -433,16 +433,56 @@ void SessionlessObj::PushMessageWork::Run()
     /* Put the message in the local cache */
     SessionlessMessageKey key(msg->GetSender(), msg->GetInterface(), msg->GetMemberName(), msg->GetObjectPath());
     slObj.advanceChangeId = true;
-    SessionlessMessage val(slObj.curChangeId, msg);
-    LocalCache::iterator it = slObj.localCache.find(key);
-    if (it == slObj.localCache.end()) {
-        slObj.localCache.insert(pair<SessionlessMessageKey, SessionlessMessage>(key, val));
+    slObj.AddLocalCacheEntry(key, msg);
+
+    slObj.lock.Unlock();
+    slObj.router.UnlockNameTable();
+}
+
+SessionlessObj::LocalCache::iterator SessionlessObj::FindLocalCacheEntry(const ChangeIdEntry& entry)
+{
+    LocalCache::iterator it = localCache.find(entry.key);
+    if ((it != localCache.end()) && (it->second.first == entry.changeId) && it->second.second.iden(entry.msg)) {
+        return it;
+    }
+    return localCache.end();
+}
+
+void SessionlessObj::AddLocalCacheEntry(const SessionlessMessageKey& key, Message& msg)
+{
+    SessionlessMessage val(curChangeId, msg);
+    LocalCache::iterator it = localCache.find(key);
+    if (it == localCache.end()) {
+        localCache.insert(pair<SessionlessMessageKey, SessionlessMessage>(key, val));
     } else {
         it->second = val;
     }
+    changeIdIndex.push_back(ChangeIdEntry(curChangeId, key, msg));
+    TrimChangeIdIndex();
+}
 
-    slObj.lock.Unlock();
-    slObj.router.UnlockNameTable();
+void SessionlessObj::TrimChangeIdIndex()
+{
+    while (!changeIdIndex.empty() && (FindLocalCacheEntry(changeIdIndex.front()) == localCache.end())) {
+        changeIdIndex.pop_front();
+    }
+
+    /*
+     * Stale entries in the middle of the index are left alone until they make
+     * up more than half of it, so compacting is amortized over the pushes.
+     */
+    if (changeIdIndex.size() > ((2 * localCache.size()) + 16)) {
+        ChangeIdIndex::iterator dst = changeIdIndex.begin();
+        for (ChangeIdIndex::iterator src = changeIdIndex.begin(); src != changeIdIndex.end(); ++src) {
+            if (FindLocalCacheEntry(*src) != localCache.end()) {
+                if (dst != src) {
+                    *dst = *src;
+                }
+                ++dst;
+            }
+        }
+        changeIdIndex.erase(dst, changeIdIndex.end());
+    }
 }
 
 QStatus SessionlessObj::PushMessage(Message& msg)
@@ -579,6 +619,7 @@ void SessionlessObj::CancelMessageWork::Run()
         }
         ++it;
     }
+    slObj.TrimChangeIdIndex();
     slObj.lock.Unlock();
 
     slObj.busController->GetAllJoynObj().CancelSessionlessMessageReply(msg, status);
@@ -631,6 +672,7 @@ void SessionlessObj::NameOwnerChangedWork::Run()
     while ((mit != slObj.localCache.end()) && (::strcmp(oldOwner.c_str(), mit->second.second->GetSender()) == 0)) {
         slObj.localCache.erase(mit++);
     }
+    slObj.TrimChangeIdIndex();
 
     /* Stop discovery if nobody is looking for sessionless signals */
     if (slObj.rules.empty()) {
@@ -845,6 +887,18 @@ void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
     bool messageErased = false;
     QCC_DbgTrace(("SessionlessObj::HandleControlSignal(%d, %d)", fromChangeId, toChangeId));
 
+    /* Parse the remote rules once for the whole range */
+    bool matchAll = remoteRules.empty();
+    vector<Rule> matchRules;
+    for (vector<String>::iterator rit = remoteRules.begin(); !matchAll && (rit != remoteRules.end()); ++rit) {
+        Rule rule(rit->c_str());
+        if (rule == legacyRule) {
+            matchAll = true;
+        } else {
+            matchRules.push_back(rule);
+        }
+    }
+
     /* Advance the curChangeId */
     router.LockNameTable();
     lock.Lock();
@@ -853,48 +907,68 @@ void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
         advanceChangeId = false;
     }
 
-    /* Send all messages in local cache in range [fromChangeId, toChangeId) */
-    LocalCache::iterator it = localCache.begin();
+    /*
+     * Send all messages in local cache in range [fromChangeId, toChangeId).
+     * The change ID index is ordered, so skip straight to the start of the
+     * range and stop at the first entry past its end.
+     */
     uint32_t rangeLen = toChangeId - fromChangeId;
-    while (it != localCache.end()) {
-        if (IN_WINDOW(uint32_t, fromChangeId, rangeLen, it->second.first)) {
-            SessionlessMessageKey key = it->first;
-            Message msg = it->second.second;
-            if (msg->IsExpired()) {
-                /* Remove expired message without sending */
-                localCache.erase(it++);
-                messageErased = true;
-            } else if (sid != 0) {
-                /* Send message to remote destination */
-                bool isMatch = remoteRules.empty();
-                for (vector<String>::iterator rit = remoteRules.begin(); !isMatch && (rit != remoteRules.end()); ++rit) {
-                    Rule rule(rit->c_str());
-                    isMatch = rule.IsMatch(msg) || (rule == legacyRule);
-                }
-                if (isMatch) {
-                    BusEndpoint ep = router.FindEndpoint(sender);
-                    if (ep->IsValid()) {
-                        lock.Unlock();
-                        router.UnlockNameTable();
-                        QCC_DbgPrintf(("Send cid=%u,serialNum=%u to sid=%u", it->second.first, msg->GetCallSerial(), sid));
-                        SendThroughEndpoint(msg, ep, sid);
-                        router.LockNameTable();
-                        lock.Lock();
-                    }
-                }
-                it = localCache.upper_bound(key);
-            } else {
-                /* Send message to local destination */
-                SendMatchingThroughEndpoint(sid, msg, fromLocalRulesId, toLocalRulesId);
-                it = localCache.upper_bound(key);
+    ChangeIdIndex::iterator it = changeIdIndex.begin();
+    size_t count = changeIdIndex.size();
+    while (count > 0) {
+        size_t step = count / 2;
+        ChangeIdIndex::iterator mid = it + step;
+        if (static_cast<int32_t>(mid->changeId - fromChangeId) < 0) {
+            it = ++mid;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    vector<SessionlessMessage> remoteMsgs;
+    for (; (it != changeIdIndex.end()) && IN_WINDOW(uint32_t, fromChangeId, rangeLen, it->changeId); ++it) {
+        LocalCache::iterator cit = FindLocalCacheEntry(*it);
+        if (cit == localCache.end()) {
+            /* Message has been replaced or removed since */
+            continue;
+        }
+        Message msg = cit->second.second;
+        if (msg->IsExpired()) {
+            /* Remove expired message without sending */
+            localCache.erase(cit);
+            messageErased = true;
+        } else if (sid != 0) {
+            /* Collect message for remote destination */
+            bool isMatch = matchAll;
+            for (vector<Rule>::iterator rit = matchRules.begin(); !isMatch && (rit != matchRules.end()); ++rit) {
+                isMatch = rit->IsMatch(msg);
+            }
+            if (isMatch) {
+                remoteMsgs.push_back(cit->second);
             }
         } else {
-            ++it;
+            /* Send message to local destination */
+            SendMatchingThroughEndpoint(sid, msg, fromLocalRulesId, toLocalRulesId);
         }
     }
+    if (messageErased) {
+        TrimChangeIdIndex();
+    }
+    BusEndpoint ep;
+    if (!remoteMsgs.empty()) {
+        ep = router.FindEndpoint(sender);
+    }
     lock.Unlock();
     router.UnlockNameTable();
 
+    /* Send the collected messages to the remote destination */
+    if (!remoteMsgs.empty() && ep->IsValid()) {
+        for (vector<SessionlessMessage>::iterator mit = remoteMsgs.begin(); mit != remoteMsgs.end(); ++mit) {
+            QCC_DbgPrintf(("Send cid=%u,serialNum=%u to sid=%u", mit->first, mit->second->GetCallSerial(), sid));
+            SendThroughEndpoint(mit->second, ep, sid);
+        }
+    }
+
     /* Alert the advertiser worker */
     if (messageErased) {
         uint32_t zero = 0;
@@ -940,6 +1014,7 @@ void SessionlessObj::AlarmTriggered(const Alarm& alarm, QStatus reason)
                 ++it;
             }
         }
+        TrimChangeIdIndex();
         lock.Unlock();
 
         /* Change advertisment if needed */
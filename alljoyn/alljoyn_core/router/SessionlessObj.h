@@ -23,6 +23,7 @@
 
 #include <qcc/platform.h>
 
+#include <deque>
 #include <map>
 #include <set>
 #include <queue>
@@ -383,6 +384,44 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
     /** Storage for sessionless messages waiting to be delivered */
     LocalCache localCache;
 
+    /**
+     * An entry in the change ID index of the local cache.  The entry is stale
+     * once the cached message for key is no longer msg.
+     */
+    struct ChangeIdEntry {
+        ChangeIdEntry(uint32_t changeId, const SessionlessMessageKey& key, const Message& msg) : changeId(changeId), key(key), msg(msg) { }
+        uint32_t changeId;
+        SessionlessMessageKey key;
+        Message msg;
+    };
+    typedef std::deque<ChangeIdEntry> ChangeIdIndex;
+    /**
+     * The local cache in the order messages were pushed, and therefore in
+     * change ID order.  Replaced and removed messages leave stale entries
+     * behind that are skipped and trimmed lazily.
+     */
+    ChangeIdIndex changeIdIndex;
+
+    /**
+     * Find the local cache entry of a change ID index entry.
+     *
+     * @param entry  The change ID index entry
+     *
+     * @return  The local cache entry or localCache.end() if entry is stale
+     */
+    LocalCache::iterator FindLocalCacheEntry(const ChangeIdEntry& entry);
+
+    /**
+     * Add a message to the local cache and the change ID index.
+     *
+     * @param key  The key of the message
+     * @param msg  The message
+     */
+    void AddLocalCacheEntry(const SessionlessMessageKey& key, Message& msg);
+
+    /** Drop stale entries from the change ID index */
+    void TrimChangeIdIndex();
+
     struct RoutedMessage {
         RoutedMessage(const Message& msg) : sender(msg->GetSender()), serial(msg->GetCallSerial()) { }
         qcc::String sender;
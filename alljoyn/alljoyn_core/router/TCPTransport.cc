@@ -872,7 +872,9 @@ TCPTransport::TCPTransport(BusAttachment& bus)
     m_isAdvertising(false), m_isDiscovering(false), m_isListening(false),
     m_isNsEnabled(false), m_reload(STATE_RELOADING),
     m_nsReleaseCount(0), m_wildcardIfaceProcessed(false),
-    m_maxRemoteClientsTcp(0), m_numUntrustedClients(0), m_dynamicScoreUpdater(*this)
+    m_maxRemoteClientsTcp(0), m_numUntrustedClients(0),
+    m_txCoalesceMessages(TX_COALESCE_MESSAGES_DEFAULT), m_txCoalesceBytes(TX_COALESCE_BYTES_DEFAULT),
+    m_dynamicScoreUpdater(*this)
 {
     QCC_DbgTrace(("TCPTransport::TCPTransport()"));
     /*
@@ -926,6 +928,7 @@ void TCPTransport::Authenticated(TCPEndpoint& conn)
     m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
     conn->SetListener(this);
+    conn->SetTxCoalescing(m_txCoalesceMessages, m_txCoalesceBytes);
 
     conn->SetEpStarting();
 
@@ -1732,6 +1735,9 @@ void* TCPTransport::Run(void* arg)
     m_maxHbeatProbeTimeout = config->GetLimit("tcp_max_probe_timeout", MAX_HEARTBEAT_PROBE_TIMEOUT_DEFAULT);
     m_defaultHbeatProbeTimeout = config->GetLimit("tcp_default_probe_timeout", DEFAULT_HEARTBEAT_PROBE_TIMEOUT_DEFAULT);
 
+    m_txCoalesceMessages = config->GetLimit("tcp_tx_coalesce_messages", TX_COALESCE_MESSAGES_DEFAULT);
+    m_txCoalesceBytes = config->GetLimit("tcp_tx_coalesce_bytes", TX_COALESCE_BYTES_DEFAULT);
+
     QCC_DbgPrintf(("TCPTransport: Using m_minHbeatIdleTimeout=%u, m_maxHbeatIdleTimeout=%u, m_numHbeatProbes=%u, m_defaultHbeatProbeTimeout=%u m_maxHbeatProbeTimeout=%u", m_minHbeatIdleTimeout, m_maxHbeatIdleTimeout, m_numHbeatProbes, m_defaultHbeatProbeTimeout, m_maxHbeatProbeTimeout));
 
     QStatus status = ER_OK;
@@ -3230,6 +3236,7 @@ QStatus TCPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
         status = tcpEp->Establish("ANONYMOUS", authName, redirection, authListener);
         if (status == ER_OK) {
             tcpEp->SetListener(this);
+            tcpEp->SetTxCoalescing(m_txCoalesceMessages, m_txCoalesceBytes);
             tcpEp->SetEpStarting();
             status = tcpEp->Start(m_defaultHbeatIdleTimeout, m_defaultHbeatProbeTimeout, m_numHbeatProbes, m_maxHbeatProbeTimeout);
             if (status == ER_OK) {
@@ -641,6 +641,17 @@ class TCPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
      */
     static const uint32_t HEARTBEAT_NUM_PROBES = 1;
 
+    /**
+     * @brief The default limits on coalescing queued messages into a single
+     * write on a TCP endpoint.
+     *
+     * This corresponds to the configuration items "tcp_tx_coalesce_messages"
+     * and "tcp_tx_coalesce_bytes".  Setting "tcp_tx_coalesce_messages" to 1
+     * sends every message with its own write.
+     */
+    static const uint32_t TX_COALESCE_MESSAGES_DEFAULT = 32;
+    static const uint32_t TX_COALESCE_BYTES_DEFAULT = 64 * 1024;
+
     /*
      * The Android Compatibility Test Suite (CTS) is used by Google to enforce a
      * common idea of what it means to be Android.  One of their tests is to
@@ -816,6 +827,10 @@ class TCPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
     uint32_t m_numHbeatProbes;             /**< Number of probes Routing node should wait for Heartbeat response to be
                                               recieved from the Leaf node before declaring it dead - Transport specific */
 
+    uint32_t m_txCoalesceMessages;         /**< Maximum number of messages written to an endpoint at once - configurable in router config */
+
+    uint32_t m_txCoalesceBytes;            /**< Maximum number of bytes coalesced into one write to an endpoint - configurable in router config */
+
     DynamicScoreUpdater m_dynamicScoreUpdater;
 };
 
@@ -466,6 +466,7 @@ const uint32_t UDP_TIMEWAIT = 1000;  /**< How long do we stay in TIMWAIT state b
  */
 const uint32_t UDP_SEGBMAX = 4440;  /**< Maximum size of an ARDP segment (quantum of reliable transmission) */
 const uint32_t UDP_SEGMAX = 93;  /**< Maximum number of ARDP segment in-flight (bandwidth-delay product sizing) */
+const uint32_t UDP_BATCH_SIZE = 8;  /**< Maximum number of datagrams ARDP receives or sends with a single system call */
 
 namespace ajn {
 
@@ -4459,6 +4460,7 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
     ardpConfig.timewait = config->GetLimit("udp_timewait", UDP_TIMEWAIT);
     ardpConfig.segbmax = config->GetLimit("udp_segbmax", UDP_SEGBMAX);
     ardpConfig.segmax = config->GetLimit("udp_segmax", UDP_SEGMAX);
+    ardpConfig.batchSize = config->GetLimit("udp_batch_size", UDP_BATCH_SIZE);
     if (ardpConfig.segmax * ardpConfig.segbmax < ALLJOYN_MAX_PACKET_LEN) {
         QCC_LogError(ER_INVALID_CONFIG, ("UDPTransport::UDPTransport(): udp_segmax (%d) * udp_segbmax (%d) < ALLJOYN_MAX_PACKET_LEN (%d) ignored", ardpConfig.segbmax, ardpConfig.segmax, ALLJOYN_MAX_PACKET_LEN));
         ardpConfig.segbmax = UDP_SEGBMAX;
@@ -9635,7 +9637,7 @@ QStatus UDPTransport::NormalizeTransportSpec(const char* inSpec, qcc::String& ou
 /**
  * This is the method that is called in order to initiate an outbound (active)
  * connection.  This is called from the AllJoyn Object in the course of
- * processing a JoinSession request in the context of a JoinSessionThread.
+ * processing a JoinSession request on one of its session setup threads.
  */
 QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts, BusEndpoint& newEp)
 {
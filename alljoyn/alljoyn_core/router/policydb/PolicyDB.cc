@@ -21,6 +21,8 @@
 
 #include <qcc/platform.h>
 
+#include <algorithm>
+
 #include <qcc/Debug.h>
 #include <qcc/Logger.h>
 #include <qcc/Util.h>
@@ -399,6 +401,11 @@ bool _PolicyDB::AddRule(const String& cat, const String& catValue, const String&
     bool success = false;
     policydb::PolicyPermission permission;
 
+    /* The compiled rule summaries and cached decisions are redone by Finalize(). */
+    sendInfo = MessageRuleInfo();
+    receiveInfo = MessageRuleInfo();
+    FlushDecisions();
+
     if (permStr == "allow") {
         permission = policydb::POLICY_ALLOW;
     } else if (permStr == "deny") {
@@ -482,6 +489,10 @@ void _PolicyDB::AddAlias(const String& alias, const String& name)
 
 void _PolicyDB::Finalize(Bus* bus)
 {
+    CompileMessageRules(sendInfo, sendRS);
+    CompileMessageRules(receiveInfo, receiveRS);
+    FlushDecisions();
+
     if (bus) {
         /*
          * If the config was reloaded while the bus is operating, then the
@@ -714,6 +725,135 @@ bool _PolicyDB::CheckMessage(bool& allow, const PolicyRuleList& ruleList,
 
 
 
+void _PolicyDB::CompileMessageRules(MessageRuleInfo& info, const PolicyRuleListSet& ruleSet)
+{
+    vector<const PolicyRuleList*> ruleLists;
+    ruleLists.push_back(&ruleSet.mandatoryRules);
+    ruleLists.push_back(&ruleSet.defaultRules);
+    for (IDRuleMap::const_iterator it = ruleSet.userRules.begin(); it != ruleSet.userRules.end(); ++it) {
+        ruleLists.push_back(&it->second);
+    }
+    for (IDRuleMap::const_iterator it = ruleSet.groupRules.begin(); it != ruleSet.groupRules.end(); ++it) {
+        ruleLists.push_back(&it->second);
+    }
+
+    info.hasRules = false;
+    info.checksBusName = false;
+    info.checksPathPrefix = false;
+    for (vector<const PolicyRuleList*>::const_iterator lit = ruleLists.begin(); lit != ruleLists.end(); ++lit) {
+        for (PolicyRuleList::const_iterator it = (*lit)->begin(); it != (*lit)->end(); ++it) {
+            info.hasRules = true;
+            info.checksBusName |= (it->busName != WILDCARD);
+            info.checksPathPrefix |= (it->pathPrefix != WILDCARD);
+        }
+    }
+}
+
+
+_PolicyDB::DecisionKey::DecisionKey(bool send, const NormalizedMsgHdr& nmh, const MessageRuleInfo& info,
+                                    uint32_t senderUid, uint32_t senderGid, uint32_t destUid, uint32_t destGid) :
+    send(send),
+    type(nmh.type),
+    ifcID(nmh.ifcID),
+    memberID(nmh.memberID),
+    errorID(nmh.errorID),
+    pathID(nmh.pathID),
+    senderUid(senderUid),
+    senderGid(senderGid),
+    destUid(destUid),
+    destGid(destGid)
+{
+    if (info.checksPathPrefix && !nmh.pathIDSet->empty()) {
+        pathIDs.assign(nmh.pathIDSet->begin(), nmh.pathIDSet->end());
+        sort(pathIDs.begin(), pathIDs.end());
+    }
+}
+
+
+void _PolicyDB::DecisionKey::SetBusNameIDs(const IDSet& bnIDSet)
+{
+    if (!bnIDSet->empty()) {
+        busNameIDs.assign(bnIDSet->begin(), bnIDSet->end());
+        sort(busNameIDs.begin(), busNameIDs.end());
+    }
+}
+
+
+bool _PolicyDB::DecisionKey::operator==(const DecisionKey& other) const
+{
+    return ((send == other.send) &&
+            (type == other.type) &&
+            (ifcID == other.ifcID) &&
+            (memberID == other.memberID) &&
+            (errorID == other.errorID) &&
+            (pathID == other.pathID) &&
+            (senderUid == other.senderUid) &&
+            (senderGid == other.senderGid) &&
+            (destUid == other.destUid) &&
+            (destGid == other.destGid) &&
+            (pathIDs == other.pathIDs) &&
+            (busNameIDs == other.busNameIDs));
+}
+
+
+size_t _PolicyDB::DecisionKeyHash::operator()(const DecisionKey& key) const
+{
+    size_t hash = (key.send ? 0x100 : 0) | static_cast<size_t>(key.type);
+    const uint32_t ids[] = {
+        key.ifcID, key.memberID, key.errorID, key.pathID,
+        key.senderUid, key.senderGid, key.destUid, key.destGid
+    };
+    for (size_t i = 0; i < ArraySize(ids); ++i) {
+        hash = (hash * 31) ^ ids[i];
+    }
+    for (vector<StringID>::const_iterator it = key.pathIDs.begin(); it != key.pathIDs.end(); ++it) {
+        hash = (hash * 31) ^ *it;
+    }
+    for (vector<StringID>::const_iterator it = key.busNameIDs.begin(); it != key.busNameIDs.end(); ++it) {
+        hash = (hash * 31) ^ *it;
+    }
+    return hash;
+}
+
+
+bool _PolicyDB::LookupDecision(const DecisionKey& key, bool& allow) const
+{
+    bool found = false;
+    decisionsLock.Lock(MUTEX_CONTEXT);
+    DecisionCache::const_iterator it = decisions.find(key);
+    if (it != decisions.end()) {
+        allow = it->second;
+        found = true;
+    }
+    decisionsLock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+
+void _PolicyDB::CacheDecision(const DecisionKey& key, bool allow) const
+{
+    decisionsLock.Lock(MUTEX_CONTEXT);
+    if (decisions.size() >= MAX_DECISION_CACHE_SIZE) {
+        /*
+         * The number of distinct keys seen in practice is small (a handful
+         * of message types between a handful of user IDs), so simply start
+         * over rather than tracking usage for eviction.
+         */
+        decisions.clear();
+    }
+    decisions[key] = allow;
+    decisionsLock.Unlock(MUTEX_CONTEXT);
+}
+
+
+void _PolicyDB::FlushDecisions()
+{
+    decisionsLock.Lock(MUTEX_CONTEXT);
+    decisions.clear();
+    decisionsLock.Unlock(MUTEX_CONTEXT);
+}
+
+
 bool _PolicyDB::OKToConnect(uint32_t uid, uint32_t gid) const
 {
     /* Implicitly default to allow any endpoint to connect. */
@@ -806,6 +946,10 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
     bool allow = true;
     bool ruleMatch = false;
 
+    if (!receiveInfo.hasRules) {
+        return allow;
+    }
+
     QCC_DbgPrintf(("Check if OK for endpoint %s to receive %s (%s{%s} --> %s{%s})",
                    dest->GetUniqueName().c_str(), nmh.msg->Description().c_str(),
                    nmh.msg->GetSender(), IDSet2String(nmh.senderIDSet).c_str(),
@@ -814,6 +958,17 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
     uint32_t senderUid = nmh.sender->GetUserId();
     uint32_t senderGid = nmh.sender->GetGroupId();
     uint32_t destUid = dest->GetUserId();
+    uint32_t gid = dest->GetGroupId();
+
+    DecisionKey key(false, nmh, receiveInfo, senderUid, senderGid, destUid, gid);
+    if (receiveInfo.checksBusName) {
+        key.SetBusNameIDs(nmh.senderIDSet);
+    }
+    if (LookupDecision(key, allow)) {
+        QCC_DbgPrintf(("    cached decision: %s", allow ? "allow" : "deny"));
+        return allow;
+    }
+
     if (!receiveRS.mandatoryRules.empty()) {
         QCC_DbgPrintf(("    checking mandatory receive rules"));
         ruleMatch = CheckMessage(allow, receiveRS.mandatoryRules, nmh, nmh.senderIDSet, senderUid, destUid, senderGid);
@@ -827,7 +982,6 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
         }
     }
 
-    uint32_t gid = dest->GetGroupId();
     if (!ruleMatch && !receiveRS.groupRules.empty()) {
         IDRuleMap::const_iterator it = receiveRS.groupRules.find(gid);
         if (it != receiveRS.groupRules.end()) {
@@ -841,6 +995,7 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
         ruleMatch = CheckMessage(allow, receiveRS.defaultRules, nmh, nmh.senderIDSet, senderUid, destUid, senderGid);
     }
 
+    CacheDecision(key, allow);
     return allow;
 }
 
@@ -850,7 +1005,13 @@ bool _PolicyDB::OKToSend(const NormalizedMsgHdr& nmh, BusEndpoint& dest) const
     /* Implicitly default to allow messages to be sent. */
     bool allow = true;
     bool ruleMatch = false;
-    const IDSet destIDSet = LookupBusNameID(dest->GetUniqueName().c_str());
+
+    if (!sendInfo.hasRules) {
+        return allow;
+    }
+
+    /* The destination's bus names only need to be looked up if a rule can match on them. */
+    const IDSet destIDSet = sendInfo.checksBusName ? LookupBusNameID(dest->GetUniqueName().c_str()) : IDSet();
 
     QCC_DbgPrintf(("Check if OK for endpoint %s to send %s to destination %s (%s{%s} --> %s{%s})",
                    nmh.sender->GetUniqueName().c_str(), nmh.msg->Description().c_str(),
@@ -867,6 +1028,15 @@ bool _PolicyDB::OKToSend(const NormalizedMsgHdr& nmh, BusEndpoint& dest) const
     }
 
     uint32_t senderUid = nmh.sender->GetUserId();
+    uint32_t senderGid = nmh.sender->GetGroupId();
+
+    DecisionKey key(true, nmh, sendInfo, senderUid, senderGid, destUid, destGid);
+    key.SetBusNameIDs(destIDSet);
+    if (LookupDecision(key, allow)) {
+        QCC_DbgPrintf(("    cached decision: %s", allow ? "allow" : "deny"));
+        return allow;
+    }
+
     if (!sendRS.mandatoryRules.empty()) {
         QCC_DbgPrintf(("    checking mandatory send rules"));
         ruleMatch = CheckMessage(allow, sendRS.mandatoryRules, nmh, destIDSet, destUid, senderUid, destGid);
@@ -881,10 +1051,9 @@ bool _PolicyDB::OKToSend(const NormalizedMsgHdr& nmh, BusEndpoint& dest) const
     }
 
     if (!ruleMatch && !sendRS.groupRules.empty()) {
-        uint32_t gid = nmh.sender->GetGroupId();
-        IDRuleMap::const_iterator it = sendRS.groupRules.find(gid);
+        IDRuleMap::const_iterator it = sendRS.groupRules.find(senderGid);
         if (it != sendRS.groupRules.end()) {
-            QCC_DbgPrintf(("    checking group=%u send rules", gid));
+            QCC_DbgPrintf(("    checking group=%u send rules", senderGid));
             ruleMatch = CheckMessage(allow, it->second, nmh, destIDSet, destUid, senderUid, destGid);
         }
     }
@@ -894,5 +1063,6 @@ bool _PolicyDB::OKToSend(const NormalizedMsgHdr& nmh, BusEndpoint& dest) const
         ruleMatch = CheckMessage(allow, sendRS.defaultRules, nmh, destIDSet, destUid, senderUid, destGid);
     }
 
+    CacheDecision(key, allow);
     return allow;
 }
@@ -24,11 +24,14 @@
 #include <qcc/platform.h>
 #include <qcc/Logger.h>
 #include <qcc/ManagedObj.h>
+#include <qcc/Mutex.h>
 #include <qcc/RWLock.h>
 #include <qcc/String.h>
 #include <qcc/StringMapKey.h>
 #include <qcc/STLContainer.h>
 
+#include <vector>
+
 #include <alljoyn/Message.h>
 
 #include "Bus.h"
@@ -462,6 +465,97 @@ class _PolicyDB {
                              const NormalizedMsgHdr& nmh, const IDSet& bnIDSet,
                              uint32_t userId, uint32_t userId2, uint32_t groupId);
 
+    /**
+     * Summary of what the message rules for one direction (send or receive)
+     * look at.  Compiled by Finalize() so that messages can skip the rule
+     * walk entirely when there are no rules and so that decision cache keys
+     * only carry the ID sets the rules can actually match on.
+     */
+    struct MessageRuleInfo {
+        bool hasRules;                  /**< at least one rule exists */
+        bool checksBusName;             /**< at least one rule matches on a bus name */
+        bool checksPathPrefix;          /**< at least one rule matches on an object path prefix */
+
+        /**
+         * Constructor.  Until the rules are compiled every check is assumed
+         * to be needed.
+         */
+        MessageRuleInfo() : hasRules(true), checksBusName(true), checksPathPrefix(true) { }
+    };
+
+    /**
+     * Everything a send or receive decision depends on.  The bus name and
+     * path prefix ID sets are stored by value (sorted) rather than by bus
+     * name so that a cached decision stays correct when bus name ownership
+     * changes.
+     */
+    struct DecisionKey {
+        bool send;                      /**< send (true) or receive (false) decision */
+        AllJoynMessageType type;        /**< message type */
+        StringID ifcID;                 /**< normalized interface name */
+        StringID memberID;              /**< normalized member name */
+        StringID errorID;               /**< normalized error name */
+        StringID pathID;                /**< normalized object path */
+        uint32_t senderUid;             /**< numeric user id of the sender */
+        uint32_t senderGid;             /**< numeric group id of the sender */
+        uint32_t destUid;               /**< numeric user id of the destination */
+        uint32_t destGid;               /**< numeric group id of the destination */
+        std::vector<StringID> pathIDs;  /**< sorted object path prefix IDs (if rules check prefixes) */
+        std::vector<StringID> busNameIDs; /**< sorted bus name IDs (if rules check bus names) */
+
+        DecisionKey(bool send, const NormalizedMsgHdr& nmh, const MessageRuleInfo& info,
+                    uint32_t senderUid, uint32_t senderGid, uint32_t destUid, uint32_t destGid);
+
+        /**
+         * Set the bus name IDs the decision depends on.
+         *
+         * @param bnIDSet   Set of normalized bus names
+         */
+        void SetBusNameIDs(const IDSet& bnIDSet);
+
+        bool operator==(const DecisionKey& other) const;
+    };
+
+    /** Hash functor for DecisionKey */
+    struct DecisionKeyHash {
+        size_t operator()(const DecisionKey& key) const;
+    };
+
+    /** typedef for the cache of send/receive decisions */
+    typedef std::unordered_map<DecisionKey, bool, DecisionKeyHash> DecisionCache;
+
+    /** Maximum number of decisions kept before the cache is flushed */
+    static const size_t MAX_DECISION_CACHE_SIZE = 4096;
+
+    /**
+     * Compile the summary of a set of message rules.
+     *
+     * @param info      [OUT] summary to be filled
+     * @param ruleSet   message rule sets to summarize
+     */
+    static void CompileMessageRules(MessageRuleInfo& info, const PolicyRuleListSet& ruleSet);
+
+    /**
+     * Look up a cached send/receive decision.
+     *
+     * @param key       decision key
+     * @param allow     [OUT] cached decision
+     *
+     * @return  true if a decision was cached, false otherwise
+     */
+    bool LookupDecision(const DecisionKey& key, bool& allow) const;
+
+    /**
+     * Cache a send/receive decision.
+     *
+     * @param key       decision key
+     * @param allow     the decision
+     */
+    void CacheDecision(const DecisionKey& key, bool allow) const;
+
+    /** Discard all cached send/receive decisions. */
+    void FlushDecisions();
+
     PolicyRuleListSet ownRS;        /**< bus name ownership policy rule sets */
     PolicyRuleListSet sendRS;       /**< sender message policy rule sets */
     PolicyRuleListSet receiveRS;    /**< receiver message policy rule sets */
@@ -471,6 +565,11 @@ class _PolicyDB {
     BusNameIDMap busNameIDMap;      /**< mapping of bus names to a set of equivalent IDs */
     mutable qcc::RWLock lock;       /**< rwlock to protect R/W contention */
 
+    MessageRuleInfo sendInfo;       /**< compiled summary of the send rules */
+    MessageRuleInfo receiveInfo;    /**< compiled summary of the receive rules */
+    mutable DecisionCache decisions;  /**< cache of send/receive decisions */
+    mutable qcc::Mutex decisionsLock; /**< mutex to protect the decision cache */
+
     friend class NormalizedMsgHdr;
 };
 
@@ -41,6 +41,7 @@
 #endif
 
 #include <qcc/IPAddress.h>
+#include <qcc/Socket.h>
 #include "ScatterGatherList.h"
 #include <qcc/Util.h>
 #include <qcc/Thread.h>
@@ -203,5 +204,136 @@ QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
     }
     return status;
 }
+#if defined(QCC_OS_LINUX)
+
+/* Maximum number of datagrams handed to a single sendmmsg() or recvmmsg() */
+static const size_t MAX_BATCH_DGRAMS = 64;
+
+QStatus SendToBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& sent, SendMsgFlags flags)
+{
+    QStatus status = ER_OK;
+    struct mmsghdr msgs[MAX_BATCH_DGRAMS];
+    struct iovec iov[MAX_BATCH_DGRAMS];
+    struct sockaddr_storage addrs[MAX_BATCH_DGRAMS];
+
+    QCC_DbgTrace(("SendToBatch(sockfd = %d, dgrams, count = %u, sent = <>, flags = 0x%x)", sockfd, count, (int)flags));
+
+    sent = 0;
+    while ((status == ER_OK) && (sent < count)) {
+        size_t num = std::min(count - sent, MAX_BATCH_DGRAMS);
+        for (size_t i = 0; i < num; ++i) {
+            Datagram& dgram = dgrams[sent + i];
+            socklen_t addrLen = sizeof(addrs[i]);
+            status = MakeSockAddr(dgram.addr, dgram.port, &addrs[i], addrLen);
+            if (status != ER_OK) {
+                num = i;
+                break;
+            }
+            iov[i].iov_base = dgram.buf;
+            iov[i].iov_len = dgram.len;
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = addrLen;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            QCC_DbgLocalData(dgram.buf, dgram.len);
+        }
+        if (num == 0) {
+            break;
+        }
+        int ret = sendmmsg(static_cast<int>(sockfd), msgs, num, (int)flags | MSG_NOSIGNAL);
+        if (ret == -1) {
+            if (errno == EAGAIN || errno == EINTR || errno == EWOULDBLOCK) {
+                status = ER_WOULDBLOCK;
+            } else {
+                status = ER_OS_ERROR;
+                QCC_LogError(status, ("SendToBatch (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+            }
+            break;
+        }
+        sent += ret;
+        if (static_cast<size_t>(ret) < num) {
+            break;
+        }
+    }
+    return (sent > 0) ? ER_OK : status;
+}
+
+QStatus RecvFromBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& received)
+{
+    struct mmsghdr msgs[MAX_BATCH_DGRAMS];
+    struct iovec iov[MAX_BATCH_DGRAMS];
+    struct sockaddr_storage addrs[MAX_BATCH_DGRAMS];
+    size_t num = std::min(count, MAX_BATCH_DGRAMS);
+
+    QCC_DbgTrace(("RecvFromBatch(sockfd = %d, dgrams, count = %u, received = <>)", sockfd, count));
+
+    received = 0;
+    for (size_t i = 0; i < num; ++i) {
+        iov[i].iov_base = dgrams[i].buf;
+        iov[i].iov_len = dgrams[i].len;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int ret = recvmmsg(static_cast<int>(sockfd), msgs, num, 0, NULL);
+    if (ret == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return ER_WOULDBLOCK;
+        }
+        QCC_DbgHLPrintf(("RecvFromBatch (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+        return ER_OS_ERROR;
+    }
+
+    for (int i = 0; i < ret; ++i) {
+        dgrams[i].received = msgs[i].msg_len;
+        GetSockAddr(&addrs[i], msgs[i].msg_hdr.msg_namelen, dgrams[i].addr, dgrams[i].port);
+        QCC_DbgRemoteData(dgrams[i].buf, dgrams[i].received);
+    }
+    received = static_cast<size_t>(ret);
+    return ER_OK;
+}
+
+#else
+
+/*
+ * Platforms without sendmmsg()/recvmmsg() handle the batch one datagram at a
+ * time.
+ */
+QStatus SendToBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& sent, SendMsgFlags flags)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("SendToBatch(sockfd = %d, dgrams, count = %u, sent = <>, flags = 0x%x)", sockfd, count, (int)flags));
+
+    for (sent = 0; sent < count; ++sent) {
+        size_t octets;
+        status = SendTo(sockfd, dgrams[sent].addr, dgrams[sent].port, dgrams[sent].buf, dgrams[sent].len, octets, flags);
+        if (status != ER_OK) {
+            break;
+        }
+    }
+    return (sent > 0) ? ER_OK : status;
+}
+
+QStatus RecvFromBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& received)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("RecvFromBatch(sockfd = %d, dgrams, count = %u, received = <>)", sockfd, count));
+
+    for (received = 0; received < count; ++received) {
+        status = RecvFrom(sockfd, dgrams[received].addr, dgrams[received].port,
+                          dgrams[received].buf, dgrams[received].len, dgrams[received].received);
+        if (status != ER_OK) {
+            break;
+        }
+    }
+    return (received > 0) ? ER_OK : status;
+}
+
+#endif
+
 } // namespace qcc
 
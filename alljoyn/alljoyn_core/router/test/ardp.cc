@@ -61,6 +61,7 @@ const uint32_t UDP_DELAYED_ACK_TIMEOUT = 100; /**< How long do we wait until ack
 const uint32_t UDP_TIMEWAIT = 1000;         /**< How long do we stay in TIMWAIT state before releasing the per-connection resources */
 const uint32_t UDP_SEGBMAX = 65507;  /**< Maximum size of an ARDP message (for receive buffer sizing) */
 const uint32_t UDP_SEGMAX = 50;      /**< Maximum number of ARDP messages in-flight (bandwidth-delay product sizing) */
+const uint32_t UDP_BATCH_SIZE = 8;  /**< Maximum number of datagrams received or sent with a single system call */
 
 bool g_user = false;
 char const* g_localport = "9954";
@@ -226,6 +227,7 @@ void* Test::Run(void* arg)
     config.timewait = UDP_TIMEWAIT;
     config.segbmax = UDP_SEGBMAX;
     config.segmax = UDP_SEGMAX;
+    config.batchSize = UDP_BATCH_SIZE;
 
     ArdpHandle* ardpHandle = ARDP_AllocHandle(&config);
     ARDP_SetAcceptCb(ardpHandle, AcceptCb);
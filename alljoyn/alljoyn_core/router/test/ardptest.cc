@@ -29,6 +29,7 @@
 #include <arpa/inet.h>
 #endif
 
+#include <algorithm>
 #include <vector>
 #include <queue>
 
@@ -39,6 +40,7 @@
 #include <qcc/SocketTypes.h>
 #include <qcc/Thread.h>
 #include <qcc/StringUtil.h>
+#include <qcc/time.h>
 #include <alljoyn/Init.h>
 #include <alljoyn/Status.h>
 
@@ -64,6 +66,7 @@ const uint32_t UDP_DELAYED_ACK_TIMEOUT = 100; /**< How long do we wait until ack
 const uint32_t UDP_TIMEWAIT = 1000;         /**< How long do we stay in TIMWAIT state before releasing the per-connection resources */
 const uint32_t UDP_SEGBMAX = 65507;  /**< Maximum size of an ARDP message (for receive buffer sizing) */
 const uint32_t UDP_SEGMAX = 50;      /**< Maximum number of ARDP messages in-flight (bandwidth-delay product sizing) */
+const uint32_t UDP_BATCH_SIZE = 8;  /**< Maximum number of datagrams received or sent with a single system call */
 
 char const* g_local_port = "9954";
 char const* g_foreign_port = "9955";
@@ -246,6 +249,242 @@ class ThreadClass : public Thread {
 
 };
 
+/*
+ * Stress test: open thousands of connections between two ARDP instances on
+ * the loopback interface and measure the cost of moving a segment as the
+ * number of connections grows.  With hashed connection lookup the per-segment
+ * cost should stay roughly flat.
+ */
+static uint32_t g_stressConnects = 0;
+static uint32_t g_stressRecvs = 0;
+static std::vector<ArdpConnRecord*> g_stressConns;
+
+static const uint32_t STRESS_SEGMENTS_PER_CONN = 8;  /**< Segments sent on each connection per stage (less than UDP_SEGMAX) */
+static const uint32_t STRESS_CHUNK = 64;             /**< Segments in flight before waiting for the receiver to catch up */
+static const uint32_t STRESS_TIMEOUT = 30000;        /**< Give up on a stage after this many ms */
+
+static bool StressAcceptCb(ArdpHandle* handle, qcc::IPAddress ipAddr, uint16_t ipPort, ArdpConnRecord* conn, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(ipAddr);
+    QCC_UNUSED(ipPort);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+
+    status = ARDP_Accept(handle, conn, UDP_SEGMAX, UDP_SEGBMAX, (uint8_t*)g_ajnAcceptString, strlen(g_ajnAcceptString) + 1);
+    return status == ER_OK;
+}
+
+static void StressConnectCb(ArdpHandle* handle, ArdpConnRecord* conn, bool passive, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+
+    if (status != ER_OK) {
+        printf("Connect failed conn = %p, passive = %d, reason = %s\n", conn, passive, QCC_StatusText(status));
+    } else if (!passive) {
+        g_stressConns.push_back(conn);
+        ++g_stressConnects;
+    }
+}
+
+static void StressDisconnectCb(ArdpHandle* handle, ArdpConnRecord* conn, QStatus status)
+{
+    QCC_UNUSED(handle);
+
+    printf("Unexpected disconnect conn = %p, reason = %s\n", conn, QCC_StatusText(status));
+}
+
+static void StressRecvCb(ArdpHandle* handle, ArdpConnRecord* conn, ArdpRcvBuf* rcv, QStatus status)
+{
+    QCC_UNUSED(status);
+
+    ++g_stressRecvs;
+    ARDP_RecvReady(handle, conn, rcv);
+}
+
+static void StressSendCb(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+
+    delete [] buf;
+}
+
+static void StressSendWindowCb(ArdpHandle* handle, ArdpConnRecord* conn, uint16_t window, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(window);
+    QCC_UNUSED(status);
+}
+
+static ArdpHandle* StressAllocHandle(ArdpGlobalConfig& config)
+{
+    ArdpHandle* handle = ARDP_AllocHandle(&config);
+    ARDP_SetAcceptCb(handle, StressAcceptCb);
+    ARDP_SetConnectCb(handle, StressConnectCb);
+    ARDP_SetDisconnectCb(handle, StressDisconnectCb);
+    ARDP_SetRecvCb(handle, StressRecvCb);
+    ARDP_SetSendCb(handle, StressSendCb);
+    ARDP_SetSendWindowCb(handle, StressSendWindowCb);
+    return handle;
+}
+
+/* Run both ARDP instances until *counter reaches target or the stage times out */
+static bool StressPump(ArdpHandle* client, qcc::SocketFd clientSock, ArdpHandle* server, qcc::SocketFd serverSock,
+                       volatile uint32_t* counter, uint32_t target, uint64_t deadline)
+{
+    qcc::Event clientEvent(clientSock, qcc::Event::IO_READ);
+    qcc::Event serverEvent(serverSock, qcc::Event::IO_READ);
+    uint32_t clientMs = 0;
+    uint32_t serverMs = 0;
+
+    /* Only run an instance when its socket is readable or one of its timers is due */
+    while ((*counter < target) && !g_interrupt) {
+        std::vector<qcc::Event*> checkEvents, signaledEvents;
+        checkEvents.push_back(&clientEvent);
+        checkEvents.push_back(&serverEvent);
+        QStatus status = qcc::Event::Wait(checkEvents, signaledEvents, (std::min)((std::min)(clientMs, serverMs), (uint32_t)100));
+        bool runClient = (status == ER_TIMEOUT);
+        bool runServer = (status == ER_TIMEOUT);
+        for (std::vector<qcc::Event*>::iterator i = signaledEvents.begin(); i != signaledEvents.end(); ++i) {
+            runClient |= (*i == &clientEvent);
+            runServer |= (*i == &serverEvent);
+        }
+        if (runServer) {
+            ARDP_Run(server, serverSock, true, true, &serverMs);
+        }
+        if (runClient) {
+            ARDP_Run(client, clientSock, true, true, &clientMs);
+        }
+        if (GetTimestamp64() > deadline) {
+            return false;
+        }
+    }
+    return !g_interrupt;
+}
+
+static QStatus StressOpenSocket(qcc::SocketFd& sock, uint16_t& port)
+{
+    QStatus status = qcc::Socket(qcc::QCC_AF_INET, qcc::QCC_SOCK_DGRAM, sock);
+    if (status == ER_OK) {
+        status = qcc::SetBlocking(sock, false);
+    }
+    if (status == ER_OK) {
+        qcc::SetRcvBuf(sock, 4 * 1024 * 1024);
+        status = qcc::Bind(sock, qcc::IPAddress(g_local_address), 0);
+    }
+    if (status == ER_OK) {
+        qcc::IPAddress addr;
+        status = qcc::GetLocalAddress(sock, addr, port);
+    }
+    return status;
+}
+
+static QStatus StressTest(uint32_t numConns)
+{
+    qcc::SocketFd clientSock;
+    qcc::SocketFd serverSock;
+    uint16_t clientPort;
+    uint16_t serverPort;
+
+    QStatus status = StressOpenSocket(clientSock, clientPort);
+    if (status == ER_OK) {
+        status = StressOpenSocket(serverSock, serverPort);
+    }
+    if (status != ER_OK) {
+        QCC_LogError(status, ("StressTest(): Unable to open sockets"));
+        return status;
+    }
+
+    ArdpGlobalConfig config;
+    config.connectTimeout = UDP_CONNECT_TIMEOUT;
+    config.connectRetries = UDP_CONNECT_RETRIES;
+    config.initialDataTimeout = UDP_INITIAL_DATA_TIMEOUT;
+    config.totalDataRetryTimeout = UDP_TOTAL_DATA_RETRY_TIMEOUT;
+    config.minDataRetries = UDP_MIN_DATA_RETRIES;
+    config.persistInterval = UDP_PERSIST_INTERVAL;
+    config.totalAppTimeout = UDP_TOTAL_APP_TIMEOUT;
+    config.linkTimeout = UDP_LINK_TIMEOUT;
+    config.keepaliveRetries = UDP_KEEPALIVE_RETRIES;
+    config.fastRetransmitAckCounter = UDP_FAST_RETRANSMIT_ACK_COUNTER;
+    config.delayedAckTimeout = UDP_DELAYED_ACK_TIMEOUT;
+    config.timewait = UDP_TIMEWAIT;
+    config.segbmax = UDP_SEGBMAX;
+    config.segmax = UDP_SEGMAX;
+    config.batchSize = UDP_BATCH_SIZE;
+
+    ArdpHandle* client = StressAllocHandle(config);
+    ArdpHandle* server = StressAllocHandle(config);
+    ARDP_StartPassive(server);
+
+    printf("%12s %12s %12s %14s\n", "connections", "segments", "time (ms)", "usec/segment");
+
+    for (uint32_t stage = 8; (status == ER_OK) && (stage >= 1); stage /= 2) {
+        uint32_t target = (std::max)(numConns / stage, (uint32_t)1);
+
+        /* Grow the number of open connections to the target for this stage */
+        while ((status == ER_OK) && (g_stressConnects < target)) {
+            uint32_t pending = (std::min)(target - g_stressConnects, STRESS_CHUNK);
+            for (uint32_t i = 0; (status == ER_OK) && (i < pending); ++i) {
+                ArdpConnRecord* conn;
+                status = ARDP_Connect(client, clientSock, qcc::IPAddress(g_local_address), serverPort, UDP_SEGMAX, UDP_SEGBMAX, &conn,
+                                      (uint8_t*)g_ajnConnString, strlen(g_ajnConnString) + 1, NULL);
+            }
+            if ((status == ER_OK) && !StressPump(client, clientSock, server, serverSock, &g_stressConnects, g_stressConnects + pending,
+                                                 GetTimestamp64() + STRESS_TIMEOUT)) {
+                status = ER_TIMEOUT;
+            }
+        }
+        if (status != ER_OK) {
+            QCC_LogError(status, ("StressTest(): Failed to open %u connections", target));
+            break;
+        }
+
+        /* Send a few small segments over every connection, round-robin */
+        uint32_t segments = g_stressConns.size() * STRESS_SEGMENTS_PER_CONN;
+        uint32_t sent = 0;
+        uint32_t recvBase = g_stressRecvs;
+        uint64_t deadline = GetTimestamp64() + STRESS_TIMEOUT;
+        uint64_t start = GetTimestamp64();
+        while ((status == ER_OK) && (sent < segments)) {
+            uint32_t chunk = (std::min)(segments - sent, STRESS_CHUNK);
+            for (uint32_t i = 0; (status == ER_OK) && (i < chunk); ++i, ++sent) {
+                uint8_t* buf = new uint8_t[64];
+                memset(buf, 0, 64);
+                status = ARDP_Send(client, g_stressConns[sent % g_stressConns.size()], buf, 64, 0);
+                if (status != ER_OK) {
+                    delete [] buf;
+                }
+            }
+            if ((status == ER_OK) && !StressPump(client, clientSock, server, serverSock, &g_stressRecvs, recvBase + sent, deadline)) {
+                status = ER_TIMEOUT;
+            }
+        }
+        uint64_t elapsed = GetTimestamp64() - start;
+        if (status != ER_OK) {
+            QCC_LogError(status, ("StressTest(): Failed to move segments over %u connections", g_stressConns.size()));
+            break;
+        }
+        printf("%12u %12u %12u %14.2f\n", (uint32_t)g_stressConns.size(), segments, (uint32_t)elapsed,
+               (elapsed * 1000.0) / segments);
+
+        /* Let the delayed ACKs drain so that every send window is open again */
+        uint32_t idle = 0;
+        StressPump(client, clientSock, server, serverSock, &idle, 1, GetTimestamp64() + 2 * UDP_DELAYED_ACK_TIMEOUT);
+    }
+
+    ARDP_FreeHandle(client);
+    ARDP_FreeHandle(server);
+    qcc::Close(clientSock);
+    qcc::Close(serverSock);
+    return status;
+}
+
 static void Print_Conn() {
     std::map<uint32_t, ArdpConnRecord*>::iterator it;
     printf("===================================================== \n");
@@ -279,6 +518,7 @@ int CDECL_CALL main(int argc, char** argv)
     }
 
     QStatus status = ER_OK;
+    uint32_t stressConns = 0;
 
     for (int i = 1; i < argc; ++i) {
         if (0 == strcmp("-lp", argv[i])) {
@@ -293,6 +533,9 @@ int CDECL_CALL main(int argc, char** argv)
         } else if (0 == strcmp("-fa", argv[i])) {
             g_foreign_address = argv[i + 1];
             i++;
+        } else if (0 == strcmp("-stress", argv[i])) {
+            stressConns = StringToU32(argv[i + 1], 0, 0);
+            i++;
         } else {
             printf("Unknown option %s\n", argv[i]);
             exit(0);
@@ -306,6 +549,13 @@ int CDECL_CALL main(int argc, char** argv)
 
     signal(SIGINT, SigIntHandler);
 
+    if (stressConns > 0) {
+        status = StressTest(stressConns);
+        AllJoynRouterShutdown();
+        AllJoynShutdown();
+        return (status == ER_OK) ? 0 : 1;
+    }
+
 
     //One time activity- Create a socket, set to blocking, bind it to local port, local address
     qcc::SocketFd sock;
@@ -344,6 +594,7 @@ int CDECL_CALL main(int argc, char** argv)
     config.timewait = UDP_TIMEWAIT;
     config.segbmax = UDP_SEGBMAX;
     config.segmax = UDP_SEGMAX;
+    config.batchSize = UDP_BATCH_SIZE;
 
     //Allocate a handle (ARDP protocol instance).
     ArdpHandle* handle = ARDP_AllocHandle(&config);
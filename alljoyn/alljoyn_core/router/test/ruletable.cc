@@ -0,0 +1,223 @@
+/**
+ * @file
+ * Microbenchmark comparing indexed match rule lookup in RuleTable against a
+ * scan of every endpoint's rules.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <set>
+#include <vector>
+
+#include <qcc/platform.h>
+#include <qcc/ManagedObj.h>
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/time.h>
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Init.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/Status.h>
+
+#include "BusEndpoint.h"
+#include "Rule.h"
+#include "RuleTable.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+class _SignalMessage : public _Message {
+  public:
+    _SignalMessage(BusAttachment& bus) : _Message(bus) { }
+
+    QStatus Signal(const char* objPath, const char* iface, const char* signalName)
+    {
+        return SignalMsg("", NULL, 0, objPath, iface, signalName, NULL, 0, 0, 0);
+    }
+};
+
+typedef ManagedObj<_SignalMessage> SignalMessage;
+
+static void Usage()
+{
+    printf("Usage: ruletable [-e <endpoints>] [-r <rules per endpoint>] [-n <distinct members>] [-i <iterations>]\n");
+}
+
+/*
+ * The behavior prior to the rule index: ask the rule table about each
+ * endpoint in turn.
+ */
+static void ScanEndpoints(RuleTable& ruleTable, const vector<BusEndpoint>& eps, const Message& msg, set<BusEndpoint>& matches)
+{
+    for (vector<BusEndpoint>::const_iterator it = eps.begin(); it != eps.end(); ++it) {
+        BusEndpoint ep = *it;
+        if (ruleTable.OkToSend(msg, ep)) {
+            matches.insert(ep);
+        }
+    }
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    uint32_t numEps = 200;
+    uint32_t rulesPerEp = 20;
+    uint32_t numMembers = 1000;
+    uint32_t iterations = 1000;
+
+    for (int i = 1; i < argc; ++i) {
+        uint32_t* val = NULL;
+        if (strcmp("-e", argv[i]) == 0) {
+            val = &numEps;
+        } else if (strcmp("-r", argv[i]) == 0) {
+            val = &rulesPerEp;
+        } else if (strcmp("-n", argv[i]) == 0) {
+            val = &numMembers;
+        } else if (strcmp("-i", argv[i]) == 0) {
+            val = &iterations;
+        }
+        if (!val || (++i == argc)) {
+            Usage();
+            AllJoynShutdown();
+            return 1;
+        }
+        *val = StringToU32(argv[i], 10, 0);
+        if (*val == 0) {
+            Usage();
+            AllJoynShutdown();
+            return 1;
+        }
+    }
+
+    BusAttachment* bus = new BusAttachment("ruletable");
+    bus->Start();
+
+    RuleTable ruleTable;
+    vector<BusEndpoint> eps;
+    EndpointType epType = ENDPOINT_TYPE_REMOTE;
+
+    /*
+     * Mostly member specific rules as added by signal handlers, with the
+     * occasional interface-wide, path-wide and match-everything rule mixed in
+     * so that every index bucket is exercised.
+     */
+    for (uint32_t e = 0; e < numEps; ++e) {
+        BusEndpoint ep(epType);
+        eps.push_back(ep);
+        for (uint32_t r = 0; r < rulesPerEp; ++r) {
+            uint32_t n = (e * rulesPerEp + r) % numMembers;
+            String ruleStr;
+            switch (r % 10) {
+            case 7:
+                ruleStr = "type='signal',interface='org.test.Iface" + U32ToString(n % 16) + "'";
+                break;
+
+            case 8:
+                ruleStr = "type='signal',path='/org/test/obj" + U32ToString(n % 16) + "'";
+                break;
+
+            case 9:
+                ruleStr = (e % 50 == 0) ? "type='signal'" : "type='signal',member='Signal" + U32ToString(n) + "',sessionless='t'";
+                break;
+
+            default:
+                ruleStr = "type='signal',interface='org.test.Iface" + U32ToString(n % 16) + "',member='Signal" + U32ToString(n) + "'";
+                break;
+            }
+            QStatus status;
+            Rule rule(ruleStr.c_str(), &status);
+            if (status == ER_OK) {
+                ruleTable.AddRule(ep, rule);
+            }
+        }
+    }
+
+    vector<Message> msgs;
+    for (uint32_t m = 0; m < 64; ++m) {
+        uint32_t n = (m * 7919) % numMembers;
+        SignalMessage sm(*bus);
+        String path = "/org/test/obj" + U32ToString(m % 16);
+        String iface = "org.test.Iface" + U32ToString(n % 16);
+        String member = "Signal" + U32ToString(n);
+        QStatus status = sm->Signal(path.c_str(), iface.c_str(), member.c_str());
+        if (status != ER_OK) {
+            printf("Failed to create signal: %s\n", QCC_StatusText(status));
+            delete bus;
+            AllJoynShutdown();
+            return 1;
+        }
+        msgs.push_back(Message::cast(sm));
+    }
+
+    /* Both lookups must produce the same set of endpoints */
+    size_t totalMatches = 0;
+    for (vector<Message>::iterator it = msgs.begin(); it != msgs.end(); ++it) {
+        set<BusEndpoint> scanned;
+        set<BusEndpoint> indexed;
+        ScanEndpoints(ruleTable, eps, *it, scanned);
+        ruleTable.GetMatchingEndpoints(*it, indexed);
+        if (scanned != indexed) {
+            printf("FAILED: indexed lookup found %u endpoints, scan found %u for %s\n",
+                   (unsigned int)indexed.size(), (unsigned int)scanned.size(), (*it)->GetMemberName());
+            delete bus;
+            AllJoynShutdown();
+            return 1;
+        }
+        totalMatches += indexed.size();
+    }
+
+    printf("%u endpoints, %u rules per endpoint, %u messages, %u matches per message on average\n",
+           numEps, rulesPerEp, (unsigned int)msgs.size(), (unsigned int)(totalMatches / msgs.size()));
+
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        set<BusEndpoint> matches;
+        ScanEndpoints(ruleTable, eps, msgs[i % msgs.size()], matches);
+    }
+    uint64_t scanTime = GetTimestamp64() - start;
+
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        set<BusEndpoint> matches;
+        ruleTable.GetMatchingEndpoints(msgs[i % msgs.size()], matches);
+    }
+    uint64_t indexTime = GetTimestamp64() - start;
+
+    printf("scan:    %llu ms for %u messages (%.2f us/msg)\n",
+           (unsigned long long)scanTime, iterations, (scanTime * 1000.0) / iterations);
+    printf("indexed: %llu ms for %u messages (%.2f us/msg)\n",
+           (unsigned long long)indexTime, iterations, (indexTime * 1000.0) / iterations);
+
+    msgs.clear();
+    for (vector<BusEndpoint>::iterator it = eps.begin(); it != eps.end(); ++it) {
+        ruleTable.RemoveAllRules(*it);
+    }
+    eps.clear();
+
+    delete bus;
+    AllJoynShutdown();
+    return 0;
+}
@@ -500,6 +500,47 @@ QStatus RecvSG(SocketFd sockfd, ScatterGatherList& sg, size_t& received);
  */
 QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
                    ScatterGatherList& sg, size_t& received);
+
+/**
+ * A single datagram sent or received by SendToBatch() and RecvFromBatch().
+ */
+struct Datagram {
+    IPAddress addr;     ///< IP Address of remote host.
+    uint16_t port;      ///< IP Port on remote host.
+    void* buf;          ///< Buffer holding the datagram.
+    size_t len;         ///< Octets to send from buf, or the size of buf when receiving.
+    size_t received;    ///< Octets received into buf.
+};
+
+/**
+ * Send a number of datagrams on a socket with as few system calls as the
+ * platform allows.  The datagrams are sent in order; if an error occurs after
+ * some of them have gone out the call succeeds and reports how many were sent.
+ *
+ * @param sockfd        Socket descriptor.
+ * @param dgrams        The datagrams to send.
+ * @param count         Number of entries in dgrams.
+ * @param sent          OUT: Number of datagrams sent.
+ * @param flags         SendMsgFlags to underlying sockets call (see sendmsg() in sockets API)
+ *
+ * @return  Indication of success of failure.
+ */
+QStatus SendToBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& sent, SendMsgFlags flags = QCC_MSG_NONE);
+
+/**
+ * Receive up to count datagrams from a socket with as few system calls as the
+ * platform allows.  This only returns the datagrams that are already queued
+ * on the socket so it is intended for use with non-blocking sockets.
+ *
+ * @param sockfd        Socket descriptor.
+ * @param dgrams        Buffers for the datagrams, the addr, port and received
+ *                      fields are filled in for each datagram received.
+ * @param count         Number of entries in dgrams.
+ * @param received      OUT: Number of datagrams received.
+ *
+ * @return  Indication of success of failure.
+ */
+QStatus RecvFromBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& received);
 }
 
 #undef QCC_MODULE
@@ -216,4 +216,38 @@ QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
     return status;
 }
 
+/*
+ * Windows has no equivalent to sendmmsg()/recvmmsg() so the batch is handled
+ * one datagram at a time.
+ */
+QStatus SendToBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& sent, SendMsgFlags flags)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("SendToBatch(sockfd = %d, dgrams, count = %u, sent = <>, flags = 0x%x)", sockfd, count, (int) flags));
+
+    for (sent = 0; sent < count; ++sent) {
+        size_t octets;
+        status = SendTo(sockfd, dgrams[sent].addr, dgrams[sent].port, dgrams[sent].buf, dgrams[sent].len, octets, flags);
+        if (status != ER_OK) {
+            break;
+        }
+    }
+    return (sent > 0) ? ER_OK : status;
+}
+
+QStatus RecvFromBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& received)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("RecvFromBatch(sockfd = %d, dgrams, count = %u, received = <>)", sockfd, count));
+
+    for (received = 0; received < count; ++received) {
+        status = RecvFrom(sockfd, dgrams[received].addr, dgrams[received].port,
+                          dgrams[received].buf, dgrams[received].len, dgrams[received].received);
+        if (status != ER_OK) {
+            break;
+        }
+    }
+    return (received > 0) ? ER_OK : status;
+}
+
 }
@@ -31,6 +31,7 @@
 #include <qcc/StringUtil.h>
 #include <qcc/StringSink.h>
 #include <qcc/StringSource.h>
+#include <qcc/time.h>
 
 #include <alljoyn/InterfaceDescription.h>
 #include <alljoyn/AllJoynStd.h>
@@ -181,7 +182,7 @@ static void SetRights(PeerState& peerState, bool mutual, bool challenger)
 AllJoynPeerObj::AllJoynPeerObj(BusAttachment& bus) :
     BusObject(org::alljoyn::Bus::Peer::ObjectPath, false),
     AlarmListener(),
-    dispatcher("PeerObjDispatcher", true, 3), supportedAuthSuitesCount(0), supportedAuthSuites(NULL), securityApplicationObj(bus)
+    dispatcher("PeerObjDispatcher", true, 3), supportedAuthSuitesCount(0), supportedAuthSuites(NULL), securityApplicationObj(bus), sessionResumption(true)
 {
     /* Add org.alljoyn.Bus.Peer.Authentication interface */
     {
@@ -194,6 +195,7 @@ AllJoynPeerObj::AllJoynPeerObj(BusAttachment& bus) :
             AddMethodHandler(ifc->GetMember("KeyExchange"), static_cast<MessageReceiver::MethodHandler>(&AllJoynPeerObj::KeyExchange));
             AddMethodHandler(ifc->GetMember("KeyAuthentication"), static_cast<MessageReceiver::MethodHandler>(&AllJoynPeerObj::KeyAuthentication));
             AddMethodHandler(ifc->GetMember("GenSessionKey"), static_cast<MessageReceiver::MethodHandler>(&AllJoynPeerObj::GenSessionKey));
+            AddMethodHandler(ifc->GetMember("ResumeSession"), static_cast<MessageReceiver::MethodHandler>(&AllJoynPeerObj::ResumeSession));
             AddMethodHandler(ifc->GetMember("ExchangeGroupKeys"), static_cast<MessageReceiver::MethodHandler>(&AllJoynPeerObj::ExchangeGroupKeys));
             AddMethodHandler(ifc->GetMember("SendManifest"), static_cast<MessageReceiver::MethodHandler>(&AllJoynPeerObj::HandleSendManifest));
             AddMethodHandler(ifc->GetMember("SendMemberships"), static_cast<MessageReceiver::MethodHandler>(&AllJoynPeerObj::SendMemberships));
@@ -462,9 +464,10 @@ QStatus AllJoynPeerObj::KeyGen(PeerState& peerState, String seed, qcc::String& v
         delete [] keymatter;
     }
     /*
-     * Store any changes to the key store.
+     * Store any changes to the key store in the background so concurrent authentications are
+     * written together.
      */
-    keyStore.Store();
+    keyStore.ScheduleStore();
     return status;
 }
 
@@ -523,6 +526,105 @@ void AllJoynPeerObj::GenSessionKey(const InterfaceDescription::Member* member, M
     peerState->ReleaseConversationHashLock();
 }
 
+void AllJoynPeerObj::ResumeSession(const InterfaceDescription::Member* member, Message& msg)
+{
+    QCC_UNUSED(member);
+    assert(bus);
+
+    QStatus status = ER_OK;
+    qcc::GUID128 remotePeerGuid(msg->GetArg(0)->v_string.str);
+    uint32_t authVersion = msg->GetArg(1)->v_uint32;
+    qcc::GUID128 localPeerGuid(msg->GetArg(2)->v_string.str);
+    qcc::String localGuidStr = bus->GetInternal().GetKeyStore().GetGuid();
+    if (!sessionResumption) {
+        /*
+         * Reply the way a peer that does not implement ResumeSession does.
+         */
+        status = ER_BUS_OBJECT_NO_SUCH_MEMBER;
+    } else if (localGuidStr.empty() || (localGuidStr != localPeerGuid.ToString())) {
+        /*
+         * Target GUID is not our GUID.
+         */
+        status = ER_BUS_NO_PEER_GUID;
+    } else if (!IsCompatibleVersion(authVersion)) {
+        /*
+         * Unlike ExchangeGuids we cannot counter-propose a version here, the initiator will fall
+         * back to ExchangeGuids.
+         */
+        status = ER_BUS_PEER_AUTH_VERSION_MISMATCH;
+    }
+    if (status == ER_OK) {
+        PeerState peerState = bus->GetInternal().GetPeerStateTable()->GetPeerState(msg->GetSender());
+        qcc::String nonce = RandHexString(NONCE_LEN);
+        qcc::String verifier;
+        /*
+         * Like GenSessionKey this replaces the session key even if the peer is already secure,
+         * that is how the initiator re-keys a live connection.
+         */
+        peerState->AcquireConversationHashLock();
+        authVersion = GetLowerVersion(authVersion, PREFERRED_AUTH_VERSION);
+        peerState->SetGuidAndAuthVersion(remotePeerGuid, authVersion);
+        status = KeyGen(peerState, msg->GetArg(3)->v_string.str + nonce, verifier, KeyBlob::RESPONDER);
+        if ((status == ER_OK) && peerState->IsConversationHashInitialized()) {
+            /*
+             * There is no authentication conversation so discard any stale conversation hash.
+             */
+            peerState->FreeConversationHash();
+        }
+        peerState->ReleaseConversationHashLock();
+        if (status == ER_OK) {
+            QCC_DbgHLPrintf(("ResumeSession succeeds for peer %s", msg->GetSender()));
+            MsgArg replyArgs[4];
+            replyArgs[0].Set("s", localGuidStr.c_str());
+            replyArgs[1].Set("u", authVersion);
+            replyArgs[2].Set("s", nonce.c_str());
+            replyArgs[3].Set("s", verifier.c_str());
+            MethodReply(msg, replyArgs, ArraySize(replyArgs));
+        }
+    }
+    if (status != ER_OK) {
+        QCC_DbgHLPrintf(("ResumeSession rejected for peer %s: %s", msg->GetSender(), QCC_StatusText(status)));
+        MethodReply(msg, status);
+    }
+}
+
+/*
+ * Upper bound on the number of bus names we remember for session resumption.
+ */
+#define MAX_RESUMABLE_PEERS 64
+
+void AllJoynPeerObj::EnableSessionResumption(bool enable)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    sessionResumption = enable;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+bool AllJoynPeerObj::GetResumableGuid(const qcc::String& busName, qcc::GUID128& guid)
+{
+    assert(bus);
+    lock.Lock(MUTEX_CONTEXT);
+    std::map<qcc::String, qcc::GUID128>::iterator it = resumableGuids.find(busName);
+    bool found = sessionResumption && (it != resumableGuids.end());
+    if (found) {
+        guid = it->second;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    if (found) {
+        KeyStore& keyStore = bus->GetInternal().GetKeyStore();
+        KeyStore::Key key(KeyStore::Key::REMOTE, guid);
+        found = keyStore.HasKey(key);
+    }
+    return found;
+}
+
+void AllJoynPeerObj::GetAuthStats(AuthStats& stats)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    stats = authStats;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
 void AllJoynPeerObj::AuthAdvance(Message& msg)
 {
     assert(bus);
@@ -985,20 +1087,56 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
     ProxyBusObject remotePeerObj(*bus, busName.c_str(), org::alljoyn::Bus::Peer::ObjectPath, 0);
     remotePeerObj.AddInterface(*ifc);
 
+    uint64_t authStart = GetTimestamp64();
+    uint32_t roundTrips = 0;
+    qcc::String localGuidStr = bus->GetInternal().GetKeyStore().GetGuid();
+    Message callMsg(*bus);
+    Message replyMsg(*bus);
+    /*
+     * If we have authenticated this peer before and still hold the master secret try to resume
+     * the session. ResumeSession does the work of ExchangeGuids and GenSessionKey in a single
+     * round trip. If the remote peer does not implement it or no longer has the master secret we
+     * fall back to the full exchange below.
+     */
+    qcc::GUID128 resumeGuid;
+    qcc::String resumeNonce;
+    bool resumed = false;
+    if (((msgType == MESSAGE_METHOD_CALL) || (msgType == MESSAGE_ERROR)) && GetResumableGuid(busName, resumeGuid)) {
+        resumeNonce = RandHexString(NONCE_LEN);
+        qcc::String resumeGuidStr = resumeGuid.ToString();
+        MsgArg resumeArgs[4];
+        resumeArgs[0].Set("s", localGuidStr.c_str());
+        resumeArgs[1].Set("u", PREFERRED_AUTH_VERSION);
+        resumeArgs[2].Set("s", resumeGuidStr.c_str());
+        resumeArgs[3].Set("s", resumeNonce.c_str());
+        const InterfaceDescription::Member* resumeSessionMember = ifc->GetMember("ResumeSession");
+        assert(resumeSessionMember);
+        ++roundTrips;
+        status = remotePeerObj.MethodCall(*resumeSessionMember, resumeArgs, ArraySize(resumeArgs), replyMsg, DEFAULT_TIMEOUT);
+        if (status == ER_OK) {
+            resumed = true;
+        } else {
+            QCC_DbgHLPrintf(("ResumeSession with %s failed: %s", busName.c_str(), QCC_StatusText(status)));
+            lock.Lock(MUTEX_CONTEXT);
+            resumableGuids.erase(busName);
+            lock.Unlock(MUTEX_CONTEXT);
+            status = ER_OK;
+        }
+    }
     /*
      * Exchange GUIDs with the peer, this will get us the GUID of the remote peer and also the
      * unique bus name from which we can determine if we have already have a session key, a
      * master secret or if we have to start an authentication conversation.
      */
-    qcc::String localGuidStr = bus->GetInternal().GetKeyStore().GetGuid();
-    MsgArg args[2];
-    args[0].Set("s", localGuidStr.c_str());
-    args[1].Set("u", PREFERRED_AUTH_VERSION);
-    Message callMsg(*bus);
-    Message replyMsg(*bus);
-    const InterfaceDescription::Member* exchangeGuidsMember = ifc->GetMember("ExchangeGuids");
-    assert(exchangeGuidsMember);
-    status = remotePeerObj.MethodCall(*exchangeGuidsMember, args, ArraySize(args), replyMsg, DEFAULT_TIMEOUT, 0, &callMsg);
+    if (!resumed) {
+        MsgArg args[2];
+        args[0].Set("s", localGuidStr.c_str());
+        args[1].Set("u", PREFERRED_AUTH_VERSION);
+        const InterfaceDescription::Member* exchangeGuidsMember = ifc->GetMember("ExchangeGuids");
+        assert(exchangeGuidsMember);
+        ++roundTrips;
+        status = remotePeerObj.MethodCall(*exchangeGuidsMember, args, ArraySize(args), replyMsg, DEFAULT_TIMEOUT, 0, &callMsg);
+    }
     if (status != ER_OK) {
         /*
          * ER_BUS_REPLY_IS_ERROR_MESSAGE has a specific meaning in the public API and should not be
@@ -1042,9 +1180,10 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
     peerState = peerStateTable->GetPeerState(sender, busName);
     peerState->SetGuidAndAuthVersion(remotePeerGuid, authVersion);
     /*
-     * We can now return if the peer is authenticated.
+     * We can now return if the peer is authenticated. If the remote peer accepted ResumeSession it
+     * has already switched to a new session key so we must derive the matching key.
      */
-    if (peerState->IsSecure()) {
+    if (peerState->IsSecure() && !resumed) {
         return ER_OK;
     }
     /*
@@ -1102,6 +1241,7 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
      */
     qcc::Event authEvent;
     peerState->SetAuthEvent(&authEvent);
+    peerState->authRoundTrips = roundTrips;
     lock.Unlock(MUTEX_CONTEXT);
 
     KeyStore& keyStore = bus->GetInternal().GetKeyStore();
@@ -1134,7 +1274,20 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
                 status = ER_AUTH_FAIL;
             }
         }
-        if (status == ER_OK) {
+        if ((status == ER_OK) && resumed && firstPass) {
+            qcc::String verifier;
+            /*
+             * The ResumeSession reply already carries the remote half of the seed string.
+             */
+            status = KeyGen(peerState, resumeNonce + replyMsg->GetArg(2)->v_string.str, verifier, KeyBlob::INITIATOR);
+            QCC_DbgHLPrintf(("Initiator KeyGen after resuming session with %s", busName.c_str()));
+            if ((status == ER_OK) && (verifier != replyMsg->GetArg(3)->v_string.str)) {
+                status = ER_AUTH_FAIL;
+            }
+            if (status != ER_OK) {
+                resumed = false;
+            }
+        } else if (status == ER_OK) {
             /*
              * Generate a random string - this is the local half of the seed string.
              */
@@ -1150,6 +1303,7 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
             const InterfaceDescription::Member* genSessionKeyMember = ifc->GetMember("GenSessionKey");
             assert(genSessionKeyMember);
             peerState->AcquireConversationHashLock();
+            peerState->authRoundTrips++;
             status = remotePeerObj.MethodCall(*genSessionKeyMember, msgArgs, ArraySize(msgArgs), replyMsg, DEFAULT_TIMEOUT, 0, &callMsg);
             peerState->UpdateHash(CONVERSATION_V4, callMsg);
             peerState->UpdateHash(CONVERSATION_V4, replyMsg);
@@ -1217,6 +1371,7 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
         }
         const InterfaceDescription::Member* exchangeGroupKeysMember = ifc->GetMember("ExchangeGroupKeys");
         assert(exchangeGroupKeysMember);
+        peerState->authRoundTrips++;
         status = remotePeerObj.MethodCall(*exchangeGroupKeysMember, &arg, 1, keyExchangeReplyMsg, DEFAULT_TIMEOUT, ALLJOYN_FLAG_ENCRYPTED);
         if (status == ER_OK) {
             if (sendKeyBlob) {
@@ -1250,7 +1405,7 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
                     }
                     if (sendManifest) {
                         SendManifest(remotePeerObj, ifc, peerState);
-                        SendMembershipData(remotePeerObj, ifc, remotePeerGuid);
+                        SendMembershipData(remotePeerObj, ifc, peerState);
                     }
                 }
             }
@@ -1262,6 +1417,9 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
     if (authTried) {
         peerAuthListener.AuthenticationComplete(mech.c_str(), sender.c_str(), status == ER_OK);
     }
+    uint64_t authLatency = GetTimestamp64() - authStart;
+    QCC_DbgHLPrintf(("Authentication with %s %s in %u ms, %u round trips%s", busName.c_str(), (status == ER_OK) ? "succeeded" : "failed",
+                     static_cast<uint32_t>(authLatency), peerState->authRoundTrips, resumed ? " (resumed)" : ""));
     /*
      * ER_BUS_REPLY_IS_ERROR_MESSAGE has a specific meaning in the public API an should not be
      * propogated to the caller from this context.
@@ -1273,6 +1431,22 @@ QStatus AllJoynPeerObj::AuthenticatePeer(AllJoynMessageType msgType, const qcc::
      * Release any other threads waiting on the result of this authentication.
      */
     lock.Lock(MUTEX_CONTEXT);
+    if (status == ER_OK) {
+        /*
+         * Remember the remote GUID under both names so the next authentication can be resumed.
+         */
+        if ((resumableGuids.size() >= MAX_RESUMABLE_PEERS) && (resumableGuids.find(busName) == resumableGuids.end())) {
+            resumableGuids.clear();
+        }
+        resumableGuids[busName] = remotePeerGuid;
+        resumableGuids[sender] = remotePeerGuid;
+        authStats.authentications++;
+        if (resumed) {
+            authStats.resumptions++;
+        }
+        authStats.roundTrips += peerState->authRoundTrips;
+        authStats.latency += authLatency;
+    }
     peerState->SetAuthEvent(NULL);
     while (authEvent.GetNumBlockedThreads() > 0) {
         authEvent.SetEvent();
@@ -1304,6 +1478,7 @@ QStatus AllJoynPeerObj::AuthenticatePeerUsingSASL(const qcc::String& busName, Pe
         MsgArg arg("s", outStr.c_str());
         const InterfaceDescription::Member* authChallengeMember = ifc->GetMember("AuthChallenge");
         assert(authChallengeMember);
+        peerState->authRoundTrips++;
         status = remotePeerObj.MethodCall(*authChallengeMember, &arg, 1, replyMsg, AUTH_TIMEOUT);
         if (status == ER_OK) {
             /*
@@ -1367,6 +1542,7 @@ QStatus AllJoynPeerObj::AskForAuthSuites(uint32_t peerAuthVersion, ProxyBusObjec
     const InterfaceDescription::Member* exchangeSuites = ifc->GetMember("ExchangeSuites");
     assert(exchangeSuites);
 
+    peerState->authRoundTrips++;
     QStatus status = remotePeerObj.MethodCall(*exchangeSuites, &arg, 1, replyMsg, DEFAULT_TIMEOUT, 0, &callMsg);
     if (excludeECDHE_ECDSA) {
         delete [] authSuites;
@@ -1421,6 +1597,7 @@ QStatus AllJoynPeerObj::AuthenticatePeerUsingKeyExchange(const uint32_t* request
     } else if (status == ER_OK) {
         status = ER_AUTH_FAIL; /* remote auth mask is 0 */
     }
+    peerState->authRoundTrips += kxCB.GetRoundTrips();
 
     if (status == ER_OK) {
         return status;
@@ -1653,6 +1830,13 @@ void AllJoynPeerObj::NameOwnerChanged(const char* busName, const char* previousO
         delete conversations[busName];
         conversations.erase(busName);
         keyExConversations.erase(busName);
+        /*
+         * Unique names are never reused so a peer that reconnects can only be resumed through a
+         * well-known name. Keep those.
+         */
+        if (busName[0] == ':') {
+            resumableGuids.erase(busName);
+        }
         lock.Unlock(MUTEX_CONTEXT);
     }
 }
@@ -1769,6 +1953,7 @@ QStatus KeyExchangerCB::SendKeyExchange(MsgArg* args, size_t numArgs, Message* s
 {
     const InterfaceDescription::Member* keyExchange = ifc->GetMember("KeyExchange");
     assert(keyExchange);
+    ++roundTrips;
     return remoteObj.MethodCall(*keyExchange, args, numArgs, *replyMsg, timeout, 0, sentMsg);
 }
 
@@ -1776,6 +1961,7 @@ QStatus KeyExchangerCB::SendKeyAuthentication(MsgArg* msg, Message* sentMsg, Mes
 {
     const InterfaceDescription::Member* keyAuth = ifc->GetMember("KeyAuthentication");
     assert(keyAuth);
+    ++roundTrips;
     return remoteObj.MethodCall(*keyAuth, msg, 1, *replyMsg, timeout, 0, sentMsg);
 }
 
@@ -1902,6 +2088,7 @@ QStatus AllJoynPeerObj::SendManifest(ProxyBusObject& remotePeerObj, const Interf
     PermissionPolicy::GenerateRules(manifest, count, rulesArg);
     Message replyMsg(*bus);
     const InterfaceDescription::Member* sendManifest = ifc->GetMember("SendManifest");
+    peerState->authRoundTrips++;
     status = remotePeerObj.MethodCall(*sendManifest, &rulesArg, 1, replyMsg, DEFAULT_TIMEOUT);
 
     delete [] manifest;
@@ -2000,10 +2187,10 @@ Exit:
     return status;
 }
 
-QStatus AllJoynPeerObj::SendMembershipData(ProxyBusObject& remotePeerObj, const InterfaceDescription* ifc, const qcc::GUID128& remotePeerGuid)
+QStatus AllJoynPeerObj::SendMembershipData(ProxyBusObject& remotePeerObj, const InterfaceDescription* ifc, PeerState& peerState)
 {
     std::vector<std::vector<MsgArg*> > args;
-    QStatus status = securityApplicationObj.GenerateSendMemberships(args, remotePeerGuid);
+    QStatus status = securityApplicationObj.GenerateSendMemberships(args, peerState->GetGuid());
     if (ER_OK != status) {
         return status;
     }
@@ -2026,6 +2213,7 @@ QStatus AllJoynPeerObj::SendMembershipData(ProxyBusObject& remotePeerObj, const
         if (ER_OK != status) {
             goto Exit;
         }
+        peerState->authRoundTrips++;
         status = remotePeerObj.MethodCall(*sendMembershipData, inputs, 2, replyMsg, DEFAULT_TIMEOUT);
         if (ER_OK != status) {
             goto Exit;
@@ -237,6 +237,33 @@ class AllJoynPeerObj : public BusObject, public BusListener, public qcc::AlarmLi
      */
     QStatus HandleMethodReply(Message& msg, Message& sentMsg, const MsgArg* args = NULL, size_t numArgs = 0);
 
+    /**
+     * Aggregate statistics for peer authentications initiated by this peer object.
+     */
+    struct AuthStats {
+        uint32_t authentications;   /**< Number of successful authentications */
+        uint32_t resumptions;       /**< Number of those that resumed from a cached master secret */
+        uint64_t roundTrips;        /**< Total method call round trips spent authenticating */
+        uint64_t latency;           /**< Total authentication latency in milliseconds */
+        AuthStats() : authentications(0), resumptions(0), roundTrips(0), latency(0) { }
+    };
+
+    /**
+     * Enable or disable session resumption. When disabled this peer neither tries to resume
+     * sessions nor accepts ResumeSession calls, it behaves like a peer that predates ResumeSession.
+     * Session resumption is enabled by default.
+     *
+     * @param enable  true to enable session resumption, false to disable it.
+     */
+    void EnableSessionResumption(bool enable);
+
+    /**
+     * Get the authentication statistics collected so far.
+     *
+     * @param[out] stats  Returns the authentication statistics.
+     */
+    void GetAuthStats(AuthStats& stats);
+
     /**
      * Destructor
      */
@@ -281,6 +308,27 @@ class AllJoynPeerObj : public BusObject, public BusListener, public qcc::AlarmLi
      */
     void GenSessionKey(const InterfaceDescription::Member* member, Message& msg);
 
+    /**
+     * ResumeSession method call handler. Combines ExchangeGuids and GenSessionKey
+     * so a peer that already holds a master secret can derive a session key in a
+     * single round trip.
+     *
+     * @param member  The member that was called
+     * @param msg     The method call message
+     */
+    void ResumeSession(const InterfaceDescription::Member* member, Message& msg);
+
+    /**
+     * Look up the GUID of a remote peer we have previously authenticated under a bus name and
+     * for which we still hold a master secret.
+     *
+     * @param busName  The bus name of the remote peer
+     * @param[out] guid Returns the GUID of the remote peer
+     *
+     * @return true if a session with the remote peer can be resumed.
+     */
+    bool GetResumableGuid(const qcc::String& busName, qcc::GUID128& guid);
+
     /**
      * ExchangeGroupKeys method call handler
      *
@@ -452,9 +500,9 @@ class AllJoynPeerObj : public BusObject, public BusListener, public qcc::AlarmLi
      * Send an SendMembership to the peer
      * @param remotePeerObj  The remote peer
      * @param ifc     The interface object
-     * @param remotePeerGuid The remote peer's authentication GUID
+     * @param peerState the peer state object
      */
-    QStatus SendMembershipData(ProxyBusObject& remotePeerObj, const InterfaceDescription* ifc, const qcc::GUID128& remotePeerGuid);
+    QStatus SendMembershipData(ProxyBusObject& remotePeerObj, const InterfaceDescription* ifc, PeerState& peerState);
 
     /**
      * SendMembership method call handler
@@ -508,6 +556,20 @@ class AllJoynPeerObj : public BusObject, public BusListener, public qcc::AlarmLi
 
     /* PermissionMgmtObj to handle message permssion */
     SecurityApplicationObj securityApplicationObj;
+
+    /** true if sessions may be resumed */
+    bool sessionResumption;
+
+    /**
+     * GUIDs of remote peers we have authenticated keyed by bus name. Used to
+     * attempt session resumption without a preceding ExchangeGuids. Unique
+     * names are removed when the peer goes away so only a peer addressed by a
+     * well-known name can be resumed after it reconnects.
+     */
+    std::map<qcc::String, qcc::GUID128> resumableGuids;
+
+    /** Authentication statistics, protected by lock */
+    AuthStats authStats;
 };
 
 
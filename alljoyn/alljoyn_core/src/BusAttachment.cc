@@ -768,6 +768,11 @@ QStatus BusAttachment::StopInternal(bool blockUntilStopped)
     QStatus status = ER_OK;
     if (isStarted) {
         isStopping = true;
+        /*
+         * A scheduled store of the key store must not run once the application starts tearing
+         * down its key store listener. The changes are stored when the bus is joined.
+         */
+        busInternal->keyStore.CancelScheduledStore();
         /*
          * Let bus listeners know the bus is stopping.
          */
@@ -840,7 +845,8 @@ void BusAttachment::WaitStopInternal()
             /* Clear peer state */
             busInternal->peerStateTable.Clear();
 
-            /* Persist keystore */
+            /* Persist keystore, including a scheduled store, while the key store listener is still registered */
+            busInternal->keyStore.FlushScheduledStore();
             busInternal->keyStore.Store();
 
             isStarted = false;
@@ -965,6 +971,14 @@ QStatus BusAttachment::RegisterSignalHandlerWithRule(MessageReceiver* receiver,
     return busInternal->RegisterSignalHandler(receiver, signalHandler, member, matchRule);
 }
 
+QStatus BusAttachment::RegisterCursorSignalHandler(MessageReceiver* receiver,
+                                                   MessageReceiver::SignalHandler signalHandler,
+                                                   const InterfaceDescription::Member* member,
+                                                   const char* matchRule)
+{
+    return busInternal->RegisterCursorSignalHandler(receiver, signalHandler, member, matchRule);
+}
+
 QStatus BusAttachment::RegisterSignalHandler(MessageReceiver* receiver,
                                              MessageReceiver::SignalHandler signalHandler,
                                              const InterfaceDescription::Member* member,
@@ -3355,6 +3369,7 @@ bool KeyStoreKeyEventListener::NotifyAutoDelete(KeyStore* holder, const KeyStore
 void BusAttachment::SetDescriptionTranslator(Translator* newTranslator)
 {
     this->translator = newTranslator;
+    IncrementAndFetch(&InterfaceDescription::translatorGeneration);
 }
 
 Translator* BusAttachment::GetDescriptionTranslator()
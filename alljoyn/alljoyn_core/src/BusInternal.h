@@ -471,6 +471,14 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
         return localEndpoint->RegisterSignalHandler(receiver, signalHandler, member, matchRule);
     }
 
+    /** Register a signal handler that reads the arguments with a MessageCursor */
+    QStatus RegisterCursorSignalHandler(MessageReceiver* receiver,
+                                        MessageReceiver::SignalHandler signalHandler,
+                                        const InterfaceDescription::Member* member,
+                                        const char* matchRule) {
+        return localEndpoint->RegisterSignalHandler(receiver, signalHandler, member, matchRule, true);
+    }
+
     /** @copydoc _LocalEndpoint::UnregisterSignalHandler() */
     virtual QStatus UnregisterSignalHandler(MessageReceiver* receiver,
                                             MessageReceiver::SignalHandler signalHandler,
@@ -32,6 +32,7 @@
 #include <qcc/Debug.h>
 #include <qcc/Util.h>
 #include <qcc/String.h>
+#include <qcc/StringUtil.h>
 #include <qcc/Mutex.h>
 #include <qcc/XmlElement.h>
 #include <alljoyn/DBusStd.h>
@@ -60,6 +61,7 @@ typedef struct {
     const InterfaceDescription::Member* member;   /**< Pointer to method's member */
     MessageReceiver::MethodHandler handler;       /**< Method implementation */
     void* context;
+    bool cursor;                                  /**< Handler reads the arguments with a MessageCursor */
 } MethodContext;
 #pragma pack(pop, MethodContext)
 
@@ -70,7 +72,15 @@ static bool operator==(const MethodContext& a, const MethodContext& b)
            (a.context == b.context);
 }
 
+/*
+ * Limit on the number of cached introspection documents per object. The language tag comes from
+ * the caller so the cache is emptied when the limit is reached rather than growing without bound.
+ */
+static const size_t MaxCachedIntrospections = 16;
+
 struct BusObject::Components {
+    Components() : introspectionTranslatorGeneration(0), introspectionGeneration(0) { }
+
     /** The interfaces this object implements */
     vector<pair<const InterfaceDescription*, bool> > ifaces;
     /** The method handlers for this object */
@@ -83,6 +93,15 @@ struct BusObject::Components {
 
     /** counter to prevent this BusObject being deleted if it is being used by another thread. */
     volatile int32_t inUseCounter;
+
+    /** Generated introspection XML keyed by depth, indent and language tag */
+    map<qcc::String, qcc::String> introspectionCache;
+    /** The translator generation the cached introspection XML was generated with */
+    int32_t introspectionTranslatorGeneration;
+    /** Incremented when the cache is invalidated so XML generated concurrently is not cached */
+    uint32_t introspectionGeneration;
+    /** lock to protect the introspection cache */
+    qcc::Mutex introspectionLock;
 };
 
 /**
@@ -192,6 +211,31 @@ qcc::String BusObject::GenerateIntrospection(bool deep, size_t indent) const
 
 qcc::String BusObject::GenerateIntrospection(const char* requestedLanguageTag, bool deep, size_t indent) const
 {
+    /*
+     * The cache key distinguishes a NULL language tag, which omits descriptions, from an empty one
+     */
+    qcc::String key = qcc::String(deep ? "d" : "s") + U32ToString((uint32_t)indent);
+    if (requestedLanguageTag) {
+        key += qcc::String(":") + requestedLanguageTag;
+    }
+    Translator* busTranslator = bus ? bus->GetDescriptionTranslator() : NULL;
+    /* Setting any description translator changes the XML of objects that use it */
+    int32_t translatorGeneration = InterfaceDescription::translatorGeneration;
+    components->introspectionLock.Lock(MUTEX_CONTEXT);
+    if (components->introspectionTranslatorGeneration != translatorGeneration) {
+        components->introspectionCache.clear();
+        components->introspectionTranslatorGeneration = translatorGeneration;
+        ++components->introspectionGeneration;
+    }
+    map<qcc::String, qcc::String>::const_iterator cached = components->introspectionCache.find(key);
+    if (cached != components->introspectionCache.end()) {
+        qcc::String cachedXml = cached->second;
+        components->introspectionLock.Unlock(MUTEX_CONTEXT);
+        return cachedXml;
+    }
+    uint32_t generation = components->introspectionGeneration;
+    components->introspectionLock.Unlock(MUTEX_CONTEXT);
+
     qcc::String in(indent, ' ');
     qcc::String xml;
     qcc::String buffer;
@@ -236,14 +280,33 @@ qcc::String BusObject::GenerateIntrospection(const char* requestedLanguageTag, b
                 (strcmp((itIf->first)->GetName(), org::freedesktop::DBus::Properties::InterfaceName) == 0)) {
                 ++itIf;
             } else {
-                xml += (itIf->first)->Introspect(indent, requestedLanguageTag, bus ? bus->GetDescriptionTranslator() : NULL);
+                xml += (itIf->first)->Introspect(indent, requestedLanguageTag, busTranslator);
                 ++itIf;
             }
         }
     }
+
+    components->introspectionLock.Lock(MUTEX_CONTEXT);
+    if (generation == components->introspectionGeneration) {
+        if (components->introspectionCache.size() >= MaxCachedIntrospections) {
+            components->introspectionCache.clear();
+        }
+        components->introspectionCache[key] = xml;
+    }
+    components->introspectionLock.Unlock(MUTEX_CONTEXT);
     return xml;
 }
 
+void BusObject::InvalidateIntrospection()
+{
+    for (BusObject* obj = this; obj; obj = obj->parent) {
+        obj->components->introspectionLock.Lock(MUTEX_CONTEXT);
+        obj->components->introspectionCache.clear();
+        ++obj->components->introspectionGeneration;
+        obj->components->introspectionLock.Unlock(MUTEX_CONTEXT);
+    }
+}
+
 void BusObject::GetProp(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
@@ -552,6 +615,16 @@ void BusObject::Introspect(const InterfaceDescription::Member* member, Message&
 }
 
 QStatus BusObject::AddMethodHandler(const InterfaceDescription::Member* member, MessageReceiver::MethodHandler handler, void* handlerContext)
+{
+    return AddMethodContext(member, handler, handlerContext, false);
+}
+
+QStatus BusObject::AddCursorMethodHandler(const InterfaceDescription::Member* member, MessageReceiver::MethodHandler handler, void* handlerContext)
+{
+    return AddMethodContext(member, handler, handlerContext, true);
+}
+
+QStatus BusObject::AddMethodContext(const InterfaceDescription::Member* member, MessageReceiver::MethodHandler handler, void* handlerContext, bool cursor)
 {
     if (!member) {
         return ER_BAD_ARG_1;
@@ -564,7 +637,7 @@ QStatus BusObject::AddMethodHandler(const InterfaceDescription::Member* member,
         status = ER_BUS_CANNOT_ADD_HANDLER;
         QCC_LogError(status, ("Cannot add method handler to an object that is already registered"));
     } else if (ImplementsInterface(member->iface->GetName())) {
-        MethodContext ctx = { member, handler, handlerContext };
+        MethodContext ctx = { member, handler, handlerContext, cursor };
         if (find(components->methodContexts.begin(), components->methodContexts.end(), ctx) == components->methodContexts.end()) {
             components->methodContexts.push_back(ctx);
         }
@@ -596,7 +669,7 @@ void BusObject::InstallMethods(MethodTable& methodTable)
     vector<MethodContext>::iterator iter;
     for (iter = components->methodContexts.begin(); iter != components->methodContexts.end(); iter++) {
         const MethodContext methodContext = *iter;
-        methodTable.Add(this, methodContext.handler, methodContext.member, methodContext.context);
+        methodTable.Add(this, methodContext.handler, methodContext.member, methodContext.context, methodContext.cursor);
     }
 }
 
@@ -641,6 +714,7 @@ QStatus BusObject::AddInterface(const InterfaceDescription& iface, AnnounceFlag
 
     /* Add the new interface */
     components->ifaces.push_back(make_pair(&iface, isAnnounced));
+    InvalidateIntrospection();
 
 ExitAddInterface:
 
@@ -669,6 +743,7 @@ QStatus BusObject::DoRegistration(BusAttachment& busAttachment)
     if (find(components->ifaces.begin(), components->ifaces.end(), comp) == components->ifaces.end()) {
         components->ifaces.push_back(comp);
     }
+    InvalidateIntrospection();
 
     /* Add the standard method handlers */
     const MethodEntry methodEntries[] = {
@@ -1000,6 +1075,7 @@ void BusObject::AddChild(BusObject& child)
     QCC_DbgPrintf(("AddChild %s to object with path = \"%s\"", child.GetPath(), GetPath()));
     child.parent = this;
     components->children.push_back(&child);
+    InvalidateIntrospection();
 }
 
 QStatus BusObject::RemoveChild(BusObject& child)
@@ -1011,6 +1087,7 @@ QStatus BusObject::RemoveChild(BusObject& child)
         child.parent = NULL;
         QCC_DbgPrintf(("RemoveChild %s from object with path = \"%s\"", child.GetPath(), GetPath()));
         components->children.erase(it);
+        InvalidateIntrospection();
         status = ER_OK;
     }
     return status;
@@ -1024,6 +1101,7 @@ BusObject* BusObject::RemoveChild()
         components->children.pop_back();
         QCC_DbgPrintf(("RemoveChild %s from object with path = \"%s\"", child->GetPath(), GetPath()));
         child->parent = NULL;
+        InvalidateIntrospection();
         return child;
     } else {
         return NULL;
@@ -1049,6 +1127,8 @@ void BusObject::Replace(BusObject& object)
         }
     }
     components->children.clear();
+    object.InvalidateIntrospection();
+    InvalidateIntrospection();
 }
 
 void BusObject::InUseIncrement() {
@@ -1118,6 +1198,7 @@ void BusObject::SetDescription(const char* language, const char* text)
 {
     languageTag.assign(language);
     description.assign(text);
+    InvalidateIntrospection();
 }
 
 const char* BusObject::GetDescription(const char* toLanguage, qcc::String& buffer) const
@@ -1256,6 +1337,7 @@ void BusObject::GetDescriptionLanguages(const InterfaceDescription::Member* memb
 void BusObject::SetDescriptionTranslator(Translator* newTranslator)
 {
     this->translator = newTranslator;
+    InvalidateIntrospection();
 }
 
 size_t BusObject::GetAnnouncedInterfaceNames(const char** interfaces, size_t numInterfaces)
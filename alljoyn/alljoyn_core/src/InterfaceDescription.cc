@@ -21,6 +21,7 @@
  ******************************************************************************/
 
 #include <qcc/platform.h>
+#include <qcc/atomic.h>
 #include <qcc/String.h>
 #include <qcc/StringMapKey.h>
 #include <qcc/XmlElement.h>
@@ -869,8 +870,11 @@ const char* InterfaceDescription::Translate(const char* toLanguage, const char*
     return NULL;
 }
 
+volatile int32_t InterfaceDescription::translatorGeneration = 0;
+
 void InterfaceDescription::SetDescriptionTranslator(Translator* translator) {
     defs->translator = translator;
+    IncrementAndFetch(&translatorGeneration);
 }
 
 Translator* InterfaceDescription::GetDescriptionTranslator() const
@@ -1249,11 +1249,17 @@ bool KeyExchangerECDHE_ECDSA::IsCertChainStructureValid(const CertificateX509* c
             QCC_DbgPrintf(("Certificate basic extension CA is false"));
             return false;
         }
-        if (!certs[cnt + 1].IsIssuerOf(certs[cnt])) {
+        if (!certs[cnt + 1].IsDNEqual(certs[cnt].GetIssuerCN(), certs[cnt].GetIssuerCNLength(),
+                                      certs[cnt].GetIssuerOU(), certs[cnt].GetIssuerOULength())) {
             QCC_DbgPrintf(("Certificate chain issuer DN verification failed"));
             return false;
         }
     }
+    /* Check the signatures last, once the cheap structural checks have passed */
+    if (ER_OK != CertificateX509::VerifyCertChain(certs, numCerts)) {
+        QCC_DbgPrintf(("Certificate chain signature verification failed"));
+        return false;
+    }
     return true;
 }
 
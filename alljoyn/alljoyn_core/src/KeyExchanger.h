@@ -76,10 +76,13 @@ class AllJoynPeerObj;
  */
 class KeyExchangerCB {
   public:
-    KeyExchangerCB(ProxyBusObject& remoteObj, const InterfaceDescription* ifc, uint32_t timeout) : remoteObj(remoteObj), ifc(ifc), timeout(timeout) { }
+    KeyExchangerCB(ProxyBusObject& remoteObj, const InterfaceDescription* ifc, uint32_t timeout) : remoteObj(remoteObj), ifc(ifc), timeout(timeout), roundTrips(0) { }
     QStatus SendKeyExchange(MsgArg* args, size_t numArgs, Message* sentMsg, Message* replyMsg);
     QStatus SendKeyAuthentication(MsgArg* msg, Message* sentMsg, Message* replyMsg);
 
+    /** Number of method calls made through this callback */
+    uint32_t GetRoundTrips() const { return roundTrips; }
+
     ~KeyExchangerCB() { }
   private:
     /* Private assigment operator - does nothing */
@@ -88,6 +91,7 @@ class KeyExchangerCB {
     ProxyBusObject& remoteObj;
     const InterfaceDescription* ifc;
     uint32_t timeout;
+    uint32_t roundTrips;
 };
 
 class KeyExchanger {
@@ -20,7 +20,9 @@
  *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  ******************************************************************************/
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 #include <qcc/platform.h>
 #include <qcc/Debug.h>
@@ -69,10 +71,45 @@ static const uint16_t MixupGuidKeyStoreVersion = 0x0103;
  */
 static const uint16_t CompositeKeyKeyStoreVersion = 0x0104;
 
+/**
+ * the key store version where the keys can be followed by a journal of
+ * changes appended to the key store.
+ */
+static const uint16_t JournalKeyStoreVersion = 0x0105;
+
+/*
+ * Highest key store version we can read. A key store is only written with this version if a
+ * journal may follow it, otherwise it is written with CompositeKeyKeyStoreVersion so that
+ * older releases can still read it.
+ */
+static const uint16_t KeyStoreVersion = JournalKeyStoreVersion;
+
+/*
+ * Sanity check on the length of the encrypted keys and journal records
+ */
+static const size_t MaxKeysLen = 0x4000000;
+
+/*
+ * Journal entry types
+ */
+static const uint8_t JournalAddKey = 1;
+static const uint8_t JournalDeleteKey = 2;
+
+/*
+ * The key store is compacted when the journal has as many entries as there are keys but not
+ * before the journal has this many entries.
+ */
+static const size_t MinCompactionEntries = 256;
+
+/*
+ * Milliseconds to wait for changes to coalesce before performing a scheduled store
+ */
+static const uint32_t ScheduledStoreDelay = 250;
+
 /*
- * Current key store version we will write
+ * Value of nextExpiration when no key has an expiration time
  */
-static const uint16_t KeyStoreVersion = 0x0104;
+static const uint64_t NoExpiration = static_cast<uint64_t>(-1);
 
 QStatus KeyStoreListener::PutKeys(KeyStore& keyStore, const qcc::String& source, const qcc::String& password)
 {
@@ -94,6 +131,11 @@ KeyStore::KeyStore(const qcc::String& application) :
     application(application),
     storeState(UNAVAILABLE),
     keys(new KeyMap),
+    journalEntries(0),
+    compactionRequired(true),
+    nextExpiration(0),
+    storeTimer("KeyStoreTimer", true),
+    storeScheduled(false),
     defaultListener(NULL),
     listener(NULL),
     thisGuid(),
@@ -113,6 +155,10 @@ KeyStore::KeyStore(const qcc::String& application) :
 
 KeyStore::~KeyStore()
 {
+    /* Perform any scheduled store before the listener goes away */
+    FlushScheduledStore();
+    storeTimer.Stop();
+    storeTimer.Join();
     /* Unblock thread that might be waiting for a store to complete */
     lock.Lock(MUTEX_CONTEXT);
     if (stored) {
@@ -154,6 +200,9 @@ QStatus KeyStore::SetListener(KeyStoreListener& keyStoreListener)
      *    listener was set with the default listener
      */
 
+    /* A scheduled store must not be made through the listener being replaced after it is gone */
+    FlushScheduledStore();
+
     lock.Lock(MUTEX_CONTEXT);
     bool setIt = false;
     if (this->listener != NULL) {
@@ -186,6 +235,7 @@ QStatus KeyStore::SetKeyEventListener(KeyStoreKeyEventListener* eventListener) {
 
 QStatus KeyStore::SetDefaultListener()
 {
+    FlushScheduledStore();
     lock.Lock(MUTEX_CONTEXT);
     delete this->listener;
     this->listener = new ProtectedKeyStoreListener(defaultListener);
@@ -196,6 +246,7 @@ QStatus KeyStore::SetDefaultListener()
 
 QStatus KeyStore::Reset()
 {
+    FlushScheduledStore();
     lock.Lock(MUTEX_CONTEXT);
     if (storeState != UNAVAILABLE) {
         lock.Unlock(MUTEX_CONTEXT);
@@ -276,13 +327,84 @@ QStatus KeyStore::Store()
             delete stored;
             stored = NULL;
         }
-        /* Done tracking deletions */
-        deletions.clear();
     }
     lock.Unlock(MUTEX_CONTEXT);
     return status;
 }
 
+QStatus KeyStore::ScheduleStore()
+{
+    QStatus status = ER_OK;
+
+    lock.Lock(MUTEX_CONTEXT);
+    if (storeState == UNAVAILABLE) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return ER_BUS_KEYSTORE_NOT_LOADED;
+    }
+    /* Changes made before the scheduled store runs are stored along with it */
+    if (storeScheduled || (storeState != MODIFIED)) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return ER_OK;
+    }
+    if (!storeTimer.IsRunning()) {
+        status = storeTimer.Start();
+    }
+    if (status == ER_OK) {
+        AlarmListener* storeListener = this;
+        storeAlarm = Alarm(ScheduledStoreDelay, storeListener);
+        status = storeTimer.AddAlarm(storeAlarm);
+    }
+    storeScheduled = (status == ER_OK);
+    lock.Unlock(MUTEX_CONTEXT);
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Failed to schedule storing the key store"));
+        status = Store();
+    }
+    return status;
+}
+
+QStatus KeyStore::FlushScheduledStore()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    Alarm alarm = storeAlarm;
+    lock.Unlock(MUTEX_CONTEXT);
+    /* Waits for the scheduled store to complete if it is already running */
+    if (!storeTimer.RemoveAlarm(alarm)) {
+        return ER_OK;
+    }
+    lock.Lock(MUTEX_CONTEXT);
+    storeScheduled = false;
+    lock.Unlock(MUTEX_CONTEXT);
+    return Store();
+}
+
+void KeyStore::CancelScheduledStore()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    Alarm alarm = storeAlarm;
+    lock.Unlock(MUTEX_CONTEXT);
+    /* The changes are left to the next store */
+    if (storeTimer.RemoveAlarm(alarm, false)) {
+        lock.Lock(MUTEX_CONTEXT);
+        storeScheduled = false;
+        lock.Unlock(MUTEX_CONTEXT);
+    }
+}
+
+void KeyStore::AlarmTriggered(const Alarm& alarm, QStatus reason)
+{
+    QCC_UNUSED(alarm);
+    QCC_UNUSED(reason);
+
+    lock.Lock(MUTEX_CONTEXT);
+    storeScheduled = false;
+    lock.Unlock(MUTEX_CONTEXT);
+    QStatus status = Store();
+    if ((status != ER_OK) && (status != ER_BUS_KEYSTORE_NOT_LOADED)) {
+        QCC_LogError(status, ("Scheduled storing of the key store failed"));
+    }
+}
+
 QStatus KeyStore::Load()
 {
     QStatus status;
@@ -311,30 +433,206 @@ QStatus KeyStore::Load()
 /* private method assumes lock is already acquired by the caller. */
 size_t KeyStore::EraseExpiredKeys()
 {
+    Timespec now;
+    GetTimeNow(&now);
+    if (now.GetAbsoluteMillis() < nextExpiration) {
+        return 0;
+    }
+    /*
+     * Collect the expired keys in a single pass and find when the next key expires. The
+     * expired keys are deleted afterwards because NotifyAutoDelete may delete other keys.
+     */
+    std::vector<Key> expired;
+    nextExpiration = NoExpiration;
+    for (KeyMap::iterator it = keys->begin(); it != keys->end(); ++it) {
+        Timespec expiration;
+        if (it->second.keyBlob.GetExpiration(expiration)) {
+            if (expiration <= now) {
+                expired.push_back(it->first);
+            } else {
+                nextExpiration = (std::min)(nextExpiration, expiration.GetAbsoluteMillis());
+            }
+        }
+    }
     size_t count = 0;
-    bool dirty = true;
-    while (dirty) {
-        dirty = false;
-        KeyMap::iterator it = keys->begin();
-        while (it != keys->end()) {
-            KeyMap::iterator current = it++;
-            if (current->second.keyBlob.HasExpired()) {
-                QCC_DbgPrintf(("Deleting expired key for GUID %s", current->first.ToString().c_str()));
-                bool affected = false;
-                if (keyEventListener) {
-                    affected = keyEventListener->NotifyAutoDelete(this, current->first);
+    for (std::vector<Key>::iterator it = expired.begin(); it != expired.end(); ++it) {
+        if (keys->find(*it) == keys->end()) {
+            continue;  /* already deleted by the NotifyAutoDelete call for another key */
+        }
+        QCC_DbgPrintf(("Deleting expired key for GUID %s", it->ToString().c_str()));
+        if (keyEventListener) {
+            keyEventListener->NotifyAutoDelete(this, *it);
+        }
+        keys->erase(*it);
+        ++count;
+    }
+    return count;
+}
+
+/* private method assumes lock is already acquired by the caller. */
+void KeyStore::UpdateNextExpiration(const KeyBlob& keyBlob)
+{
+    Timespec expiration;
+    if (keyBlob.GetExpiration(expiration)) {
+        nextExpiration = (std::min)(nextExpiration, expiration.GetAbsoluteMillis());
+    }
+}
+
+QStatus KeyStore::PullKeyRecord(Source& source, uint16_t version, Key& key, KeyRecord& keyRec)
+{
+    uint8_t guidBuf[qcc::GUID128::SIZE];
+    size_t pulled;
+    QStatus status = source.PullBytes(&keyRec.revision, sizeof(keyRec.revision), pulled);
+    Key::KeyType keyType = Key::REMOTE;
+    if ((status == ER_OK) && (version >= CompositeKeyKeyStoreVersion)) {
+        status = source.PullBytes(&keyType, sizeof(keyType), pulled);
+    }
+    if (status == ER_OK) {
+        status = source.PullBytes(guidBuf, qcc::GUID128::SIZE, pulled);
+    }
+    if (status != ER_OK) {
+        return status;
+    }
+    qcc::GUID128 guid(0);
+    guid.SetBytes(guidBuf);
+    key.SetType(keyType);
+    key.SetGUID(guid);
+    status = keyRec.keyBlob.Load(source);
+    if (status == ER_OK) {
+        if (version > LowStoreVersion) {
+            status = source.PullBytes(&keyRec.accessRights, sizeof(keyRec.accessRights), pulled);
+        } else {
+            /*
+             * Maintain backwards compatibility with an older key store
+             */
+            for (size_t i = 0; i < ArraySize(keyRec.accessRights); ++i) {
+                keyRec.accessRights[i] = _PeerState::ALLOW_SECURE_TX | _PeerState::ALLOW_SECURE_RX;
+            }
+        }
+    }
+    QCC_DbgPrintf(("KeyStore::PullKeyRecord rev:%d GUID %s %s", keyRec.revision, QCC_StatusText(status), guid.ToString().c_str()));
+    return status;
+}
+
+QStatus KeyStore::PushKeyRecord(Sink& sink, const Key& key, const KeyRecord& keyRec)
+{
+    size_t pushed;
+    QStatus status = sink.PushBytes(&keyRec.revision, sizeof(keyRec.revision), pushed);
+    Key::KeyType keyType = key.GetType();
+    if (status == ER_OK) {
+        status = sink.PushBytes(&keyType, sizeof(keyType), pushed);
+    }
+    if (status == ER_OK) {
+        status = sink.PushBytes(key.GetGUID().GetBytes(), qcc::GUID128::SIZE, pushed);
+    }
+    if (status == ER_OK) {
+        status = keyRec.keyBlob.Store(sink);
+    }
+    if (status == ER_OK) {
+        status = sink.PushBytes(&keyRec.accessRights, sizeof(keyRec.accessRights), pushed);
+    }
+    QCC_DbgPrintf(("KeyStore::PushKeyRecord rev:%d key %s", keyRec.revision, key.ToString().c_str()));
+    return status;
+}
+
+/* private method assumes lock is already acquired by the caller. */
+QStatus KeyStore::PullJournal(Source& source)
+{
+    QStatus status = ER_OK;
+    Crypto_AES aes(*keyStoreKey, Crypto_AES::CCM);
+
+    journalEntries = 0;
+    compactionRequired = false;
+    /*
+     * Each journal record is the revision it was stored with, the length of the encrypted
+     * entries, and the encrypted entries. The end of the source is the end of the journal.
+     */
+    while (true) {
+        uint32_t recordRevision;
+        uint32_t recordLen;
+        size_t pulled;
+        status = source.PullBytes(&recordRevision, sizeof(recordRevision), pulled);
+        if (status == ER_EOF) {
+            return ER_OK;
+        }
+        if ((status == ER_OK) && (pulled != sizeof(recordRevision))) {
+            status = ER_BUS_CORRUPT_KEYSTORE;
+        }
+        if (status == ER_OK) {
+            status = source.PullBytes(&recordLen, sizeof(recordLen), pulled);
+            if ((status == ER_OK) && (pulled != sizeof(recordLen))) {
+                status = ER_BUS_CORRUPT_KEYSTORE;
+            }
+        }
+        /* Revisions must increase so a record cannot be replayed */
+        if ((status == ER_OK) && ((recordRevision <= revision) || (recordLen > MaxKeysLen))) {
+            status = ER_BUS_CORRUPT_KEYSTORE;
+        }
+        if (status != ER_OK) {
+            break;
+        }
+        uint8_t* data = new uint8_t[recordLen];
+        status = source.PullBytes(data, recordLen, pulled);
+        if ((status == ER_OK) && (pulled != recordLen)) {
+            status = ER_BUS_CORRUPT_KEYSTORE;
+        }
+        if (status == ER_OK) {
+            size_t len = recordLen;
+            KeyBlob nonce((uint8_t*)&recordRevision, sizeof(recordRevision), KeyBlob::GENERIC);
+            status = aes.Decrypt_CCM(data, data, len, nonce, NULL, 0, 16);
+            /*
+             * Apply the entries, the record has been authenticated so they are complete.
+             */
+            StringSource strSource(data, len);
+            while (status == ER_OK) {
+                uint8_t entryType;
+                Key key;
+                status = strSource.PullBytes(&entryType, sizeof(entryType), pulled);
+                if (status != ER_OK) {
+                    break;
+                }
+                if (entryType == JournalAddKey) {
+                    KeyRecord keyRec;
+                    status = PullKeyRecord(strSource, JournalKeyStoreVersion, key, keyRec);
+                    if (status == ER_OK) {
+                        (*keys)[key] = keyRec;
+                    }
+                } else if (entryType == JournalDeleteKey) {
+                    Key::KeyType keyType;
+                    uint8_t guidBuf[qcc::GUID128::SIZE];
+                    status = strSource.PullBytes(&keyType, sizeof(keyType), pulled);
+                    if (status == ER_OK) {
+                        status = strSource.PullBytes(guidBuf, qcc::GUID128::SIZE, pulled);
+                    }
+                    if (status == ER_OK) {
+                        qcc::GUID128 guid(0);
+                        guid.SetBytes(guidBuf);
+                        keys->erase(Key(keyType, guid));
+                    }
+                } else {
+                    status = ER_BUS_CORRUPT_KEYSTORE;
                 }
-                keys->erase(current);
-                ++count;
-                dirty = true;
-                if (affected) {
-                    break;  /* need to refresh the iterator because the list members may have changed by the NotifyAutoDelete call */
+                if (status == ER_OK) {
+                    ++journalEntries;
                 }
             }
+            if (status == ER_EOF) {
+                status = ER_OK;
+                revision = recordRevision;
+            }
         }
-    } /* clean sweep */
-
-    return count;
+        delete [] data;
+        if (status != ER_OK) {
+            break;
+        }
+    }
+    /*
+     * A record that cannot be read was only partially written. The keys stored before it are
+     * kept and the key store is rewritten without it the next time it is stored.
+     */
+    QCC_LogError(status, ("Ignoring key store journal after revision %u", revision));
+    compactionRequired = true;
+    return ER_OK;
 }
 
 QStatus KeyStore::Pull(Source& source, const qcc::String& password)
@@ -354,6 +652,10 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
     size_t len = 0;
     uint16_t version;
 
+    /* The stored key store is rewritten unless it is read in a format that can be appended to */
+    compactionRequired = true;
+    journalEntries = 0;
+
     /* Pull and check the key store version */
     QStatus status = source.PullBytes(&version, sizeof(version), pulled);
     if ((status == ER_OK) && ((version > KeyStoreVersion) || (version < LowStoreVersion))) {
@@ -397,7 +699,7 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
         goto ExitPull;
     }
     /* Sanity check on the length */
-    if (len > 64000) {
+    if (len > MaxKeysLen) {
         status = ER_BUS_CORRUPT_KEYSTORE;
         goto ExitPull;
     }
@@ -447,35 +749,11 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
              */
             StringSource strSource(data, len);
             while (status == ER_OK) {
-                uint32_t rev;
-                status = strSource.PullBytes(&rev, sizeof(rev), pulled);
-                Key::KeyType keyType = Key::REMOTE;
-                if ((status == ER_OK) && (version >= CompositeKeyKeyStoreVersion)) {
-                    status = strSource.PullBytes(&keyType, sizeof(keyType), pulled);
-                }
+                Key key;
+                KeyRecord keyRec;
+                status = PullKeyRecord(strSource, version, key, keyRec);
                 if (status == ER_OK) {
-                    status = strSource.PullBytes(guidBuf, qcc::GUID128::SIZE, pulled);
-                }
-                if (status == ER_OK) {
-                    qcc::GUID128 guid(0);
-                    guid.SetBytes(guidBuf);
-                    Key key(keyType, guid);
-                    KeyRecord& keyRec = (*keys)[key];
-                    keyRec.revision = rev;
-                    status = keyRec.keyBlob.Load(strSource);
-                    if (status == ER_OK) {
-                        if (version > LowStoreVersion) {
-                            status = strSource.PullBytes(&keyRec.accessRights, sizeof(keyRec.accessRights), pulled);
-                        } else {
-                            /*
-                             * Maintain backwards compatibility with an older key store
-                             */
-                            for (size_t i = 0; i < ArraySize(keyRec.accessRights); ++i) {
-                                keyRec.accessRights[i] = _PeerState::ALLOW_SECURE_TX | _PeerState::ALLOW_SECURE_RX;
-                            }
-                        }
-                    }
-                    QCC_DbgPrintf(("KeyStore::Pull rev:%d GUID %s %s", rev, QCC_StatusText(status), guid.ToString().c_str()));
+                    (*keys)[key] = keyRec;
                 }
             }
             if (status == ER_EOF) {
@@ -487,6 +765,17 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
     if (status != ER_OK) {
         goto ExitPull;
     }
+    /*
+     * Apply the changes appended to the key store. Key stores written in an older format are
+     * rewritten in the current format before anything is appended to them.
+     */
+    if (version >= JournalKeyStoreVersion) {
+        status = PullJournal(source);
+    }
+    if (status != ER_OK) {
+        goto ExitPull;
+    }
+    nextExpiration = 0;
     if (EraseExpiredKeys()) {
         storeState = MODIFIED;
     } else {
@@ -517,6 +806,8 @@ QStatus KeyStore::Clear()
     storeState = MODIFIED;
     revision = 0;
     deletions.clear();
+    updates.clear();
+    compactionRequired = true;
     lock.Unlock(MUTEX_CONTEXT);
     listener->StoreRequest(*this);
     return ER_OK;
@@ -534,25 +825,17 @@ QStatus KeyStore::Clear(const qcc::String& tagPrefixPattern)
         lock.Unlock(MUTEX_CONTEXT);
         return ER_BUS_KEYSTORE_NOT_LOADED;
     }
-    bool dirty = true;
     QStatus status = ER_OK;
-    while (dirty) {
-        dirty = false;
-        for (KeyMap::iterator it = keys->begin(); it != keys->end(); it++) {
-            if (it->second.keyBlob.GetTag().empty()) {
-                continue;  /* skip the untag */
-            }
-            if (MatchesPrefix(it->second.keyBlob.GetTag(), tagPrefixPattern)) {
-                status = DeleteKey(it->first);
-                if (ER_OK != status) {
-                    break;
-                }
-                dirty = true;
-                break;  /* redo the loop since the iterator is out-of-sync */
-            }
+    for (KeyMap::iterator it = keys->begin(); it != keys->end();) {
+        KeyMap::iterator current = it++;
+        if (current->second.keyBlob.GetTag().empty()) {
+            continue;  /* skip the untag */
         }
-        if (ER_OK != status) {
-            break;
+        if (MatchesPrefix(current->second.keyBlob.GetTag(), tagPrefixPattern)) {
+            status = DeleteKey(current->first);
+            if (ER_OK != status) {
+                break;
+            }
         }
     }
     lock.Unlock(MUTEX_CONTEXT);
@@ -603,13 +886,21 @@ QStatus KeyStore::Reload()
         /*
          * Handle deletions
          */
-        std::set<Key>::iterator itDel;
-        for (itDel = deletions.begin(); itDel != deletions.end(); ++itDel) {
+        std::set<Key>::iterator itDel = deletions.begin();
+        while (itDel != deletions.end()) {
             it = keys->find(*itDel);
-            if ((it != keys->end()) && (it->second.revision <= currentRevision)) {
+            if ((it != keys->end()) && (it->second.revision > currentRevision)) {
+                /*
+                 * The key was stored again after it was deleted so the deletion no longer applies
+                 */
+                deletions.erase(itDel++);
+                continue;
+            }
+            if (it != keys->end()) {
                 QCC_DbgPrintf(("KeyStore::Reload deleting %s", itDel->ToString().c_str()));
-                keys->erase(*itDel);
+                keys->erase(it);
             }
+            ++itDel;
         }
         /*
          * Handle additions and updates
@@ -622,6 +913,7 @@ QStatus KeyStore::Reload()
                      * In case of a merge conflict go with the key that is currently stored
                      */
                     QCC_DbgPrintf(("KeyStore::Reload merge conflict rev:%d %s", it->second.revision, it->first.ToString().c_str()));
+                    updates.erase(it->first);
                 } else {
                     (*keys)[it->first] = it->second;
                     QCC_DbgPrintf(("KeyStore::Reload merging %s", it->first.ToString().c_str()));
@@ -629,6 +921,7 @@ QStatus KeyStore::Reload()
             }
         }
         delete currentKeys;
+        nextExpiration = 0;
         EraseExpiredKeys();
     } else {
         /*
@@ -638,16 +931,18 @@ QStatus KeyStore::Reload()
         keys = currentKeys;
         delete goner;
         revision = currentRevision;
+        nextExpiration = 0;
     }
 
     lock.Unlock(MUTEX_CONTEXT);
     return status;
 }
 
-QStatus KeyStore::Push(Sink& sink)
+QStatus KeyStore::Push(Sink& sink, bool journal)
 {
     size_t pushed;
     QStatus status = ER_OK;
+    const uint16_t version = journal ? JournalKeyStoreVersion : CompositeKeyKeyStoreVersion;
 
     QCC_DbgHLPrintf(("KeyStore::Push (revision %d)", revision + 1));
     lock.Lock(MUTEX_CONTEXT);
@@ -658,20 +953,13 @@ QStatus KeyStore::Push(Sink& sink)
     StringSink strSink;
     KeyMap::iterator it;
     for (it = keys->begin(); it != keys->end(); ++it) {
-        strSink.PushBytes(&it->second.revision, sizeof(revision), pushed);
-        Key::KeyType keyType = it->first.GetType();
-        strSink.PushBytes(&keyType, sizeof(keyType), pushed);
-        strSink.PushBytes(it->first.GetGUID().GetBytes(), qcc::GUID128::SIZE, pushed);
-        it->second.keyBlob.Store(strSink);
-
-        strSink.PushBytes(&it->second.accessRights, sizeof(it->second.accessRights), pushed);
-        QCC_DbgPrintf(("KeyStore::Push rev:%d key %s", it->second.revision, it->first.ToString().c_str()));
+        PushKeyRecord(strSink, it->first, it->second);
     }
     size_t keysLen = strSink.GetString().size();
     /*
      * First two bytes are the version number.
      */
-    status = sink.PushBytes(&KeyStoreVersion, sizeof(KeyStoreVersion), pushed);
+    status = sink.PushBytes(&version, sizeof(version), pushed);
     if (status != ER_OK) {
         goto ExitPush;
     }
@@ -719,6 +1007,11 @@ QStatus KeyStore::Push(Sink& sink)
         goto ExitPush;
     }
     storeState = LOADED;
+    /* The stored key store has no journal and changes can only be appended if it may have one */
+    deletions.clear();
+    updates.clear();
+    journalEntries = 0;
+    compactionRequired = !journal;
 
 ExitPush:
 
@@ -729,6 +1022,90 @@ ExitPush:
     return status;
 }
 
+QStatus KeyStore::PushChanges(Sink& sink)
+{
+    size_t pushed;
+    QStatus status = ER_OK;
+
+    lock.Lock(MUTEX_CONTEXT);
+    if (storeState == UNAVAILABLE) {
+        status = ER_BUS_KEYSTORE_NOT_LOADED;
+        goto ExitPushChanges;
+    }
+    /*
+     * Compact the key store once the journal is as large as the key store, this keeps the cost
+     * of rewriting the key store proportional to the number of changes.
+     */
+    if (compactionRequired || ((journalEntries + deletions.size() + updates.size()) > (std::max)(MinCompactionEntries, keys->size()))) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return ER_KEY_STORE_COMPACTION_REQUIRED;
+    }
+    QCC_DbgHLPrintf(("KeyStore::PushChanges (revision %d)", revision + 1));
+    {
+        /*
+         * Pack the journal entries into an intermediate string sink.
+         */
+        StringSink strSink;
+        size_t entries = 0;
+        for (std::set<Key>::iterator itDel = deletions.begin(); itDel != deletions.end(); ++itDel) {
+            Key::KeyType keyType = itDel->GetType();
+            strSink.PushBytes(&JournalDeleteKey, sizeof(JournalDeleteKey), pushed);
+            strSink.PushBytes(&keyType, sizeof(keyType), pushed);
+            strSink.PushBytes(itDel->GetGUID().GetBytes(), qcc::GUID128::SIZE, pushed);
+            ++entries;
+        }
+        for (std::set<Key>::iterator itUpd = updates.begin(); itUpd != updates.end(); ++itUpd) {
+            KeyMap::iterator it = keys->find(*itUpd);
+            if (it != keys->end()) {
+                strSink.PushBytes(&JournalAddKey, sizeof(JournalAddKey), pushed);
+                PushKeyRecord(strSink, it->first, it->second);
+                ++entries;
+            }
+        }
+        if (entries > 0) {
+            /*
+             * Append a record with the encrypted entries, the record is pushed in a single write
+             * so a failed write leaves at most one partial record at the end of the journal.
+             */
+            uint32_t recordRevision = revision + 1;
+            size_t len = strSink.GetString().size();
+            uint32_t recordLen = static_cast<uint32_t>(len + 16);
+            const size_t headerLen = sizeof(recordRevision) + sizeof(recordLen);
+            uint8_t* record = new uint8_t[headerLen + recordLen];
+            memcpy(record, &recordRevision, sizeof(recordRevision));
+            memcpy(record + sizeof(recordRevision), &recordLen, sizeof(recordLen));
+            KeyBlob nonce((uint8_t*)&recordRevision, sizeof(recordRevision), KeyBlob::GENERIC);
+            Crypto_AES aes(*keyStoreKey, Crypto_AES::CCM);
+            status = aes.Encrypt_CCM(strSink.GetString().data(), record + headerLen, len, nonce, NULL, 0, 16);
+            if (status == ER_OK) {
+                status = sink.PushBytes(record, headerLen + recordLen, pushed);
+            }
+            if ((status == ER_OK) && (pushed != (headerLen + recordLen))) {
+                status = ER_BUS_WRITE_ERROR;
+            }
+            delete [] record;
+            if (status != ER_OK) {
+                /* Rewrite the key store rather than append after a partial record */
+                compactionRequired = true;
+                goto ExitPushChanges;
+            }
+            revision = recordRevision;
+            journalEntries += entries;
+        }
+    }
+    storeState = LOADED;
+    deletions.clear();
+    updates.clear();
+
+ExitPushChanges:
+
+    if (stored) {
+        stored->SetEvent();
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
+
 QStatus KeyStore::GetKey(const Key& key, KeyBlob& keyBlob, uint8_t accessRights[4])
 {
     lock.Lock(MUTEX_CONTEXT);
@@ -776,8 +1153,10 @@ QStatus KeyStore::AddKey(const Key& key, const KeyBlob& keyBlob, const uint8_t a
     keyRec.keyBlob = keyBlob;
     QCC_DbgPrintf(("AccessRights %1x%1x%1x%1x", accessRights[0], accessRights[1], accessRights[2], accessRights[3]));
     memcpy(&keyRec.accessRights, accessRights, sizeof(uint8_t) * 4);
+    UpdateNextExpiration(keyBlob);
     storeState = MODIFIED;
     deletions.erase(key);
+    updates.insert(key);
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
@@ -795,6 +1174,7 @@ QStatus KeyStore::DeleteKey(const Key& key)
     Key keyCopy(key);
     keys->erase(key);
     storeState = MODIFIED;
+    updates.erase(keyCopy);
     deletions.insert(keyCopy);
     return ER_OK;
 }
@@ -822,7 +1202,9 @@ QStatus KeyStore::SetKeyExpiration(const Key& key, const Timespec& expiration)
     QCC_DbgPrintf(("KeyStore::SetExpiration %s", key.ToString().c_str()));
     if (keys->count(key) != 0) {
         (*keys)[key].keyBlob.SetExpiration(expiration);
+        UpdateNextExpiration((*keys)[key].keyBlob);
         storeState = MODIFIED;
+        updates.insert(key);
     } else {
         status = ER_BUS_KEY_UNAVAILABLE;
     }
@@ -36,6 +36,7 @@
 #include <qcc/Mutex.h>
 #include <qcc/Stream.h>
 #include <qcc/Event.h>
+#include <qcc/Timer.h>
 #include <qcc/time.h>
 
 #include <alljoyn/KeyStoreListener.h>
@@ -52,8 +53,15 @@ class KeyStoreKeyEventListener;
 /**
  * The %KeyStore class manages the storing and loading of key blobs from
  * external storage.
+ *
+ * The stored key store is a snapshot of all keys optionally followed by a journal of the keys
+ * that were added or deleted since the snapshot was written. Listeners that can append to the
+ * stored key store use PushChanges() to write just the changed keys, the snapshot is rewritten
+ * by Push() once the journal has grown as large as the key store itself. A key store that may
+ * have a journal is written with a format version (0x0105) that older releases cannot read,
+ * key stores without one are written in the older format (0x0104).
  */
-class KeyStore {
+class KeyStore : public qcc::AlarmListener {
   public:
 
     /**
@@ -186,6 +194,33 @@ class KeyStore {
      */
     QStatus Store();
 
+    /**
+     * Requests the key store listener to store the contents of the key store in the background.
+     * Changes made before the store is performed are coalesced into a single store request.
+     *
+     * @return
+     *      - ER_OK if the store was scheduled or if there are no changes to store
+     *      - ER_BUS_KEYSTORE_NOT_LOADED if the key store has not been loaded
+     */
+    QStatus ScheduleStore();
+
+    /**
+     * Performs a store scheduled by ScheduleStore() right away rather than in the background,
+     * waiting for it if it is already in progress. This is called before the key store listener
+     * can go away.
+     *
+     * @return
+     *      - ER_OK if there was no scheduled store or the store succeeded
+     *      - An error status otherwise
+     */
+    QStatus FlushScheduledStore();
+
+    /**
+     * Cancels a store scheduled by ScheduleStore() without waiting for one that is already in
+     * progress. The key store stays modified so the changes are written by the next store.
+     */
+    void CancelScheduledStore();
+
     /**
      * Re-read keys from the key store. This is a no-op unless the key store is shared.
      * If the key store is shared the key store is reloaded merging any changes made by
@@ -379,12 +414,29 @@ class KeyStore {
     /**
      * Push the current keys from the key store into a sink
      *
-     * @param sink The sink to write the keys to.
+     * @param sink     The sink to write the keys to.
+     * @param journal  true if changes will be appended to the keys with PushChanges(). The keys
+     *                 are then written in a format that releases without journal support cannot
+     *                 read.
      * @return
      *      - ER_OK if successful
      *      - An error status otherwise
      */
-    QStatus Push(qcc::Sink& sink);
+    QStatus Push(qcc::Sink& sink, bool journal = false);
+
+    /**
+     * Push the keys that have been added, changed or deleted since the key store was last pushed
+     * or loaded into a sink that appends to the stored key store. Changes can only be appended
+     * to keys that were pushed or loaded with a journal.
+     *
+     * @param sink The sink to append the changes to.
+     * @return
+     *      - ER_OK if successful
+     *      - ER_KEY_STORE_COMPACTION_REQUIRED if nothing was written because the entire key store
+     *        must be stored with Push()
+     *      - An error status otherwise
+     */
+    QStatus PushChanges(qcc::Sink& sink);
 
     /**
      * Indicates if this is a shared key store.
@@ -478,6 +530,21 @@ class KeyStore {
      */
     size_t EraseExpiredKeys();
 
+    /**
+     * Lower the time of the next key expiration if the key blob expires before it.
+     */
+    void UpdateNextExpiration(const qcc::KeyBlob& keyBlob);
+
+    /**
+     * Read the journal records that follow the key store snapshot.
+     */
+    QStatus PullJournal(qcc::Source& source);
+
+    /**
+     * Handle the alarm for a scheduled store.
+     */
+    void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
+
     /**
      * Internal Load function
      */
@@ -542,6 +609,16 @@ class KeyStore {
      */
     typedef std::map<Key, KeyRecord> KeyMap;
 
+    /**
+     * Read a key record from a key store snapshot or journal entry.
+     */
+    static QStatus PullKeyRecord(qcc::Source& source, uint16_t version, Key& key, KeyRecord& keyRec);
+
+    /**
+     * Write a key record to a key store snapshot or journal entry.
+     */
+    static QStatus PushKeyRecord(qcc::Sink& sink, const Key& key, const KeyRecord& keyRec);
+
     /**
      * In memory copy of the key store
      */
@@ -552,6 +629,41 @@ class KeyStore {
      */
     std::set<Key> deletions;
 
+    /**
+     * GUID for keys that have been added or changed since the key store was stored
+     */
+    std::set<Key> updates;
+
+    /**
+     * Number of journal entries following the stored key store snapshot
+     */
+    size_t journalEntries;
+
+    /**
+     * Indicates that the stored key store must be rewritten instead of appended to
+     */
+    bool compactionRequired;
+
+    /**
+     * No key expires before this time in milliseconds, 0 if the keys need to be checked
+     */
+    uint64_t nextExpiration;
+
+    /**
+     * Timer for scheduled stores
+     */
+    qcc::Timer storeTimer;
+
+    /**
+     * Alarm for the last store scheduled on the store timer
+     */
+    qcc::Alarm storeAlarm;
+
+    /**
+     * Indicates that a store has been scheduled on the store timer
+     */
+    bool storeScheduled;
+
     /**
      * Default listener for handling load/store requests
      */
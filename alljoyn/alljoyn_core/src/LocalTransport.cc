@@ -22,13 +22,17 @@
  ******************************************************************************/
 #include <qcc/platform.h>
 
+#include <deque>
 #include <list>
+#include <vector>
 
+#include <qcc/Condition.h>
 #include <qcc/Debug.h>
 #include <qcc/GUID.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Thread.h>
+#include <qcc/Util.h>
 #include <qcc/atomic.h>
 
 #include <alljoyn/DBusStd.h>
@@ -54,18 +58,31 @@ namespace ajn {
 
 static const uint32_t LOCAL_ENDPOINT_CONCURRENCY = 4;
 
-class _LocalEndpoint::Dispatcher : public qcc::Timer, public qcc::AlarmListener {
+/*
+ * Number of messages from other endpoints that may be queued per dispatcher
+ * worker before the threads delivering them are made to wait.
+ */
+static const uint32_t LOCAL_ENDPOINT_QUEUE_DEPTH = 16;
+
+/*
+ * The dispatcher runs method and signal handlers on up to concurrency worker
+ * threads. Method calls and signals are sharded by sender across per-worker
+ * queues and each queue is only served by its own worker, so messages from
+ * one sender are handled in order even when handlers call
+ * EnableConcurrentCallbacks(). Method replies and pending work go on a queue
+ * shared by all the workers so that a handler blocked waiting for a reply
+ * never holds up that reply. Handlers are serialized by the reentrancy lock
+ * unless the running handler calls EnableConcurrentCallbacks().
+ */
+class _LocalEndpoint::Dispatcher {
   public:
-    Dispatcher(_LocalEndpoint* endpoint, uint32_t concurrency = LOCAL_ENDPOINT_CONCURRENCY) :
-        Timer("lepDisp" + U32ToString(qcc::IncrementAndFetch(&dispatcherCnt)), true, concurrency, true, 10),
-        AlarmListener(), endpoint(endpoint), pendingWork(),
-        needDeferredCallbacks(false), needObserverWork(false),
-        needCachedPropertyReplyWork(false)
-    {
-        uint32_t zero = 0;
-        qcc::AlarmListener* listener = static_cast<qcc::AlarmListener*>(this);
-        pendingWork = Alarm(zero, listener);
-    }
+    Dispatcher(_LocalEndpoint* endpoint, uint32_t concurrency = LOCAL_ENDPOINT_CONCURRENCY);
+
+    ~Dispatcher();
+
+    QStatus Start();
+    QStatus Stop();
+    QStatus Join();
 
     QStatus DispatchMessage(Message& msg);
 
@@ -77,13 +94,69 @@ class _LocalEndpoint::Dispatcher : public qcc::Timer, public qcc::AlarmListener
     void PerformObserverWork();
     void PerformCachedPropertyReplyWork();
 
-    void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
+    void EnableReentrancy();
+    bool IsHoldingReentrantLock() const;
+    bool IsDispatcherThread() const;
 
   private:
+    /* A queued message or, if msg is NULL, a request to perform pending work */
+    struct WorkItem {
+        Message* msg;
+        bool limitable;
+    };
+
+    class Worker : public qcc::Thread {
+      public:
+        Worker(Dispatcher* dispatcher, const qcc::String& name, uint32_t shard) :
+            Thread(name), shard(shard), hasReentrancyLock(false), idle(false), retired(false), dispatcher(dispatcher) { }
+
+        const uint32_t shard;         /**< Index of the queue served by this worker */
+        bool hasReentrancyLock;       /**< Only accessed by the worker thread itself */
+        bool idle;                    /**< Waiting for work, protected by Dispatcher::lock */
+        bool retired;                 /**< Removed from the dispatcher, protected by Dispatcher::lock */
+        qcc::Condition workAvailable; /**< Signaled when there is work for an idle worker */
+
+      private:
+        qcc::ThreadReturn STDCALL Run(void* arg)
+        {
+            QCC_UNUSED(arg);
+            dispatcher->WorkerRun(this);
+            return 0;
+        }
+
+        Dispatcher* dispatcher;
+    };
+
+    void WorkerRun(Worker* worker);
+    QStatus Enqueue(Message* msg, bool limitable);
+    bool TakeNext(Worker* worker, WorkItem& item);
+    Worker* CurrentWorker() const;
+    bool StartWorker(uint32_t shard);
+    void WakeWorker(Worker* worker);
+    void ScheduleWorker();
+    void ScheduleShard(uint32_t shard);
+    void Execute(WorkItem& item);
+    void QueuePendingWork();
+
     _LocalEndpoint* endpoint;
+    qcc::String name;
     static volatile int32_t dispatcherCnt;
 
-    Alarm pendingWork;
+    std::vector<Worker*> workers;     /**< Worker threads indexed by shard, NULL until started */
+    uint32_t numWorkers;              /**< Number of started worker threads */
+    uint32_t idleWorkers;             /**< Workers waiting for work */
+    uint32_t busyWorkers;             /**< Workers running a handler */
+    std::vector<Worker*> exitedWorkers; /**< Workers that were stopped from one of their own handlers */
+    std::vector<std::deque<WorkItem> > shards; /**< Method calls and signals waiting for the worker of the same index */
+    std::deque<WorkItem> queue;       /**< Replies and pending work waiting for any worker */
+    size_t numLimitable;              /**< Number of queued messages from other endpoints */
+    size_t maxLimitable;              /**< Queued messages from other endpoints before producers wait */
+    bool running;
+    bool pendingWorkQueued;
+    mutable qcc::Mutex lock;
+    qcc::Condition queueNotFull;
+    qcc::Mutex reentrancyLock;
+
     bool needDeferredCallbacks;
     bool needObserverWork;
     bool needCachedPropertyReplyWork;
@@ -92,6 +165,312 @@ class _LocalEndpoint::Dispatcher : public qcc::Timer, public qcc::AlarmListener
 
 volatile int32_t _LocalEndpoint::Dispatcher::dispatcherCnt = 0;
 
+_LocalEndpoint::Dispatcher::Dispatcher(_LocalEndpoint* endpoint, uint32_t concurrency) :
+    endpoint(endpoint),
+    name("lepDisp" + U32ToString(qcc::IncrementAndFetch(&dispatcherCnt))),
+    workers((concurrency > 0) ? concurrency : 1, static_cast<Worker*>(NULL)),
+    numWorkers(0), idleWorkers(0), busyWorkers(0), shards(workers.size()),
+    numLimitable(0), maxLimitable(workers.size() * LOCAL_ENDPOINT_QUEUE_DEPTH),
+    running(false), pendingWorkQueued(false),
+    needDeferredCallbacks(false), needObserverWork(false),
+    needCachedPropertyReplyWork(false)
+{
+}
+
+_LocalEndpoint::Dispatcher::~Dispatcher()
+{
+    Stop();
+    Join();
+    for (size_t i = 0; i < exitedWorkers.size(); ++i) {
+        exitedWorkers[i]->Join();
+        delete exitedWorkers[i];
+    }
+}
+
+QStatus _LocalEndpoint::Dispatcher::Start()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    running = true;
+    if (numWorkers == 0) {
+        ScheduleWorker();
+    }
+    QStatus status = (numWorkers > 0) ? ER_OK : ER_OS_ERROR;
+    if (status != ER_OK) {
+        running = false;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
+
+QStatus _LocalEndpoint::Dispatcher::Stop()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    running = false;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (workers[i]) {
+            /* Stopping the thread alerts a handler that is blocked waiting on an event */
+            workers[i]->Stop();
+            WakeWorker(workers[i]);
+        }
+    }
+    queueNotFull.Broadcast();
+    lock.Unlock(MUTEX_CONTEXT);
+    return ER_OK;
+}
+
+QStatus _LocalEndpoint::Dispatcher::Join()
+{
+    Worker* current = CurrentWorker();
+
+    lock.Lock(MUTEX_CONTEXT);
+    std::vector<Worker*> joining;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (workers[i]) {
+            joining.push_back(workers[i]);
+        }
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+
+    /* A worker joining its own dispatcher returns to its handler so it is not waited for */
+    for (size_t i = 0; i < joining.size(); ++i) {
+        if (joining[i] != current) {
+            joining[i]->Join();
+        }
+    }
+
+    /*
+     * Messages still queued when the workers exit are discarded without being
+     * dispatched, as are any pending work requests.
+     */
+    lock.Lock(MUTEX_CONTEXT);
+    if (!running) {
+        while (!queue.empty()) {
+            delete queue.front().msg;
+            queue.pop_front();
+        }
+        numWorkers = 0;
+        for (size_t i = 0; i < workers.size(); ++i) {
+            while (!shards[i].empty()) {
+                delete shards[i].front().msg;
+                shards[i].pop_front();
+            }
+            Worker* worker = workers[i];
+            if (!worker) {
+                continue;
+            }
+            workers[i] = NULL;
+            /* The calling worker is still running so it is deleted by the destructor */
+            if (worker == current) {
+                worker->retired = true;
+                exitedWorkers.push_back(worker);
+            } else {
+                delete worker;
+            }
+        }
+        numLimitable = 0;
+        pendingWorkQueued = false;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return ER_OK;
+}
+
+_LocalEndpoint::Dispatcher::Worker* _LocalEndpoint::Dispatcher::CurrentWorker() const
+{
+    /*
+     * This is called on every message pushed to the local endpoint so it does
+     * not take the lock. A worker is published before it can run a handler and
+     * only a worker can find itself here, so a concurrent change to the worker
+     * list can never make another thread look like a worker.
+     */
+    Thread* thread = Thread::GetThread();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        Worker* worker = workers[i];
+        if (worker && (static_cast<Thread*>(worker) == thread)) {
+            return worker;
+        }
+    }
+    return NULL;
+}
+
+bool _LocalEndpoint::Dispatcher::StartWorker(uint32_t shard)
+{
+    Worker* worker = new Worker(this, name + "_" + U32ToString(shard), shard);
+    QStatus status = worker->Start();
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Failed to start dispatcher thread %s", worker->GetName()));
+        delete worker;
+        return false;
+    }
+    workers[shard] = worker;
+    ++numWorkers;
+    return true;
+}
+
+void _LocalEndpoint::Dispatcher::WakeWorker(Worker* worker)
+{
+    if (worker->idle) {
+        worker->idle = false;
+        --idleWorkers;
+    }
+    worker->workAvailable.Signal();
+}
+
+void _LocalEndpoint::Dispatcher::ScheduleWorker()
+{
+    /*
+     * Make sure there is a worker, other than those already running handlers,
+     * that will pick up the queued work.
+     */
+    if ((numWorkers - idleWorkers - busyWorkers) > 0) {
+        return;
+    }
+    if ((numWorkers > 0) && (queue.empty() || !running)) {
+        return;
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (workers[i] && workers[i]->idle) {
+            WakeWorker(workers[i]);
+            return;
+        }
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (!workers[i]) {
+            StartWorker(i);
+            return;
+        }
+    }
+}
+
+void _LocalEndpoint::Dispatcher::ScheduleShard(uint32_t shard)
+{
+    Worker* worker = workers[shard];
+    if (!worker) {
+        StartWorker(shard);
+    } else if (worker->idle) {
+        WakeWorker(worker);
+    }
+}
+
+bool _LocalEndpoint::Dispatcher::TakeNext(Worker* worker, WorkItem& item)
+{
+    std::deque<WorkItem>& shard = shards[worker->shard];
+    std::deque<WorkItem>& from = queue.empty() ? shard : queue;
+    if (from.empty()) {
+        return false;
+    }
+    item = from.front();
+    from.pop_front();
+    if (item.limitable) {
+        --numLimitable;
+        queueNotFull.Signal();
+    }
+    if (!item.msg) {
+        pendingWorkQueued = false;
+    }
+    return true;
+}
+
+void _LocalEndpoint::Dispatcher::WorkerRun(Worker* worker)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    while (running && !worker->retired) {
+        if (queue.empty() && shards[worker->shard].empty()) {
+            ++idleWorkers;
+            worker->idle = true;
+            worker->workAvailable.Wait(lock);
+            if (worker->idle) {
+                worker->idle = false;
+                --idleWorkers;
+            }
+            continue;
+        }
+        lock.Unlock(MUTEX_CONTEXT);
+
+        reentrancyLock.Lock(MUTEX_CONTEXT);
+        worker->hasReentrancyLock = true;
+
+        WorkItem item;
+        lock.Lock(MUTEX_CONTEXT);
+        bool found = running && !worker->retired && TakeNext(worker, item);
+        if (found) {
+            ++busyWorkers;
+            ScheduleWorker();
+        }
+        lock.Unlock(MUTEX_CONTEXT);
+
+        if (found) {
+            Execute(item);
+        }
+        if (worker->hasReentrancyLock) {
+            worker->hasReentrancyLock = false;
+            reentrancyLock.Unlock(MUTEX_CONTEXT);
+        }
+
+        lock.Lock(MUTEX_CONTEXT);
+        if (found) {
+            --busyWorkers;
+        }
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+QStatus _LocalEndpoint::Dispatcher::Enqueue(Message* msg, bool limitable)
+{
+    bool fromWorker = (CurrentWorker() != NULL);
+    lock.Lock(MUTEX_CONTEXT);
+    /*
+     * Wait for room if the queue is full. Handlers are never made to wait
+     * since the work they would be waiting for may need their worker.
+     */
+    if (limitable && !fromWorker) {
+        while (running && (numLimitable >= maxLimitable)) {
+            queueNotFull.Wait(lock);
+        }
+    }
+    if (!running) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return ER_BUS_STOPPING;
+    }
+    WorkItem item = { msg, limitable };
+    if (msg && (((*msg)->GetType() == MESSAGE_METHOD_CALL) || ((*msg)->GetType() == MESSAGE_SIGNAL))) {
+        uint32_t shard = qcc::hash_string((*msg)->GetSender()) % shards.size();
+        shards[shard].push_back(item);
+        ScheduleShard(shard);
+    } else {
+        queue.push_back(item);
+        ScheduleWorker();
+    }
+    if (limitable) {
+        ++numLimitable;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return ER_OK;
+}
+
+void _LocalEndpoint::Dispatcher::EnableReentrancy()
+{
+    Worker* worker = CurrentWorker();
+    if (worker) {
+        if (worker->hasReentrancyLock) {
+            worker->hasReentrancyLock = false;
+            reentrancyLock.Unlock(MUTEX_CONTEXT);
+        }
+    } else {
+        QCC_LogError(ER_BUS_NOT_ALLOWED, ("Invalid call to EnableReentrancy from thread %s", Thread::GetThreadName()));
+    }
+}
+
+bool _LocalEndpoint::Dispatcher::IsHoldingReentrantLock() const
+{
+    Worker* worker = CurrentWorker();
+    return worker && worker->hasReentrancyLock;
+}
+
+bool _LocalEndpoint::Dispatcher::IsDispatcherThread() const
+{
+    return CurrentWorker() != NULL;
+}
+
 LocalTransport::~LocalTransport()
 {
     Stop();
@@ -422,18 +801,12 @@ QStatus _LocalEndpoint::PeerInterface(Message& message)
 
 QStatus _LocalEndpoint::Dispatcher::DispatchMessage(Message& msg)
 {
-    uint32_t zero = 0;
-    void* context = new Message(msg);
-    qcc::AlarmListener* localEndpointListener = this;
+    Message* queued = new Message(msg);
     bool limitable = (endpoint->GetUniqueName() != msg->GetSender());
-    Alarm alarm(zero, localEndpointListener, context, zero, limitable);
 
-    QStatus status = AddAlarm(alarm);
+    QStatus status = Enqueue(queued, limitable);
     if (status != ER_OK) {
-        Message* temp = static_cast<Message*>(context);
-        if (temp) {
-            delete temp;
-        }
+        delete queued;
     }
     return status;
 }
@@ -464,16 +837,7 @@ void _LocalEndpoint::Dispatcher::TriggerDeferredCallbacks()
     needDeferredCallbacks = true;
     workLock.Unlock(MUTEX_CONTEXT);
 
-    /*
-     * Don't block while adding the alarm.
-     * First, we may be calling this method from within the context of a
-     * triggered Alarm. In this case a blocking AddAlarm is an instant
-     * deadlock.
-     * Second, AddAlarm would only block if the our alarm queue is already
-     * full. The work will be picked up by the first existing alarm that
-     * triggers anyway.
-     */
-    AddAlarmNonBlocking(pendingWork);
+    QueuePendingWork();
 }
 
 void _LocalEndpoint::Dispatcher::TriggerObserverWork()
@@ -486,16 +850,7 @@ void _LocalEndpoint::Dispatcher::TriggerObserverWork()
     needObserverWork = true;
     workLock.Unlock(MUTEX_CONTEXT);
 
-    /*
-     * Don't block while adding the alarm.
-     * First, we may be calling this method from within the context of a
-     * triggered Alarm. In this case a blocking AddAlarm is an instant
-     * deadlock.
-     * Second, AddAlarm would only block if the our alarm queue is already
-     * full. The work will be picked up by the first existing alarm that
-     * triggers anyway.
-     */
-    AddAlarmNonBlocking(pendingWork);
+    QueuePendingWork();
 }
 
 void _LocalEndpoint::Dispatcher::TriggerCachedPropertyReplyWork()
@@ -508,16 +863,28 @@ void _LocalEndpoint::Dispatcher::TriggerCachedPropertyReplyWork()
     needCachedPropertyReplyWork = true;
     workLock.Unlock(MUTEX_CONTEXT);
 
+    QueuePendingWork();
+}
+
+void _LocalEndpoint::Dispatcher::QueuePendingWork()
+{
     /*
-     * Don't block while adding the alarm.
-     * First, we may be calling this method from within the context of a
-     * triggered Alarm. In this case a blocking AddAlarm is an instant
-     * deadlock.
-     * Second, AddAlarm would only block if the our alarm queue is already
-     * full. The work will be picked up by the first existing alarm that
-     * triggers anyway.
+     * Pending work is never subject to the queue limit so this does not block
+     * when called from within a handler. The work is also picked up by the
+     * next queued message, so a single request in the queue is sufficient.
      */
-    AddAlarmNonBlocking(pendingWork);
+    lock.Lock(MUTEX_CONTEXT);
+    if (running && !pendingWorkQueued) {
+        pendingWorkQueued = true;
+        lock.Unlock(MUTEX_CONTEXT);
+        if (Enqueue(NULL, false) != ER_OK) {
+            lock.Lock(MUTEX_CONTEXT);
+            pendingWorkQueued = false;
+            lock.Unlock(MUTEX_CONTEXT);
+        }
+        return;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
 }
 
 void _LocalEndpoint::Dispatcher::PerformDeferredCallbacks()
@@ -574,26 +941,20 @@ void _LocalEndpoint::Dispatcher::PerformCachedPropertyReplyWork()
     endpoint->replyMapLock.Unlock(MUTEX_CONTEXT);
 }
 
-void _LocalEndpoint::Dispatcher::AlarmTriggered(const Alarm& alarm, QStatus reason)
+void _LocalEndpoint::Dispatcher::Execute(WorkItem& item)
 {
     /* first deal with incoming messages */
-    Message* msg = static_cast<Message*>(alarm->GetContext());
+    Message* msg = item.msg;
     if (msg) {
-        if (reason == ER_OK) {
-            QStatus status = endpoint->DoPushMessage(*msg);
-            // ER_BUS_STOPPING is a common shutdown error
-            if (status != ER_OK && status != ER_BUS_STOPPING) {
-                QCC_LogError(status, ("LocalEndpoint::DoPushMessage failed"));
-            }
+        QStatus status = endpoint->DoPushMessage(*msg);
+        // ER_BUS_STOPPING is a common shutdown error
+        if (status != ER_OK && status != ER_BUS_STOPPING) {
+            QCC_LogError(status, ("LocalEndpoint::DoPushMessage failed"));
         }
         delete msg;
     }
 
     /* next, deal with any pending work */
-    if (reason != ER_OK) {
-        return;
-    }
-
     workLock.Lock(MUTEX_CONTEXT);
 
     if (needObserverWork) {
@@ -630,7 +991,7 @@ QStatus _LocalEndpoint::PushMessage(Message& message)
     if (running) {
         BusEndpoint ep = bus->GetInternal().GetRouter().FindEndpoint(message->GetSender());
         /* Determine if the source of this message is local to the process */
-        if ((ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL) && (dispatcher->IsTimerCallbackThread())) {
+        if ((ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL) && (dispatcher->IsDispatcherThread())) {
             ret = DoPushMessage(message);
         } else {
             ret = dispatcher->DispatchMessage(message);
@@ -1014,7 +1375,8 @@ bool _LocalEndpoint::ResumeReplyHandlerTimeout(Message& methodCallMsg)
 QStatus _LocalEndpoint::RegisterSignalHandler(MessageReceiver* receiver,
                                               MessageReceiver::SignalHandler signalHandler,
                                               const InterfaceDescription::Member* member,
-                                              const char* matchRule)
+                                              const char* matchRule,
+                                              bool cursor)
 {
     if (!receiver) {
         return ER_BAD_ARG_1;
@@ -1028,7 +1390,7 @@ QStatus _LocalEndpoint::RegisterSignalHandler(MessageReceiver* receiver,
     if (!matchRule) {
         return ER_BAD_ARG_4;
     }
-    signalTable.Add(receiver, signalHandler, member, matchRule);
+    signalTable.Add(receiver, signalHandler, member, matchRule, cursor);
     return ER_OK;
 }
 
@@ -1216,7 +1578,11 @@ QStatus _LocalEndpoint::HandleMethodCall(Message& message)
             }
         }
         if (status == ER_OK) {
-            status = message->UnmarshalArgs(entry->member->signature, entry->member->returnSignature.c_str());
+            if (entry->cursor && !message->IsEncrypted()) {
+                status = message->CheckArgsSignature(entry->member->signature, entry->member->returnSignature.c_str());
+            } else {
+                status = message->UnmarshalArgs(entry->member->signature, entry->member->returnSignature.c_str());
+            }
         }
     }
     if (status == ER_OK) {
@@ -1315,8 +1681,10 @@ QStatus _LocalEndpoint::HandleSignal(Message& message)
      */
     list<SignalTable::Entry> callList;
     const InterfaceDescription::Member* signal = range.first->second.member;
+    bool cursor = false;
     do {
         if (range.first->second.rule.IsMatch(message)) {
+            cursor = (callList.empty() || cursor) && range.first->second.cursor;
             callList.push_back(range.first->second);
         }
     } while (++range.first != range.second);
@@ -1330,6 +1698,12 @@ QStatus _LocalEndpoint::HandleSignal(Message& message)
     if (signal->iface->IsSecure() && !message->IsEncrypted()) {
         status = ER_BUS_MESSAGE_NOT_ENCRYPTED;
         QCC_LogError(status, ("Signal from secure interface was not encrypted"));
+    } else if (cursor && !message->IsEncrypted()) {
+        /*
+         * All the handlers read the arguments with a MessageCursor so there is no need to
+         * unmarshal them.
+         */
+        status = message->CheckArgsSignature(signal->signature);
     } else {
         status = message->UnmarshalArgs(signal->signature);
     }
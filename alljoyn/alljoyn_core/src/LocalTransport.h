@@ -192,6 +192,7 @@ class _LocalEndpoint : public _BusEndpoint, public qcc::AlarmListener, public Me
      * @param signalHandler  The signal handler method.
      * @param member         Interface/member of signal.
      * @param matchRule      A filter rule.
+     * @param cursor         True if the signal handler reads the arguments with a MessageCursor.
      * @return
      *      - ER_OK if successful
      *      - An error status otherwise
@@ -199,7 +200,8 @@ class _LocalEndpoint : public _BusEndpoint, public qcc::AlarmListener, public Me
     QStatus RegisterSignalHandler(MessageReceiver* receiver,
                                   MessageReceiver::SignalHandler signalHandler,
                                   const InterfaceDescription::Member* member,
-                                  const char* matchRule);
+                                  const char* matchRule,
+                                  bool cursor = false);
 
     /**
      * Un-Register a signal handler.
@@ -40,6 +40,7 @@
 #include "BusInternal.h"
 #include "BusUtil.h"
 #include "PermissionMgmtObj.h"
+#include "MessageBufferPool.h"
 
 #define QCC_MODULE "ALLJOYN"
 
@@ -347,7 +348,7 @@ void _Message::Init(BusAttachment& busAttachment)
 
 _Message::~_Message(void)
 {
-    delete [] _msgBuf;
+    MessageBufferPool::Free(_msgBuf);
     delete [] msgArgs;
     while (numHandles) {
         qcc::Close(handles[--numHandles]);
@@ -381,7 +382,7 @@ _Message::_Message(const _Message& other) :
 {
     if (bufSize > 0) {
         assert(other.msgBuf != NULL);
-        _msgBuf = new uint8_t[bufSize + 7];
+        _msgBuf = MessageBufferPool::Alloc(bufSize + 7);
         msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7);
         bufEOD = ((uint8_t*)msgBuf) + (other.bufEOD - ((uint8_t*)other.msgBuf));
         bufPos = ((uint8_t*)msgBuf) + (other.bufPos - ((uint8_t*)other.msgBuf));
@@ -442,20 +443,32 @@ QStatus _Message::ReMarshal(const char* senderName)
     numRefMsgArgs = 0;
 
     /*
-     * We delete the current buffer after we have copied the body data
+     * Compute the new header sizes
      */
-    uint8_t* _savBuf = _msgBuf;
+    size_t hdrRegionLen = ComputeHeaderLen();
 
     /*
-     * Compute the new header sizes
+     * If there is room in front of the body for the new header we only need to rewrite the
+     * header, the body stays where it is.
+     */
+    if (msgBuf && bodyPtr) {
+        uint8_t* bufStart = (uint8_t*)((uintptr_t)(_msgBuf + 7) & ~7);
+        if ((size_t)(bodyPtr - bufStart) >= hdrRegionLen) {
+            return ReMarshalHeader(hdrRegionLen);
+        }
+    }
+
+    /*
+     * We delete the current buffer after we have copied the body data
      */
-    ComputeHeaderLen();
+    uint8_t* _savBuf = _msgBuf;
+
     /*
      * Padding the end of the buffer ensures we can unmarshal a few bytes beyond the end of the
      * message reducing the places where we need to check for bufEOD when unmarshaling the body.
      */
     bufSize = sizeof(msgHeader) + ((((msgHeader.headerLen + 7) & ~7) + msgHeader.bodyLen + 7) & ~7) + 8;
-    _msgBuf = new uint8_t[bufSize + 7];
+    _msgBuf = MessageBufferPool::Alloc(bufSize + 7);
     msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7); /* Align to 8 byte boundary */
     bufPos = (uint8_t*)msgBuf;
     memcpy(bufPos, &msgHeader, sizeof(msgHeader));
@@ -488,7 +501,60 @@ QStatus _Message::ReMarshal(const char* senderName)
      */
     assert((size_t)(bufEOD - (uint8_t*)msgBuf) < bufSize);
     memset(bufEOD, 0, (uint8_t*)msgBuf + bufSize - bufEOD);
-    delete [] _savBuf;
+    MessageBufferPool::Free(_savBuf);
+    return ER_OK;
+}
+
+QStatus _Message::ReMarshalHeader(size_t hdrRegionLen)
+{
+    uint8_t* bufEnd = (uint8_t*)msgBuf + bufSize;
+    /*
+     * The marshaled header fields point into the current header which the new header is going to
+     * overwrite so the new header is built in a scratch buffer and then copied into place.
+     */
+    uint8_t* scratch = MessageBufferPool::Alloc(hdrRegionLen);
+    msgBuf = (uint64_t*)scratch;
+    bufPos = scratch;
+    memcpy(bufPos, &msgHeader, sizeof(msgHeader));
+    bufPos += sizeof(msgHeader);
+    if (endianSwap) {
+        MessageHeader* hdr = (MessageHeader*)msgBuf;
+        hdr->bodyLen = EndianSwap32(hdr->bodyLen);
+        hdr->serialNum = EndianSwap32(hdr->serialNum);
+        hdr->headerLen = EndianSwap32(hdr->headerLen);
+    }
+    MarshalHeaderFields();
+    assert((size_t)(bufPos - scratch) == hdrRegionLen);
+    /*
+     * Move the header in front of the body and relocate the field strings to match.
+     */
+    msgBuf = (uint64_t*)(bodyPtr - hdrRegionLen);
+    memcpy(msgBuf, scratch, hdrRegionLen);
+    for (uint32_t fieldId = ALLJOYN_HDR_FIELD_PATH; fieldId < ArraySize(hdrFields.field); fieldId++) {
+        MsgArg* field = &hdrFields.field[fieldId];
+        switch (field->typeId) {
+        case ALLJOYN_SIGNATURE:
+            field->v_signature.sig = (char*)msgBuf + (field->v_signature.sig - (char*)scratch);
+            break;
+
+        case ALLJOYN_OBJECT_PATH:
+        case ALLJOYN_STRING:
+            field->v_string.str = (char*)msgBuf + (field->v_string.str - (char*)scratch);
+            break;
+
+        default:
+            break;
+        }
+    }
+    MessageBufferPool::Free(scratch);
+    bufSize = bufEnd - (uint8_t*)msgBuf;
+    bufPos = bodyPtr + msgHeader.bodyLen;
+    bufEOD = bufPos;
+    /*
+     * Zero fill the pad at the end of the buffer
+     */
+    assert((size_t)(bufEOD - (uint8_t*)msgBuf) < bufSize);
+    memset(bufEOD, 0, bufEnd - bufEOD);
     return ER_OK;
 }
 
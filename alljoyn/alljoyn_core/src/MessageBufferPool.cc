@@ -0,0 +1,203 @@
+/**
+ * @file
+ *
+ * This file implements the pool that message buffers are allocated from.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <qcc/Debug.h>
+#include <qcc/Mutex.h>
+
+#include <alljoyn/Message.h>
+
+#include "MessageBufferPool.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+
+namespace ajn {
+
+/*
+ * Every buffer is preceded by a small header recording the size class it
+ * belongs to so that Free() does not need to be told the size.  The header is
+ * 8 bytes to preserve the alignment of the memory returned by new.
+ */
+static const size_t BUF_HEADER_LEN = 8;
+
+/* Size class recorded in buffers that were not allocated from a free list */
+static const uint32_t OVERSIZE_CLASS = 0xFFFFFFFF;
+
+MessageBufferPool* MessageBufferPool::pool = NULL;
+
+MessageBufferPool::MessageBufferPool() : oversizeAllocs(0), oversizeFrees(0)
+{
+    assert((ALLJOYN_MAX_PACKET_LEN + 1024) <= (static_cast<size_t>(1) << MAX_SHIFT));
+    for (uint32_t c = 0; c < NUM_CLASSES; ++c) {
+        size_t classSize = static_cast<size_t>(1) << (c + MIN_SHIFT);
+        classes[c].maxCached = (classSize < MAX_CACHED_BYTES) ? (MAX_CACHED_BYTES / classSize) : 1;
+        classes[c].freeList.reserve(classes[c].maxCached);
+        classes[c].allocs = 0;
+        classes[c].hits = 0;
+        classes[c].frees = 0;
+        classes[c].released = 0;
+    }
+}
+
+MessageBufferPool::~MessageBufferPool()
+{
+    for (uint32_t c = 0; c < NUM_CLASSES; ++c) {
+        for (std::vector<uint8_t*>::iterator it = classes[c].freeList.begin(); it != classes[c].freeList.end(); ++it) {
+            delete [] *it;
+        }
+    }
+}
+
+uint8_t* MessageBufferPool::Alloc(size_t size)
+{
+    MessageBufferPool* p = pool;
+    uint32_t c = 0;
+    size_t need = size + BUF_HEADER_LEN;
+    while ((c < NUM_CLASSES) && ((static_cast<size_t>(1) << (c + MIN_SHIFT)) < need)) {
+        ++c;
+    }
+    uint8_t* raw = NULL;
+    if (p && (c < NUM_CLASSES)) {
+        SizeClass& sc = p->classes[c];
+        sc.lock.Lock(MUTEX_CONTEXT);
+        ++sc.allocs;
+        if (!sc.freeList.empty()) {
+            raw = sc.freeList.back();
+            sc.freeList.pop_back();
+            ++sc.hits;
+        }
+        sc.lock.Unlock(MUTEX_CONTEXT);
+        if (!raw) {
+            raw = new uint8_t[static_cast<size_t>(1) << (c + MIN_SHIFT)];
+        }
+    } else {
+        if (p) {
+            p->oversizeLock.Lock(MUTEX_CONTEXT);
+            ++p->oversizeAllocs;
+            p->oversizeLock.Unlock(MUTEX_CONTEXT);
+        }
+        c = OVERSIZE_CLASS;
+        raw = new uint8_t[need];
+    }
+    *reinterpret_cast<uint32_t*>(raw) = c;
+    return raw + BUF_HEADER_LEN;
+}
+
+void MessageBufferPool::Free(uint8_t* buf)
+{
+    if (!buf) {
+        return;
+    }
+    uint8_t* raw = buf - BUF_HEADER_LEN;
+    uint32_t c = *reinterpret_cast<uint32_t*>(raw);
+    MessageBufferPool* p = pool;
+    if (p && (c < NUM_CLASSES)) {
+        SizeClass& sc = p->classes[c];
+        sc.lock.Lock(MUTEX_CONTEXT);
+        ++sc.frees;
+        if (sc.freeList.size() < sc.maxCached) {
+            sc.freeList.push_back(raw);
+            raw = NULL;
+        } else {
+            ++sc.released;
+        }
+        sc.lock.Unlock(MUTEX_CONTEXT);
+    } else if (p) {
+        p->oversizeLock.Lock(MUTEX_CONTEXT);
+        ++p->oversizeFrees;
+        p->oversizeLock.Unlock(MUTEX_CONTEXT);
+    }
+    delete [] raw;
+}
+
+void MessageBufferPool::GetStats(Stats& stats)
+{
+    memset(&stats, 0, sizeof(stats));
+    MessageBufferPool* p = pool;
+    if (!p) {
+        return;
+    }
+    for (uint32_t c = 0; c < NUM_CLASSES; ++c) {
+        SizeClass& sc = p->classes[c];
+        sc.lock.Lock(MUTEX_CONTEXT);
+        stats.allocs += sc.allocs;
+        stats.hits += sc.hits;
+        stats.frees += sc.frees;
+        stats.released += sc.released;
+        stats.cachedBuffers += sc.freeList.size();
+        stats.cachedBytes += sc.freeList.size() << (c + MIN_SHIFT);
+        sc.lock.Unlock(MUTEX_CONTEXT);
+    }
+    p->oversizeLock.Lock(MUTEX_CONTEXT);
+    stats.allocs += p->oversizeAllocs;
+    stats.frees += p->oversizeFrees;
+    stats.released += p->oversizeFrees;
+    p->oversizeLock.Unlock(MUTEX_CONTEXT);
+    stats.misses = stats.allocs - stats.hits;
+}
+
+void MessageBufferPool::Trim()
+{
+    MessageBufferPool* p = pool;
+    if (!p) {
+        return;
+    }
+    for (uint32_t c = 0; c < NUM_CLASSES; ++c) {
+        SizeClass& sc = p->classes[c];
+        std::vector<uint8_t*> freeList;
+        sc.lock.Lock(MUTEX_CONTEXT);
+        freeList.swap(sc.freeList);
+        sc.lock.Unlock(MUTEX_CONTEXT);
+        for (std::vector<uint8_t*>::iterator it = freeList.begin(); it != freeList.end(); ++it) {
+            delete [] *it;
+        }
+    }
+}
+
+void MessageBufferPool::Init()
+{
+    if (!pool) {
+        pool = new MessageBufferPool();
+    }
+}
+
+void MessageBufferPool::Shutdown()
+{
+    MessageBufferPool* p = pool;
+    if (p) {
+        MessageBufferPool::Stats stats;
+        GetStats(stats);
+        QCC_DbgPrintf(("MessageBufferPool: %llu allocs %llu hits %llu frees %llu released",
+                       (unsigned long long)stats.allocs, (unsigned long long)stats.hits,
+                       (unsigned long long)stats.frees, (unsigned long long)stats.released));
+        pool = NULL;
+        delete p;
+    }
+}
+
+}
@@ -0,0 +1,145 @@
+#ifndef _ALLJOYN_MESSAGEBUFFERPOOL_H
+#define _ALLJOYN_MESSAGEBUFFERPOOL_H
+/**
+ * @file
+ *
+ * This file defines the pool that message buffers are allocated from.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include MessageBufferPool.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+#include <qcc/Mutex.h>
+
+#include <vector>
+
+namespace ajn {
+
+/**
+ * Recycles the buffers that marshaled and unmarshaled messages are held in.
+ *
+ * Buffers are grouped into power-of-two size classes large enough for any
+ * message up to ALLJOYN_MAX_PACKET_LEN.  A freed buffer goes onto the free
+ * list for its size class and is handed out again by the next allocation of
+ * that class, so once the pool has warmed up a message stream of steady size
+ * does not touch the heap.  Each size class has its own lock; buffers are
+ * routinely allocated on one thread (e.g. an endpoint's rx thread) and freed
+ * on another, so the free lists are shared rather than per-thread.
+ *
+ * The number of bytes cached in each size class is bounded; buffers freed
+ * once a class is full, and requests too large for any class, go straight
+ * back to (or come straight from) the heap.
+ */
+class MessageBufferPool {
+  public:
+
+    /**
+     * Counters describing how well the pool is doing.
+     */
+    struct Stats {
+        uint64_t allocs;        ///< Number of calls to Alloc()
+        uint64_t hits;          ///< Allocations satisfied from a free list
+        uint64_t misses;        ///< Allocations that went to the heap
+        uint64_t frees;         ///< Number of calls to Free()
+        uint64_t released;      ///< Frees that went back to the heap because the free list was full
+        size_t cachedBuffers;   ///< Buffers currently held on the free lists
+        size_t cachedBytes;     ///< Bytes currently held on the free lists
+    };
+
+    /**
+     * Allocate a message buffer.  The pointer returned is 8 byte aligned.
+     *
+     * @param size  Number of bytes required.
+     *
+     * @return  A buffer of at least size bytes that must be released with Free().
+     */
+    static uint8_t* Alloc(size_t size);
+
+    /**
+     * Release a buffer obtained from Alloc().
+     *
+     * @param buf  The buffer to release, may be NULL.
+     */
+    static void Free(uint8_t* buf);
+
+    /**
+     * Get a snapshot of the pool counters.
+     *
+     * @param[out] stats  Returns the counters.
+     */
+    static void GetStats(Stats& stats);
+
+    /**
+     * Release every cached buffer back to the heap.  The counters are not
+     * reset.
+     */
+    static void Trim();
+
+    /**
+     * Create the pool.  Until this is called, and after Shutdown(), Alloc()
+     * and Free() go directly to the heap.
+     */
+    static void Init();
+
+    /**
+     * Destroy the pool.
+     */
+    static void Shutdown();
+
+  private:
+
+    /** Smallest size class is 1 << MIN_SHIFT bytes */
+    static const uint32_t MIN_SHIFT = 8;
+
+    /** Largest size class is 1 << MAX_SHIFT bytes, enough for ALLJOYN_MAX_PACKET_LEN plus header */
+    static const uint32_t MAX_SHIFT = 18;
+
+    /** Number of size classes */
+    static const uint32_t NUM_CLASSES = MAX_SHIFT - MIN_SHIFT + 1;
+
+    /** Upper bound on the bytes cached in each size class */
+    static const size_t MAX_CACHED_BYTES = 1024 * 1024;
+
+    /** Free list for one size class */
+    struct SizeClass {
+        qcc::Mutex lock;
+        std::vector<uint8_t*> freeList;
+        size_t maxCached;
+        uint64_t allocs;
+        uint64_t hits;
+        uint64_t frees;
+        uint64_t released;
+    };
+
+    MessageBufferPool();
+    ~MessageBufferPool();
+
+    SizeClass classes[NUM_CLASSES];
+    qcc::Mutex oversizeLock;
+    uint64_t oversizeAllocs;
+    uint64_t oversizeFrees;
+
+    static MessageBufferPool* pool;
+};
+
+}
+
+#endif
@@ -0,0 +1,642 @@
+/**
+ * @file
+ *
+ * This file implements a cursor for reading message arguments directly from the message body.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <string.h>
+
+#include <qcc/String.h>
+#include <qcc/Util.h>
+
+#include <alljoyn/Message.h>
+#include <alljoyn/MessageCursor.h>
+#include <alljoyn/MsgArg.h>
+
+#include "SignatureUtils.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+
+namespace ajn {
+
+static inline uint16_t Read16(const uint8_t* ptr, bool swap)
+{
+    uint16_t v = *((const uint16_t*)ptr);
+    return swap ? EndianSwap16(v) : v;
+}
+
+static inline uint32_t Read32(const uint8_t* ptr, bool swap)
+{
+    uint32_t v = *((const uint32_t*)ptr);
+    return swap ? EndianSwap32(v) : v;
+}
+
+static inline uint64_t Read64(const uint8_t* ptr, bool swap)
+{
+    uint64_t v = *((const uint64_t*)ptr);
+    return swap ? EndianSwap64(v) : v;
+}
+
+static inline bool IsScalar(AllJoynTypeId typeId)
+{
+    switch (typeId) {
+    case ALLJOYN_BYTE:
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+    case ALLJOYN_BOOLEAN:
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_INT64:
+    case ALLJOYN_UINT64:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+MessageCursor::MessageCursor() :
+    message(NULL),
+    pos(NULL),
+    end(NULL),
+    sig(""),
+    sigStart(sig),
+    sigEnd(sig),
+    isArray(false),
+    endianSwap(false),
+    status(ER_OK)
+{
+}
+
+MessageCursor::MessageCursor(const Message& msg) :
+    message(msg.unwrap()),
+    pos(NULL),
+    end(NULL),
+    sig(""),
+    sigStart(sig),
+    sigEnd(sig),
+    isArray(false),
+    endianSwap(false),
+    status(ER_OK)
+{
+    if ((message->msgHeader.msgType == MESSAGE_INVALID) || !message->msgBuf) {
+        status = ER_FAIL;
+    } else if (message->IsEncrypted() && !message->msgArgs) {
+        /*
+         * The body is decrypted in place by UnmarshalArgs
+         */
+        status = ER_BUS_NOT_ALLOWED;
+    } else {
+        sig = message->GetSignature();
+        sigStart = sig;
+        sigEnd = sig + strlen(sig);
+        if (message->bodyPtr) {
+            pos = message->bodyPtr;
+            end = pos + message->msgHeader.bodyLen;
+        }
+        /*
+         * UnmarshalArgs changes the endianness recorded in msgHeader but not the body itself so
+         * use the header in the buffer which matches the body.
+         */
+        endianSwap = ((const _Message::MessageHeader*)message->msgBuf)->endian != _Message::myEndian;
+    }
+}
+
+bool MessageCursor::AtEnd() const
+{
+    return isArray ? (pos >= end) : (sig >= sigEnd);
+}
+
+AllJoynTypeId MessageCursor::GetTypeId() const
+{
+    if ((status != ER_OK) || AtEnd()) {
+        return ALLJOYN_INVALID;
+    }
+    switch (*sig) {
+    case ALLJOYN_STRUCT_OPEN:
+        return ALLJOYN_STRUCT;
+
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        return ALLJOYN_DICT_ENTRY;
+
+    default:
+        return (AllJoynTypeId)(*sig);
+    }
+}
+
+qcc::String MessageCursor::GetSignature() const
+{
+    if (isArray) {
+        return qcc::String(sigStart, sigEnd - sigStart);
+    } else {
+        return qcc::String(sig, sigEnd - sig);
+    }
+}
+
+QStatus MessageCursor::ReadBasic(MsgArg& arg, AllJoynTypeId typeId, const uint8_t*& ptr) const
+{
+    switch (typeId) {
+    case ALLJOYN_BYTE:
+        if (ptr >= end) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        arg.v_byte = *ptr++;
+        break;
+
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+        ptr = AlignPtr(ptr, 2);
+        if ((end - ptr) < 2) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        arg.v_uint16 = Read16(ptr, endianSwap);
+        ptr += 2;
+        break;
+
+    case ALLJOYN_BOOLEAN:
+        {
+            ptr = AlignPtr(ptr, 4);
+            if ((end - ptr) < 4) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            uint32_t v = Read32(ptr, endianSwap);
+            if (v > 1) {
+                return ER_BUS_BAD_VALUE;
+            }
+            arg.v_bool = (v == 1);
+            ptr += 4;
+        }
+        break;
+
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+        ptr = AlignPtr(ptr, 4);
+        if ((end - ptr) < 4) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        arg.v_uint32 = Read32(ptr, endianSwap);
+        ptr += 4;
+        break;
+
+    case ALLJOYN_HANDLE:
+        {
+            ptr = AlignPtr(ptr, 4);
+            if ((end - ptr) < 4) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            uint32_t index = Read32(ptr, endianSwap);
+            const MsgArg& numHandles = message->hdrFields.field[ALLJOYN_HDR_FIELD_HANDLES];
+            if ((numHandles.typeId == ALLJOYN_INVALID) || (index >= numHandles.v_uint32)) {
+                return ER_BUS_NO_SUCH_HANDLE;
+            }
+            arg.v_handle.fd = message->handles[index];
+            ptr += 4;
+        }
+        break;
+
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_UINT64:
+    case ALLJOYN_INT64:
+        ptr = AlignPtr(ptr, 8);
+        if ((end - ptr) < 8) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        arg.v_uint64 = Read64(ptr, endianSwap);
+        ptr += 8;
+        break;
+
+    case ALLJOYN_OBJECT_PATH:
+    case ALLJOYN_STRING:
+        {
+            ptr = AlignPtr(ptr, 4);
+            if ((end - ptr) < 4) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            size_t len = Read32(ptr, endianSwap);
+            ptr += 4;
+            if ((ptrdiff_t)len >= (end - ptr)) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            if (ptr[len] != 0) {
+                return ER_BUS_NOT_NUL_TERMINATED;
+            }
+            arg.v_string.len = len;
+            arg.v_string.str = (const char*)ptr;
+            ptr += len + 1;
+        }
+        break;
+
+    case ALLJOYN_SIGNATURE:
+        {
+            if (ptr >= end) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            size_t len = *ptr++;
+            if ((ptrdiff_t)len >= (end - ptr)) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            if (ptr[len] != 0) {
+                return ER_BUS_NOT_NUL_TERMINATED;
+            }
+            arg.v_signature.len = len;
+            arg.v_signature.sig = (const char*)ptr;
+            ptr += len + 1;
+        }
+        break;
+
+    default:
+        return ER_BUS_BAD_VALUE_TYPE;
+    }
+    arg.typeId = typeId;
+    return ER_OK;
+}
+
+QStatus MessageCursor::ReadArrayBounds(const char* elemSig, const uint8_t*& ptr, const uint8_t*& dataEnd) const
+{
+    size_t alignment = SignatureUtils::AlignmentForType((AllJoynTypeId)(*elemSig));
+    if (alignment == 0) {
+        return ER_BUS_BAD_SIGNATURE;
+    }
+    ptr = AlignPtr(ptr, 4);
+    if ((end - ptr) < 4) {
+        return ER_BUS_BAD_LENGTH;
+    }
+    uint32_t len = Read32(ptr, endianSwap);
+    ptr += 4;
+    /*
+     * The array length does not include the pad bytes between the length and the first element
+     */
+    ptr = AlignPtr(ptr, alignment);
+    if ((len > ALLJOYN_MAX_ARRAY_LEN) || ((end - ptr) < (ptrdiff_t)len)) {
+        return ER_BUS_BAD_LENGTH;
+    }
+    dataEnd = ptr + len;
+    return ER_OK;
+}
+
+QStatus MessageCursor::ReadScalarArray(MsgArg& arg, AllJoynTypeId elemTypeId, const uint8_t*& ptr) const
+{
+    const char elemSig[2] = { (char)elemTypeId, 0 };
+    const uint8_t* dataEnd;
+    QStatus status = ReadArrayBounds(elemSig, ptr, dataEnd);
+    if (status != ER_OK) {
+        return status;
+    }
+    size_t len = dataEnd - ptr;
+    size_t num;
+
+    switch (elemTypeId) {
+    case ALLJOYN_BYTE:
+        num = len;
+        arg.v_scalarArray.v_byte = ptr;
+        break;
+
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+        if (len & 1) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        num = len / 2;
+        if (endianSwap && num) {
+            uint16_t* swapped = new uint16_t[num];
+            EndianSwapArray16(swapped, (const uint16_t*)ptr, num);
+            arg.v_scalarArray.v_uint16 = swapped;
+            arg.SetOwnershipFlags(MsgArg::OwnsData);
+        } else {
+            arg.v_scalarArray.v_uint16 = (const uint16_t*)ptr;
+        }
+        break;
+
+    case ALLJOYN_BOOLEAN:
+        {
+            if (len & 3) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            num = len / 4;
+            bool* bools = new bool[num];
+            for (size_t i = 0; i < num; i++) {
+                uint32_t b = Read32(ptr + i * 4, endianSwap);
+                if (b > 1) {
+                    delete [] bools;
+                    return ER_BUS_BAD_VALUE;
+                }
+                bools[i] = (b == 1);
+            }
+            arg.v_scalarArray.v_bool = bools;
+            arg.SetOwnershipFlags(MsgArg::OwnsData);
+        }
+        break;
+
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+        if (len & 3) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        num = len / 4;
+        if (endianSwap && num) {
+            uint32_t* swapped = new uint32_t[num];
+            EndianSwapArray32(swapped, (const uint32_t*)ptr, num);
+            arg.v_scalarArray.v_uint32 = swapped;
+            arg.SetOwnershipFlags(MsgArg::OwnsData);
+        } else {
+            arg.v_scalarArray.v_uint32 = (const uint32_t*)ptr;
+        }
+        break;
+
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_INT64:
+    case ALLJOYN_UINT64:
+        if (len & 7) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        num = len / 8;
+        if (endianSwap && num) {
+            uint64_t* swapped = new uint64_t[num];
+            EndianSwapArray64(swapped, (const uint64_t*)ptr, num);
+            arg.v_scalarArray.v_uint64 = swapped;
+            arg.SetOwnershipFlags(MsgArg::OwnsData);
+        } else {
+            arg.v_scalarArray.v_uint64 = (const uint64_t*)ptr;
+        }
+        break;
+
+    default:
+        return ER_BUS_BAD_VALUE_TYPE;
+    }
+    arg.typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
+    arg.v_scalarArray.numElements = num;
+    ptr = dataEnd;
+    return ER_OK;
+}
+
+QStatus MessageCursor::ReadVariantSignature(const uint8_t*& ptr, const char*& variantSig, size_t& len) const
+{
+    if (ptr >= end) {
+        return ER_BUS_BAD_LENGTH;
+    }
+    len = *ptr++;
+    if ((ptrdiff_t)len >= (end - ptr)) {
+        return ER_BUS_BAD_LENGTH;
+    }
+    if (ptr[len] != 0) {
+        return ER_BUS_BAD_SIGNATURE;
+    }
+    variantSig = (const char*)ptr;
+    ptr += len + 1;
+    /*
+     * A variant must hold exactly one complete type
+     */
+    const char* s = variantSig;
+    if ((SignatureUtils::ParseCompleteType(s) != ER_OK) || (s != (variantSig + len))) {
+        return ER_BUS_BAD_SIGNATURE;
+    }
+    return ER_OK;
+}
+
+QStatus MessageCursor::SkipValue(const uint8_t*& ptr, const char*& sigPtr, bool arrayElem) const
+{
+    QStatus status = ER_OK;
+
+    switch (AllJoynTypeId typeId = (AllJoynTypeId)(*sigPtr)) {
+    case ALLJOYN_ARRAY:
+        {
+            const char* elemEnd = sigPtr;
+            status = SignatureUtils::ParseCompleteType(elemEnd);
+            if (status == ER_OK) {
+                const uint8_t* dataEnd;
+                status = ReadArrayBounds(sigPtr + 1, ptr, dataEnd);
+                if (status == ER_OK) {
+                    ptr = dataEnd;
+                    sigPtr = elemEnd;
+                }
+            }
+        }
+        break;
+
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        if (!arrayElem) {
+            status = ER_BUS_BAD_SIGNATURE;
+            break;
+        }
+
+    /* Falling through */
+    case ALLJOYN_STRUCT_OPEN:
+        ptr = AlignPtr(ptr, 8);
+        ++sigPtr;
+        while ((status == ER_OK) && (*sigPtr != ALLJOYN_STRUCT_CLOSE) && (*sigPtr != ALLJOYN_DICT_ENTRY_CLOSE)) {
+            if (*sigPtr == 0) {
+                status = ER_BUS_BAD_SIGNATURE;
+            } else {
+                status = SkipValue(ptr, sigPtr, false);
+            }
+        }
+        if (status == ER_OK) {
+            ++sigPtr;
+        }
+        break;
+
+    case ALLJOYN_VARIANT:
+        {
+            const char* variantSig;
+            size_t len;
+            status = ReadVariantSignature(ptr, variantSig, len);
+            if (status == ER_OK) {
+                status = SkipValue(ptr, variantSig, false);
+            }
+            if (status == ER_OK) {
+                ++sigPtr;
+            }
+        }
+        break;
+
+    default:
+        {
+            MsgArg arg;
+            status = ReadBasic(arg, typeId, ptr);
+            if (status == ER_OK) {
+                ++sigPtr;
+            }
+        }
+        break;
+    }
+    return status;
+}
+
+void MessageCursor::Advance(const uint8_t* ptr, const char* sigPtr)
+{
+    pos = ptr;
+    sig = sigPtr;
+    if (isArray && (sig >= sigEnd)) {
+        sig = sigStart;
+    }
+}
+
+QStatus MessageCursor::Fail(QStatus error)
+{
+    status = error;
+    QCC_LogError(status, ("Message arg parse error at or near %ld", (long)(pos - message->bodyPtr)));
+    return status;
+}
+
+QStatus MessageCursor::Get(MsgArg& arg)
+{
+    arg.Clear();
+    if (status != ER_OK) {
+        return status;
+    }
+    if (AtEnd()) {
+        return ER_EOF;
+    }
+    const uint8_t* ptr = pos;
+    const char* s = sig;
+    QStatus readStatus;
+
+    switch (AllJoynTypeId typeId = (AllJoynTypeId)(*s)) {
+    case ALLJOYN_STRUCT_OPEN:
+    case ALLJOYN_DICT_ENTRY_OPEN:
+    case ALLJOYN_VARIANT:
+        return ER_BUS_BAD_VALUE_TYPE;
+
+    case ALLJOYN_ARRAY:
+        if (!IsScalar((AllJoynTypeId)s[1])) {
+            /*
+             * Only arrays of scalars can be read in one go
+             */
+            return ER_BUS_BAD_VALUE_TYPE;
+        }
+        readStatus = ReadScalarArray(arg, (AllJoynTypeId)s[1], ptr);
+        s += 2;
+        break;
+
+    default:
+        readStatus = ReadBasic(arg, typeId, ptr);
+        ++s;
+        break;
+    }
+    if (readStatus != ER_OK) {
+        arg.Clear();
+        return Fail(readStatus);
+    }
+    Advance(ptr, s);
+    return ER_OK;
+}
+
+QStatus MessageCursor::Skip()
+{
+    if (status != ER_OK) {
+        return status;
+    }
+    if (AtEnd()) {
+        return ER_EOF;
+    }
+    const uint8_t* ptr = pos;
+    const char* s = sig;
+    QStatus skipStatus = SkipValue(ptr, s, isArray);
+    if (skipStatus != ER_OK) {
+        return Fail(skipStatus);
+    }
+    Advance(ptr, s);
+    return ER_OK;
+}
+
+QStatus MessageCursor::Recurse(MessageCursor& sub)
+{
+    if (status != ER_OK) {
+        return status;
+    }
+    if (AtEnd()) {
+        return ER_EOF;
+    }
+    const uint8_t* ptr = pos;
+    const char* s = sig;
+    QStatus recurseStatus = ER_OK;
+
+    sub.message = message;
+    sub.end = end;
+    sub.isArray = false;
+    sub.endianSwap = endianSwap;
+    sub.status = ER_OK;
+
+    switch (*s) {
+    case ALLJOYN_ARRAY:
+        {
+            const char* elemEnd = s;
+            const uint8_t* dataEnd = NULL;
+            recurseStatus = SignatureUtils::ParseCompleteType(elemEnd);
+            if (recurseStatus == ER_OK) {
+                recurseStatus = ReadArrayBounds(s + 1, ptr, dataEnd);
+            }
+            if (recurseStatus == ER_OK) {
+                sub.pos = ptr;
+                sub.end = dataEnd;
+                sub.sig = sub.sigStart = s + 1;
+                sub.sigEnd = elemEnd;
+                sub.isArray = true;
+                ptr = dataEnd;
+                s = elemEnd;
+            }
+        }
+        break;
+
+    case ALLJOYN_DICT_ENTRY_OPEN:
+    case ALLJOYN_STRUCT_OPEN:
+        {
+            const char* close = s;
+            recurseStatus = SignatureUtils::ParseCompleteType(close);
+            if (recurseStatus == ER_OK) {
+                sub.pos = AlignPtr(ptr, 8);
+                sub.sig = sub.sigStart = s + 1;
+                sub.sigEnd = close - 1;
+                recurseStatus = SkipValue(ptr, s, isArray);
+            }
+        }
+        break;
+
+    case ALLJOYN_VARIANT:
+        {
+            const char* variantSig;
+            size_t len;
+            recurseStatus = ReadVariantSignature(ptr, variantSig, len);
+            if (recurseStatus == ER_OK) {
+                sub.pos = ptr;
+                sub.sig = sub.sigStart = variantSig;
+                sub.sigEnd = variantSig + len;
+                recurseStatus = SkipValue(ptr, variantSig, false);
+                ++s;
+            }
+        }
+        break;
+
+    default:
+        return ER_BUS_BAD_VALUE_TYPE;
+    }
+    if (recurseStatus != ER_OK) {
+        sub.status = recurseStatus;
+        return Fail(recurseStatus);
+    }
+    Advance(ptr, s);
+    return ER_OK;
+}
+
+}
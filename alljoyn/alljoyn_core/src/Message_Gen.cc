@@ -42,6 +42,7 @@
 #include "AllJoynPeerObj.h"
 #include "SignatureUtils.h"
 #include "BusInternal.h"
+#include "MessageBufferPool.h"
 
 #define QCC_MODULE "ALLJOYN"
 
@@ -154,10 +155,12 @@ QStatus _Message::MarshalArgs(const MsgArg* arg, size_t numArgs)
                 /*
                  * Check elements conform to the expected signature type
                  */
+                const char* elemSig = arg->v_array.GetElemSig();
                 for (size_t i = 0; i < arg->v_array.numElements; i++) {
-                    if (!arg->v_array.elements[i].HasSignature(arg->v_array.GetElemSig())) {
+                    const char* sigPtr = elemSig;
+                    if (!SignatureUtils::MatchSignature(&arg->v_array.elements[i], sigPtr) || *sigPtr) {
                         status = ER_BUS_BAD_VALUE;
-                        QCC_LogError(status, ("Array element[%d] does not have expected signature \"%s\"", i, arg->v_array.GetElemSig()));
+                        QCC_LogError(status, ("Array element[%d] does not have expected signature \"%s\"", i, elemSig));
                         break;
                     }
                 }
@@ -528,10 +531,14 @@ QStatus _Message::Deliver(RemoteEndpoint& endpoint)
 }
 
 QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint)
+{
+    return DeliverNonBlocking(endpoint, endpoint->GetSink());
+}
+
+QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint, Sink& sink)
 {
     size_t pushed;
     QStatus status = ER_OK;
-    Sink& sink = endpoint->GetSink();
 
     switch (writeState) {
     case MESSAGE_NEW:
@@ -966,7 +973,7 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
      * Allocate buffer for entire message.
      */
     bufSize = (hdrLen + msgHeader.bodyLen + maxCryptoValsLen + 16);
-    _msgBuf = new uint8_t[bufSize];
+    _msgBuf = MessageBufferPool::Alloc(bufSize + 7);
     msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7); /* Align to 8 byte boundary */
     /*
      * Initialize the buffer and copy in the message header
@@ -1051,14 +1058,14 @@ ExitMarshalMessage:
     /*
      * Don't need the old message buffer any more
      */
-    delete [] _oldMsgBuf;
+    MessageBufferPool::Free(_oldMsgBuf);
 
     if (status == ER_OK) {
         QCC_DbgHLPrintf(("MarshalMessage: %d+%d %s %s", hdrLen, msgHeader.bodyLen, Description().c_str(), encrypt ? " (encrypted)" : ""));
     } else {
         QCC_LogError(status, ("MarshalMessage: %s", Description().c_str()));
         msgBuf = NULL;
-        delete [] _msgBuf;
+        MessageBufferPool::Free(_msgBuf);
         _msgBuf = NULL;
         bodyPtr = NULL;
         bufPos = NULL;
@@ -41,6 +41,7 @@
 #include "AllJoynPeerObj.h"
 #include "SignatureUtils.h"
 #include "BusInternal.h"
+#include "MessageBufferPool.h"
 
 #define QCC_MODULE "ALLJOYN"
 
@@ -117,13 +118,9 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 2);
             if (endianSwap) {
-                arg->v_scalarArray.v_uint16 = new uint16_t[arg->v_scalarArray.numElements];
-                uint16_t* p = (uint16_t*)arg->v_scalarArray.v_uint16;
-                uint16_t* n = (uint16_t*)bufPos;
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    *p++ = EndianSwap16(*n);
-                    n++;
-                }
+                uint16_t* swapped = new uint16_t[arg->v_scalarArray.numElements];
+                EndianSwapArray16(swapped, (const uint16_t*)bufPos, arg->v_scalarArray.numElements);
+                arg->v_scalarArray.v_uint16 = swapped;
                 arg->flags = MsgArg::OwnsData;
             } else {
                 arg->v_scalarArray.v_uint16 = (uint16_t*)bufPos;
@@ -175,13 +172,9 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 4);
             if (endianSwap) {
-                arg->v_scalarArray.v_uint32 = new uint32_t[arg->v_scalarArray.numElements];
-                uint32_t* p = (uint32_t*)arg->v_scalarArray.v_uint32;
-                uint32_t* n = (uint32_t*)bufPos;
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    *p++ = EndianSwap32(*n);
-                    n++;
-                }
+                uint32_t* swapped = new uint32_t[arg->v_scalarArray.numElements];
+                EndianSwapArray32(swapped, (const uint32_t*)bufPos, arg->v_scalarArray.numElements);
+                arg->v_scalarArray.v_uint32 = swapped;
                 arg->flags = MsgArg::OwnsData;
             } else {
                 arg->v_scalarArray.v_uint32 = (uint32_t*)bufPos;
@@ -201,13 +194,9 @@ QStatus _Message::ParseArray(MsgArg* arg,
             bufPos = AlignPtr(bufPos, 8);
             arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
             if (endianSwap) {
-                arg->v_scalarArray.v_uint64 = new uint64_t[arg->v_scalarArray.numElements];
-                uint64_t* p = (uint64_t*)arg->v_scalarArray.v_uint64;
-                uint64_t* n = (uint64_t*)bufPos;
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    *p++ = EndianSwap64(*n);
-                    n++;
-                }
+                uint64_t* swapped = new uint64_t[arg->v_scalarArray.numElements];
+                EndianSwapArray64(swapped, (const uint64_t*)bufPos, arg->v_scalarArray.numElements);
+                arg->v_scalarArray.v_uint64 = swapped;
                 arg->flags = MsgArg::OwnsData;
             } else {
                 arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
@@ -239,6 +228,16 @@ QStatus _Message::ParseArray(MsgArg* arg,
                  */
                 uint8_t* endOfArray = bufPos + len;
                 size_t capacity = 8;
+                /*
+                 * If the elements all have the same size we know how many there are and can avoid
+                 * growing the array, which copies every element parsed so far.
+                 */
+                size_t elemSize = SignatureUtils::GetFixedSize(elemSig.c_str());
+                if (elemSize) {
+                    size_t alignment = SignatureUtils::AlignmentForType((AllJoynTypeId)elemSig[0]);
+                    size_t stride = (elemSize + alignment - 1) & ~(alignment - 1);
+                    capacity = (len + stride - 1) / stride;
+                }
                 numElements = 0;
                 elements = new MsgArg[capacity];
                 /*
@@ -720,6 +719,27 @@ ExitUnmarshalArgs:
     return status;
 }
 
+QStatus _Message::CheckArgsSignature(const qcc::String& expectedSignature, const char* expectedReplySignature)
+{
+    const char* sig = GetSignature();
+
+    if (msgHeader.msgType == MESSAGE_INVALID) {
+        return ER_FAIL;
+    }
+    if (expectedSignature != sig) {
+        QStatus status = ER_BUS_SIGNATURE_MISMATCH;
+        QCC_LogError(status, ("Expected \"%s\" got \"%s\"", expectedSignature.c_str(), sig));
+        return status;
+    }
+    /*
+     * Save the reply signature so we can check it when we marshall the reply.
+     */
+    if (expectedReplySignature) {
+        replySignature = expectedReplySignature;
+    }
+    return ER_OK;
+}
+
 
 
 static QStatus PedanticCheck(const MsgArg* field, uint32_t fieldId)
@@ -793,6 +813,12 @@ static QStatus PedanticCheck(const MsgArg* field, uint32_t fieldId)
  */
 static const size_t MAX_PULL = (128 * 1024);
 
+/*
+ * Space reserved in front of a received message for the header to grow into when it is
+ * re-marshaled. Must be a multiple of 8 bytes.
+ */
+static const size_t HEADER_HEADROOM = 64;
+
 /*
  * Timeout is scaled by the amount of data being read but is very conservative to allow for
  * congested links.
@@ -935,8 +961,12 @@ QStatus _Message::InterpretHeader()
      */
     bufSize = sizeof(msgHeader) + ((pktSize + 7) & ~7) + sizeof(uint64_t);
     assert(_msgBuf == nullptr);
-    _msgBuf = new uint8_t[bufSize + 7];
-    msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7); /* Align to 8 byte boundary */
+    /*
+     * Leave some room in front of the message so that ReMarshal can grow the header, typically to
+     * replace a missing or bad sender, without having to copy the body into a new buffer.
+     */
+    _msgBuf = MessageBufferPool::Alloc(bufSize + HEADER_HEADROOM + 7);
+    msgBuf = (uint64_t*)(((uintptr_t)(_msgBuf + 7) & ~7) + HEADER_HEADROOM); /* Align to 8 byte boundary */
     /*
      * Copy header into the buffer
      */
@@ -1115,7 +1145,7 @@ QStatus _Message::Read(RemoteEndpoint& endpoint, bool checkSender, bool pedantic
      * Clear out any stale message state
      */
     msgBuf = NULL;
-    delete [] _msgBuf;
+    MessageBufferPool::Free(_msgBuf);
     _msgBuf = NULL;
     ClearHeader();
     readState = MESSAGE_NEW;
@@ -1355,7 +1385,7 @@ ExitUnmarshal:
          * There was an unrecoverable failure while unmarshaling the message, cleanup before we return.
          */
         msgBuf = NULL;
-        delete [] _msgBuf;
+        MessageBufferPool::Free(_msgBuf);
         _msgBuf = NULL;
         ClearHeader();
         if ((status != ER_SOCK_OTHER_END_CLOSED) && (status != ER_STOPPING_THREAD)) {
@@ -49,9 +49,10 @@ MethodTable::~MethodTable()
 void MethodTable::Add(BusObject* object,
                       MessageReceiver::MethodHandler func,
                       const InterfaceDescription::Member* member,
-                      void* context)
+                      void* context,
+                      bool cursor)
 {
-    Entry* entry = new Entry(object, func, member, context);
+    Entry* entry = new Entry(object, func, member, context, cursor);
     lock.Lock(MUTEX_CONTEXT);
     hashTable[Key(object->GetPath(), entry->ifaceStr.empty() ? NULL : entry->ifaceStr.c_str(), member->name.c_str())] = entry;
 
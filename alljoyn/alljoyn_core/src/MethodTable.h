@@ -58,8 +58,9 @@ class MethodTable {
         Entry(BusObject* object,
               MessageReceiver::MethodHandler handler,
               const InterfaceDescription::Member* member,
-              void* context)
-            : object(object), handler(handler), member(member), context(context), ifaceStr(member->iface->GetName()), methodStr(member->name),
+              void* context,
+              bool cursor)
+            : object(object), handler(handler), member(member), context(context), cursor(cursor), ifaceStr(member->iface->GetName()), methodStr(member->name),
             refCount(0) { }
 
         ~Entry()
@@ -72,12 +73,13 @@ class MethodTable {
         /**
          * Construct an empty Entry.
          */
-        Entry(void) : object(NULL), handler(), ifaceStr(), methodStr() { }
+        Entry(void) : object(NULL), handler(), cursor(false), ifaceStr(), methodStr() { }
 
         BusObject* object;                             /**<  BusObject instance*/
         MessageReceiver::MethodHandler handler;        /**<  Handler for method */
         const InterfaceDescription::Member* member;    /**<  Member that handler implements  */
         void* context;                                 /**<  Optional context provided when handler was registered */
+        bool cursor;                                   /**<  Handler reads the arguments with a MessageCursor */
         qcc::String ifaceStr;                          /**<  Interface string */
         qcc::String methodStr;                         /**<  Method string */
         mutable volatile int32_t refCount;
@@ -113,11 +115,14 @@ class MethodTable {
      * @param object     Object instance.
      * @param func       Handler for method.
      * @param member     Member that func implements.
+     * @param context    Optional context provided when the handler was registered.
+     * @param cursor     True if func reads the arguments with a MessageCursor.
      */
     void Add(BusObject* object,
              MessageReceiver::MethodHandler func,
              const InterfaceDescription::Member* member,
-             void* context = NULL);
+             void* context = NULL,
+             bool cursor = false);
 
     /**
      * Find an Entry based on set of criteria.
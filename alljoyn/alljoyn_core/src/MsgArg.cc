@@ -289,11 +289,7 @@ QStatus AllJoynArray::SetElements(const char* signature, size_t number, MsgArg*
 
 bool MsgArg::HasSignature(const char* signature) const
 {
-    char sig[256];
-    size_t len = 0;
-    SignatureUtils::MakeSignature(this, 1, sig, len);
-    return strcmp(signature, sig) == 0;
-
+    return signature && SignatureUtils::MatchSignature(this, signature) && (*signature == 0);
 }
 
 void MsgArg::Stabilize()
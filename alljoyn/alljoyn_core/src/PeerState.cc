@@ -332,6 +332,47 @@ void _PeerState::SetGuildMetadata(const qcc::String& serial, const qcc::String&
         guildMap.erase(key);
     }
     guildMap[key] = guild;
+    ClearAuthorizationCache();
+}
+
+bool _PeerState::LookupAuthorization(const qcc::String& request, uint32_t epoch, bool& authorized, uint32_t& generation)
+{
+    bool found = false;
+    authorizationLock.Lock(MUTEX_CONTEXT);
+    if (authorizationEpoch != epoch) {
+        /* the policy or the local security configuration changed */
+        authorizationCache.clear();
+        authorizationEpoch = epoch;
+    }
+    std::map<qcc::String, bool>::const_iterator iter = authorizationCache.find(request);
+    if (iter != authorizationCache.end()) {
+        authorized = iter->second;
+        found = true;
+    }
+    generation = authorizationGeneration;
+    authorizationLock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+void _PeerState::CacheAuthorization(const qcc::String& request, uint32_t epoch, uint32_t generation, bool authorized)
+{
+    authorizationLock.Lock(MUTEX_CONTEXT);
+    /* only keep the decision if nothing it depends on changed while it was computed */
+    if ((authorizationEpoch == epoch) && (authorizationGeneration == generation)) {
+        if (authorizationCache.size() >= MAX_AUTHORIZATION_CACHE_SIZE) {
+            authorizationCache.clear();
+        }
+        authorizationCache[request] = authorized;
+    }
+    authorizationLock.Unlock(MUTEX_CONTEXT);
+}
+
+void _PeerState::ClearAuthorizationCache()
+{
+    authorizationLock.Lock(MUTEX_CONTEXT);
+    authorizationCache.clear();
+    ++authorizationGeneration;
+    authorizationLock.Unlock(MUTEX_CONTEXT);
 }
 
 _PeerState::GuildMetadata* _PeerState::GetGuildMetadata(const qcc::String& serial, const String& issuerAki)
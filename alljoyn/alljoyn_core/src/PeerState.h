@@ -120,13 +120,16 @@ class _PeerState {
         manifestSize(0),
         guildArgsSentCount(0),
         isLocalPeer(false),
+        authRoundTrips(0),
         clockOffset((std::numeric_limits<int32_t>::max)()),
         firstClockAdjust(true),
         lastDriftAdjustTime(0),
         expectedSerial(0),
         isSecure(false),
         authEvent(NULL),
-        hashUtil(NULL)
+        hashUtil(NULL),
+        authorizationEpoch(0),
+        authorizationGeneration(0)
     {
         ::memset(window, 0, sizeof(window));
         ::memset(authorizations, 0, sizeof(authorizations));
@@ -176,6 +179,7 @@ class _PeerState {
     void SetGuidAndAuthVersion(const qcc::GUID128& newGuid, uint32_t authenticationVersion) {
         this->guid = newGuid;
         this->authVersion = authenticationVersion;
+        ClearAuthorizationCache();
     }
 
     /**
@@ -187,6 +191,7 @@ class _PeerState {
     void SetKey(const qcc::KeyBlob& key, PeerKeyType keyType) {
         keys[keyType] = key;
         isSecure = key.IsValid();
+        ClearAuthorizationCache();
     }
 
     /**
@@ -219,6 +224,7 @@ class _PeerState {
         keys[PEER_SESSION_KEY].Erase();
         keys[PEER_GROUP_KEY].Erase();
         isSecure = false;
+        ClearAuthorizationCache();
     }
 
     /**
@@ -296,6 +302,42 @@ class _PeerState {
         }
     }
 
+    /**
+     * Maximum number of memoized permission decisions kept for a peer. The cache is simply
+     * cleared when it fills up.
+     */
+    static const size_t MAX_AUTHORIZATION_CACHE_SIZE = 256;
+
+    /**
+     * Look up a memoized permission decision for this peer.
+     *
+     * @param request     Key describing the request (object path, interface, member and action).
+     * @param epoch       The permission manager's current authorization epoch. Decisions cached
+     *                    under an older epoch are discarded.
+     * @param authorized  [out] The cached decision if one was found.
+     * @param generation  [out] The peer's cache generation, to be passed back to CacheAuthorization().
+     *
+     * @return  Returns true if a cached decision was found.
+     */
+    bool LookupAuthorization(const qcc::String& request, uint32_t epoch, bool& authorized, uint32_t& generation);
+
+    /**
+     * Memoize a permission decision for this peer. The decision is dropped if the peer's
+     * authorization data or the permission manager's epoch changed since LookupAuthorization().
+     *
+     * @param request     Key describing the request.
+     * @param epoch       The epoch the decision was computed under.
+     * @param generation  The generation returned by LookupAuthorization().
+     * @param authorized  The decision to cache.
+     */
+    void CacheAuthorization(const qcc::String& request, uint32_t epoch, uint32_t generation, bool authorized);
+
+    /**
+     * Discard the memoized permission decisions for this peer. Must be called whenever the
+     * peer's manifest, memberships or authentication state change.
+     */
+    void ClearAuthorizationCache();
+
 
     /**
      * Set the guild metadata indexed by the serial number and the issuer.
@@ -469,6 +511,11 @@ class _PeerState {
      */
     bool isLocalPeer;
 
+    /**
+     * Number of method call round trips used by the last authentication initiated with this peer.
+     */
+    uint32_t authRoundTrips;
+
     /**
      * The estimated clock offset between the local peer and the remote peer. This is used to
      * convert between remote and local timestamps.
@@ -535,6 +582,26 @@ class _PeerState {
      * Mutex to protect the conversation hash
      */
     qcc::Mutex hashLock;
+
+    /**
+     * Memoized permission decisions keyed by request.
+     */
+    std::map<qcc::String, bool> authorizationCache;
+
+    /**
+     * The permission manager epoch the cached decisions were computed under.
+     */
+    uint32_t authorizationEpoch;
+
+    /**
+     * Bumped every time the cached decisions are invalidated for this peer.
+     */
+    uint32_t authorizationGeneration;
+
+    /**
+     * Mutex to protect the authorization cache
+     */
+    qcc::Mutex authorizationLock;
 };
 
 
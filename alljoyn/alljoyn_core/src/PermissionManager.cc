@@ -474,6 +474,48 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
     return authorized;
 }
 
+/**
+ * Generate the key under which a decision is memoized on the peer state.
+ */
+static String GenAuthorizationKey(const Request& request)
+{
+    String key;
+    key.reserve(64);
+    key += request.outgoing ? 'o' : 'i';
+    key += request.propertyRequest ? (request.isSetProperty ? 's' : 'p') : 'm';
+    key += static_cast<char>('0' + request.mbrType);
+    key += ' ';
+    if (request.objPath) {
+        key += request.objPath;
+    }
+    key += ' ';
+    if (request.iName) {
+        key += request.iName;
+    }
+    key += ' ';
+    if (request.mbrName) {
+        key += request.mbrName;
+    } else {
+        /* a GetAll request is different from a request for a property with an empty name */
+        key += '*';
+    }
+    return key;
+}
+
+bool PermissionManager::IsAuthorizedCached(const Request& request, PeerState& peerState)
+{
+    uint32_t epoch = static_cast<uint32_t>(authorizationEpoch);
+    String key = GenAuthorizationKey(request);
+    bool authorized = false;
+    uint32_t generation;
+    if (peerState->LookupAuthorization(key, epoch, authorized, generation)) {
+        return authorized;
+    }
+    authorized = IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj);
+    peerState->CacheAuthorization(key, epoch, generation, authorized);
+    return authorized;
+}
+
 static bool IsStdInterface(const char* iName)
 {
     if (strcmp(iName, org::alljoyn::Bus::InterfaceName) == 0) {
@@ -705,7 +747,7 @@ QStatus PermissionManager::AuthorizeMessage(bool outgoing, Message& msg, PeerSta
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage with outgoing: %d msg %s", outgoing, msg->ToString().c_str()));
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage: local policy %s", GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
-    authorized = IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj);
+    authorized = IsAuthorizedCached(request, peerState);
     if (!authorized) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeMessage IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
@@ -727,7 +769,7 @@ QStatus PermissionManager::AuthorizeGetProperty(const char* objPath, const char*
     QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty: ifc %s prop %s local policy %s", ifcName, propName, GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
     Request request(objPath, ifcName, propName, PermissionPolicy::Rule::Member::PROPERTY, false, true);
-    if (!IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj)) {
+    if (!IsAuthorizedCached(request, peerState)) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
     }
@@ -25,11 +25,14 @@
 #error Only include PermissionManager.h in C++ code.
 #endif
 
+#include <qcc/atomic.h>
 #include <alljoyn/PermissionPolicy.h>
 #include "PermissionMgmtObj.h"
 
 namespace ajn {
 
+struct Request;
+
 class PermissionManager {
 
   public:
@@ -38,7 +41,7 @@ class PermissionManager {
      * Constructor
      *
      */
-    PermissionManager() : policy(NULL), permissionMgmtObj(NULL)
+    PermissionManager() : policy(NULL), permissionMgmtObj(NULL), authorizationEpoch(0)
     {
     }
 
@@ -59,6 +62,7 @@ class PermissionManager {
     {
         delete this->policy;
         this->policy = policy;
+        InvalidateAuthorizations();
     }
 
     /**
@@ -103,6 +107,16 @@ class PermissionManager {
         return permissionMgmtObj;
     }
 
+    /**
+     * Discard the authorization decisions memoized on every peer. Must be called
+     * whenever the local security configuration (policy, trust anchors or the
+     * stored peer credentials) changes.
+     */
+    void InvalidateAuthorizations()
+    {
+        qcc::IncrementAndFetch(&authorizationEpoch);
+    }
+
   private:
     /* Private assigment operator to prevent double freeing of memory */
     PermissionManager& operator=(const PermissionManager& src);
@@ -111,8 +125,11 @@ class PermissionManager {
 
     bool AuthorizePermissionMgmt(bool outgoing, const char* iName, const char* mbrName, bool& authorized);
 
+    bool IsAuthorizedCached(const Request& request, PeerState& peerState);
+
     PermissionPolicy* policy;
     PermissionMgmtObj* permissionMgmtObj;
+    volatile int32_t authorizationEpoch;  /* bumped to invalidate all the memoized decisions */
 };
 
 }
@@ -181,6 +181,8 @@ void PermissionMgmtObj::PolicyChanged(PermissionPolicy* policy)
     ca->GetGuid(localGUID);
     bus.GetInternal().GetPermissionManager().SetPolicy(policy);
     ManageTrustAnchors(policy);
+    /* drop any decision made against the old trust anchors */
+    bus.GetInternal().GetPermissionManager().InvalidateAuthorizations();
 
     /* Finally, inform the application that it's security policy has changed. */
     bus.GetInternal().CallPolicyChangedCallback();
@@ -1943,6 +1945,7 @@ QStatus PermissionMgmtObj::ParseSendManifest(Message& msg, PeerState& peerState)
     delete [] peerState->manifest;
     peerState->manifest = rules;
     peerState->manifestSize = count;
+    peerState->ClearAuthorizationCache();
     return ER_OK;  /* done */
 
 DoneValidation:
@@ -2009,6 +2012,7 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
         status = GetConnectedPeerPublicKey(peerState->GetGuid(), &peerPublicKey);
         if (ER_OK != status) {
             _PeerState::ClearGuildMap(peerState->guildMap);
+            peerState->ClearAuthorizationCache();
             done = true;
             return ER_OK;  /* could not validate */
         }
@@ -2051,6 +2055,7 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
                 break;  /* done */
             }
         }
+        peerState->ClearAuthorizationCache();
         done = true;
     }
     return ER_OK;
@@ -2135,6 +2140,7 @@ QStatus PermissionMgmtObj::PerformReset(bool keepForClaim)
     KeyStore::Key key;
     QStatus status;
     ClearTrustAnchors();
+    bus.GetInternal().GetPermissionManager().InvalidateAuthorizations();
     if (!keepForClaim) {
         ca->GetLocalKey(KeyBlob::DSA_PRIVATE, key);
         status = ca->DeleteKey(key);
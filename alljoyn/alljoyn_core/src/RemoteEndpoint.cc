@@ -21,6 +21,10 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <list>
+#include <vector>
+
 #include <qcc/Debug.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
@@ -29,6 +33,7 @@
 #include <qcc/SocketStream.h>
 #include <qcc/atomic.h>
 #include <qcc/IODispatch.h>
+#include <qcc/LockFreeQueue.h>
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/AllJoynStd.h>
@@ -52,6 +57,49 @@ namespace ajn {
 
 #define ENDPOINT_IS_DEAD_ALERTCODE  1
 
+/*
+ * Number of control messages that can be queued up on a routing node before
+ * the endpoint is disconnected.
+ */
+static const int32_t MAX_CONTROL_MESSAGES = 30;
+
+/*
+ * Number of data messages that can be queued up before PushMessage() blocks
+ * (per endpoint) when coalescing is disabled.
+ */
+static const int32_t MAX_DATA_MESSAGES = 1;
+
+/*
+ * Upper bound on the number of messages coalesced into a single write, this is
+ * also the most data messages that will be queued up on a routing node when
+ * coalescing is enabled.
+ */
+static const uint32_t MAX_TX_COALESCE_MESSAGES = 64;
+
+/*
+ * A sink that collects the bytes pushed into it instead of sending them so
+ * that several messages can be sent with a single gather write.  The buffers
+ * must stay alive until the bytes have actually been sent.
+ */
+class TxGatherSink : public Sink {
+  public:
+    TxGatherSink(std::vector<IOVec>& iov) : iov(iov), numBytes(0) { }
+
+    QStatus PushBytes(const void* buf, size_t numBytes, size_t& numSent)
+    {
+        IOVec v;
+        v.buf = const_cast<char*>(static_cast<const char*>(buf));
+        v.len = numBytes;
+        iov.push_back(v);
+        this->numBytes += numBytes;
+        numSent = numBytes;
+        return ER_OK;
+    }
+
+    std::vector<IOVec>& iov;
+    size_t numBytes;
+};
+
 class _RemoteEndpoint::Internal {
     friend class _RemoteEndpoint;
   public:
@@ -59,8 +107,14 @@ class _RemoteEndpoint::Internal {
     Internal(BusAttachment& bus, bool incoming, const qcc::String& connectSpec, Stream* stream, const char* threadName, bool isSocket) :
         bus(bus),
         stream(stream),
-        txQueue(),
+        txQueue(MAX_CONTROL_MESSAGES + MAX_DATA_MESSAGES, Message(bus)),
+        txIovPos(0),
+        txCoalesceMessages(1),
+        txCoalesceBytes(0),
         txWaitQueue(),
+        numTxWaiters(0),
+        txWaitLock(),
+        txConsumerLock(),
         lock(),
         exitCount(0),
         listener(NULL),
@@ -85,7 +139,8 @@ class _RemoteEndpoint::Internal {
         stopping(false),
         pingCallSerial(0),
         sendTimeout(0),
-        maxControlMessages(30),
+        maxControlMessages(MAX_CONTROL_MESSAGES),
+        maxDataMessages(MAX_DATA_MESSAGES),
         numControlMessages(0),
         numDataMessages(0)
     {
@@ -97,9 +152,18 @@ class _RemoteEndpoint::Internal {
     BusAttachment& bus;                      /**< Message bus associated with this endpoint */
     qcc::Stream* stream;                     /**< Stream for this endpoint or NULL if uninitialized */
 
-    std::deque<Message> txQueue;             /**< Transmit message queue */
-    std::deque<qcc::Thread*> txWaitQueue;    /**< Threads waiting for txQueue to become not-full */
-    qcc::Mutex lock;                         /**< Mutex that protects the txQueue and timeout values */
+    qcc::LockFreeQueue<Message> txQueue;     /**< Transmit message queue (many producers, consumed by WriteCallback) */
+    std::vector<Message> txBatch;            /**< Messages taken off the txQueue whose bytes are in txIov */
+    std::vector<qcc::IOVec> txIov;           /**< Bytes waiting for a gather write */
+    size_t txIovPos;                         /**< First entry in txIov that has not been completely written */
+    uint32_t txCoalesceMessages;             /**< Maximum number of messages per gather write, 1 if coalescing is disabled */
+    size_t txCoalesceBytes;                  /**< Stop adding messages to a gather write once it holds this many bytes */
+    std::list<qcc::Thread*> txWaitQueue;     /**< Threads waiting for txQueue to become not-full */
+    volatile int32_t numTxWaiters;           /**< Number of threads in txWaitQueue */
+    qcc::Mutex txWaitLock;                   /**< Mutex that protects the txWaitQueue */
+    qcc::Mutex txConsumerLock;               /**< Held by the single consumer of the txQueue: WriteCallback() or a blocked
+                                                  producer discarding expired messages */
+    qcc::Mutex lock;                         /**< Mutex that protects the timeout values */
     int32_t exitCount;                       /**< Number of sub-threads (rx and tx) that have exited (atomically incremented) */
 
     EndpointListener* listener;              /**< Listener for thread exit and untrusted client start and exit notifications. */
@@ -137,10 +201,12 @@ class _RemoteEndpoint::Internal {
                                                   disconnect the remote node if it has not read a message from the link
                                                   in the situation that the send buffer on this end and receive buffer on
                                                   the remote end are full. */
-    size_t maxControlMessages;               /**< Number of control messages that can be queued up before disconnecting this endpoint.
+    int32_t maxControlMessages;              /**< Number of control messages that can be queued up before disconnecting this endpoint.
+                                                  - used on Routing nodes only */
+    int32_t maxDataMessages;                 /**< Number of data messages that can be queued up before PushMessage() blocks
                                                   - used on Routing nodes only */
-    size_t numControlMessages;               /**< Number of control messages in txQueue - used on Routing nodes only */
-    size_t numDataMessages;                  /**< Number of data messages in txQueue - used on Routing nodes only */
+    volatile int32_t numControlMessages;     /**< Number of control messages in txQueue - used on Routing nodes only */
+    volatile int32_t numDataMessages;        /**< Number of data messages in txQueue (all messages on leaf nodes) */
   private:
     Internal& operator=(const Internal&);
 };
@@ -479,18 +545,39 @@ QStatus _RemoteEndpoint::Start()
 }
 QStatus _RemoteEndpoint::Start(uint32_t idleTimeout, uint32_t probeTimeout, uint32_t numProbes, uint32_t sendTimeout)
 {
+    if (internal) {
+        internal->sendTimeout = sendTimeout;
+        internal->maxControlMessages = sendTimeout * MAX_CONTROL_MSGS_PER_SECOND;
+        /*
+         * Nothing can have been queued yet so the txQueue can be resized to hold as many messages
+         * as may be queued up.
+         */
+        internal->txQueue.Reset(internal->maxControlMessages + internal->maxDataMessages);
+    }
     QStatus status = Start();
     if (status == ER_OK && endpointType == ENDPOINT_TYPE_REMOTE) {
         /* Set idle timeouts for leaf nodes only */
         status = SetIdleTimeouts(idleTimeout, probeTimeout, numProbes);
     }
-    internal->sendTimeout = sendTimeout;
-    internal->maxControlMessages = sendTimeout * MAX_CONTROL_MSGS_PER_SECOND;
     if (status != ER_OK) {
         Invalidate();
     }
     return status;
 }
+void _RemoteEndpoint::SetTxCoalescing(uint32_t maxMessages, uint32_t maxBytes)
+{
+    if (internal) {
+        internal->txCoalesceMessages = (std::max)((std::min)(maxMessages, MAX_TX_COALESCE_MESSAGES), (uint32_t)1);
+        internal->txCoalesceBytes = maxBytes;
+        /*
+         * A gather write can only batch the data messages that are queued up, so as many may be
+         * queued as are written together. Without coalescing a single data message is queued.
+         */
+        internal->maxDataMessages = (std::max)(MAX_DATA_MESSAGES, (int32_t)internal->txCoalesceMessages);
+        internal->txQueue.Reset(internal->maxControlMessages + internal->maxDataMessages);
+    }
+}
+
 void _RemoteEndpoint::SetListener(EndpointListener* listener)
 {
     if (internal) {
@@ -537,7 +624,7 @@ QStatus _RemoteEndpoint::StopAfterTxEmpty(uint32_t maxWaitMs)
     /* Wait for txqueue to empty before triggering stop */
     internal->lock.Lock(MUTEX_CONTEXT);
     for (;;) {
-        if (internal->txQueue.empty() || (maxWaitMs && (qcc::GetTimestamp() > (startTime + maxWaitMs)))) {
+        if (internal->txQueue.Empty() || (maxWaitMs && (qcc::GetTimestamp() > (startTime + maxWaitMs)))) {
             status = Stop();
             break;
         } else {
@@ -583,13 +670,14 @@ void _RemoteEndpoint::ThreadExit(Thread* thread)
         return;
     }
     /* This is notification of a txQueue waiter has died. Remove him */
-    internal->lock.Lock(MUTEX_CONTEXT);
-    deque<Thread*>::iterator it = find(internal->txWaitQueue.begin(), internal->txWaitQueue.end(), thread);
+    internal->txWaitLock.Lock(MUTEX_CONTEXT);
+    list<Thread*>::iterator it = find(internal->txWaitQueue.begin(), internal->txWaitQueue.end(), thread);
     if (it != internal->txWaitQueue.end()) {
         (*it)->RemoveAuxListener(this);
         internal->txWaitQueue.erase(it);
+        DecrementAndFetch(&internal->numTxWaiters);
     }
-    internal->lock.Unlock(MUTEX_CONTEXT);
+    internal->txWaitLock.Unlock(MUTEX_CONTEXT);
 
     return;
 }
@@ -644,13 +732,13 @@ void _RemoteEndpoint::ExitCallback()
         return;
     }
     /* Alert any threads that are on the wait queue */
-    internal->lock.Lock(MUTEX_CONTEXT);
-    deque<Thread*>::iterator it = internal->txWaitQueue.begin();
+    internal->txWaitLock.Lock(MUTEX_CONTEXT);
+    list<Thread*>::iterator it = internal->txWaitQueue.begin();
     while (it != internal->txWaitQueue.end()) {
         (*it++)->Alert(ENDPOINT_IS_DEAD_ALERTCODE);
     }
 
-    internal->lock.Unlock(MUTEX_CONTEXT);
+    internal->txWaitLock.Unlock(MUTEX_CONTEXT);
     RemoteEndpoint rep = RemoteEndpoint::wrap(this);
     /* Un-register this remote endpoint from the router */
     internal->bus.GetInternal().GetRouter().UnregisterEndpoint(this->GetUniqueName(), this->GetEndpointType());
@@ -912,26 +1000,50 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
         return ER_BUS_ENDPOINT_CLOSING;
     }
     QStatus status = ER_OK;
+    internal->txConsumerLock.Lock(MUTEX_CONTEXT);
     while (status == ER_OK) {
         if (!IsValid()) {
+            internal->txConsumerLock.Unlock(MUTEX_CONTEXT);
             return ER_BUS_NO_ENDPOINT;
         }
+        /* Finish off any gather write before starting on the next message */
+        if (!internal->txIov.empty()) {
+            status = FlushTxBatch();
+            continue;
+        }
         if (internal->getNextMsg) {
-            internal->lock.Lock(MUTEX_CONTEXT);
-            if (!internal->txQueue.empty()) {
+            if (internal->txQueue.Peek(internal->currentWriteMsg)) {
                 /* Make a deep copy of the message since there is state information inside the message.
                  * Each copy of the message could be in different write state.
                  */
-                internal->currentWriteMsg = Message(internal->txQueue.back(), true);
+                internal->currentWriteMsg = Message(internal->currentWriteMsg, true);
                 internal->getNextMsg = false;
-                internal->lock.Unlock(MUTEX_CONTEXT);
             } else {
-
-                internal->bus.GetInternal().GetIODispatch().DisableWriteCallback(internal->stream);
-                internal->lock.Unlock(MUTEX_CONTEXT);
+                IODispatch& iodispatch = internal->bus.GetInternal().GetIODispatch();
+                iodispatch.DisableWriteCallback(internal->stream);
+                /*
+                 * A producer only enables the write callback when its message
+                 * is the first one in the queue.  If that happened while this
+                 * callback was still enabled the wakeup was lost, so check
+                 * again now that it is disabled.  This also covers a message
+                 * that is published while an earlier producer has not yet
+                 * finished publishing its own.
+                 */
+                if (!internal->txQueue.Empty()) {
+                    iodispatch.EnableWriteCallbackNow(internal->stream);
+                }
+                internal->txConsumerLock.Unlock(MUTEX_CONTEXT);
                 return ER_OK;
             }
         }
+        /*
+         * Messages that carry handles are never coalesced, nor is a message that has already been
+         * partly written.
+         */
+        if ((internal->txCoalesceMessages > 1) && (internal->currentWriteMsg->writeState == MESSAGE_NEW) && !internal->currentWriteMsg->handles) {
+            status = GatherTxBatch();
+            continue;
+        }
         /* Deliver message */
         RemoteEndpoint rep = RemoteEndpoint::wrap(this);
         status = internal->currentWriteMsg->DeliverNonBlocking(rep);
@@ -948,30 +1060,12 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
             status = ER_OK;
         }
         if (status == ER_OK) {
-
             /* Message has been successfully delivered. i.e. PushBytes is complete
              */
-            internal->lock.Lock(MUTEX_CONTEXT);
-            internal->txQueue.pop_back();
-            internal->getNextMsg = true;
-            if (internal->bus.GetInternal().GetRouter().IsDaemon()) {
-                if (IsControlMessage(internal->currentWriteMsg)) {
-                    internal->numControlMessages--;
-                } else {
-                    internal->numDataMessages--;
-                }
-            }
-            /* Alert the first one in the txWaitQueue */
-            if (0 < internal->txWaitQueue.size()) {
-                Thread* wakeMe = internal->txWaitQueue.back();
-                status = wakeMe->Alert();
-                if (ER_OK != status) {
-                    QCC_LogError(status, ("Failed to alert thread blocked on full tx queue"));
-                }
-            }
-            internal->lock.Unlock(MUTEX_CONTEXT);
+            status = TxMessageDone();
         }
     }
+    internal->txConsumerLock.Unlock(MUTEX_CONTEXT);
 
     if (status == ER_TIMEOUT) {
         /* Timed-out in the middle of a message write. */
@@ -995,245 +1089,314 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
     }
     return status;
 }
-QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
+QStatus _RemoteEndpoint::TxMessageDone()
 {
-    QStatus status = ER_OK;
-    static const size_t MAX_DATA_MESSAGES = 1;
-
-    internal->lock.Lock(MUTEX_CONTEXT);
-    count = internal->txQueue.size();
-    bool wasEmpty = (count == 0);
+    QCC_VERIFY(internal->txQueue.Pop());
+    internal->getNextMsg = true;
+    ReleaseTxRoom(internal->currentWriteMsg);
+    return AlertTxWaiter();
+}
 
-    if (IsControlMessage(msg)) {
+QStatus _RemoteEndpoint::AlertTxWaiter()
+{
+    QStatus status = ER_OK;
 
-        if (internal->numControlMessages < internal->maxControlMessages) {
-            internal->txQueue.push_front(msg);
-            internal->numControlMessages++;
-            if (wasEmpty) {
-                internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+    /* Alert the first one in the txWaitQueue */
+    if (internal->numTxWaiters > 0) {
+        internal->txWaitLock.Lock(MUTEX_CONTEXT);
+        if (!internal->txWaitQueue.empty()) {
+            Thread* wakeMe = internal->txWaitQueue.front();
+            status = wakeMe->Alert();
+            if (ER_OK != status) {
+                QCC_LogError(status, ("Failed to alert thread blocked on full tx queue"));
             }
-            internal->lock.Unlock(MUTEX_CONTEXT);
-        } else {
-            internal->lock.Unlock(MUTEX_CONTEXT);
-            Invalidate();
-            internal->stopping = true;
-            internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
-            QCC_LogError(ER_BUS_ENDPOINT_CLOSING, ("Endpoint Tx failed (%s)", GetUniqueName().c_str()));
-            status = ER_BUS_ENDPOINT_CLOSING;
         }
+        internal->txWaitLock.Unlock(MUTEX_CONTEXT);
+    }
+    return status;
+}
 
-    } else {
-        /* If the txWaitQueue is not empty, dont queue the message.
-         * There are other threads that are blocked trying to send a message to
-         * this RemoteEndpoint
-         */
-        if ((internal->numDataMessages < MAX_DATA_MESSAGES) && (internal->txWaitQueue.empty())) {
-            internal->txQueue.push_front(msg);
-            internal->numDataMessages++;
-        } else {
-            /* This thread will have to wait for room in the queue */
-            Thread* thread = Thread::GetThread();
-            assert(thread);
-
-            thread->AddAuxListener(this);
-            internal->txWaitQueue.push_front(thread);
-
-            for (;;) {
-                /* Remove a queue entry whose TTLs is expired.
-                 * Only threads that are the head of the txWaitqueue will purge this deque
-                 * and enqueue new messages to the txQueue.
-                 * This is to ensure that the original order of calling of PushMessage
-                 * is preserved.
-                 */
-                uint32_t maxWait = Event::WAIT_FOREVER;
-                if (internal->txWaitQueue.back() == thread) {
-                    deque<Message>::iterator it = internal->txQueue.begin();
-                    while (it != internal->txQueue.end()) {
-                        uint32_t expMs;
-                        if ((*it)->IsExpired(&expMs)) {
-                            if (IsControlMessage(internal->currentWriteMsg)) {
-                                internal->numControlMessages--;
-                            } else {
-                                internal->numDataMessages--;
-                            }
-
-                            internal->txQueue.erase(it);
-                            break;
-                        } else {
-                            ++it;
-                            if (maxWait == Event::WAIT_FOREVER) {
-                                maxWait = expMs;
-                            } else {
-                                maxWait = (std::min)(maxWait, expMs);
-                            }
-                        }
-                    }
-
-                    if (internal->numDataMessages < MAX_DATA_MESSAGES) {
-                        count = internal->txQueue.size();
-                        /* Check queue wasn't drained while we were waiting */
-                        if (internal->txQueue.size() == 0) {
-                            wasEmpty = true;
-                        }
-                        internal->txQueue.push_front(msg);
-                        internal->numDataMessages++;
-
-                        status = ER_OK;
-                        break;
-                    }
-                }
-                internal->lock.Unlock(MUTEX_CONTEXT);
-                status = Event::Wait(Event::neverSet, maxWait);
-                internal->lock.Lock(MUTEX_CONTEXT);
-                /* Reset alert status */
-                if (ER_ALERTED_THREAD == status) {
-                    if (thread->GetAlertCode() == ENDPOINT_IS_DEAD_ALERTCODE) {
-                        status = ER_BUS_ENDPOINT_CLOSING;
-                    }
-                    thread->ResetAlertCode();
-                    thread->GetStopEvent().ResetEvent();
-                }
-
-                if (internal->stopping) {
-                    status = ER_BUS_ENDPOINT_CLOSING;
-                }
-                if ((ER_OK != status) && (ER_ALERTED_THREAD != status) && (ER_TIMEOUT != status)) {
-                    break;
-                }
+QStatus _RemoteEndpoint::GatherTxBatch()
+{
+    QStatus status = ER_OK;
+    RemoteEndpoint rep = RemoteEndpoint::wrap(this);
+    TxGatherSink gatherSink(internal->txIov);
 
+    /* Always take at least one message so that a small byte limit cannot stall the endpoint */
+    while ((status == ER_OK) && (internal->txIov.empty() || ((internal->txBatch.size() < internal->txCoalesceMessages) && (gatherSink.numBytes < internal->txCoalesceBytes)))) {
+        if (internal->getNextMsg) {
+            if (!internal->txQueue.Peek(internal->currentWriteMsg)) {
+                break;
             }
-            /* Remove thread from wait queue. */
-            thread->RemoveAuxListener(this);
-            deque<Thread*>::iterator eit = find(internal->txWaitQueue.begin(), internal->txWaitQueue.end(), thread);
-            if (eit != internal->txWaitQueue.end()) {
-                internal->txWaitQueue.erase(eit);
+            internal->currentWriteMsg = Message(internal->currentWriteMsg, true);
+            internal->getNextMsg = false;
+        }
+        if (internal->currentWriteMsg->handles) {
+            break;
+        }
+        size_t numIov = internal->txIov.size();
+        status = internal->currentWriteMsg->DeliverNonBlocking(rep, gatherSink);
+        /* Report authorization failure as a security violation */
+        if ((status == ER_BUS_NOT_AUTHORIZED) || (status == ER_PERMISSION_DENIED)) {
+            internal->bus.GetInternal().GetLocalEndpoint()->GetPeerObj()->HandleSecurityViolation(internal->currentWriteMsg, status);
+            status = ER_OK;
+        }
+        if (status == ER_OK) {
+            if (internal->txIov.size() != numIov) {
+                /*
+                 * The message is taken off the txQueue now but has to be kept alive until its
+                 * bytes have been written, and its room is not released until then either so
+                 * that producers cannot queue more than the limits allow.
+                 */
+                QCC_VERIFY(internal->txQueue.Pop());
+                internal->getNextMsg = true;
+                internal->txBatch.push_back(internal->currentWriteMsg);
+            } else {
+                /* Expired messages and messages that may not be sent did not push anything */
+                status = TxMessageDone();
             }
+        }
+    }
+    return status;
+}
 
-            /* Alert the first one in the txWaitQueue */
-            if (0 < internal->txWaitQueue.size()) {
-                Thread* wakeMe = internal->txWaitQueue.back();
-                status = wakeMe->Alert();
-                if (ER_OK != status) {
-                    QCC_LogError(status, ("Failed to alert thread blocked on full tx queue"));
-                }
-            }
+QStatus _RemoteEndpoint::FlushTxBatch()
+{
+    QStatus status = ER_OK;
+    Sink& sink = GetSink();
+    std::vector<IOVec>& iov = internal->txIov;
 
+    while (internal->txIovPos < iov.size()) {
+        size_t sent = 0;
+        status = sink.PushBytesV(&iov[internal->txIovPos], iov.size() - internal->txIovPos, sent);
+        if (status != ER_OK) {
+            return status;
         }
+        /* Skip over the buffers that were completely written and trim the one that was not */
+        while ((sent > 0) && (internal->txIovPos < iov.size())) {
+            IOVec& v = iov[internal->txIovPos];
+            if (sent >= v.len) {
+                sent -= v.len;
+                ++internal->txIovPos;
+            } else {
+                v.buf = static_cast<char*>(v.buf) + sent;
+                v.len -= sent;
+                sent = 0;
+            }
+        }
+    }
+    iov.clear();
+    internal->txIovPos = 0;
+    if (!internal->txBatch.empty()) {
+        for (std::vector<Message>::iterator it = internal->txBatch.begin(); it != internal->txBatch.end(); ++it) {
+            ReleaseTxRoom(*it);
+        }
+        internal->txBatch.clear();
+        status = AlertTxWaiter();
+    }
+    return status;
+}
 
+void _RemoteEndpoint::ReleaseTxRoom(Message& msg)
+{
+    if (internal->bus.GetInternal().GetRouter().IsDaemon() && IsControlMessage(msg)) {
+        DecrementAndFetch(&internal->numControlMessages);
+    } else {
+        DecrementAndFetch(&internal->numDataMessages);
+    }
+}
 
-        if (wasEmpty && (status == ER_OK)) {
-            internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+uint32_t _RemoteEndpoint::DiscardExpiredTxMessages()
+{
+    uint32_t maxWait = Event::WAIT_FOREVER;
+
+    /* WriteCallback() never blocks so waiting for it to finish is brief */
+    internal->txConsumerLock.Lock(MUTEX_CONTEXT);
+    /* A message the writer has started on cannot be discarded and nor can the ones behind it */
+    if (internal->getNextMsg) {
+        Message msg(internal->bus);
+        while (internal->txQueue.Peek(msg)) {
+            uint32_t expMs;
+            if (!msg->IsExpired(&expMs)) {
+                /* Messages without a TTL report the maximum, which is also WAIT_FOREVER */
+                maxWait = expMs;
+                break;
+            }
+            QCC_DbgPrintf(("Discarding expired message (serial=%u) queued for %s", msg->GetCallSerial(), GetUniqueName().c_str()));
+            QCC_VERIFY(internal->txQueue.Pop());
+            ReleaseTxRoom(msg);
         }
-        internal->lock.Unlock(MUTEX_CONTEXT);
-
     }
+    internal->txConsumerLock.Unlock(MUTEX_CONTEXT);
+    return maxWait;
+}
 
-    return status;
+/*
+ * Reserve room for one more message in the txQueue against a limit without
+ * taking a lock.  The reservation is released by WriteCallback() once the
+ * message has been written, or by DiscardExpiredTxMessages().
+ */
+static inline bool ReserveTxRoom(volatile int32_t& counter, int32_t limit)
+{
+    int32_t n = counter;
+    while (n < limit) {
+        if (CompareAndExchange(&counter, n, n + 1)) {
+            return true;
+        }
+        n = counter;
+    }
+    return false;
 }
-QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
+
+QStatus _RemoteEndpoint::EnqueueTxMessage(Message& msg, volatile int32_t& counter, size_t& count)
 {
-    static const size_t MAX_TX_QUEUE_SIZE = 1;
+    int32_t depth = 0;
+    /*
+     * The txQueue is sized to hold as many messages as can be reserved so this should not fail,
+     * but if it does the reservation must be given back or the room would be lost for good.
+     */
+    if (!internal->txQueue.TryPush(msg, &depth)) {
+        DecrementAndFetch(&counter);
+        count = internal->txQueue.Size();
+        QCC_LogError(ER_BUS_WRITE_QUEUE_FULL, ("txQueue of %s is full (capacity %u)", GetUniqueName().c_str(), internal->txQueue.Capacity()));
+        return ER_BUS_WRITE_QUEUE_FULL;
+    }
+    count = (depth > 0) ? (depth - 1) : 0;
+    if (depth == 1) {
+        internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+    }
+    return ER_OK;
+}
 
+QStatus _RemoteEndpoint::WaitForTxRoom(volatile int32_t& counter, int32_t limit)
+{
     QStatus status = ER_OK;
-    internal->lock.Lock(MUTEX_CONTEXT);
-    count = internal->txQueue.size();
-    bool wasEmpty = (count == 0);
-    /* If the txWaitQueue is not empty, dont queue the message.
-     * There are other threads that are blocked trying to send a message to
-     * this RemoteEndpoint
-     */
-    if ((count < MAX_TX_QUEUE_SIZE) && (internal->txWaitQueue.empty())) {
-        internal->txQueue.push_front(msg);
-    } else {
-        /* This thread will have to wait for room in the queue */
-        Thread* thread = Thread::GetThread();
-        assert(thread);
-
-        thread->AddAuxListener(this);
-        internal->txWaitQueue.push_front(thread);
-
-        for (;;) {
-            /* Remove a queue entry whose TTLs is expired.
-             * Only threads that are the head of the txWaitqueue will purge this deque
-             * and enqueue new messages to the txQueue.
-             * This is to ensure that the original order of calling of PushMessage
-             * is preserved.
-             */
-            uint32_t maxWait = Event::WAIT_FOREVER;
-            if (internal->txWaitQueue.back() == thread) {
-                deque<Message>::iterator it = internal->txQueue.begin();
-                while (it != internal->txQueue.end()) {
-                    uint32_t expMs;
-                    if ((*it)->IsExpired(&expMs)) {
-                        internal->txQueue.erase(it);
-                        break;
-                    } else {
-                        ++it;
-                        if (maxWait == Event::WAIT_FOREVER) {
-                            maxWait = expMs;
-                        } else {
-                            maxWait = (std::min)(maxWait, expMs);
-                        }
-                    }
-                }
 
-                if (internal->txQueue.size() < MAX_TX_QUEUE_SIZE) {
-                    count = internal->txQueue.size();
-                    /* Check queue wasn't drained while we were waiting */
-                    if (internal->txQueue.size() == 0) {
-                        wasEmpty = true;
-                    }
-                    internal->txQueue.push_front(msg);
-                    status = ER_OK;
-                    break;
-                }
-            }
-            internal->lock.Unlock(MUTEX_CONTEXT);
-            status = Event::Wait(Event::neverSet, maxWait);
-            internal->lock.Lock(MUTEX_CONTEXT);
-            /* Reset alert status */
-            if (ER_ALERTED_THREAD == status) {
-                if (thread->GetAlertCode() == ENDPOINT_IS_DEAD_ALERTCODE) {
-                    status = ER_BUS_ENDPOINT_CLOSING;
-                }
-                thread->ResetAlertCode();
-                thread->GetStopEvent().ResetEvent();
-            }
+    /* This thread will have to wait for room in the queue */
+    Thread* thread = Thread::GetThread();
+    assert(thread);
 
-            if (internal->stopping) {
-                status = ER_BUS_ENDPOINT_CLOSING;
+    internal->txWaitLock.Lock(MUTEX_CONTEXT);
+    thread->AddAuxListener(this);
+    list<Thread*>::iterator waiter = internal->txWaitQueue.insert(internal->txWaitQueue.end(), thread);
+    IncrementAndFetch(&internal->numTxWaiters);
+
+    for (;;) {
+        /*
+         * Only the thread at the head of the txWaitQueue may take room that
+         * frees up.  This is to ensure that the original order of calling of
+         * PushMessage is preserved among the blocked threads.
+         *
+         * The head of the txWaitQueue also discards queued messages whose TTL
+         * has expired so it is not held up by a peer that has stopped reading,
+         * and wakes up again when the next queued message expires.  The
+         * txWaitLock is released while doing so because WriteCallback() takes
+         * it while holding the txConsumerLock.
+         */
+        uint32_t maxWait = Event::WAIT_FOREVER;
+        if (internal->txWaitQueue.front() == thread) {
+            if (ReserveTxRoom(counter, limit)) {
+                status = ER_OK;
+                break;
             }
-            if ((ER_OK != status) && (ER_ALERTED_THREAD != status) && (ER_TIMEOUT != status)) {
+            internal->txWaitLock.Unlock(MUTEX_CONTEXT);
+            maxWait = DiscardExpiredTxMessages();
+            internal->txWaitLock.Lock(MUTEX_CONTEXT);
+            if (ReserveTxRoom(counter, limit)) {
+                status = ER_OK;
                 break;
             }
+        }
+        internal->txWaitLock.Unlock(MUTEX_CONTEXT);
+        status = Event::Wait(Event::neverSet, maxWait);
+        internal->txWaitLock.Lock(MUTEX_CONTEXT);
+        /* Reset alert status */
+        if (ER_ALERTED_THREAD == status) {
+            if (thread->GetAlertCode() == ENDPOINT_IS_DEAD_ALERTCODE) {
+                status = ER_BUS_ENDPOINT_CLOSING;
+            }
+            thread->ResetAlertCode();
+            thread->GetStopEvent().ResetEvent();
+        }
 
+        if (internal->stopping) {
+            status = ER_BUS_ENDPOINT_CLOSING;
         }
-        /* Remove thread from wait queue. */
-        thread->RemoveAuxListener(this);
-        deque<Thread*>::iterator eit = find(internal->txWaitQueue.begin(), internal->txWaitQueue.end(), thread);
-        if (eit != internal->txWaitQueue.end()) {
-            internal->txWaitQueue.erase(eit);
+        if ((ER_OK != status) && (ER_ALERTED_THREAD != status) && (ER_TIMEOUT != status)) {
+            break;
         }
+    }
 
-        /* Alert the first one in the txWaitQueue */
-        if (0 < internal->txWaitQueue.size()) {
-            Thread* wakeMe = internal->txWaitQueue.back();
-            status = wakeMe->Alert();
-            if (ER_OK != status) {
-                QCC_LogError(status, ("Failed to alert thread blocked on full tx queue"));
-            }
+    /* Remove thread from wait queue. */
+    thread->RemoveAuxListener(this);
+    internal->txWaitQueue.erase(waiter);
+    DecrementAndFetch(&internal->numTxWaiters);
+
+    /* Alert the first one in the txWaitQueue */
+    if (!internal->txWaitQueue.empty()) {
+        Thread* wakeMe = internal->txWaitQueue.front();
+        QStatus alertStatus = wakeMe->Alert();
+        if (ER_OK != alertStatus) {
+            QCC_LogError(alertStatus, ("Failed to alert thread blocked on full tx queue"));
         }
+    }
+    internal->txWaitLock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
 
+QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
+{
+    QStatus status = ER_OK;
 
+    if (IsControlMessage(msg)) {
+        if (ReserveTxRoom(internal->numControlMessages, internal->maxControlMessages)) {
+            status = EnqueueTxMessage(msg, internal->numControlMessages, count);
+        } else {
+            count = internal->txQueue.Size();
+            Invalidate();
+            internal->stopping = true;
+            internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+            QCC_LogError(ER_BUS_ENDPOINT_CLOSING, ("Endpoint Tx failed (%s)", GetUniqueName().c_str()));
+            status = ER_BUS_ENDPOINT_CLOSING;
+        }
+    } else {
+        /* If the txWaitQueue is not empty, dont queue the message.
+         * There are other threads that are blocked trying to send a message to
+         * this RemoteEndpoint
+         */
+        if ((internal->numTxWaiters > 0) || !ReserveTxRoom(internal->numDataMessages, internal->maxDataMessages)) {
+            status = WaitForTxRoom(internal->numDataMessages, internal->maxDataMessages);
+        }
+        if (status == ER_OK) {
+            status = EnqueueTxMessage(msg, internal->numDataMessages, count);
+        } else {
+            count = internal->txQueue.Size();
+        }
     }
 
+    return status;
+}
+
+QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
+{
+    static const int32_t MAX_TX_QUEUE_SIZE = 1;
 
-    if (wasEmpty && (status == ER_OK)) {
-        internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+    QStatus status = ER_OK;
+    /* If the txWaitQueue is not empty, dont queue the message.
+     * There are other threads that are blocked trying to send a message to
+     * this RemoteEndpoint
+     */
+    if ((internal->numTxWaiters > 0) || !ReserveTxRoom(internal->numDataMessages, MAX_TX_QUEUE_SIZE)) {
+        status = WaitForTxRoom(internal->numDataMessages, MAX_TX_QUEUE_SIZE);
+    }
+    if (status == ER_OK) {
+        status = EnqueueTxMessage(msg, internal->numDataMessages, count);
+    } else {
+        count = internal->txQueue.Size();
     }
-    internal->lock.Unlock(MUTEX_CONTEXT);
     return status;
 }
+
 QStatus _RemoteEndpoint::PushMessage(Message& msg)
 {
     assert(minimalEndpoint == false && "_RemoteEndpoint::PushMessage(): Unexpected PushMessage with no queues");
@@ -381,6 +381,18 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     virtual QStatus SetLinkTimeout(uint32_t& idleTimeout);
 
+    /**
+     * Set the policy for coalescing queued messages into a single gather write
+     * on the endpoint's stream.  Queued messages are written together until
+     * either limit is reached or the txQueue is empty.  Must be called before
+     * Start().  On a routing node up to maxMessages data messages may be queued
+     * before PushMessage() blocks so that there is something to coalesce.
+     *
+     * @param maxMessages  Maximum number of messages per write, 1 disables coalescing.
+     * @param maxBytes     Stop adding messages to a write once it holds this many bytes.
+     */
+    void SetTxCoalescing(uint32_t maxMessages, uint32_t maxBytes);
+
     /**
      * Set Idle timeouts for Router to leaf node connection
      *
@@ -638,6 +650,90 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      *      - An error status otherwise
      */
     virtual QStatus PushMessageLeaf(Message& msg, size_t& count);
+
+    /**
+     * Add a message to the txQueue once room for it has been reserved and
+     * wake up the writer if the queue was empty.
+     *
+     * @param[in] msg      Message to be sent.
+     * @param[in] counter  Count of queued messages the room was reserved against.
+     * @param[out] count   Number of messages in txQueue ahead of this one
+     * @return
+     *      - ER_OK if successful.
+     *      - ER_BUS_WRITE_QUEUE_FULL if the txQueue had no free slot, the reservation is released.
+     */
+    QStatus EnqueueTxMessage(Message& msg, volatile int32_t& counter, size_t& count);
+
+    /**
+     * Release the room reserved for a message that has been taken off the txQueue.
+     *
+     * @param[in] msg   The message taken off the txQueue.
+     */
+    void ReleaseTxRoom(Message& msg);
+
+    /**
+     * Discard expired messages at the head of the txQueue that the writer has
+     * not started on.  Called by a producer blocked on a full txQueue.
+     *
+     * @return  Milliseconds until the message now at the head of the txQueue
+     *          expires or Event::WAIT_FOREVER if it has no TTL.
+     */
+    uint32_t DiscardExpiredTxMessages();
+
+    /**
+     * Block until room for a message can be reserved in the txQueue.  Blocked
+     * threads get room in the order they arrived.  The first blocked thread
+     * discards expired messages from the txQueue, as the writer may not reach
+     * them while the peer is not reading.
+     *
+     * @param[in] counter  Count of queued messages of the kind being sent.
+     * @param[in] limit    Maximum number of queued messages of that kind.
+     * @return
+     *      - ER_OK once room has been reserved.
+     *      - An error status otherwise
+     */
+    QStatus WaitForTxRoom(volatile int32_t& counter, int32_t limit);
+
+    /**
+     * Take the message that has just been written off the txQueue and wake up
+     * a thread waiting for room.
+     *
+     * @return
+     *      - ER_OK if successful.
+     *      - An error status otherwise
+     */
+    QStatus TxMessageDone();
+
+    /**
+     * Wake up the first thread waiting for room in the txQueue after room
+     * has been released.
+     *
+     * @return
+     *      - ER_OK if successful.
+     *      - An error status otherwise
+     */
+    QStatus AlertTxWaiter();
+
+    /**
+     * Move messages from the txQueue into a batch to be sent with a single
+     * gather write, starting with currentWriteMsg.  Stops at the coalescing
+     * limits, when the txQueue is empty or at a message that carries handles.
+     *
+     * @return
+     *      - ER_OK if successful.
+     *      - An error status otherwise
+     */
+    QStatus GatherTxBatch();
+
+    /**
+     * Write out the batch collected by GatherTxBatch().
+     *
+     * @return
+     *      - ER_OK once the whole batch has been written.
+     *      - ER_TIMEOUT if the stream cannot take any more bytes right now.
+     *      - An error status otherwise
+     */
+    QStatus FlushTxBatch();
 };
 
 }
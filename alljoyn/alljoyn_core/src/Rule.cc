@@ -22,6 +22,7 @@
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <alljoyn/Message.h>
+#include <alljoyn/MessageCursor.h>
 
 #include "Rule.h"
 #include "BusUtil.h"
@@ -127,6 +128,57 @@ Rule::Rule(const char* ruleSpec, QStatus* outStatus) : type(MESSAGE_INVALID), se
     }
 }
 
+bool Rule::ArgsMatch(const Message& msg) const
+{
+    /*
+     * Read the arguments directly from the message body. The cursor does not modify the message
+     * so there is no need to clone it even though the LocalEndpoint may be unmarshaling the same
+     * message, and only the arguments up to the last one in the rule are looked at.
+     */
+    MessageCursor cursor(msg);
+    if (cursor.GetStatus() == ER_BUS_NOT_ALLOWED) {
+        /*
+         * The body is encrypted, clone the message since this message is unmarshalled by the
+         * LocalEndpoint too and the process of unmarshalling is not thread-safe.
+         */
+        Message clone = Message(msg, true);
+        QStatus status = clone->UnmarshalArgs(clone->GetSignature());
+        if (status != ER_OK) {
+            return false;
+        }
+        for (map<uint32_t, String>::const_iterator it = args.begin(); it != args.end(); ++it) {
+            const MsgArg* arg = clone->GetArg(it->first);
+            if (!arg) {
+                return false;
+            }
+            if (ALLJOYN_STRING != arg->typeId) {
+                return false;
+            }
+            if (it->second != arg->v_string.str) {
+                return false;
+            }
+        }
+        return true;
+    }
+    uint32_t argN = 0;
+    for (map<uint32_t, String>::const_iterator it = args.begin(); it != args.end(); ++it) {
+        for (; argN < it->first; ++argN) {
+            if (cursor.Skip() != ER_OK) {
+                return false;
+            }
+        }
+        MsgArg arg;
+        if ((cursor.GetTypeId() != ALLJOYN_STRING) || (cursor.Get(arg) != ER_OK)) {
+            return false;
+        }
+        ++argN;
+        if (it->second != arg.v_string.str) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Rule::IsMatch(const Message& msg) const
 {
     /* The fields of a rule (if specified) are logically anded together */
@@ -148,29 +200,8 @@ bool Rule::IsMatch(const Message& msg) const
     if (!destination.empty() && (0 != strcmp(destination.c_str(), msg->GetDestination()))) {
         return false;
     }
-    if (!args.empty()) {
-        /*
-         * Clone the message since this message is unmarshalled by the
-         * LocalEndpoint too and the process of unmarshalling is not
-         * thread-safe.
-         */
-        Message clone = Message(msg, true);
-        QStatus status = clone->UnmarshalArgs(clone->GetSignature());
-        if (status != ER_OK) {
-            return false;
-        }
-        for (map<uint32_t, String>::const_iterator it = args.begin(); it != args.end(); ++it) {
-            const MsgArg* arg = clone->GetArg(it->first);
-            if (!arg) {
-                return false;
-            }
-            if (ALLJOYN_STRING != arg->typeId) {
-                return false;
-            }
-            if (it->second != arg->v_string.str) {
-                return false;
-            }
-        }
+    if (!args.empty() && !ArgsMatch(msg)) {
+        return false;
     }
     if (!implements.empty()) {
         if (strcmp(msg->GetInterface(), "org.alljoyn.About") || strcmp(msg->GetMemberName(), "Announce")) {
@@ -99,6 +99,16 @@ struct Rule {
      */
     qcc::String ToString() const;
 
+  private:
+
+    /**
+     * Return true if the string arguments of a message match the arg keys of the rule.
+     *
+     * @param msg   Message to compare with rule.
+     * @return  true if all of the args match.
+     */
+    bool ArgsMatch(const Message& msg) const;
+
 };
 
 }
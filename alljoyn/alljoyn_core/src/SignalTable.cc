@@ -39,13 +39,14 @@ namespace ajn {
 void SignalTable::Add(MessageReceiver* receiver,
                       MessageReceiver::SignalHandler handler,
                       const InterfaceDescription::Member* member,
-                      const qcc::String& rule)
+                      const qcc::String& rule,
+                      bool cursor)
 {
     QCC_DbgTrace(("SignalTable::Add(iface = {%s}, member = {%s}, rule = \"%s\")",
                   member->iface->GetName(),
                   member->name.c_str(),
                   rule.c_str()));
-    Entry entry(handler, receiver, member, rule);
+    Entry entry(handler, receiver, member, rule, cursor);
     Key key(member->iface->GetName(), member->name);
     lock.Lock(MUTEX_CONTEXT);
     hashTable.insert(pair<const Key, Entry>(key, entry));
@@ -80,20 +80,22 @@ class SignalTable {
         MessageReceiver* object;                     /**< Object that received the signal */
         const InterfaceDescription::Member* member;  /**< Signal member */
         Rule rule;                                   /**< Match rule */
+        bool cursor;                                 /**< Handler reads the arguments with a MessageCursor */
 
         /**
          * Construct an Entry
          */
-        Entry(const MessageReceiver::SignalHandler& handler, MessageReceiver* object, const InterfaceDescription::Member* member, const qcc::String& matchRule)
+        Entry(const MessageReceiver::SignalHandler& handler, MessageReceiver* object, const InterfaceDescription::Member* member, const qcc::String& matchRule, bool cursor)
             : handler(handler),
             object(object),
             member(member),
-            rule(matchRule.c_str()) { }
+            rule(matchRule.c_str()),
+            cursor(cursor) { }
 
         /**
          * Construct an empty Entry.
          */
-        Entry(void) : handler(), object(NULL), member(NULL), rule() { }
+        Entry(void) : handler(), object(NULL), member(NULL), rule(), cursor(false) { }
     };
 
     /** %Hash functor */
@@ -137,11 +139,13 @@ class SignalTable {
      * @param func        Handler for signal.
      * @param member      Signal member.
      * @param rule        Match rule
+     * @param cursor      True if func reads the arguments with a MessageCursor
      */
     void Add(MessageReceiver* receiver,
              MessageReceiver::SignalHandler func,
              const InterfaceDescription::Member* member,
-             const qcc::String& rule);
+             const qcc::String& rule,
+             bool cursor = false);
 
     /**
      * Remove an entry from the signal hash table.
@@ -229,7 +229,16 @@ size_t SignatureUtils::GetSize(const MsgArg* values, size_t numValues, size_t of
         case ALLJOYN_ARRAY:
             sz = PadUp(sz, 4) + 4;
             if (values->v_array.numElements) {
-                sz = GetSize(values->v_array.elements, values->v_array.numElements, sz);
+                /*
+                 * Arrays of fixed size elements can be sized without visiting each element.
+                 */
+                size_t elemSize = GetFixedSize(values->v_array.GetElemSig());
+                if (elemSize) {
+                    size_t alignment = AlignmentForType((AllJoynTypeId)(values->v_array.elemSig[0]));
+                    sz = PadUp(sz, alignment) + (values->v_array.numElements - 1) * PadUp(elemSize, alignment) + elemSize;
+                } else {
+                    sz = GetSize(values->v_array.elements, values->v_array.numElements, sz);
+                }
             } else {
                 size_t alignment = AlignmentForType((AllJoynTypeId)(values->v_array.elemSig[0]));
                 sz = PadUp(sz, alignment);
@@ -306,6 +315,141 @@ size_t SignatureUtils::GetSize(const MsgArg* values, size_t numValues, size_t of
     return sz;
 }
 
+/*
+ * Accumulates the marshaled size of a single complete type, returns false if the type does not have
+ * a fixed size.
+ */
+static bool AddFixedSize(const char*& sigPtr, size_t& sz)
+{
+    switch (*sigPtr++) {
+    case ALLJOYN_BYTE:
+        sz += 1;
+        return true;
+
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+        sz = PadUp(sz, 2) + 2;
+        return true;
+
+    case ALLJOYN_BOOLEAN:
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+    case ALLJOYN_HANDLE:
+        sz = PadUp(sz, 4) + 4;
+        return true;
+
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_UINT64:
+    case ALLJOYN_INT64:
+        sz = PadUp(sz, 8) + 8;
+        return true;
+
+    case ALLJOYN_STRUCT_OPEN:
+        sz = PadUp(sz, 8);
+        while (*sigPtr != ALLJOYN_STRUCT_CLOSE) {
+            if (!AddFixedSize(sigPtr, sz)) {
+                return false;
+            }
+        }
+        ++sigPtr;
+        return true;
+
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        sz = PadUp(sz, 8);
+        while (*sigPtr != ALLJOYN_DICT_ENTRY_CLOSE) {
+            if (!AddFixedSize(sigPtr, sz)) {
+                return false;
+            }
+        }
+        ++sigPtr;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+size_t SignatureUtils::GetFixedSize(const char* signature)
+{
+    size_t sz = 0;
+    if (!signature || !AddFixedSize(signature, sz) || *signature) {
+        return 0;
+    }
+    return sz;
+}
+
+bool SignatureUtils::MatchSignature(const MsgArg* value, const char*& sigPtr)
+{
+    if (!value) {
+        return false;
+    }
+    switch (value->typeId) {
+    case ALLJOYN_DICT_ENTRY:
+        if (*sigPtr++ != ALLJOYN_DICT_ENTRY_OPEN) {
+            return false;
+        }
+        if (!MatchSignature(value->v_dictEntry.key, sigPtr) || !MatchSignature(value->v_dictEntry.val, sigPtr)) {
+            return false;
+        }
+        return *sigPtr++ == ALLJOYN_DICT_ENTRY_CLOSE;
+
+    case ALLJOYN_STRUCT:
+        if (*sigPtr++ != ALLJOYN_STRUCT_OPEN) {
+            return false;
+        }
+        for (size_t i = 0; i < value->v_struct.numMembers; i++) {
+            if (!MatchSignature(&value->v_struct.members[i], sigPtr)) {
+                return false;
+            }
+        }
+        return *sigPtr++ == ALLJOYN_STRUCT_CLOSE;
+
+    case ALLJOYN_ARRAY:
+        {
+            const char* elemSig = value->v_array.GetElemSig();
+            size_t elemSigLen = strlen(elemSig);
+            if ((*sigPtr++ != ALLJOYN_ARRAY) || (elemSigLen == 0) || (strncmp(sigPtr, elemSig, elemSigLen) != 0)) {
+                return false;
+            }
+            sigPtr += elemSigLen;
+            return true;
+        }
+
+    case ALLJOYN_BOOLEAN_ARRAY:
+    case ALLJOYN_INT32_ARRAY:
+    case ALLJOYN_UINT32_ARRAY:
+    case ALLJOYN_DOUBLE_ARRAY:
+    case ALLJOYN_UINT64_ARRAY:
+    case ALLJOYN_INT64_ARRAY:
+    case ALLJOYN_INT16_ARRAY:
+    case ALLJOYN_UINT16_ARRAY:
+    case ALLJOYN_BYTE_ARRAY:
+        if (*sigPtr++ != ALLJOYN_ARRAY) {
+            return false;
+        }
+        return *sigPtr++ == (char)(value->typeId >> 8);
+
+    case ALLJOYN_BOOLEAN:
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_UINT64:
+    case ALLJOYN_INT64:
+    case ALLJOYN_SIGNATURE:
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+    case ALLJOYN_OBJECT_PATH:
+    case ALLJOYN_STRING:
+    case ALLJOYN_VARIANT:
+    case ALLJOYN_BYTE:
+    case ALLJOYN_HANDLE:
+        return *sigPtr++ == (char)value->typeId;
+
+    default:
+        return false;
+    }
+}
+
 uint8_t SignatureUtils::CountCompleteTypes(const char* signature)
 {
     uint8_t count = 0;
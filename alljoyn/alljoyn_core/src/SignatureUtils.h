@@ -82,6 +82,29 @@ class SignatureUtils {
      */
     static size_t GetSize(const MsgArg* values, size_t numValues, size_t offset = 0);
 
+    /**
+     * Get the marshaled size of a single complete type if every value with that signature has the
+     * same size, i.e. the type is made up of fixed size basic types, structs and dictionary entries.
+     *
+     * @param signature  The signature of a single complete type
+     *
+     * @return  The marshaled size of the type starting on its alignment boundary or 0 if the type
+     *          does not have a fixed size.
+     */
+    static size_t GetFixedSize(const char* signature);
+
+    /**
+     * Check a message arg value against the signature it is expected to have without building
+     * its signature.
+     *
+     * @param value   The value to check
+     * @param sigPtr  Pointer to the expected signature, on success this is left pointing at the
+     *                first character after the complete type that matched.
+     *
+     * @return  Returns true if the signature of the value is a prefix of the expected signature.
+     */
+    static bool MatchSignature(const MsgArg* value, const char*& sigPtr);
+
     /**
      * Parses a complete type leaving the signature pointer pointing at the first character after
      * the complete type.
@@ -25,6 +25,7 @@
 #include <alljoyn/PasswordManager.h>
 #include "AutoPingerInternal.h"
 #include "BusInternal.h"
+#include "MessageBufferPool.h"
 #include "NamedPipeClientTransport.h"
 
 namespace ajn {
@@ -33,6 +34,7 @@ class StaticGlobals {
   public:
     static void Init()
     {
+        MessageBufferPool::Init();
         NamedPipeClientTransport::Init();
         AutoPingerInternal::Init();
         PasswordManager::Init();
@@ -45,6 +47,7 @@ class StaticGlobals {
         PasswordManager::Shutdown();
         AutoPingerInternal::Shutdown();
         NamedPipeClientTransport::Shutdown();
+        MessageBufferPool::Shutdown();
     }
 };
 
@@ -95,10 +95,26 @@ class DefaultKeyStoreListener : public KeyStoreListener {
 
     QStatus StoreRequest(KeyStore& keyStore) {
         QStatus status;
+        /* Append the changes to an existing key store unless it needs to be rewritten */
+        if (FileExists(fileName) == ER_OK) {
+            FileSink sink(fileName, FileSink::APPEND);
+            if (sink.IsValid()) {
+                sink.Lock(true);
+                status = keyStore.PushChanges(sink);
+                sink.Unlock();
+                if (status == ER_OK) {
+                    QCC_DbgHLPrintf(("Appended key store changes to %s", fileName.c_str()));
+                    return status;
+                }
+                if (status != ER_KEY_STORE_COMPACTION_REQUIRED) {
+                    QCC_LogError(status, ("Cannot append key store changes to %s", fileName.c_str()));
+                }
+            }
+        }
         FileSink sink(fileName, FileSink::PRIVATE);
         if (sink.IsValid()) {
             sink.Lock(true);
-            status = keyStore.Push(sink);
+            status = keyStore.Push(sink, true);
             if (status == ER_OK) {
                 QCC_DbgHLPrintf(("Wrote key store to %s", fileName.c_str()));
             }
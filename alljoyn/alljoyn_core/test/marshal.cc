@@ -23,6 +23,7 @@
 #include <ctype.h>
 #include <qcc/platform.h>
 #include <queue>
+#include <vector>
 #include <algorithm>
 
 #include <qcc/Util.h>
@@ -30,11 +31,13 @@
 #include <qcc/Pipe.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
+#include <qcc/time.h>
 #include <qcc/ManagedObj.h>
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/Init.h>
 #include <alljoyn/Message.h>
+#include <alljoyn/MessageCursor.h>
 #include <alljoyn/version.h>
 
 #include <alljoyn/Status.h>
@@ -1063,14 +1066,141 @@ QStatus TestMsgUnpack()
 
 }
 
+/*
+ * Time marshaling a message with a single large array argument
+ */
+static QStatus TimeMarshal(const char* label, const MsgArg& arg, size_t iterations)
+{
+    QStatus status = ER_OK;
+    MyMessage msg;
+    bool wasQuiet = quiet;
+    quiet = true;
+    uint64_t start = GetTimestamp64();
+    for (size_t j = 0; (j < iterations) && (status == ER_OK); ++j) {
+        status = msg->MethodCall("desti.nation", "/foo/bar", "foo.bar", "test", &arg, 1);
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+    quiet = wasQuiet;
+    if (status == ER_OK) {
+        printf("%-24s %8.3f ms per message\n", label, (double)elapsed / iterations);
+    }
+    return status;
+}
+
+/*
+ * Time reading the first argument of a received message by unmarshaling the whole body compared
+ * with reading just that argument with a MessageCursor
+ */
+static QStatus TimeUnmarshal(const char* label, const MsgArg* args, size_t numArgs, size_t iterations)
+{
+    QStatus status = ER_OK;
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    RemoteEndpoint ep(*gBus, falsiness, String::Empty, pStream);
+    bool wasQuiet = quiet;
+    quiet = true;
+    for (int lazy = 0; (lazy < 2) && (status == ER_OK); ++lazy) {
+        std::vector<MyMessage> rcvd;
+        for (size_t j = 0; (j < iterations) && (status == ER_OK); ++j) {
+            MyMessage msg;
+            MyMessage rcv;
+            status = msg->Signal(NULL, "/foo/bar", "foo.bar", "test", args, numArgs);
+            if (status == ER_OK) {
+                status = msg->Deliver(ep);
+            }
+            if (status == ER_OK) {
+                status = rcv->Read(ep, ":88.88");
+            }
+            if (status == ER_OK) {
+                status = rcv->Unmarshal(ep, ":88.88");
+            }
+            rcvd.push_back(rcv);
+        }
+        uint32_t first = 0;
+        uint64_t start = GetTimestamp64();
+        for (size_t j = 0; (j < rcvd.size()) && (status == ER_OK); ++j) {
+            if (lazy) {
+                MessageCursor cursor(Message::cast(rcvd[j]));
+                MsgArg arg;
+                status = cursor.Get(arg);
+                first += arg.v_uint32;
+            } else {
+                status = rcvd[j]->UnmarshalBody();
+                if (status == ER_OK) {
+                    first += rcvd[j]->GetArg(0)->v_uint32;
+                }
+            }
+        }
+        uint64_t elapsed = GetTimestamp64() - start;
+        if (status == ER_OK) {
+            printf("%-24s %-13s %8.3f ms per message\n", label, lazy ? "MessageCursor" : "UnmarshalArgs", (double)elapsed / iterations);
+        }
+    }
+    quiet = wasQuiet;
+    return status;
+}
+
+QStatus MarshalBenchmark()
+{
+    QStatus status;
+    const size_t numElements = 10000;
+    const size_t iterations = 50;
+    MsgArg* elements = new MsgArg[numElements];
+    MsgArg* values = new MsgArg[numElements];
+    MsgArg arg;
+
+    /* array of fixed size structs */
+    for (size_t j = 0; j < numElements; ++j) {
+        elements[j].Set("(yiqt)", (uint8_t)j, (int32_t)j, (uint16_t)j, (uint64_t)j);
+    }
+    status = arg.Set("a(yiqt)", numElements, elements);
+    if (status == ER_OK) {
+        status = TimeMarshal("a(yiqt) x 10000", arg, iterations);
+    }
+    /* array of structs with strings */
+    if (status == ER_OK) {
+        for (size_t j = 0; j < numElements; ++j) {
+            elements[j].Set("(isd)", (int32_t)j, s, d);
+        }
+        status = arg.Set("a(isd)", numElements, elements);
+    }
+    if (status == ER_OK) {
+        status = TimeMarshal("a(isd) x 10000", arg, iterations);
+    }
+    /* dictionary with variant values */
+    if (status == ER_OK) {
+        for (size_t j = 0; j < numElements; ++j) {
+            values[j].Set("u", (uint32_t)j);
+            elements[j].Set("{sv}", s, &values[j]);
+        }
+        status = arg.Set("a{sv}", numElements, elements);
+    }
+    if (status == ER_OK) {
+        status = TimeMarshal("a{sv} x 10000", arg, iterations);
+    }
+    /* signal with a small argument in front of a large dictionary */
+    if (status == ER_OK) {
+        MsgArg args[2];
+        args[0].Set("u", 42);
+        status = args[1].Set("a{sv}", 2000, elements);
+        if (status == ER_OK) {
+            status = TimeUnmarshal("ua{sv} x 2000", args, ArraySize(args), iterations);
+        }
+    }
+    arg.Clear();
+    delete [] elements;
+    delete [] values;
+    return status;
+}
 
 static void usage(void)
 {
-    printf("Usage: marshal [-f] [-q]\n");
+    printf("Usage: marshal [-f] [-q] [-b] [-p]\n");
     printf("Options:\n");
     printf("   -f         = fuzzing\n");
     printf("   -q         = Quiet\n");
     printf("   -b         = Suppress big array test (which takes a long time)\n");
+    printf("   -p         = Run marshaling benchmark\n");
 }
 
 int CDECL_CALL main(int argc, char** argv)
@@ -1085,6 +1215,7 @@ int CDECL_CALL main(int argc, char** argv)
     }
 #endif
     bool fuzz = false;
+    bool bench = false;
     QStatus status = ER_OK;
 
     printf("AllJoyn Library version: %s\n", ajn::GetVersion());
@@ -1098,6 +1229,8 @@ int CDECL_CALL main(int argc, char** argv)
             nobig = true;
         } else if (0 == strcmp("-q", argv[j])) {
             quiet = true;
+        } else if (0 == strcmp("-p", argv[j])) {
+            bench = true;
         } else {
             usage();
             exit(1);
@@ -1321,6 +1454,10 @@ int CDECL_CALL main(int argc, char** argv)
         status = MarshalTests();
     }
 
+    if ((status == ER_OK) && bench) {
+        status = MarshalBenchmark();
+    }
+
     if (status == ER_OK) {
         printf("\nPASSED\n");
     } else {
@@ -17,14 +17,18 @@
 #include "ajTestCommon.h"
 #include "BusObjectTestBusObject.h"
 #include <alljoyn/Message.h>
+#include <alljoyn/MessageCursor.h>
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/BusListener.h>
 #include <alljoyn/BusObject.h>
 #include <alljoyn/ProxyBusObject.h>
 #include <alljoyn/InterfaceDescription.h>
 #include <alljoyn/DBusStd.h>
+#include <qcc/atomic.h>
 #include <qcc/Debug.h>
+#include <qcc/StringUtil.h>
 #include <qcc/Thread.h>
+#include <qcc/time.h>
 #include <qcc/Util.h>
 
 using namespace ajn;
@@ -594,3 +598,302 @@ TEST(BusObjectTest, GetAllPropsWithStaticMsgArgProp)
     status = pbo.GetAllProperties("org.test", props);
     EXPECT_EQ(ER_OK, status);
 }
+
+class IntrospectTestBusObject : public BusObject {
+  public:
+    IntrospectTestBusObject(const char* path) : BusObject(path) { }
+
+    using BusObject::AddInterface;
+    using BusObject::GenerateIntrospection;
+};
+
+static void CreateIntrospectTestInterface(BusAttachment& bus, const qcc::String& name, const InterfaceDescription*& iface)
+{
+    InterfaceDescription* intf = NULL;
+    EXPECT_EQ(ER_OK, bus.CreateInterface(name.c_str(), intf));
+    ASSERT_TRUE(intf != NULL);
+    intf->SetDescriptionLanguage("en");
+    intf->SetDescription("An interface for testing introspection");
+    EXPECT_EQ(ER_OK, intf->AddMethod("Method", "sus", "s", "inStr1,inInt,inStr2,outStr", 0));
+    EXPECT_EQ(ER_OK, intf->SetMemberDescription("Method", "A method"));
+    EXPECT_EQ(ER_OK, intf->AddSignal("Signal", "a{sv}", "dict", 0));
+    EXPECT_EQ(ER_OK, intf->SetMemberDescription("Signal", "A signal"));
+    EXPECT_EQ(ER_OK, intf->AddProperty("Prop", "u", PROP_ACCESS_RW));
+    EXPECT_EQ(ER_OK, intf->SetPropertyDescription("Prop", "A property"));
+    intf->Activate();
+    iface = intf;
+}
+
+TEST(BusObjectTest, IntrospectionCacheInvalidation)
+{
+    BusAttachment bus("testIntrospectionCache");
+    const InterfaceDescription* iface1 = NULL;
+    const InterfaceDescription* iface2 = NULL;
+    CreateIntrospectTestInterface(bus, "org.test.introspect1", iface1);
+    CreateIntrospectTestInterface(bus, "org.test.introspect2", iface2);
+    ASSERT_TRUE(iface1 != NULL);
+    ASSERT_TRUE(iface2 != NULL);
+
+    IntrospectTestBusObject parent("/org/alljoyn/test/introspect");
+    IntrospectTestBusObject child("/org/alljoyn/test/introspect/child");
+    EXPECT_EQ(ER_OK, parent.AddInterface(*iface1));
+    EXPECT_EQ(ER_OK, child.AddInterface(*iface1));
+    EXPECT_EQ(ER_OK, bus.RegisterBusObject(parent));
+
+    /* Repeated requests return the same document, with or without descriptions */
+    qcc::String noDesc = parent.GenerateIntrospection(false, 2);
+    qcc::String withDesc = parent.GenerateIntrospection("en", false, 2);
+    EXPECT_EQ(noDesc, parent.GenerateIntrospection(false, 2));
+    EXPECT_EQ(withDesc, parent.GenerateIntrospection("en", false, 2));
+    EXPECT_NE(noDesc, withDesc);
+    EXPECT_NE(+qcc::String::npos, withDesc.find("A method"));
+    EXPECT_EQ(+qcc::String::npos, noDesc.find("A method"));
+
+    /* Registering a child changes the parent's document */
+    qcc::String deep = parent.GenerateIntrospection("en", true, 0);
+    EXPECT_EQ(ER_OK, bus.RegisterBusObject(child));
+    qcc::String withChild = parent.GenerateIntrospection("en", false, 2);
+    EXPECT_NE(withDesc, withChild);
+    EXPECT_NE(+qcc::String::npos, withChild.find("<node name=\"child\"/>"));
+
+    /* Changes to the child change the deep document of the parent */
+    deep = parent.GenerateIntrospection("en", true, 0);
+    child.SetDescription("en", "A child object");
+    qcc::String deepWithDesc = parent.GenerateIntrospection("en", true, 0);
+    EXPECT_NE(deep, deepWithDesc);
+    EXPECT_NE(+qcc::String::npos, deepWithDesc.find("A child object"));
+    EXPECT_EQ(ER_OK, child.AddInterface(*iface2));
+    EXPECT_NE(deepWithDesc, parent.GenerateIntrospection("en", true, 0));
+    EXPECT_NE(+qcc::String::npos, parent.GenerateIntrospection("en", true, 0).find("org.test.introspect2"));
+
+    /* Adding an interface to the parent */
+    EXPECT_EQ(+qcc::String::npos, withChild.find("org.test.introspect2"));
+    EXPECT_EQ(ER_OK, parent.AddInterface(*iface2));
+    EXPECT_NE(+qcc::String::npos, parent.GenerateIntrospection("en", false, 2).find("org.test.introspect2"));
+
+    /* Unregistering the child removes it from the parent's document */
+    bus.UnregisterBusObject(child);
+    EXPECT_EQ(+qcc::String::npos, parent.GenerateIntrospection("en", false, 2).find("<node name=\"child\"/>"));
+    bus.UnregisterBusObject(parent);
+}
+
+TEST(BusObjectTest, IntrospectionCacheTranslators)
+{
+    BusAttachment bus("testIntrospectionCacheTranslators");
+    InterfaceDescription* intf = NULL;
+    EXPECT_EQ(ER_OK, bus.CreateInterface("org.test.introspect", intf));
+    ASSERT_TRUE(intf != NULL);
+    intf->SetDescriptionLanguage("en");
+    EXPECT_EQ(ER_OK, intf->AddMethod("Method", "s", "s", "inStr,outStr", 0));
+    EXPECT_EQ(ER_OK, intf->SetMemberDescription("Method", "A method"));
+    intf->Activate();
+
+    IntrospectTestBusObject obj("/org/alljoyn/test/introspect");
+    EXPECT_EQ(ER_OK, obj.AddInterface(*intf));
+    EXPECT_EQ(ER_OK, bus.RegisterBusObject(obj));
+    EXPECT_NE(+qcc::String::npos, obj.GenerateIntrospection("de", false, 2).find("A method"));
+
+    /* Setting a translator on an activated interface */
+    StringTableTranslator german;
+    EXPECT_EQ(ER_OK, german.AddStringTranslation("A method", "Eine Methode", "de"));
+    intf->SetDescriptionTranslator(&german);
+    EXPECT_NE(+qcc::String::npos, obj.GenerateIntrospection("de", false, 2).find("Eine Methode"));
+
+    /* Setting a translator again picks up changed translations */
+    EXPECT_EQ(ER_OK, german.AddStringTranslation("A method", "Ein Verfahren", "de"));
+    intf->SetDescriptionTranslator(&german);
+    EXPECT_NE(+qcc::String::npos, obj.GenerateIntrospection("de", false, 2).find("Ein Verfahren"));
+
+    /* The bus translator is used once the interface translator is removed */
+    StringTableTranslator busGerman;
+    EXPECT_EQ(ER_OK, busGerman.AddStringTranslation("A method", "Methode des Busses", "de"));
+    intf->SetDescriptionTranslator(NULL);
+    EXPECT_NE(+qcc::String::npos, obj.GenerateIntrospection("de", false, 2).find("A method"));
+    bus.SetDescriptionTranslator(&busGerman);
+    EXPECT_NE(+qcc::String::npos, obj.GenerateIntrospection("de", false, 2).find("Methode des Busses"));
+    bus.SetDescriptionTranslator(NULL);
+    bus.UnregisterBusObject(obj);
+}
+
+TEST(BusObjectTest, DISABLED_IntrospectionCacheBenchmark)
+{
+    BusAttachment bus("testIntrospectionBenchmark");
+    const size_t numIfaces = 8;
+    const uint32_t iterations = 5000;
+
+    IntrospectTestBusObject obj("/org/alljoyn/test/introspect");
+    for (size_t i = 0; i < numIfaces; ++i) {
+        const InterfaceDescription* iface = NULL;
+        CreateIntrospectTestInterface(bus, "org.test.introspect" + U32ToString((uint32_t)i), iface);
+        ASSERT_TRUE(iface != NULL);
+        EXPECT_EQ(ER_OK, obj.AddInterface(*iface));
+    }
+    EXPECT_EQ(ER_OK, bus.RegisterBusObject(obj));
+
+    qcc::String expected = obj.GenerateIntrospection("en", false, 2);
+    size_t length = 0;
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        /* Setting the same description discards the cached document without changing it */
+        obj.SetDescription("", "");
+        length += obj.GenerateIntrospection("en", false, 2).size();
+    }
+    uint64_t uncached = GetTimestamp64() - start;
+    EXPECT_EQ(iterations * expected.size(), length);
+
+    length = 0;
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        length += obj.GenerateIntrospection("en", false, 2).size();
+    }
+    uint64_t cached = GetTimestamp64() - start;
+    EXPECT_EQ(iterations * expected.size(), length);
+    EXPECT_EQ(expected, obj.GenerateIntrospection("en", false, 2));
+
+    printf("Introspect %u interfaces (%u bytes): uncached %.0f calls/sec, cached %.0f calls/sec\n",
+           static_cast<unsigned int>(numIfaces), static_cast<unsigned int>(expected.size()),
+           iterations * 1000.0 / (uncached ? uncached : 1), iterations * 1000.0 / (cached ? cached : 1));
+    bus.UnregisterBusObject(obj);
+}
+
+class CursorTestBusObject : public BusObject {
+  public:
+    CursorTestBusObject(BusAttachment& bus, const char* path) : BusObject(path), wasRegistered(false), argsUnmarshaled(false)
+    {
+        const InterfaceDescription* intf = bus.GetInterface("org.test");
+        EXPECT_TRUE(intf != NULL);
+        AddInterface(*intf);
+        EXPECT_EQ(ER_OK, AddCursorMethodHandler(intf->GetMember("pasta"), static_cast<MessageReceiver::MethodHandler>(&CursorTestBusObject::Pasta)));
+    }
+
+    void ObjectRegistered(void) {
+        wasRegistered = true;
+    }
+
+    void Pasta(const InterfaceDescription::Member* member, Message& msg)
+    {
+        QCC_UNUSED(member);
+        size_t numArgs = 0;
+        const MsgArg* args = NULL;
+        msg->GetArgs(numArgs, args);
+        argsUnmarshaled = (numArgs != 0);
+
+        /* Reply with the arguments in reverse order */
+        MessageCursor cursor(msg);
+        MsgArg str;
+        MsgArg num;
+        EXPECT_EQ(ER_OK, cursor.Get(str));
+        EXPECT_EQ(ER_OK, cursor.Get(num));
+        EXPECT_TRUE(cursor.AtEnd());
+        MsgArg reply[2] = { num, str };
+        EXPECT_EQ(ER_OK, MethodReply(msg, reply, ArraySize(reply)));
+    }
+
+    bool wasRegistered;
+    volatile bool argsUnmarshaled;
+};
+
+class CursorTestSignalReceiver : public MessageReceiver {
+  public:
+    CursorTestSignalReceiver() : signalReceived(0), argsUnmarshaled(false) { }
+
+    void SignalHandler(const InterfaceDescription::Member* member, const char* sourcePath, Message& msg)
+    {
+        QCC_UNUSED(member);
+        QCC_UNUSED(sourcePath);
+        size_t numArgs = 0;
+        const MsgArg* args = NULL;
+        msg->GetArgs(numArgs, args);
+        argsUnmarshaled = (numArgs != 0);
+
+        MessageCursor cursor(msg);
+        EXPECT_EQ(ALLJOYN_STRING, cursor.GetTypeId());
+        MsgArg str;
+        EXPECT_EQ(ER_OK, cursor.Get(str));
+        EXPECT_STREQ("cursor", str.v_string.str);
+        EXPECT_TRUE(cursor.AtEnd());
+        IncrementAndFetch(&signalReceived);
+    }
+
+    volatile int32_t signalReceived;
+    volatile bool argsUnmarshaled;
+};
+
+TEST(BusObjectTest, CursorHandlersReadArgumentsInPlace)
+{
+    BusAttachment busService("CursorHandlersService");
+    BusAttachment busClient("CursorHandlersClient");
+    ASSERT_EQ(ER_OK, busService.Start());
+    ASSERT_EQ(ER_OK, busService.Connect(ajn::getConnectArg().c_str()));
+    ASSERT_EQ(ER_OK, busClient.Start());
+    ASSERT_EQ(ER_OK, busClient.Connect(ajn::getConnectArg().c_str()));
+
+    InterfaceDescription* intf = NULL;
+    ASSERT_EQ(ER_OK, busService.CreateInterface("org.test", intf));
+    EXPECT_EQ(ER_OK, intf->AddMethod("pasta", "su", "us", "inStr,inNum,outNum,outStr", 0));
+    EXPECT_EQ(ER_OK, intf->AddSignal("my_signal", "s", NULL, 0));
+    intf->Activate();
+    ASSERT_EQ(ER_OK, busClient.CreateInterface("org.test", intf));
+    EXPECT_EQ(ER_OK, intf->AddMethod("pasta", "su", "us", "inStr,inNum,outNum,outStr", 0));
+    EXPECT_EQ(ER_OK, intf->AddSignal("my_signal", "s", NULL, 0));
+    intf->Activate();
+
+    CursorTestBusObject testObj(busService, OBJECT_PATH);
+    EXPECT_EQ(ER_OK, busService.RegisterBusObject(testObj));
+    for (int i = 0; !testObj.wasRegistered && (i < 500); ++i) {
+        qcc::Sleep(10);
+    }
+    EXPECT_TRUE(testObj.wasRegistered);
+
+    /* The method call is dispatched without unmarshaling its arguments */
+    ProxyBusObject proxy(busClient, busService.GetUniqueName().c_str(), OBJECT_PATH, 0, false);
+    EXPECT_EQ(ER_OK, proxy.AddInterface(*intf));
+    MsgArg inArgs[2];
+    EXPECT_EQ(ER_OK, inArgs[0].Set("s", "Pasta String"));
+    EXPECT_EQ(ER_OK, inArgs[1].Set("u", 42));
+    Message reply(busClient);
+    EXPECT_EQ(ER_OK, proxy.MethodCall("org.test", "pasta", inArgs, ArraySize(inArgs), reply, 5000));
+    EXPECT_FALSE(testObj.argsUnmarshaled);
+    size_t numReplyArgs = 0;
+    const MsgArg* replyArgs = NULL;
+    reply->GetArgs(numReplyArgs, replyArgs);
+    ASSERT_EQ(2U, numReplyArgs);
+    EXPECT_EQ(42U, reply->GetArg(0)->v_uint32);
+    EXPECT_STREQ("Pasta String", reply->GetArg(1)->v_string.str);
+
+    /* The signature is still checked */
+    BusAttachment busWrong("CursorHandlersWrongSignature");
+    ASSERT_EQ(ER_OK, busWrong.Start());
+    ASSERT_EQ(ER_OK, busWrong.Connect(ajn::getConnectArg().c_str()));
+    InterfaceDescription* wrongIntf = NULL;
+    ASSERT_EQ(ER_OK, busWrong.CreateInterface("org.test", wrongIntf));
+    EXPECT_EQ(ER_OK, wrongIntf->AddMethod("pasta", "ss", "us", "inStr,inNum,outNum,outStr", 0));
+    wrongIntf->Activate();
+    ProxyBusObject wrongProxy(busWrong, busService.GetUniqueName().c_str(), OBJECT_PATH, 0, false);
+    EXPECT_EQ(ER_OK, wrongProxy.AddInterface(*wrongIntf));
+    EXPECT_EQ(ER_OK, inArgs[1].Set("s", "42"));
+    Message wrongReply(busWrong);
+    EXPECT_EQ(ER_BUS_REPLY_IS_ERROR_MESSAGE, wrongProxy.MethodCall("org.test", "pasta", inArgs, ArraySize(inArgs), wrongReply, 5000));
+
+    /* The signal is dispatched without unmarshaling its arguments */
+    CursorTestSignalReceiver signalReceiver;
+    EXPECT_EQ(ER_OK, busClient.RegisterCursorSignalHandler(&signalReceiver,
+                                                           static_cast<MessageReceiver::SignalHandler>(&CursorTestSignalReceiver::SignalHandler),
+                                                           intf->GetMember("my_signal"),
+                                                           "type='signal',interface='org.test',member='my_signal'"));
+    EXPECT_EQ(ER_OK, busClient.AddMatch("type='signal',interface='org.test',member='my_signal'"));
+    MsgArg sigArg("s", "cursor");
+    const InterfaceDescription* serviceIntf = busService.GetInterface("org.test");
+    EXPECT_EQ(ER_OK, testObj.Signal(NULL, 0, *serviceIntf->GetMember("my_signal"), &sigArg, 1));
+    for (int i = 0; !signalReceiver.signalReceived && (i < 500); ++i) {
+        qcc::Sleep(10);
+    }
+    EXPECT_EQ(1, signalReceiver.signalReceived);
+    EXPECT_FALSE(signalReceiver.argsUnmarshaled);
+
+    EXPECT_EQ(ER_OK, busClient.UnregisterSignalHandlerWithRule(&signalReceiver,
+                                                               static_cast<MessageReceiver::SignalHandler>(&CursorTestSignalReceiver::SignalHandler),
+                                                               intf->GetMember("my_signal"),
+                                                               "type='signal',interface='org.test',member='my_signal'"));
+    busService.UnregisterBusObject(testObj);
+}
@@ -25,6 +25,9 @@
 
 #include <qcc/platform.h>
 
+#include <stdio.h>
+
+#include <qcc/atomic.h>
 #include <qcc/Debug.h>
 #include <qcc/FileStream.h>
 #include <qcc/KeyBlob.h>
@@ -34,8 +37,11 @@
 #include <qcc/GUID.h>
 #include <qcc/time.h>
 
+#include <alljoyn/BusAttachment.h>
 #include <alljoyn/version.h>
+#include "BusInternal.h"
 #include "KeyStore.h"
+#include "InMemoryKeyStore.h"
 
 #include <alljoyn/Status.h>
 
@@ -215,3 +221,315 @@ TEST(KeyStoreTest, keystore_store_load_merge) {
     DeleteFile("keystore_test");
 }
 
+
+static const char journalTestFile[] = "keystore_journal_test";
+
+static int64_t KeyStoreFileSize()
+{
+    int64_t size = 0;
+    FileSource source(GetHomeDir() + "/" + journalTestFile);
+    source.GetSize(size);
+    return size;
+}
+
+static void MakeKey(KeyBlob& key, uint32_t n)
+{
+    uint8_t data[32];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(n >> (8 * (i % 4))) ^ (uint8_t)i;
+    }
+    key.Set(data, sizeof(data), KeyBlob::GENERIC);
+}
+
+TEST(KeyStoreTest, keystore_journal_append_reload) {
+    qcc::GUID128 guid1;
+    qcc::GUID128 guid2;
+    qcc::GUID128 guid3;
+    qcc::GUID128 guid4;
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, guid1);
+    KeyStore::Key idx2(KeyStore::Key::REMOTE, guid2);
+    KeyStore::Key idx3(KeyStore::Key::REMOTE, guid3);
+    KeyStore::Key idx4(KeyStore::Key::REMOTE, guid4);
+    KeyBlob key;
+    KeyBlob replaced;
+    int64_t storedSize;
+
+    {
+        KeyStore keyStore("keystore_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+        ASSERT_EQ(ER_OK, keyStore.Clear());
+
+        MakeKey(key, 1);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx1, key));
+        MakeKey(key, 2);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        MakeKey(key, 3);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx3, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        storedSize = KeyStoreFileSize();
+
+        /* These changes are appended to the stored key store */
+        MakeKey(replaced, 10);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx1, replaced));
+        ASSERT_EQ(ER_OK, keyStore.DelKey(idx2));
+        MakeKey(key, 4);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx4, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        ASSERT_GT(KeyStoreFileSize(), storedSize);
+    }
+
+    {
+        KeyStore keyStore("keystore_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx1, key));
+        ASSERT_EQ(replaced.GetSize(), key.GetSize());
+        ASSERT_EQ(0, memcmp(replaced.GetData(), key.GetData(), key.GetSize()));
+        ASSERT_EQ(ER_BUS_KEY_UNAVAILABLE, keyStore.GetKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx3, key));
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx4, key));
+    }
+    DeleteFile(GetHomeDir() + "/" + journalTestFile);
+}
+
+TEST(KeyStoreTest, keystore_journal_partial_record) {
+    qcc::GUID128 guid1;
+    qcc::GUID128 guid2;
+    KeyStore::Key idx1(KeyStore::Key::REMOTE, guid1);
+    KeyStore::Key idx2(KeyStore::Key::REMOTE, guid2);
+    String fileName = GetHomeDir() + "/" + journalTestFile;
+    KeyBlob key;
+
+    {
+        KeyStore keyStore("keystore_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+        ASSERT_EQ(ER_OK, keyStore.Clear());
+        MakeKey(key, 1);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx1, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        MakeKey(key, 2);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+
+    /* Simulate a failed append by cutting off the end of the last journal record */
+    {
+        int64_t size = KeyStoreFileSize();
+        uint8_t* data = new uint8_t[size];
+        size_t pulled = 0;
+        size_t pushed = 0;
+        {
+            FileSource source(fileName);
+            ASSERT_EQ(ER_OK, source.PullBytes(data, size, pulled));
+        }
+        FileSink sink(fileName, FileSink::PRIVATE);
+        ASSERT_EQ(ER_OK, sink.PushBytes(data, pulled - 5, pushed));
+        delete [] data;
+    }
+
+    {
+        KeyStore keyStore("keystore_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx1, key));
+        ASSERT_EQ(ER_BUS_KEY_UNAVAILABLE, keyStore.GetKey(idx2, key));
+
+        /* The key store is rewritten without the partial record */
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+
+    {
+        KeyStore keyStore("keystore_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx1, key));
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx2, key));
+    }
+    DeleteFile(fileName);
+}
+
+static uint16_t KeyStoreVersion(const String& stored)
+{
+    uint16_t version = 0;
+    if (stored.size() >= sizeof(version)) {
+        memcpy(&version, stored.data(), sizeof(version));
+    }
+    return version;
+}
+
+TEST(KeyStoreTest, keystore_journal_format_version) {
+    qcc::GUID128 guid;
+    KeyStore::Key idx(KeyStore::Key::REMOTE, guid);
+    KeyBlob key;
+    MakeKey(key, 1);
+
+    /* Key stores without a journal can still be read by older releases */
+    {
+        KeyStore keyStore("keystore_test");
+        InMemoryKeyStoreListener listener;
+        ASSERT_EQ(ER_OK, keyStore.SetListener(listener));
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        String stored;
+        ASSERT_EQ(ER_OK, listener.GetKeys(keyStore, stored));
+        ASSERT_EQ(0x0104, KeyStoreVersion(stored));
+    }
+
+    /* The default listener appends a journal so it writes the journal format */
+    {
+        KeyStore keyStore("keystore_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+        ASSERT_EQ(ER_OK, keyStore.Clear());
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        String stored;
+        uint8_t data[2];
+        size_t pulled = 0;
+        FileSource source(GetHomeDir() + "/" + journalTestFile);
+        ASSERT_EQ(ER_OK, source.PullBytes(data, sizeof(data), pulled));
+        stored.append(reinterpret_cast<const char*>(data), pulled);
+        ASSERT_EQ(0x0105, KeyStoreVersion(stored));
+    }
+    DeleteFile(GetHomeDir() + "/" + journalTestFile);
+}
+
+TEST(KeyStoreTest, keystore_erase_expired_keys) {
+    const uint32_t numKeys = 1000;
+    KeyStore keyStore("keystore_test");
+    InMemoryKeyStoreListener listener;
+    ASSERT_EQ(ER_OK, keyStore.SetListener(listener));
+    ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+
+    KeyStore::Key* idx = new KeyStore::Key[numKeys];
+    for (uint32_t i = 0; i < numKeys; ++i) {
+        KeyBlob key;
+        MakeKey(key, i);
+        if (i & 1) {
+            key.SetExpiration(Timespec(1, TIME_RELATIVE));
+        }
+        idx[i] = KeyStore::Key(KeyStore::Key::REMOTE, GUID128());
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx[i], key));
+    }
+    qcc::Sleep(10);
+    ASSERT_EQ(ER_OK, keyStore.Store());
+    for (uint32_t i = 0; i < numKeys; ++i) {
+        ASSERT_EQ((i & 1) == 0, keyStore.HasKey(idx[i])) << " key " << i;
+    }
+    delete [] idx;
+}
+
+/* Counts the store requests made to it */
+class CountingKeyStoreListener : public InMemoryKeyStoreListener {
+  public:
+
+    CountingKeyStoreListener() : stores(0) { }
+
+    QStatus StoreRequest(KeyStore& keyStore) {
+        IncrementAndFetch(&stores);
+        return InMemoryKeyStoreListener::StoreRequest(keyStore);
+    }
+
+    volatile int32_t stores;
+};
+
+/* Longer than the delay before a scheduled store is performed */
+static const uint32_t scheduledStoreWait = 500;
+
+TEST(KeyStoreTest, keystore_scheduled_store_flushed_when_listener_replaced) {
+    KeyStore keyStore("keystore_test");
+    CountingKeyStoreListener listener;
+    ASSERT_EQ(ER_OK, keyStore.SetListener(listener));
+    ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        KeyBlob key;
+        MakeKey(key, i);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(KeyStore::Key(KeyStore::Key::REMOTE, GUID128()), key));
+        ASSERT_EQ(ER_OK, keyStore.ScheduleStore());
+    }
+
+    /* The scheduled changes are written together before the listener is released */
+    ASSERT_EQ(ER_OK, keyStore.SetDefaultListener());
+    EXPECT_EQ(1, listener.stores);
+    qcc::Sleep(scheduledStoreWait);
+    EXPECT_EQ(1, listener.stores);
+}
+
+TEST(KeyStoreTest, keystore_scheduled_store_flushed_when_bus_stopped) {
+    CountingKeyStoreListener listener;
+    BusAttachment bus("keystore_test");
+    ASSERT_EQ(ER_OK, bus.RegisterKeyStoreListener(listener));
+    ASSERT_EQ(ER_OK, bus.Start());
+    ASSERT_EQ(ER_OK, bus.EnablePeerSecurity("ALLJOYN_ECDHE_NULL", NULL));
+    KeyStore& keyStore = bus.GetInternal().GetKeyStore();
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        KeyBlob key;
+        MakeKey(key, i);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(KeyStore::Key(KeyStore::Key::REMOTE, GUID128()), key));
+        ASSERT_EQ(ER_OK, keyStore.ScheduleStore());
+    }
+    int32_t stored = listener.stores;
+
+    /* The scheduled changes are written together by the time the bus has stopped */
+    ASSERT_EQ(ER_OK, bus.Stop());
+    ASSERT_EQ(ER_OK, bus.Join());
+    EXPECT_EQ(stored + 1, listener.stores);
+    qcc::Sleep(scheduledStoreWait);
+    EXPECT_EQ(stored + 1, listener.stores);
+}
+
+TEST(KeyStoreBenchmark, DISABLED_keystore_journal_50k_keys) {
+    const uint32_t numKeys = 50000;
+    const uint32_t numUpdates = 200;
+    KeyStore::Key* idx = new KeyStore::Key[numKeys];
+    KeyBlob key;
+    uint64_t start;
+
+    {
+        KeyStore keyStore("keystore_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+        ASSERT_EQ(ER_OK, keyStore.Clear());
+        for (uint32_t i = 0; i < numKeys; ++i) {
+            MakeKey(key, i);
+            idx[i] = KeyStore::Key(KeyStore::Key::REMOTE, GUID128());
+            ASSERT_EQ(ER_OK, keyStore.AddKey(idx[i], key));
+        }
+        ASSERT_EQ(ER_OK, keyStore.Store());
+
+        /* Rewrite the whole key store as every store used to */
+        start = GetTimestamp64();
+        {
+            FileSink sink(GetHomeDir() + "/" + journalTestFile, FileSink::PRIVATE);
+            ASSERT_EQ(ER_OK, keyStore.Push(sink));
+        }
+        uint64_t fullStore = GetTimestamp64() - start;
+        int64_t fullSize = KeyStoreFileSize();
+
+        /* Each of these stores appends one key rather than rewriting all of them */
+        start = GetTimestamp64();
+        for (uint32_t i = 0; i < numUpdates; ++i) {
+            MakeKey(key, numKeys + i);
+            ASSERT_EQ(ER_OK, keyStore.AddKey(idx[i], key));
+            ASSERT_EQ(ER_OK, keyStore.Store());
+        }
+        uint64_t appendStores = GetTimestamp64() - start;
+        printf("%u keys: full store %u ms (%u bytes), %u single key stores %u ms (%u bytes appended)\n",
+               numKeys, (uint32_t)fullStore, (uint32_t)fullSize, numUpdates, (uint32_t)appendStores, (uint32_t)(KeyStoreFileSize() - fullSize));
+    }
+
+    {
+        KeyStore keyStore("keystore_test");
+        start = GetTimestamp64();
+        ASSERT_EQ(ER_OK, keyStore.Init(journalTestFile, false));
+        printf("%u keys: load with %u journal records %u ms\n", numKeys, numUpdates, (uint32_t)(GetTimestamp64() - start));
+        for (uint32_t i = 0; i < numKeys; ++i) {
+            ASSERT_EQ(ER_OK, keyStore.GetKey(idx[i], key));
+            KeyBlob expected;
+            MakeKey(expected, (i < numUpdates) ? (numKeys + i) : i);
+            ASSERT_EQ(0, memcmp(expected.GetData(), key.GetData(), key.GetSize())) << " key " << i;
+        }
+    }
+    delete [] idx;
+    DeleteFile(GetHomeDir() + "/" + journalTestFile);
+}
@@ -0,0 +1,242 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <qcc/atomic.h>
+#include <qcc/Mutex.h>
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+
+#include <map>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/MsgArg.h>
+#include <alljoyn/ProxyBusObject.h>
+
+#include <alljoyn/Status.h>
+
+/* Private files included for unit testing */
+#include <BusInternal.h>
+#include <LocalTransport.h>
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "ajTestCommon.h"
+
+using namespace ajn;
+using namespace qcc;
+
+/*
+ * Cached property replies are delivered by the local endpoint's dispatcher so
+ * they are used here to run callbacks on the dispatcher without connecting the
+ * bus.
+ */
+class DispatchedCallback : public ProxyBusObject::Listener {
+  public:
+
+    DispatchedCallback(LocalEndpoint& ep) : ep(ep), calls(0), reentrant(true), joined(false) { }
+
+    void Schedule(bool join)
+    {
+        MsgArg value("u", 1);
+        ep->ScheduleCachedGetPropertyReply(NULL, this, static_cast<ProxyBusObject::Listener::GetPropertyCB>(&DispatchedCallback::Callback), join ? this : NULL, value);
+    }
+
+    void Callback(QStatus status, ProxyBusObject* obj, const MsgArg& value, void* context)
+    {
+        QCC_UNUSED(status);
+        QCC_UNUSED(obj);
+        QCC_UNUSED(value);
+        if (!ep->IsReentrantCall()) {
+            reentrant = false;
+        }
+        IncrementAndFetch(&calls);
+        if (context) {
+            /* Stopping and joining from a handler must not wait for or free the calling worker */
+            ep->Stop();
+            ep->Join();
+            joined = true;
+        }
+    }
+
+    LocalEndpoint& ep;
+    volatile int32_t calls;
+    volatile bool reentrant;
+    volatile bool joined;
+};
+
+TEST(LocalEndpointTest, CallbacksHoldReentrancyLock)
+{
+    BusAttachment bus("CallbacksHoldReentrancyLock", false, 4);
+    ASSERT_EQ(ER_OK, bus.Start());
+    LocalEndpoint ep = bus.GetInternal().GetLocalEndpoint();
+    EXPECT_FALSE(ep->IsReentrantCall());
+
+    const int32_t count = 1000;
+    DispatchedCallback cb(ep);
+    for (int32_t i = 0; i < count; ++i) {
+        cb.Schedule(false);
+    }
+    for (uint32_t msec = 0; (cb.calls < count) && (msec < 5000); msec += 10) {
+        qcc::Sleep(10);
+    }
+    EXPECT_EQ(count, cb.calls);
+    EXPECT_TRUE(cb.reentrant);
+
+    EXPECT_EQ(ER_OK, bus.Stop());
+    EXPECT_EQ(ER_OK, bus.Join());
+}
+
+TEST(LocalEndpointTest, JoinFromCallback)
+{
+    BusAttachment bus("JoinFromCallback", false, 4);
+    ASSERT_EQ(ER_OK, bus.Start());
+    LocalEndpoint ep = bus.GetInternal().GetLocalEndpoint();
+
+    DispatchedCallback cb(ep);
+    cb.Schedule(true);
+    for (uint32_t msec = 0; !cb.joined && (msec < 5000); msec += 10) {
+        qcc::Sleep(10);
+    }
+    EXPECT_TRUE(cb.joined);
+
+    EXPECT_EQ(ER_OK, bus.Stop());
+    EXPECT_EQ(ER_OK, bus.Join());
+}
+
+/*
+ * Records the order in which signals from each sender are handled. Handlers enable concurrent
+ * callbacks so only the dispatcher keeps the signals from one sender in order.
+ */
+class SenderOrderReceiver : public MessageReceiver {
+  public:
+
+    SenderOrderReceiver(BusAttachment& bus) : bus(bus), received(0), inOrder(true) { }
+
+    void Handler(const InterfaceDescription::Member* member, const char* srcPath, Message& msg)
+    {
+        QCC_UNUSED(member);
+        QCC_UNUSED(srcPath);
+        bus.EnableConcurrentCallbacks();
+        String sender = msg->GetSender();
+        uint32_t seq = msg->GetArg(0)->v_uint32;
+
+        lock.Lock(MUTEX_CONTEXT);
+        if ((seq != next[sender]) || active[sender]) {
+            inOrder = false;
+        }
+        active[sender] = true;
+        lock.Unlock(MUTEX_CONTEXT);
+
+        /* Give a later signal from the same sender the chance to overtake this one */
+        qcc::Sleep(1);
+
+        lock.Lock(MUTEX_CONTEXT);
+        active[sender] = false;
+        next[sender] = seq + 1;
+        lock.Unlock(MUTEX_CONTEXT);
+        IncrementAndFetch(&received);
+    }
+
+    BusAttachment& bus;
+    Mutex lock;
+    std::map<String, uint32_t> next;
+    std::map<String, bool> active;
+    volatile int32_t received;
+    volatile bool inOrder;
+};
+
+class _SeqSignal : public _Message {
+  public:
+
+    _SeqSignal(BusAttachment& bus) : _Message(bus) { }
+
+    QStatus Signal(const char* sender, uint32_t seq)
+    {
+        MsgArg arg("u", seq);
+        QStatus status = SignalMsg("u", NULL, 0, "/org/alljoyn/test", "org.alljoyn.test.SenderOrder", "Seq", &arg, 1, 0, 0);
+        if (status == ER_OK) {
+            status = ReMarshal(sender);
+        }
+        return status;
+    }
+};
+
+typedef ManagedObj<_SeqSignal> SeqSignal;
+
+/* Pushes numbered signals from one sender into the local endpoint */
+class SenderThread : public Thread {
+  public:
+
+    SenderThread(BusAttachment& bus, const String& sender, uint32_t count) :
+        Thread("SenderThread"), bus(bus), sender(sender), count(count), status(ER_OK) { }
+
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        LocalEndpoint ep = bus.GetInternal().GetLocalEndpoint();
+        for (uint32_t i = 0; (i < count) && (status == ER_OK); ++i) {
+            SeqSignal seq(bus);
+            status = seq->Signal(sender.c_str(), i);
+            if (status == ER_OK) {
+                Message msg = Message::cast(seq);
+                status = ep->PushMessage(msg);
+            }
+        }
+        return 0;
+    }
+
+    BusAttachment& bus;
+    String sender;
+    uint32_t count;
+    QStatus status;
+};
+
+TEST(LocalEndpointTest, ConcurrentSendersHandledInOrder)
+{
+    const uint32_t numSenders = 4;
+    const uint32_t count = 50;
+
+    BusAttachment bus("ConcurrentSendersHandledInOrder", false, 4);
+    InterfaceDescription* iface = NULL;
+    ASSERT_EQ(ER_OK, bus.CreateInterface("org.alljoyn.test.SenderOrder", iface));
+    ASSERT_EQ(ER_OK, iface->AddSignal("Seq", "u", NULL, 0));
+    iface->Activate();
+    SenderOrderReceiver receiver(bus);
+    ASSERT_EQ(ER_OK, bus.RegisterSignalHandler(&receiver, static_cast<MessageReceiver::SignalHandler>(&SenderOrderReceiver::Handler), iface->GetMember("Seq"), NULL));
+    ASSERT_EQ(ER_OK, bus.Start());
+
+    SenderThread* senders[numSenders];
+    for (uint32_t i = 0; i < numSenders; ++i) {
+        senders[i] = new SenderThread(bus, ":sender" + U32ToString(i) + ".2", count);
+        ASSERT_EQ(ER_OK, senders[i]->Start());
+    }
+    for (uint32_t i = 0; i < numSenders; ++i) {
+        senders[i]->Join();
+        EXPECT_EQ(ER_OK, senders[i]->status);
+        delete senders[i];
+    }
+    for (uint32_t msec = 0; (receiver.received < (int32_t)(numSenders * count)) && (msec < 10000); msec += 10) {
+        qcc::Sleep(10);
+    }
+    EXPECT_EQ((int32_t)(numSenders * count), receiver.received);
+    EXPECT_TRUE(receiver.inOrder);
+
+    EXPECT_EQ(ER_OK, bus.Stop());
+    EXPECT_EQ(ER_OK, bus.Join());
+}
@@ -25,6 +25,7 @@
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/Message.h>
+#include <alljoyn/MessageCursor.h>
 #include <alljoyn/version.h>
 
 #include <alljoyn/Status.h>
@@ -33,6 +34,7 @@
 #include <PeerState.h>
 #include <SignatureUtils.h>
 #include <RemoteEndpoint.h>
+#include <MessageBufferPool.h>
 
 /* Header files included for Google Test Framework */
 #include <gtest/gtest.h>
@@ -125,6 +127,8 @@ class MyMessage : public _Message {
 
     QStatus UnmarshalBody() { return UnmarshalArgs("*"); }
 
+    QStatus ReMarshal(const char* senderName) { return _Message::ReMarshal(senderName); }
+
     QStatus Read(RemoteEndpoint& ep, const qcc::String& endpointName, bool pedantic = true)
     {
         QCC_UNUSED(endpointName);
@@ -307,6 +311,205 @@ TEST(MarshalTest, TestMsgUnpack) {
     delete bus;
 }
 
+TEST(MarshalTest, MessageBuffersAreRecycled) {
+    BusAttachment* bus = new BusAttachment("MessageBuffersAreRecycled", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    MsgArg args[2];
+    size_t numArgs = ArraySize(args);
+    MsgArg::Set(args, numArgs, "us", 4, "hello");
+
+    MessageBufferPool::Stats before;
+    MessageBufferPool::Stats after;
+    for (int pass = 0; pass < 2; ++pass) {
+        /* The first pass warms the pool up, the second one must not miss */
+        MessageBufferPool::GetStats(before);
+        for (int i = 0; i < 20; ++i) {
+            MyMessage msg(*bus);
+            ASSERT_EQ(ER_OK, msg.Signal(NULL, "/foo/bar", "foo.bar", "test", args, numArgs));
+            ASSERT_EQ(ER_OK, msg.Deliver(ep));
+            MyMessage rcv(*bus);
+            ASSERT_EQ(ER_OK, rcv.Read(ep, ":88.88"));
+            ASSERT_EQ(ER_OK, rcv.Unmarshal(ep, ":88.88"));
+            ASSERT_EQ(ER_OK, rcv.UnmarshalBody());
+        }
+        MessageBufferPool::GetStats(after);
+    }
+    EXPECT_LE(40U, after.allocs - before.allocs);
+    EXPECT_EQ(after.allocs - before.allocs, after.frees - before.frees);
+    EXPECT_EQ(before.misses, after.misses);
+    EXPECT_LE(1U, after.cachedBuffers);
+
+    delete bus;
+}
+
+TEST(MarshalTest, ReMarshalReplacesSenderInPlace) {
+    BusAttachment* bus = new BusAttachment("ReMarshalReplacesSenderInPlace", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    uint8_t payload[8192];
+    for (size_t i = 0; i < sizeof(payload); ++i) {
+        payload[i] = (uint8_t)(i * 7);
+    }
+    MsgArg args[2];
+    size_t numArgs = ArraySize(args);
+    MsgArg::Set(args, numArgs, "ays", sizeof(payload), payload, "tail");
+
+    /* A short name shrinks the header, the others grow it by different amounts */
+    const char* senders[] = { ":a.1", ":abcdefgh.2", ":abcdefghijklmnopqrstuvwxyz.12345" };
+    for (size_t n = 0; n < ArraySize(senders); ++n) {
+        ep->SetUniqueName(senders[n]);
+        MyMessage msg(*bus);
+        ASSERT_EQ(ER_OK, msg.Signal(NULL, "/foo/bar", "foo.bar", "test", args, numArgs));
+        ASSERT_EQ(ER_OK, msg.Deliver(ep));
+        MyMessage rcv(*bus);
+        ASSERT_EQ(ER_OK, rcv.Read(ep, senders[n]));
+        ASSERT_EQ(ER_OK, rcv.Unmarshal(ep, senders[n]));
+        EXPECT_STREQ(senders[n], rcv.GetSender());
+        EXPECT_STREQ("/foo/bar", rcv.GetObjectPath());
+        EXPECT_STREQ("foo.bar", rcv.GetInterface());
+        EXPECT_STREQ("test", rcv.GetMemberName());
+        ASSERT_EQ(ER_OK, rcv.UnmarshalBody());
+
+        /* The copy constructor must cope with the relocated header */
+        MyMessage copy(rcv);
+        MyMessage* msgs[] = { &rcv, &copy };
+        for (size_t m = 0; m < ArraySize(msgs); ++m) {
+            uint8_t* data;
+            size_t len;
+            const char* str;
+            ASSERT_EQ(ER_OK, msgs[m]->GetArgs("ays", &len, &data, &str));
+            ASSERT_EQ(sizeof(payload), len);
+            EXPECT_EQ(0, memcmp(payload, data, len));
+            EXPECT_STREQ("tail", str);
+            EXPECT_STREQ(senders[n], msgs[m]->GetSender());
+        }
+
+        /* Replacing the sender again rewrites the header in front of the body without moving it */
+        uint8_t* body;
+        size_t len;
+        const char* str;
+        ASSERT_EQ(ER_OK, rcv.GetArgs("ays", &len, &body, &str));
+        const char* newSender = senders[(n + 1) % ArraySize(senders)];
+        ASSERT_EQ(ER_OK, rcv.ReMarshal(newSender));
+        EXPECT_STREQ(newSender, rcv.GetSender());
+        ASSERT_EQ(ER_OK, rcv.UnmarshalBody());
+        uint8_t* data;
+        ASSERT_EQ(ER_OK, rcv.GetArgs("ays", &len, &data, &str));
+        EXPECT_EQ(body, data);
+        ASSERT_EQ(sizeof(payload), len);
+        EXPECT_EQ(0, memcmp(payload, data, len));
+        EXPECT_STREQ("tail", str);
+    }
+
+    delete bus;
+}
+
+TEST(MarshalTest, MessageCursorReadsBodyInPlace) {
+    BusAttachment* bus = new BusAttachment("MessageCursorReadsBodyInPlace", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    int32_t ai[] = { -1, 2, -3, 4, -5 };
+    MsgArg values[2];
+    values[0].Set("s", "value");
+    values[1].Set("ai", ArraySize(ai), ai);
+    MsgArg entries[2];
+    entries[0].Set("{sv}", "first", &values[0]);
+    entries[1].Set("{sv}", "second", &values[1]);
+    MsgArg args[4];
+    size_t numArgs = ArraySize(args);
+    ASSERT_EQ(ER_OK, MsgArg::Set(args, numArgs, "ua{sv}(sai)s", 42, ArraySize(entries), entries, "member", ArraySize(ai), ai, "tail"));
+
+    const char endians[] = { ALLJOYN_LITTLE_ENDIAN, ALLJOYN_BIG_ENDIAN };
+    for (size_t e = 0; e < ArraySize(endians); ++e) {
+        _Message::SetEndianess(endians[e]);
+        MyMessage msg(*bus);
+        ASSERT_EQ(ER_OK, msg.Signal(NULL, "/foo/bar", "foo.bar", "test", args, numArgs));
+        ASSERT_EQ(ER_OK, msg.Deliver(ep));
+        qcc::ManagedObj<MyMessage> rcv(*bus);
+        ASSERT_EQ(ER_OK, rcv->Read(ep, ":88.88"));
+        ASSERT_EQ(ER_OK, rcv->Unmarshal(ep, ":88.88"));
+        Message rcvMsg = Message::cast(rcv);
+
+        /* Read the first and last arguments skipping over the others */
+        MessageCursor cursor(rcvMsg);
+        MsgArg arg;
+        ASSERT_EQ(ALLJOYN_UINT32, cursor.GetTypeId());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_EQ(42U, arg.v_uint32);
+        EXPECT_EQ(ER_BUS_BAD_VALUE_TYPE, cursor.Get(arg));
+        EXPECT_EQ(ER_OK, cursor.Skip());
+        EXPECT_EQ(ER_OK, cursor.Skip());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_STREQ("tail", arg.v_string.str);
+        EXPECT_TRUE(cursor.AtEnd());
+        EXPECT_EQ(ER_EOF, cursor.Skip());
+
+        /* Walk the containers */
+        MessageCursor top(rcvMsg);
+        MessageCursor dict;
+        MessageCursor entry;
+        MessageCursor variant;
+        ASSERT_EQ(ER_OK, top.Skip());
+        ASSERT_EQ(ER_OK, top.Recurse(dict));
+        EXPECT_STREQ("{sv}", dict.GetSignature().c_str());
+        ASSERT_EQ(ER_OK, dict.Recurse(entry));
+        ASSERT_EQ(ER_OK, entry.Get(arg));
+        EXPECT_STREQ("first", arg.v_string.str);
+        ASSERT_EQ(ER_OK, entry.Recurse(variant));
+        ASSERT_EQ(ER_OK, variant.Get(arg));
+        EXPECT_STREQ("value", arg.v_string.str);
+        EXPECT_TRUE(variant.AtEnd());
+        EXPECT_TRUE(entry.AtEnd());
+        ASSERT_EQ(ER_OK, dict.Recurse(entry));
+        ASSERT_EQ(ER_OK, entry.Get(arg));
+        EXPECT_STREQ("second", arg.v_string.str);
+        ASSERT_EQ(ER_OK, entry.Recurse(variant));
+        ASSERT_EQ(ALLJOYN_ARRAY, variant.GetTypeId());
+        ASSERT_EQ(ER_OK, variant.Get(arg));
+        ASSERT_EQ(ALLJOYN_INT32_ARRAY, arg.typeId);
+        ASSERT_EQ(ArraySize(ai), arg.v_scalarArray.numElements);
+        EXPECT_EQ(0, memcmp(ai, arg.v_scalarArray.v_int32, sizeof(ai)));
+        EXPECT_TRUE(dict.AtEnd());
+
+        MessageCursor member;
+        ASSERT_EQ(ALLJOYN_STRUCT, top.GetTypeId());
+        ASSERT_EQ(ER_OK, top.Recurse(member));
+        ASSERT_EQ(ER_OK, member.Get(arg));
+        EXPECT_STREQ("member", arg.v_string.str);
+        ASSERT_EQ(ER_OK, member.Get(arg));
+        EXPECT_EQ(0, memcmp(ai, arg.v_scalarArray.v_int32, sizeof(ai)));
+        EXPECT_TRUE(member.AtEnd());
+        ASSERT_EQ(ER_OK, top.Get(arg));
+        EXPECT_STREQ("tail", arg.v_string.str);
+        EXPECT_TRUE(top.AtEnd());
+
+        /* The cursor still works once the body has been unmarshaled */
+        ASSERT_EQ(ER_OK, rcv->UnmarshalBody());
+        MessageCursor after(rcvMsg);
+        ASSERT_EQ(ER_OK, after.Get(arg));
+        EXPECT_EQ(42U, arg.v_uint32);
+    }
+    _Message::SetEndianess(0);
+
+    delete bus;
+}
+
 TEST(MarshalTest, ReplayProtection) {
     QStatus status = ER_OK;
 
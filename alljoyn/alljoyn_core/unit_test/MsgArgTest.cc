@@ -14,6 +14,7 @@
  *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  ******************************************************************************/
 #include <qcc/platform.h>
+#include <qcc/Util.h>
 
 #include <alljoyn/MsgArg.h>
 #include <alljoyn/Message.h>
@@ -1462,3 +1463,36 @@ TEST(MsgArgTest, MaximumLengthArraysPlusOne_dictionary) {
     status = arg.Set("a{ss}", ALLJOYN_MAX_ARRAY_LEN + 1, over_max_length_adict);
     EXPECT_EQ(ER_BUS_BAD_VALUE, status);
 }
+
+TEST(MsgArgTest, HasSignature) {
+    MsgArg dictVal("s", "value");
+    MsgArg entry;
+    ASSERT_EQ(ER_OK, entry.Set("{sv}", "key", &dictVal));
+    EXPECT_TRUE(entry.HasSignature("{sv}"));
+    EXPECT_FALSE(entry.HasSignature("{ss}"));
+    EXPECT_FALSE(entry.HasSignature("{sv"));
+    EXPECT_FALSE(entry.HasSignature("{sv}s"));
+
+    MsgArg structs[3];
+    for (size_t i = 0; i < ArraySize(structs); i++) {
+        ASSERT_EQ(ER_OK, structs[i].Set("(yiai)", static_cast<uint8_t>(i), static_cast<int32_t>(i), 0, NULL));
+        EXPECT_TRUE(structs[i].HasSignature("(yiai)"));
+        EXPECT_FALSE(structs[i].HasSignature("(yia)"));
+        EXPECT_FALSE(structs[i].HasSignature("(yiau)"));
+        EXPECT_FALSE(structs[i].HasSignature("(yi)"));
+    }
+    MsgArg arry;
+    ASSERT_EQ(ER_OK, arry.Set("a(yiai)", ArraySize(structs), structs));
+    EXPECT_TRUE(arry.HasSignature("a(yiai)"));
+    EXPECT_FALSE(arry.HasSignature("a(yiai"));
+    EXPECT_FALSE(arry.HasSignature("a(yiai)i"));
+    EXPECT_FALSE(arry.HasSignature("a(yia)"));
+
+    MsgArg empty;
+    EXPECT_FALSE(empty.HasSignature(""));
+    EXPECT_FALSE(empty.HasSignature("i"));
+    MsgArg str("s", "string");
+    EXPECT_TRUE(str.HasSignature("s"));
+    EXPECT_FALSE(str.HasSignature(""));
+    EXPECT_FALSE(str.HasSignature("o"));
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <qcc/ManagedObj.h>
+#include <qcc/Pipe.h>
+#include <qcc/String.h>
+#include <qcc/Thread.h>
+#include <qcc/time.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Message.h>
+
+#include <alljoyn/Status.h>
+
+/* Private files included for unit testing */
+#include <RemoteEndpoint.h>
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "ajTestCommon.h"
+
+using namespace ajn;
+using namespace qcc;
+
+class _TxTestMessage : public _Message {
+  public:
+
+    _TxTestMessage(BusAttachment& bus) : _Message(bus) { }
+
+    QStatus Signal(uint16_t ttl)
+    {
+        return SignalMsg("", NULL, 0, "/org/alljoyn/test", "org.alljoyn.test", "Ping", NULL, 0, 0, ttl);
+    }
+};
+
+typedef ManagedObj<_TxTestMessage> TxTestMessage;
+
+/*
+ * Pushes a message to an endpoint from a qcc::Thread, which is what a producer that has to wait for
+ * room in the txQueue must be.
+ */
+class TxPushThread : public Thread {
+  public:
+
+    TxPushThread(RemoteEndpoint& ep, Message& msg) : Thread("TxPushThread"), ep(ep), msg(msg), status(ER_FAIL), done(false) { }
+
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        status = ep->PushMessage(msg);
+        done = true;
+        return 0;
+    }
+
+    RemoteEndpoint& ep;
+    Message& msg;
+    volatile QStatus status;
+    volatile bool done;
+};
+
+/*
+ * The endpoints in these tests are never started so nothing drains their txQueue and a leaf node
+ * endpoint holds a single message.
+ */
+TEST(RemoteEndpointTest, BlockedPushDiscardsExpiredMessage)
+{
+    BusAttachment bus("BlockedPushDiscardsExpiredMessage", false);
+    ASSERT_EQ(ER_OK, bus.Start());
+    Pipe stream;
+    Pipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(bus, falsiness, String::Empty, pStream);
+
+    const uint16_t ttl = 100;
+    TxTestMessage expiring(bus);
+    ASSERT_EQ(ER_OK, expiring->Signal(ttl));
+    Message first = Message::cast(expiring);
+    ASSERT_EQ(ER_OK, ep->PushMessage(first));
+
+    TxTestMessage waiting(bus);
+    ASSERT_EQ(ER_OK, waiting->Signal(0));
+    Message second = Message::cast(waiting);
+    uint64_t start = GetTimestamp64();
+    TxPushThread pusher(ep, second);
+    ASSERT_EQ(ER_OK, pusher.Start());
+    for (uint32_t msec = 0; !pusher.done && (msec < 5000); msec += 10) {
+        qcc::Sleep(10);
+    }
+    pusher.Join();
+
+    /* The blocked producer discards the expired message and takes its place */
+    EXPECT_TRUE(pusher.done);
+    EXPECT_EQ(ER_OK, pusher.status);
+    EXPECT_LE(start + ttl, GetTimestamp64() + 10);
+}
+
+TEST(RemoteEndpointTest, BlockedPushWaitsForUnexpiredMessage)
+{
+    BusAttachment bus("BlockedPushWaitsForUnexpiredMessage", false);
+    ASSERT_EQ(ER_OK, bus.Start());
+    Pipe stream;
+    Pipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(bus, falsiness, String::Empty, pStream);
+
+    TxTestMessage queued(bus);
+    ASSERT_EQ(ER_OK, queued->Signal(0));
+    Message first = Message::cast(queued);
+    ASSERT_EQ(ER_OK, ep->PushMessage(first));
+
+    TxTestMessage waiting(bus);
+    ASSERT_EQ(ER_OK, waiting->Signal(0));
+    Message second = Message::cast(waiting);
+    TxPushThread pusher(ep, second);
+    ASSERT_EQ(ER_OK, pusher.Start());
+
+    /* Nothing drains the queue and the queued message never expires so the producer stays blocked */
+    qcc::Sleep(300);
+    EXPECT_FALSE(pusher.done);
+
+    /* Until it is stopped */
+    pusher.Stop();
+    pusher.Join();
+    EXPECT_TRUE(pusher.done);
+    EXPECT_EQ(ER_STOPPING_THREAD, pusher.status);
+}
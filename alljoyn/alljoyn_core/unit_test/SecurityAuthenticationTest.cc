@@ -1170,6 +1170,14 @@ class SecurityAuthenticationTest2 : public testing::Test {
         EXPECT_EQ(ER_OK, peer1Bus.Join());
         EXPECT_EQ(ER_OK, peer2Bus.Stop());
         EXPECT_EQ(ER_OK, peer2Bus.Join());
+        EXPECT_EQ(ER_OK, busUsedAsCA.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsCA.Join());
+        EXPECT_EQ(ER_OK, busUsedAsCA1.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsCA1.Join());
+        EXPECT_EQ(ER_OK, busUsedAsLivingRoom.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsLivingRoom.Join());
+        EXPECT_EQ(ER_OK, busUsedAsPeerC.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsPeerC.Join());
     }
 
     PermissionPolicy CreatePeer1Policy(uint32_t version) {
@@ -2310,6 +2318,10 @@ class SecurityAuthenticationTest3 : public testing::Test {
         EXPECT_EQ(ER_OK, peer1Bus.Join());
         EXPECT_EQ(ER_OK, peer2Bus.Stop());
         EXPECT_EQ(ER_OK, peer2Bus.Join());
+        EXPECT_EQ(ER_OK, busUsedAsCA.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsCA.Join());
+        EXPECT_EQ(ER_OK, busUsedAsLivingRoom.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsLivingRoom.Join());
     }
 
     PermissionPolicy CreatePeer1Policy(uint32_t version) {
@@ -2907,6 +2919,14 @@ class SecurityAuthenticationTest4 : public testing::Test {
         EXPECT_EQ(ER_OK, peer1Bus.Join());
         EXPECT_EQ(ER_OK, peer2Bus.Stop());
         EXPECT_EQ(ER_OK, peer2Bus.Join());
+        EXPECT_EQ(ER_OK, busUsedAsCA.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsCA.Join());
+        EXPECT_EQ(ER_OK, busUsedAsCA1.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsCA1.Join());
+        EXPECT_EQ(ER_OK, busUsedAsLivingRoom.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsLivingRoom.Join());
+        EXPECT_EQ(ER_OK, busUsedAsPeerC.Stop());
+        EXPECT_EQ(ER_OK, busUsedAsPeerC.Join());
     }
 
     /**
@@ -1797,4 +1797,7 @@ TEST(SecurityDefaultPolicy2Test, DefaultPolicy_self_install_membership_certifica
     // app. bus calls InstallMembership on itself.
     // verify: Verify that InstallMembership fails as the app. bus is not yet claimed.
     EXPECT_EQ(ER_PERMISSION_DENIED, sapWithSelf.InstallMembership(membershipCertificate, 1));
+
+    unclaimedBus.Stop();
+    unclaimedBus.Join();
 }
@@ -401,6 +401,9 @@ class SecurityManagementPolicyTest : public testing::Test {
         peer2Bus.Stop();
         peer2Bus.Join();
 
+        peer3Bus.Stop();
+        peer3Bus.Join();
+
         delete managerAuthListener;
         delete peer1AuthListener;
         delete peer2AuthListener;
@@ -2833,4 +2836,9 @@ TEST(SecurityManagementPolicy2Test, ManagedApplication_method_calls_should_fail_
         MsgArg membershipSummaries;
         EXPECT_EQ(ER_PERMISSION_DENIED, sapBus1toBus2.GetMembershipSummaries(membershipSummaries));
     }
+
+    peer1.Stop();
+    peer1.Join();
+    peer2.Stop();
+    peer2.Join();
 }
@@ -17,12 +17,19 @@
 #include <alljoyn/AuthListener.h>
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/SecurityApplicationProxy.h>
+#include <qcc/time.h>
 #include <iostream>
 #include <map>
 
+#include "AllJoynPeerObj.h"
+#include "BusInternal.h"
 #include "InMemoryKeyStore.h"
+#include "PeerState.h"
+#include "PermissionManager.h"
 #include "PermissionMgmtObj.h"
 #include "PermissionMgmtTest.h"
+#include "TestSecureApplication.h"
+#include "TestSecurityManager.h"
 
 using namespace ajn;
 using namespace qcc;
@@ -381,6 +388,11 @@ TEST(SecurityOtherTest, methodCallOverECDHE_ECDSASession) {
     EXPECT_TRUE(peer2AuthListener.verifyCredentialsCalled);
     EXPECT_TRUE(peer2AuthListener.authenticationSuccessfull);
     EXPECT_FALSE(peer2AuthListener.securityViolationCalled);
+
+    peer1Bus.Stop();
+    peer1Bus.Join();
+    peer2Bus.Stop();
+    peer2Bus.Join();
 }
 
 /*
@@ -767,6 +779,13 @@ TEST(SecurityOtherTest, unsecure_messages_not_blocked_by_policies_rules) {
 
         EXPECT_TRUE(chirpSignalReceiver.signalReceivedFlag);
     }
+
+    managerBus.Stop();
+    managerBus.Join();
+    peer1Bus.Stop();
+    peer1Bus.Join();
+    peer2Bus.Stop();
+    peer2Bus.Join();
 }
 
 class SecurityOtherECDHE_NULLAuthListener : public AuthListener {
@@ -1207,3 +1226,492 @@ TEST(SecurityOtherTest, call_security_application_over_ECDHE_ECDSA) {
     peer2Bus.Stop();
     peer2Bus.Join();
 }
+
+#define AUTHORIZATION_CACHE_OTHER_INTERFACE "other.test.interface"
+
+/*
+ * The provider's permission manager is asked directly whether an authenticated
+ * consumer may get the test property. The provider's policy grants it to any
+ * trusted peer and the consumer's manifest allows it.
+ */
+class SecurityAuthorizationCacheTest : public testing::Test {
+  public:
+    SecurityAuthorizationCacheTest() : prov("AuthorizationCacheProvider"), cons("AuthorizationCacheConsumer"), sessionId(0) { }
+
+    virtual void SetUp()
+    {
+        ASSERT_EQ(ER_OK, tsm.Init());
+        ASSERT_EQ(ER_OK, prov.Init(tsm));
+        ASSERT_EQ(ER_OK, cons.Init(tsm));
+        ASSERT_EQ(ER_OK, prov.SetAnyTrustedUserPolicy(tsm, PermissionPolicy::Rule::Member::ACTION_MODIFY | PermissionPolicy::Rule::Member::ACTION_OBSERVE | PermissionPolicy::Rule::Member::ACTION_PROVIDE));
+        ASSERT_EQ(ER_OK, prov.HostSession());
+        ASSERT_EQ(ER_OK, cons.JoinSession(prov, sessionId));
+        proxy = shared_ptr<ProxyBusObject>(cons.GetProxyObject(prov, sessionId));
+        ASSERT_TRUE(proxy != NULL);
+        ASSERT_EQ(ER_OK, proxy->SecureConnection(true));
+        peerState = prov.GetBusAttachement().GetInternal().GetPeerStateTable()->GetPeerState(cons.GetBusAttachement().GetUniqueName());
+    }
+
+    PermissionManager& ProviderPermissionManager()
+    {
+        return prov.GetBusAttachement().GetInternal().GetPermissionManager();
+    }
+
+    QStatus Authorize()
+    {
+        return ProviderPermissionManager().AuthorizeGetProperty(DEFAULT_TEST_OBJ_PATH, TEST_INTERFACE, TEST_PROP_NAME, peerState);
+    }
+
+    /*
+     * Take the test interface out of the provider's policy without going through
+     * SetPolicy(), so nothing tells the permission manager about it.
+     */
+    void RevokeGrantInPlace()
+    {
+        PermissionPolicy* policy = const_cast<PermissionPolicy*>(ProviderPermissionManager().GetPolicy());
+        ASSERT_TRUE(policy != NULL);
+        std::vector<PermissionPolicy::Acl> acls(policy->GetAcls(), policy->GetAcls() + policy->GetAclsSize());
+        for (size_t i = 0; i < acls.size(); i++) {
+            std::vector<PermissionPolicy::Rule> rules(acls[i].GetRules(), acls[i].GetRules() + acls[i].GetRulesSize());
+            for (size_t j = 0; j < rules.size(); j++) {
+                if (rules[j].GetInterfaceName() == TEST_INTERFACE) {
+                    rules[j].SetInterfaceName(AUTHORIZATION_CACHE_OTHER_INTERFACE);
+                }
+            }
+            acls[i].SetRules(rules.size(), &rules[0]);
+        }
+        policy->SetAcls(acls.size(), &acls[0]);
+    }
+
+    /*
+     * Get an allow decision cached and make it stale. The decision is only
+     * revoked if whatever is tested next invalidates the cache.
+     */
+    void CacheStaleAllow()
+    {
+        ASSERT_EQ(ER_OK, Authorize());
+        RevokeGrantInPlace();
+        ASSERT_EQ(ER_OK, Authorize());
+    }
+
+    /* Have the consumer send its manifest again, as it does when it authenticates */
+    QStatus SendManifest()
+    {
+        BusAttachment& bus = cons.GetBusAttachement();
+        PermissionMgmtObj* permissionMgmtObj = bus.GetInternal().GetPermissionManager().GetPermissionMgmtObj();
+        size_t count = 0;
+        QStatus status = permissionMgmtObj->RetrieveManifest(NULL, &count);
+        if (ER_OK != status) {
+            return status;
+        }
+        std::vector<PermissionPolicy::Rule> manifest(count);
+        status = permissionMgmtObj->RetrieveManifest(&manifest[0], &count);
+        if (ER_OK != status) {
+            return status;
+        }
+        MsgArg rulesArg;
+        status = PermissionPolicy::GenerateRules(&manifest[0], count, rulesArg);
+        if (ER_OK != status) {
+            return status;
+        }
+        return CallPeerAuthentication("SendManifest", &rulesArg, 1);
+    }
+
+    /* Have the consumer send its membership certificates again, as it does when it authenticates */
+    QStatus SendMemberships()
+    {
+        BusAttachment& bus = cons.GetBusAttachement();
+        PermissionMgmtObj* permissionMgmtObj = bus.GetInternal().GetPermissionManager().GetPermissionMgmtObj();
+        PeerState provPeerState = bus.GetInternal().GetPeerStateTable()->GetPeerState(prov.GetBusAttachement().GetUniqueName());
+        std::vector<std::vector<MsgArg*> > args;
+        QStatus status = permissionMgmtObj->GenerateSendMemberships(args, provPeerState->GetGuid());
+        if (ER_OK != status) {
+            return status;
+        }
+        if (args.size() != 1) {
+            _PeerState::ClearGuildArgs(args);
+            return ER_FAIL;
+        }
+        std::vector<MsgArg> certChain(args[0].size());
+        for (size_t i = 0; i < certChain.size(); i++) {
+            certChain[i] = *args[0][i];
+        }
+        MsgArg inputs[2];
+        inputs[0].Set("y", PermissionMgmtObj::SEND_MEMBERSHIP_LAST);
+        inputs[1].Set("a(yay)", certChain.size(), &certChain[0]);
+        status = CallPeerAuthentication("SendMemberships", inputs, ArraySize(inputs));
+        _PeerState::ClearGuildArgs(args);
+        return status;
+    }
+
+    QStatus CallPeerAuthentication(const char* methodName, const MsgArg* args, size_t numArgs)
+    {
+        BusAttachment& bus = cons.GetBusAttachement();
+        const InterfaceDescription* ifc = bus.GetInterface(org::alljoyn::Bus::Peer::Authentication::InterfaceName);
+        if (ifc == NULL) {
+            return ER_BUS_NO_SUCH_INTERFACE;
+        }
+        ProxyBusObject peerObj(bus, prov.GetBusAttachement().GetUniqueName().c_str(), org::alljoyn::Bus::Peer::ObjectPath, sessionId);
+        peerObj.AddInterface(*ifc);
+        Message reply(bus);
+        return peerObj.MethodCall(*ifc->GetMember(methodName), args, numArgs, reply);
+    }
+
+    TestSecurityManager tsm;
+    TestSecureApplication prov;
+    TestSecureApplication cons;
+    SessionId sessionId;
+    shared_ptr<ProxyBusObject> proxy;
+    PeerState peerState;
+};
+
+TEST_F(SecurityAuthorizationCacheTest, stale_decision_is_served_from_cache)
+{
+    CacheStaleAllow();
+    EXPECT_EQ(ER_OK, Authorize());
+    peerState->ClearAuthorizationCache();
+    EXPECT_EQ(ER_PERMISSION_DENIED, Authorize());
+}
+
+TEST_F(SecurityAuthorizationCacheTest, policy_update_revokes_cached_allow)
+{
+    ASSERT_EQ(ER_OK, Authorize());
+    ASSERT_EQ(ER_OK, Authorize());
+    /* goes through PermissionMgmtObj::PolicyChanged() */
+    ASSERT_EQ(ER_OK, prov.SetAnyTrustedUserPolicy(tsm, PermissionPolicy::Rule::Member::ACTION_OBSERVE, AUTHORIZATION_CACHE_OTHER_INTERFACE));
+    EXPECT_EQ(ER_PERMISSION_DENIED, Authorize());
+}
+
+TEST_F(SecurityAuthorizationCacheTest, set_policy_revokes_cached_allow)
+{
+    CacheStaleAllow();
+    PermissionManager& permissionManager = ProviderPermissionManager();
+    permissionManager.SetPolicy(new PermissionPolicy(*permissionManager.GetPolicy()));
+    EXPECT_EQ(ER_PERMISSION_DENIED, Authorize());
+}
+
+TEST_F(SecurityAuthorizationCacheTest, manifest_revokes_cached_allow)
+{
+    CacheStaleAllow();
+    ASSERT_EQ(ER_OK, SendManifest());
+    EXPECT_EQ(ER_PERMISSION_DENIED, Authorize());
+}
+
+TEST_F(SecurityAuthorizationCacheTest, memberships_revoke_cached_allow)
+{
+    ASSERT_EQ(ER_OK, tsm.InstallMembership(cons.GetBusAttachement(), GUID128()));
+    CacheStaleAllow();
+    ASSERT_EQ(ER_OK, SendMemberships());
+    EXPECT_EQ(ER_PERMISSION_DENIED, Authorize());
+}
+
+TEST_F(SecurityAuthorizationCacheTest, clear_keys_revokes_cached_allow)
+{
+    CacheStaleAllow();
+    peerState->ClearKeys();
+    EXPECT_EQ(ER_PERMISSION_DENIED, Authorize());
+}
+
+TEST_F(SecurityAuthorizationCacheTest, guid_and_auth_version_revoke_cached_allow)
+{
+    CacheStaleAllow();
+    peerState->SetGuidAndAuthVersion(peerState->GetGuid(), peerState->GetAuthVersion());
+    EXPECT_EQ(ER_PERMISSION_DENIED, Authorize());
+}
+
+/*
+ * Purpose:
+ * Measure the per-call overhead of the permission manager against a large
+ * policy, with and without the per-peer authorization decision cache.
+ *
+ * Setup:
+ * Claim an application and install a policy with a few hundred ACLs where
+ * only the last one grants access to the interface under test.
+ *
+ * Verification:
+ * The cost per call of both paths is reported. Run it with
+ * --gtest_also_run_disabled_tests.
+ */
+TEST(SecurityOtherBenchmark, DISABLED_authorization_cache) {
+    TestSecurityManager securityManager("SecurityOtherBenchManager");
+    ASSERT_EQ(ER_OK, securityManager.Init());
+
+    BusAttachment peerBus("SecurityOtherBenchPeer", true);
+    EXPECT_EQ(ER_OK, peerBus.Start());
+    EXPECT_EQ(ER_OK, peerBus.Connect());
+    InMemoryKeyStoreListener peerKeyStoreListener;
+    EXPECT_EQ(ER_OK, peerBus.RegisterKeyStoreListener(peerKeyStoreListener));
+    DefaultECDHEAuthListener peerAuthListener;
+    EXPECT_EQ(ER_OK, peerBus.EnablePeerSecurity("ALLJOYN_ECDHE_NULL ALLJOYN_ECDHE_ECDSA", &peerAuthListener));
+
+    PermissionPolicy::Rule::Member allMembers[1];
+    allMembers[0].Set("*", PermissionPolicy::Rule::Member::NOT_SPECIFIED, PermissionPolicy::Rule::Member::ACTION_PROVIDE | PermissionPolicy::Rule::Member::ACTION_MODIFY | PermissionPolicy::Rule::Member::ACTION_OBSERVE);
+    PermissionPolicy::Rule allRules[1];
+    allRules[0].SetInterfaceName("*");
+    allRules[0].SetMembers(1, allMembers);
+    PermissionPolicy::Acl manifest;
+    manifest.SetRules(1, allRules);
+    ASSERT_EQ(ER_OK, securityManager.Claim(peerBus, manifest));
+
+    const size_t aclCount = 256;
+    PermissionPolicy::Peer peers[1];
+    peers[0].SetType(PermissionPolicy::Peer::PEER_ALL);
+    PermissionPolicy::Acl* acls = new PermissionPolicy::Acl[aclCount];
+    for (size_t i = 0; i < aclCount; i++) {
+        PermissionPolicy::Rule::Member members[1];
+        members[0].Set("Prop" + U32ToString(i), PermissionPolicy::Rule::Member::PROPERTY, PermissionPolicy::Rule::Member::ACTION_OBSERVE);
+        PermissionPolicy::Rule rules[1];
+        rules[0].SetObjPath("/bench/" + U32ToString(i));
+        rules[0].SetInterfaceName("org.allseen.test.security.bench" + U32ToString(i));
+        rules[0].SetMembers(1, members);
+        acls[i].SetPeers(1, peers);
+        acls[i].SetRules(1, rules);
+    }
+    PermissionPolicy policy;
+    policy.SetAcls(aclCount, acls);
+    delete [] acls;
+    ASSERT_EQ(ER_OK, securityManager.UpdatePolicy(peerBus, policy));
+
+    /* a remote peer granted everything by its manifest */
+    PermissionManager& permissionManager = peerBus.GetInternal().GetPermissionManager();
+    PeerState peerState = peerBus.GetInternal().GetPeerStateTable()->GetPeerState(":SecurityOtherBench.1");
+    peerState->manifest = new PermissionPolicy::Rule[1];
+    peerState->manifest[0] = allRules[0];
+    peerState->manifestSize = 1;
+
+    const qcc::String objPath = "/bench/" + U32ToString(aclCount - 1);
+    const qcc::String ifcName = "org.allseen.test.security.bench" + U32ToString(aclCount - 1);
+    const qcc::String propName = "Prop" + U32ToString(aclCount - 1);
+    const uint32_t iterations = 20000;
+
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; i++) {
+        peerState->ClearAuthorizationCache();
+        ASSERT_EQ(ER_OK, permissionManager.AuthorizeGetProperty(objPath.c_str(), ifcName.c_str(), propName.c_str(), peerState));
+    }
+    uint64_t uncached = GetTimestamp64() - start;
+
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ASSERT_EQ(ER_OK, permissionManager.AuthorizeGetProperty(objPath.c_str(), ifcName.c_str(), propName.c_str(), peerState));
+    }
+    uint64_t cached = GetTimestamp64() - start;
+
+    printf("AuthorizeGetProperty with %u ACLs: uncached %.3f usec/call, cached %.3f usec/call\n",
+           static_cast<unsigned int>(aclCount),
+           (uncached * 1000.0) / iterations, (cached * 1000.0) / iterations);
+
+    peerBus.Stop();
+    peerBus.Join();
+}
+
+#define RESUMPTION_TEST_NAME "org.alljoyn.test.SecurityOtherResume"
+
+/*
+ * A client authenticates with a service and then authenticates again with the
+ * master secret it holds, first through ResumeSession and falling back to the
+ * full conversation when the service cannot resume.
+ */
+class SecuritySessionResumptionTest : public testing::Test {
+  public:
+    SecuritySessionResumptionTest() :
+        serviceBus("SecurityOtherResumeService", false),
+        clientBus("SecurityOtherResumeClient", false),
+        serviceAuthListener(psk, sizeof(psk)),
+        clientAuthListener(psk, sizeof(psk)),
+        peerObj(NULL)
+    {
+    }
+
+    virtual void SetUp()
+    {
+        StartSecureBus(serviceBus, serviceKeyStoreListener, serviceAuthListener);
+        StartSecureBus(clientBus, clientKeyStoreListener, clientAuthListener);
+        peerObj = clientBus.GetInternal().GetLocalEndpoint()->GetPeerObj();
+    }
+
+    virtual void TearDown()
+    {
+        clientBus.Stop();
+        clientBus.Join();
+        serviceBus.Stop();
+        serviceBus.Join();
+    }
+
+    void StartSecureBus(BusAttachment& bus, KeyStoreListener& keyStoreListener, AuthListener& authListener)
+    {
+        ASSERT_EQ(ER_OK, bus.Start());
+        ASSERT_EQ(ER_OK, bus.Connect());
+        ASSERT_EQ(ER_OK, bus.RegisterKeyStoreListener(keyStoreListener));
+        ASSERT_EQ(ER_OK, bus.EnablePeerSecurity("ALLJOYN_ECDHE_PSK", &authListener));
+    }
+
+    /* Secure the connection to name and return the statistics of that authentication alone */
+    AllJoynPeerObj::AuthStats Authenticate(const char* name)
+    {
+        AllJoynPeerObj::AuthStats before;
+        AllJoynPeerObj::AuthStats after;
+        peerObj->GetAuthStats(before);
+        EXPECT_EQ(ER_OK, clientBus.SecureConnection(name));
+        peerObj->GetAuthStats(after);
+        after.authentications -= before.authentications;
+        after.resumptions -= before.resumptions;
+        after.roundTrips -= before.roundTrips;
+        after.latency -= before.latency;
+        return after;
+    }
+
+    /* Drop the session keys of the client but keep the master secrets */
+    void ClearClientKeys(BusAttachment& service)
+    {
+        clientBus.GetInternal().GetPeerStateTable()->GetPeerState(service.GetUniqueName())->ClearKeys();
+    }
+
+    /* Drop the session keys on both sides but keep the master secrets */
+    void ClearSessionKeys()
+    {
+        ClearClientKeys(serviceBus);
+        serviceBus.GetInternal().GetPeerStateTable()->GetPeerState(clientBus.GetUniqueName())->ClearKeys();
+    }
+
+    KeyStore::Key ClientMasterSecret()
+    {
+        return KeyStore::Key(KeyStore::Key::REMOTE, GUID128(clientBus.GetInternal().GetKeyStore().GetGuid()));
+    }
+
+    /* Wait until the client has seen the owner of a well-known name go away */
+    void WaitForNameLost(const char* name)
+    {
+        PeerStateTable* peerStateTable = clientBus.GetInternal().GetPeerStateTable();
+        for (uint32_t msec = 0; peerStateTable->IsKnownPeer(name) && (msec < 5000); msec += 10) {
+            qcc::Sleep(10);
+        }
+        ASSERT_FALSE(peerStateTable->IsKnownPeer(name));
+    }
+
+    /* The service cannot resume the session so the client must authenticate without resuming */
+    void ExpectFallback()
+    {
+        AllJoynPeerObj::AuthStats stats = Authenticate(serviceBus.GetUniqueName().c_str());
+        EXPECT_EQ(1U, stats.authentications);
+        EXPECT_EQ(0U, stats.resumptions);
+        EXPECT_TRUE(clientBus.GetInternal().GetPeerStateTable()->GetPeerState(serviceBus.GetUniqueName())->IsSecure());
+        EXPECT_TRUE(serviceBus.GetInternal().GetPeerStateTable()->GetPeerState(clientBus.GetUniqueName())->IsSecure());
+    }
+
+    static const uint8_t psk[16];
+    BusAttachment serviceBus;
+    BusAttachment clientBus;
+    InMemoryKeyStoreListener serviceKeyStoreListener;
+    InMemoryKeyStoreListener clientKeyStoreListener;
+    DefaultECDHEAuthListener serviceAuthListener;
+    DefaultECDHEAuthListener clientAuthListener;
+    AllJoynPeerObj* peerObj;
+};
+
+const uint8_t SecuritySessionResumptionTest::psk[16] = { 0xfa, 0xaa, 0x0a, 0xf3, 0xdd, 0x3f, 0x1e, 0x03, 0x79, 0xda, 0x04, 0x6a, 0x3a, 0xb6, 0xca, 0x44 };
+
+TEST_F(SecuritySessionResumptionTest, single_round_trip) {
+    AllJoynPeerObj::AuthStats full = Authenticate(serviceBus.GetUniqueName().c_str());
+    EXPECT_EQ(1U, full.authentications);
+    EXPECT_EQ(0U, full.resumptions);
+
+    ClearSessionKeys();
+    AllJoynPeerObj::AuthStats resumed = Authenticate(serviceBus.GetUniqueName().c_str());
+    EXPECT_EQ(1U, resumed.authentications);
+    EXPECT_EQ(1U, resumed.resumptions);
+    /* ResumeSession followed by ExchangeGroupKeys */
+    EXPECT_EQ(2U, resumed.roundTrips);
+    EXPECT_LT(resumed.roundTrips, full.roundTrips);
+}
+
+TEST_F(SecuritySessionResumptionTest, rekeys_live_connection) {
+    EXPECT_EQ(0U, Authenticate(serviceBus.GetUniqueName().c_str()).resumptions);
+
+    /* the service still holds its session key for the client */
+    ClearClientKeys(serviceBus);
+    EXPECT_EQ(1U, Authenticate(serviceBus.GetUniqueName().c_str()).resumptions);
+
+    /* and both sides agree on the new one */
+    ClearClientKeys(serviceBus);
+    EXPECT_EQ(1U, Authenticate(serviceBus.GetUniqueName().c_str()).resumptions);
+}
+
+TEST_F(SecuritySessionResumptionTest, falls_back_when_responder_lost_master_secret) {
+    EXPECT_EQ(0U, Authenticate(serviceBus.GetUniqueName().c_str()).resumptions);
+    EXPECT_EQ(ER_OK, serviceBus.GetInternal().GetKeyStore().DelKey(ClientMasterSecret()));
+    ClearSessionKeys();
+
+    ExpectFallback();
+    EXPECT_TRUE(serviceBus.GetInternal().GetKeyStore().HasKey(ClientMasterSecret()));
+}
+
+TEST_F(SecuritySessionResumptionTest, falls_back_when_responder_master_secret_expired) {
+    EXPECT_EQ(0U, Authenticate(serviceBus.GetUniqueName().c_str()).resumptions);
+    KeyStore& keyStore = serviceBus.GetInternal().GetKeyStore();
+    KeyBlob secret;
+    ASSERT_EQ(ER_OK, keyStore.GetKey(ClientMasterSecret(), secret));
+    Timespec now;
+    GetTimeNow(&now);
+    secret.SetExpiration(now);
+    ASSERT_EQ(ER_OK, keyStore.AddKey(ClientMasterSecret(), secret));
+    ClearSessionKeys();
+
+    ExpectFallback();
+}
+
+TEST_F(SecuritySessionResumptionTest, falls_back_when_responder_predates_resume_session) {
+    EXPECT_EQ(0U, Authenticate(serviceBus.GetUniqueName().c_str()).resumptions);
+    serviceBus.GetInternal().GetLocalEndpoint()->GetPeerObj()->EnableSessionResumption(false);
+    ClearSessionKeys();
+
+    ExpectFallback();
+}
+
+TEST_F(SecuritySessionResumptionTest, falls_back_on_guid_mismatch) {
+    ASSERT_EQ(ER_OK, serviceBus.RequestName(RESUMPTION_TEST_NAME, DBUS_NAME_FLAG_DO_NOT_QUEUE));
+    EXPECT_EQ(0U, Authenticate(RESUMPTION_TEST_NAME).resumptions);
+
+    /* the name moves to a service with a different GUID */
+    ASSERT_EQ(ER_OK, serviceBus.ReleaseName(RESUMPTION_TEST_NAME));
+    WaitForNameLost(RESUMPTION_TEST_NAME);
+    BusAttachment otherBus("SecurityOtherResumeOther", false);
+    InMemoryKeyStoreListener otherKeyStoreListener;
+    DefaultECDHEAuthListener otherAuthListener(psk, sizeof(psk));
+    StartSecureBus(otherBus, otherKeyStoreListener, otherAuthListener);
+    ASSERT_EQ(ER_OK, otherBus.RequestName(RESUMPTION_TEST_NAME, DBUS_NAME_FLAG_DO_NOT_QUEUE));
+
+    AllJoynPeerObj::AuthStats stats = Authenticate(RESUMPTION_TEST_NAME);
+    EXPECT_EQ(1U, stats.authentications);
+    EXPECT_EQ(0U, stats.resumptions);
+    PeerState peerState = clientBus.GetInternal().GetPeerStateTable()->GetPeerState(otherBus.GetUniqueName());
+    EXPECT_EQ(otherBus.GetInternal().GetKeyStore().GetGuid(), peerState->GetGuid().ToString());
+
+    otherBus.Stop();
+    otherBus.Join();
+}
+
+/*
+ * Unique names are never reused so only a service that is addressed by a
+ * well-known name can be resumed after it reconnects.
+ */
+TEST_F(SecuritySessionResumptionTest, resumes_reconnected_well_known_name) {
+    ASSERT_EQ(ER_OK, serviceBus.RequestName(RESUMPTION_TEST_NAME, DBUS_NAME_FLAG_DO_NOT_QUEUE));
+    EXPECT_EQ(0U, Authenticate(RESUMPTION_TEST_NAME).resumptions);
+
+    /* the service comes back with a new unique name but the same key store */
+    serviceBus.Stop();
+    serviceBus.Join();
+    WaitForNameLost(RESUMPTION_TEST_NAME);
+    BusAttachment reconnectedBus("SecurityOtherResumeService", false);
+    DefaultECDHEAuthListener reconnectedAuthListener(psk, sizeof(psk));
+    StartSecureBus(reconnectedBus, serviceKeyStoreListener, reconnectedAuthListener);
+    ASSERT_EQ(ER_OK, reconnectedBus.RequestName(RESUMPTION_TEST_NAME, DBUS_NAME_FLAG_DO_NOT_QUEUE));
+
+    AllJoynPeerObj::AuthStats stats = Authenticate(RESUMPTION_TEST_NAME);
+    EXPECT_EQ(1U, stats.authentications);
+    EXPECT_EQ(1U, stats.resumptions);
+
+    reconnectedBus.Stop();
+    reconnectedBus.Join();
+}
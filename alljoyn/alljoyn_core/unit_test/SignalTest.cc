@@ -48,7 +48,11 @@ using namespace qcc;
 using namespace ajn;
 
 const uint32_t SLEEP_TIME = 2000;
-const uint32_t BACKPRESSURE_TEST_NUM_SIGNALS = 12;
+/*
+ * The local endpoint of a bus attachment with the default concurrency of 4
+ * queues up to 64 signals before the sender is made to wait.
+ */
+const uint32_t BACKPRESSURE_TEST_NUM_SIGNALS = 66;
 
 class TestObject : public BusObject {
   public:
@@ -760,8 +764,8 @@ TEST_F(SignalTest, Rules) {
     recvBn.verify_norecv();
 }
 
-/* This is a blocking test. The idea is to send out 12 signals, the first signal handler
-   will sleep for SLEEP_TIME, as a result of which the SendSignal should block for approx
+/* This is a blocking test. The idea is to send out more signals than the receiver queues, the first
+   signal handler will sleep for SLEEP_TIME, as a result of which the SendSignal should block for approx
    SLEEP_TIME ms until that signal handler returns.
  */
 TEST_F(SignalTest, BackPressure) {
@@ -143,8 +143,8 @@ class TestAllJoynObj : public AllJoynObj {
         JoinSessionMethodCall msg(bus, ":joiner.3", id, ":host.3", port, opts);
 
         bool isJoin = true;
-        TestJoinSessionThread joinSessionThread(*this, Message::cast(msg), isJoin);
-        joinSessionThread.RunJoin();
+        TestJoinSessionTask joinSessionTask(*this, Message::cast(msg), isJoin);
+        joinSessionTask.RunJoin();
     }
     virtual Transport* GetTransport(const String& transportSpec) {
         for (vector<TestTransport*>::iterator it = transportList.begin(); it != transportList.end(); ++it) {
@@ -206,10 +206,10 @@ class TestAllJoynObj : public AllJoynObj {
         return ER_OK;
     }
 
-    class TestJoinSessionThread : public JoinSessionThread {
+    class TestJoinSessionTask : public JoinSessionTask {
       public:
-        TestJoinSessionThread(TestAllJoynObj& ajObj, const Message& msg, bool isJoin)
-            : JoinSessionThread(ajObj, msg, isJoin), ajObj(ajObj) { }
+        TestJoinSessionTask(TestAllJoynObj& ajObj, const Message& msg, bool isJoin)
+            : JoinSessionTask(ajObj, msg, isJoin), ajObj(ajObj) { }
         virtual QStatus Reply(uint32_t sessionReplyCode, SessionId id, SessionOpts optsOut) {
             QCC_UNUSED(id);
             ajObj.replyCode = sessionReplyCode;
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <qcc/atomic.h>
+#include <qcc/Event.h>
+#include <qcc/ManagedObj.h>
+#include <qcc/Stream.h>
+#include <qcc/String.h>
+#include <qcc/Thread.h>
+
+#include <alljoyn/Message.h>
+
+#include <alljoyn/Status.h>
+
+#include "Bus.h"
+#include "ConfigDB.h"
+#include "RemoteEndpoint.h"
+#include "Transport.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/*
+ * A stream that counts the writes made to it. The first write is held up until Release() is
+ * called so that messages queue up behind it.
+ */
+class CountingStream : public Stream {
+  public:
+
+    CountingStream() : writes(0), bytes(0), firstBytes(0), writing(false) { }
+
+    QStatus PushBytes(const void* buf, size_t numBytes, size_t& numSent)
+    {
+        IOVec iov;
+        iov.buf = const_cast<void*>(buf);
+        iov.len = numBytes;
+        return PushBytesV(&iov, 1, numSent);
+    }
+
+    QStatus PushBytesV(const IOVec* iov, size_t iovLen, size_t& numSent)
+    {
+        writing = true;
+        Event::Wait(released, 5000);
+        numSent = 0;
+        for (size_t i = 0; i < iovLen; ++i) {
+            numSent += iov[i].len;
+        }
+        if (writes == 0) {
+            firstBytes = numSent;
+        }
+        bytes += numSent;
+        IncrementAndFetch(&writes);
+        return ER_OK;
+    }
+
+    void Release()
+    {
+        released.SetEvent();
+    }
+
+    Event released;
+    volatile int32_t writes;
+    volatile size_t bytes;
+    volatile size_t firstBytes;
+    volatile bool writing;
+};
+
+class _TxTestMessage : public _Message {
+  public:
+
+    _TxTestMessage(BusAttachment& bus) : _Message(bus) { }
+
+    /* Messages from a ".1" sender are control messages, this one is a data message */
+    QStatus Signal(const char* sender)
+    {
+        QStatus status = SignalMsg("", NULL, 0, "/org/alljoyn/test", "org.alljoyn.test", "Ping", NULL, 0, 0, 0);
+        if (status == ER_OK) {
+            status = ReMarshal(sender);
+        }
+        return status;
+    }
+};
+
+typedef ManagedObj<_TxTestMessage> TxTestMessage;
+
+TEST(RemoteEndpointTest, CoalescesQueuedDataMessages)
+{
+    const uint32_t numMessages = 8;
+
+    ConfigDB configDb("");
+    configDb.LoadConfig();
+    TransportFactoryContainer factories;
+    Bus bus("CoalescesQueuedDataMessages", factories);
+    ASSERT_EQ(ER_OK, bus.Start());
+
+    CountingStream stream;
+    Stream* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(bus, falsiness, String::Empty, pStream, "CoalescesQueuedDataMessages");
+    ep->SetUniqueName(":CoalescesQueuedDataMessages.2");
+    ep->SetTxCoalescing(numMessages, 64 * 1024);
+    ASSERT_EQ(ER_OK, ep->Start(0, 0, 0, 30));
+
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        TxTestMessage tx(bus);
+        ASSERT_EQ(ER_OK, tx->Signal(":CoalescesQueuedDataMessages.3"));
+        Message msg = Message::cast(tx);
+        ASSERT_EQ(ER_OK, ep->PushMessage(msg));
+        /* The rest of the messages queue up behind the first one while it is being written */
+        for (uint32_t msec = 0; !stream.writing && (msec < 5000); msec += 10) {
+            qcc::Sleep(10);
+        }
+        ASSERT_TRUE(stream.writing);
+    }
+    stream.Release();
+    /* The first write is the first message on its own and all the messages are the same size */
+    for (uint32_t msec = 0; (stream.firstBytes == 0) && (msec < 5000); msec += 10) {
+        qcc::Sleep(10);
+    }
+    ASSERT_NE(0U, stream.firstBytes);
+    size_t expectedBytes = numMessages * stream.firstBytes;
+    for (uint32_t msec = 0; (stream.bytes < expectedBytes) && (msec < 5000); msec += 10) {
+        qcc::Sleep(10);
+    }
+
+    /* Every message was written but not with a write per message */
+    EXPECT_EQ(expectedBytes, stream.bytes);
+    EXPECT_LT(stream.writes, (int32_t)numMessages);
+
+    ep->Stop();
+    ep->Join();
+    bus.Stop();
+    bus.Join();
+}
@@ -35,6 +35,24 @@
 
 #include <Status.h>
 
+/*
+ * On x86-64 the AES-NI instructions are used when the CPU supports them. The
+ * intrinsics are compiled per function so the rest of the library does not
+ * require -maes.
+ */
+#if (defined(__x86_64__) && defined(__GNUC__)) || defined(_M_X64)
+#define QCC_AESNI
+#include <wmmintrin.h>
+#include <smmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AESNI_TARGET
+#else
+#include <cpuid.h>
+#define AESNI_TARGET __attribute__((target("aes,sse4.1")))
+#endif
+#endif
+
 using namespace std;
 using namespace qcc;
 
@@ -60,6 +78,7 @@ const int MAX_SCHEDULE_LEN = 48;
 
 struct Crypto_AES::KeyState {
     uint32_t fkey[MAX_SCHEDULE_LEN];
+    bool aesni;
 };
 
 #define ROTL8(x)  ((((uint32_t)(x)) << 8)  | (((uint32_t)(x)) >> 24))
@@ -278,6 +297,238 @@ static void AJ_AES_ECB_128_ENCRYPT(const uint32_t* fkey, const uint8_t* in, uint
     Unpack32(out, out32);
 }
 
+#ifdef QCC_AESNI
+
+static bool DetectAESNI()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    unsigned int ecx = (unsigned int)info[2];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+#endif
+    /* AES-NI is bit 25 and SSE4.1 (needed for the counter update) is bit 19 */
+    return ((ecx & (1 << 25)) != 0) && ((ecx & (1 << 19)) != 0);
+}
+
+static bool HaveAESNI()
+{
+    static const bool aesni = DetectAESNI();
+    return aesni;
+}
+
+/*
+ * On a little endian CPU the key schedule words are already laid out as the
+ * round key bytes expected by the AES instructions.
+ */
+AESNI_TARGET static inline void AESNI_LoadKey(__m128i* rk, const uint32_t* fkey)
+{
+    for (int i = 0; i < 11; ++i) {
+        rk[i] = _mm_loadu_si128((const __m128i*)(fkey + 4 * i));
+    }
+}
+
+AESNI_TARGET static inline __m128i AESNI_Encrypt(__m128i b, const __m128i* rk)
+{
+    b = _mm_xor_si128(b, rk[0]);
+    for (int i = 1; i < 10; ++i) {
+        b = _mm_aesenc_si128(b, rk[i]);
+    }
+    return _mm_aesenclast_si128(b, rk[10]);
+}
+
+/*
+ * Encrypt two independent blocks with their rounds interleaved so the
+ * latency of one hides the latency of the other.
+ */
+AESNI_TARGET static inline void AESNI_Encrypt2(__m128i& a, __m128i& b, const __m128i* rk)
+{
+    a = _mm_xor_si128(a, rk[0]);
+    b = _mm_xor_si128(b, rk[0]);
+    for (int i = 1; i < 10; ++i) {
+        a = _mm_aesenc_si128(a, rk[i]);
+        b = _mm_aesenc_si128(b, rk[i]);
+    }
+    a = _mm_aesenclast_si128(a, rk[10]);
+    b = _mm_aesenclast_si128(b, rk[10]);
+}
+
+AESNI_TARGET static inline void AESNI_Encrypt4(__m128i* b, const __m128i* rk)
+{
+    for (int j = 0; j < 4; ++j) {
+        b[j] = _mm_xor_si128(b[j], rk[0]);
+    }
+    for (int i = 1; i < 10; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            b[j] = _mm_aesenc_si128(b[j], rk[i]);
+        }
+    }
+    for (int j = 0; j < 4; ++j) {
+        b[j] = _mm_aesenclast_si128(b[j], rk[10]);
+    }
+}
+
+/*
+ * The counter field is the big-endian last word of the counter block
+ */
+AESNI_TARGET static inline __m128i AESNI_Counter(__m128i ctr, uint32_t n)
+{
+    return _mm_insert_epi32(ctr, (int)htobe32(n), 3);
+}
+
+AESNI_TARGET static void AESNI_ECB_128_ENCRYPT(const uint32_t* fkey, const uint8_t* in, uint8_t* out, uint32_t numBlocks)
+{
+    __m128i rk[11];
+    AESNI_LoadKey(rk, fkey);
+
+    while (numBlocks >= 4) {
+        __m128i b[4];
+        for (int j = 0; j < 4; ++j) {
+            b[j] = _mm_loadu_si128((const __m128i*)(in + 16 * j));
+        }
+        AESNI_Encrypt4(b, rk);
+        for (int j = 0; j < 4; ++j) {
+            _mm_storeu_si128((__m128i*)(out + 16 * j), b[j]);
+        }
+        in += 64;
+        out += 64;
+        numBlocks -= 4;
+    }
+    while (numBlocks--) {
+        _mm_storeu_si128((__m128i*)out, AESNI_Encrypt(_mm_loadu_si128((const __m128i*)in), rk));
+        in += 16;
+        out += 16;
+    }
+}
+
+AESNI_TARGET static void AESNI_CBC_MAC_128(const uint32_t* fkey, uint8_t* mac, const uint8_t* in, size_t numBlocks)
+{
+    __m128i rk[11];
+    AESNI_LoadKey(rk, fkey);
+
+    __m128i x = _mm_loadu_si128((const __m128i*)mac);
+    while (numBlocks--) {
+        x = AESNI_Encrypt(_mm_xor_si128(x, _mm_loadu_si128((const __m128i*)in)), rk);
+        in += 16;
+    }
+    _mm_storeu_si128((__m128i*)mac, x);
+}
+
+/*
+ * Encrypts the CCM authentication field with counter block 0 and then runs
+ * CTR mode over the message with the CBC-MAC over the message interleaved.
+ * For encryption the MAC is computed over the input, for decryption over the
+ * output. The running MAC is passed in and returned in mac.
+ */
+AESNI_TARGET static void AESNI_CCM_128(const uint32_t* fkey, bool encrypt, uint8_t* mac, const uint8_t* ivec, uint8_t* tag, const uint8_t* in, uint8_t* out, size_t len)
+{
+    __m128i rk[11];
+    AESNI_LoadKey(rk, fkey);
+
+    __m128i ctr = _mm_loadu_si128((const __m128i*)ivec);
+    uint32_t n = betoh32(((const uint32_t*)ivec)[3]);
+    __m128i x = _mm_loadu_si128((const __m128i*)mac);
+    __m128i s0 = AESNI_Encrypt(AESNI_Counter(ctr, n++), rk);
+    Crypto_AES::Block tmp;
+
+    if (encrypt) {
+        while (len) {
+            size_t bytes = min(len, (size_t)16);
+            __m128i p;
+            if (bytes == 16) {
+                p = _mm_loadu_si128((const __m128i*)in);
+            } else {
+                memcpy(tmp.data, in, bytes);
+                tmp.Pad(16 - bytes);
+                p = _mm_loadu_si128((const __m128i*)tmp.data);
+            }
+            __m128i k = AESNI_Counter(ctr, n++);
+            x = _mm_xor_si128(x, p);
+            AESNI_Encrypt2(k, x, rk);
+            if (bytes == 16) {
+                _mm_storeu_si128((__m128i*)out, _mm_xor_si128(p, k));
+            } else {
+                _mm_storeu_si128((__m128i*)tmp.data, _mm_xor_si128(p, k));
+                memcpy(out, tmp.data, bytes);
+            }
+            in += bytes;
+            out += bytes;
+            len -= bytes;
+        }
+        /* the tag is computed over the plaintext and is encrypted with counter block 0 */
+        _mm_storeu_si128((__m128i*)tag, _mm_xor_si128(x, s0));
+    } else {
+        /* the tag to verify is decrypted with counter block 0 */
+        _mm_storeu_si128((__m128i*)tag, _mm_xor_si128(_mm_loadu_si128((const __m128i*)tag), s0));
+        /*
+         * The plaintext of a block is only known after its key stream has been computed so
+         * the MAC lags one block behind the decryption.
+         */
+        __m128i pending = _mm_setzero_si128();
+        bool havePending = false;
+        while (len) {
+            size_t bytes = min(len, (size_t)16);
+            __m128i c;
+            if (bytes == 16) {
+                c = _mm_loadu_si128((const __m128i*)in);
+            } else {
+                memcpy(tmp.data, in, bytes);
+                c = _mm_loadu_si128((const __m128i*)tmp.data);
+            }
+            __m128i k = AESNI_Counter(ctr, n++);
+            if (havePending) {
+                x = _mm_xor_si128(x, pending);
+                AESNI_Encrypt2(k, x, rk);
+            } else {
+                k = AESNI_Encrypt(k, rk);
+            }
+            pending = _mm_xor_si128(c, k);
+            if (bytes == 16) {
+                _mm_storeu_si128((__m128i*)out, pending);
+            } else {
+                _mm_storeu_si128((__m128i*)tmp.data, pending);
+                tmp.Pad(16 - bytes);
+                pending = _mm_loadu_si128((const __m128i*)tmp.data);
+                memcpy(out, tmp.data, bytes);
+            }
+            havePending = true;
+            in += bytes;
+            out += bytes;
+            len -= bytes;
+        }
+        if (havePending) {
+            x = AESNI_Encrypt(_mm_xor_si128(x, pending), rk);
+        }
+    }
+    _mm_storeu_si128((__m128i*)mac, x);
+    ClearMemory(&tmp, sizeof(tmp));
+}
+
+#endif
+
+/*
+ * Continue a CBC-MAC over some whole blocks, mac holds the running value.
+ */
+static void CBC_MAC_128(const uint32_t* fkey, bool aesni, uint8_t* mac, const uint8_t* in, size_t numBlocks)
+{
+#ifdef QCC_AESNI
+    if (aesni) {
+        AESNI_CBC_MAC_128(fkey, mac, in, numBlocks);
+        return;
+    }
+#else
+    QCC_UNUSED(aesni);
+#endif
+    while (numBlocks--) {
+        AJ_AES_CBC_128_ENCRYPT(fkey, in, mac, 16, mac);
+        in += 16;
+    }
+}
+
 Crypto_AES::Crypto_AES(const KeyBlob& key, Mode mode) : mode(mode), keyState(new KeyState())
 {
     const int rounds = 10;
@@ -291,6 +542,11 @@ Crypto_AES::Crypto_AES(const KeyBlob& key, Mode mode) : mode(mode), keyState(new
         fkey[6] = fkey[2] ^ fkey[5];
         fkey[7] = fkey[3] ^ fkey[6];
     }
+#ifdef QCC_AESNI
+    keyState->aesni = HaveAESNI();
+#else
+    keyState->aesni = false;
+#endif
 }
 
 Crypto_AES::~Crypto_AES()
@@ -308,6 +564,12 @@ QStatus Crypto_AES::Encrypt(const Block* in, Block* out, uint32_t numBlocks)
         return ER_CRYPTO_ERROR;
     }
 
+#ifdef QCC_AESNI
+    if (keyState->aesni) {
+        AESNI_ECB_128_ENCRYPT(keyState->fkey, in->data, out->data, numBlocks);
+        return ER_OK;
+    }
+#endif
     while (numBlocks--) {
         AJ_AES_ECB_128_ENCRYPT(keyState->fkey, in->data, out->data);
         ++in;
@@ -347,7 +609,10 @@ QStatus Crypto_AES::Encrypt(const void* in, size_t len, Block* out, uint32_t num
     return status;
 }
 
-static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, uint8_t M, uint8_t L, const KeyBlob& nonce, const uint8_t* mData, size_t mLen, const uint8_t* addData, size_t addLen)
+/*
+ * Start the CCM CBC-MAC with the B_0 block and the additional data, T returns the running MAC.
+ */
+static void Compute_CCM_AuthHeader(const uint32_t* fkey, bool aesni, Crypto_AES::Block& T, uint8_t M, uint8_t L, const KeyBlob& nonce, size_t mLen, const uint8_t* addData, size_t addLen)
 {
     uint8_t flags = ((addLen) ? 0x40 : 0) | (((M - 2) / 2) << 3) | (L - 1);
     /*
@@ -364,9 +629,9 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
     /*
      * Initialize CBC-MAC with B_0 initialization vector is 0.
      */
-    Crypto_AES::Block ivec(0);
+    memset(T.data, 0, sizeof(T.data));
     Trace("CBC IV in: ", B_0.data, sizeof(B_0.data));
-    AJ_AES_CBC_128_ENCRYPT(fkey, B_0.data, T.data, sizeof(T.data), ivec.data);
+    CBC_MAC_128(fkey, aesni, T.data, B_0.data, 1);
     Trace("CBC IV out:", T.data, sizeof(T.data));
     /*
      * Compute CBC-MAC for the add data.
@@ -398,37 +663,40 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
         /*
          * Continue computing the CBC-MAC
          */
-        AJ_AES_CBC_128_ENCRYPT(fkey, A.data, T.data, sizeof(T.data), ivec.data);
+        CBC_MAC_128(fkey, aesni, T.data, A.data, 1);
         Trace("After AES 1: ", T.data, sizeof(T.data));
-        while (addLen >= sizeof(Crypto_AES::Block)) {
-            AJ_AES_CBC_128_ENCRYPT(fkey, addData, T.data, sizeof(T.data), ivec.data);
-            Trace("After AES 2: ", T.data, sizeof(T.data));
-            addData += sizeof(Crypto_AES::Block);
-            addLen -= sizeof(Crypto_AES::Block);
-        }
+        size_t numBlocks = addLen / sizeof(Crypto_AES::Block);
+        CBC_MAC_128(fkey, aesni, T.data, addData, numBlocks);
+        Trace("After AES 2: ", T.data, sizeof(T.data));
+        addData += numBlocks * sizeof(Crypto_AES::Block);
+        addLen -= numBlocks * sizeof(Crypto_AES::Block);
         if (addLen) {
             memcpy(A.data, addData, addLen);
             A.Pad(16 - addLen);
-            AJ_AES_CBC_128_ENCRYPT(fkey, A.data, T.data, sizeof(T.data), ivec.data);
+            CBC_MAC_128(fkey, aesni, T.data, A.data, 1);
             Trace("After AES 3: ", T.data, sizeof(T.data));
         }
 
     }
+}
+
+static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, uint8_t M, uint8_t L, const KeyBlob& nonce, const uint8_t* mData, size_t mLen, const uint8_t* addData, size_t addLen)
+{
+    Compute_CCM_AuthHeader(fkey, false, T, M, L, nonce, mLen, addData, addLen);
     /*
      * Continue computing CBC-MAC over the message data.
      */
     if (mLen) {
-        while (mLen >= sizeof(Crypto_AES::Block)) {
-            AJ_AES_CBC_128_ENCRYPT(fkey, mData, T.data, sizeof(T.data), ivec.data);
-            Trace("After AES 4: ", T.data, sizeof(T.data));
-            mData += sizeof(Crypto_AES::Block);
-            mLen -= sizeof(Crypto_AES::Block);
-        }
+        size_t numBlocks = mLen / sizeof(Crypto_AES::Block);
+        CBC_MAC_128(fkey, false, T.data, mData, numBlocks);
+        Trace("After AES 4: ", T.data, sizeof(T.data));
+        mData += numBlocks * sizeof(Crypto_AES::Block);
+        mLen -= numBlocks * sizeof(Crypto_AES::Block);
         if (mLen) {
             Crypto_AES::Block final;
             memcpy(final.data, mData, mLen);
             final.Pad(16 - mLen);
-            AJ_AES_CBC_128_ENCRYPT(fkey, final.data, T.data, sizeof(T.data), ivec.data);
+            CBC_MAC_128(fkey, false, T.data, final.data, 1);
             Trace("After AES 5: ", T.data, sizeof(T.data));
         }
     }
@@ -474,11 +742,6 @@ QStatus Crypto_AES::Encrypt_CCM(const void* in, void* out, size_t& len, const Ke
     if (L < LengthOctetsFor(len)) {
         return ER_BAD_ARG_3;
     }
-    /*
-     * Compute the authentication field T.
-     */
-    Block T;
-    Compute_CCM_AuthField(keyState->fkey, T, authLen, L, nonce, (uint8_t*)in, len, (uint8_t*)addData, addLen);
     /*
      * Initialize ivec and other initial args.
      */
@@ -486,10 +749,27 @@ QStatus Crypto_AES::Encrypt_CCM(const void* in, void* out, size_t& len, const Ke
     ivec.data[0] = (L - 1);
     memcpy(&ivec.data[1], nonce.GetData(), nLen);
     Block ecount_buf(0);
+    Block T;
+    Block U;
+#ifdef QCC_AESNI
+    if (keyState->aesni) {
+        /*
+         * Compute the authentication field T while encrypting the message.
+         */
+        Compute_CCM_AuthHeader(keyState->fkey, true, T, authLen, L, nonce, len, (uint8_t*)addData, addLen);
+        AESNI_CCM_128(keyState->fkey, true, T.data, ivec.data, U.data, (const uint8_t*)in, (uint8_t*)out, len);
+        memcpy((uint8_t*)out + len, U.data, authLen);
+        len += authLen;
+        return ER_OK;
+    }
+#endif
+    /*
+     * Compute the authentication field T.
+     */
+    Compute_CCM_AuthField(keyState->fkey, T, authLen, L, nonce, (uint8_t*)in, len, (uint8_t*)addData, addLen);
     /*
      * Encrypt the authentication field
      */
-    Block U;
     AJ_AES_CTR_128(keyState->fkey, T.data, U.data, 16, ivec.data);
     Trace("CTR Start: ", ivec.data, 16);
     AJ_AES_CTR_128(keyState->fkey, (const uint8_t*)in, (uint8_t*)out, len, ivec.data);
@@ -531,23 +811,40 @@ QStatus Crypto_AES::Decrypt_CCM(const void* in, void* out, size_t& len, const Ke
     ivec.data[0] = (L - 1);
     memcpy(&ivec.data[1], nonce.GetData(), nLen);
     Block ecount_buf(0);
-    /*
-     * Decrypt the authentication field
-     */
     Block U;
     Block T;
+    Block F;
     len = len - authLen;
-    memcpy(U.data, (const uint8_t*)in + len, authLen);
-    AJ_AES_CTR_128(keyState->fkey, U.data, T.data, sizeof(T.data), ivec.data);
-    /*
-     * Decrypt message.
-     */
-    AJ_AES_CTR_128(keyState->fkey, (const uint8_t*)in, (uint8_t*)out, len, ivec.data);
+#ifdef QCC_AESNI
+    if (keyState->aesni) {
+        /*
+         * Decrypt the authentication field and the message while computing the
+         * authentication field F over the decrypted message.
+         */
+        memcpy(T.data, (const uint8_t*)in + len, authLen);
+        T.Pad(16 - authLen);
+        Compute_CCM_AuthHeader(keyState->fkey, true, F, authLen, L, nonce, len, (uint8_t*)addData, addLen);
+        AESNI_CCM_128(keyState->fkey, false, F.data, ivec.data, T.data, (const uint8_t*)in, (uint8_t*)out, len);
+    } else
+#endif
+    {
+        /*
+         * Decrypt the authentication field
+         */
+        memcpy(U.data, (const uint8_t*)in + len, authLen);
+        AJ_AES_CTR_128(keyState->fkey, U.data, T.data, sizeof(T.data), ivec.data);
+        /*
+         * Decrypt message.
+         */
+        AJ_AES_CTR_128(keyState->fkey, (const uint8_t*)in, (uint8_t*)out, len, ivec.data);
+        /*
+         * Compute the authentication field F.
+         */
+        Compute_CCM_AuthField(keyState->fkey, F, authLen, L, nonce, (uint8_t*)out, len, (uint8_t*)addData, addLen);
+    }
     /*
-     * Compute and verify the authentication field T.
+     * Verify the authentication field T.
      */
-    Block F;
-    Compute_CCM_AuthField(keyState->fkey, F, authLen, L, nonce, (uint8_t*)out, len, (uint8_t*)addData, addLen);
     if (Crypto_Compare(F.data, T.data, authLen) == 0) {
         return ER_OK;
     } else {
@@ -39,6 +39,7 @@ class Timer;
 class _Alarm;
 class TimerImpl;
 class TimerThread;
+class AlarmQueue;
 
 typedef ManagedObj<_Alarm> Alarm;
 
@@ -69,6 +70,7 @@ class AlarmListener {
 class _Alarm {
     friend class TimerImpl;
     friend class TimerThread;
+    friend class AlarmQueue;
 
   public:
 
@@ -288,6 +288,8 @@ class CertificateX509 {
 
     /**
      * Verify the certificate.
+     * Successful verifications are remembered in a bounded process-wide cache,
+     * so verifying the same certificate with the same key again is cheap.
      * @param key the ECDSA public key.
      * @return ER_OK for success; otherwise, error code.
      */
@@ -300,6 +302,17 @@ class CertificateX509 {
      */
     QStatus Verify(const KeyInfoNISTP256& trustAnchor) const;
 
+    /**
+     * Verify the signatures of a certificate chain.  Each certificate must be
+     * signed by the subject public key of the certificate following it.  The
+     * signature of the last certificate is not checked.  Signatures already
+     * verified with the same key are not verified again.
+     * @param certChain the array of certs, end-entity cert first.
+     * @param count the number of certs
+     * @return ER_OK for success; otherwise, error code.
+     */
+    static QStatus AJ_CALL VerifyCertChain(const CertificateX509* certChain, size_t count);
+
     /**
      * Verify the validity period of the certificate.
      * @return ER_OK for success; otherwise, error code.
@@ -706,6 +719,10 @@ class CertificateX509 {
 
   private:
 
+    static void Init();
+    static void Shutdown();
+    friend class StaticGlobals;
+
     struct DistinguishedName {
         uint8_t* ou;
         size_t ouLen;
@@ -166,6 +166,33 @@ void ec_affine_tojacobian(const ecpoint_t* Q, ecpoint_jacobian_t* P);
  */
 QStatus ec_scalarmul(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve);
 
+/**
+ * Compute the scalar multiplication k*G, where G is the generator of the curve.
+ * Uses a precomputed table of multiples of G and runs in constant time.
+ *
+ * @param[in]  k     The scalar.
+ * @param[out] Q     The output point Q = k*G.
+ * @param[in]  curve The curve.
+ *
+ * @return AJ_OK if succcessful
+ */
+QStatus ec_scalarmul_base(digit256_t k, ecpoint_t* Q, ec_t* curve);
+
+/**
+ * Compute the double scalar multiplication k*G + l*P, where G is the generator of the curve.
+ * This function is NOT constant time and must only be used with public scalars,
+ * such as in ECDSA signature verification.
+ *
+ * @param[in]  k     The scalar for the generator, in [0, r-1].
+ * @param[in]  P     The second point, which must be a valid point on the curve.
+ * @param[in]  l     The scalar for P, in [0, r-1].
+ * @param[out] Q     The output point Q = k*G + l*P, (0,0) if it is the point at infinity.
+ * @param[in]  curve The curve P is on.
+ *
+ * @return AJ_OK if succcessful
+ */
+QStatus ec_scalarmul_double_vartime(digit256_t k, const ecpoint_t* P, digit256_t l, ecpoint_t* Q, ec_t* curve);
+
 /**
  * Check that a point is on the given curve.
  *
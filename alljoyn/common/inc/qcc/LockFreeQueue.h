@@ -0,0 +1,234 @@
+/**
+ * @file
+ *
+ * Bounded lock-free multi-producer/single-consumer queue.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#ifndef _QCC_LOCKFREEQUEUE_H
+#define _QCC_LOCKFREEQUEUE_H
+
+#include <qcc/platform.h>
+#include <qcc/atomic.h>
+
+#include <vector>
+
+namespace qcc {
+
+/**
+ * A bounded FIFO that any number of threads may push to while a single
+ * thread pops from it, without taking a lock.
+ *
+ * The queue is a ring of slots, each carrying a sequence number that tells
+ * producers and the consumer whose turn it is to use the slot.  Producers
+ * claim a position by advancing the tail with a compare-and-exchange and then
+ * publish the slot by bumping its sequence number; the consumer owns the head
+ * outright.  A producer that claimed a slot but has not published it yet
+ * holds up the consumer until it does; entries pushed after it are not
+ * visible before it.
+ *
+ * @tparam T  Copyable element type.  Popped slots are reset to a copy of the
+ *            value passed to the constructor so that they do not keep
+ *            references alive.
+ */
+template <typename T>
+class LockFreeQueue {
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param minCapacity  Minimum number of entries the queue can hold.  The
+     *                     actual capacity is rounded up to a power of two.
+     * @param emptyValue   Value stored in unused slots.
+     */
+    LockFreeQueue(uint32_t minCapacity, const T& emptyValue) :
+        mask(RoundUp(minCapacity) - 1),
+        slots(mask + 1, Slot(emptyValue)),
+        emptyValue(emptyValue),
+        head(0),
+        tail(0),
+        count(0)
+    {
+        for (uint32_t i = 0; i <= mask; ++i) {
+            slots[i].seq = static_cast<int32_t>(i);
+        }
+    }
+
+    /**
+     * Discard the contents of the queue and change its capacity.  Must only be
+     * called while no other thread is using the queue.
+     *
+     * @param minCapacity  Minimum number of entries the queue can hold.  The
+     *                     actual capacity is rounded up to a power of two.
+     */
+    void Reset(uint32_t minCapacity)
+    {
+        mask = RoundUp(minCapacity) - 1;
+        slots.assign(mask + 1, Slot(emptyValue));
+        for (uint32_t i = 0; i <= mask; ++i) {
+            slots[i].seq = static_cast<int32_t>(i);
+        }
+        head = 0;
+        tail = 0;
+        count = 0;
+    }
+
+    /**
+     * Add an entry to the tail of the queue.  May be called from any thread.
+     *
+     * @param val         Value to add.
+     * @param[out] depth  If non-NULL, number of entries in the queue once this
+     *                    one was added.  A depth of 1 means the queue was
+     *                    empty, which is normally the cue to wake the consumer.
+     *
+     * @return  false if the queue is full.
+     */
+    bool TryPush(const T& val, int32_t* depth = NULL)
+    {
+        for (;;) {
+            uint32_t pos = static_cast<uint32_t>(tail);
+            Slot& slot = slots[pos & mask];
+            int32_t diff = static_cast<int32_t>(static_cast<uint32_t>(slot.seq) - pos);
+            if (diff < 0) {
+                /* The consumer has not released this slot yet */
+                return false;
+            }
+            if ((diff == 0) && CompareAndExchange(&tail, static_cast<int32_t>(pos), static_cast<int32_t>(pos + 1))) {
+                slot.val = val;
+                Publish(slot.seq, pos, pos + 1);
+                int32_t n = IncrementAndFetch(&count);
+                if (depth) {
+                    *depth = n;
+                }
+                return true;
+            }
+            /* Another producer claimed this position first; try the next one */
+        }
+    }
+
+    /**
+     * Get the entry at the head of the queue without removing it.  Must only
+     * be called by the consumer.
+     *
+     * @param[out] val  The entry at the head of the queue.
+     *
+     * @return  false if there is no entry ready at the head of the queue.
+     */
+    bool Peek(T& val)
+    {
+        Slot& slot = slots[head & mask];
+        if (!IsReady(slot)) {
+            return false;
+        }
+        val = slot.val;
+        return true;
+    }
+
+    /**
+     * Remove the entry at the head of the queue.  Must only be called by the
+     * consumer.
+     *
+     * @return  false if there is no entry ready at the head of the queue.
+     */
+    bool Pop()
+    {
+        Slot& slot = slots[head & mask];
+        if (!IsReady(slot)) {
+            return false;
+        }
+        slot.val = emptyValue;
+        Publish(slot.seq, head + 1, head + mask + 1);
+        ++head;
+        DecrementAndFetch(&count);
+        return true;
+    }
+
+    /**
+     * Number of entries in the queue.  Only a snapshot when producers are
+     * active; it counts entries once they have been published.
+     *
+     * @return  Number of entries in the queue.
+     */
+    uint32_t Size() const
+    {
+        int32_t n = count;
+        return (n > 0) ? static_cast<uint32_t>(n) : 0;
+    }
+
+    /**
+     * Test for an empty queue.
+     *
+     * @return  true if the queue has no published entries.
+     */
+    bool Empty() const { return Size() == 0; }
+
+    /**
+     * Get the capacity of the queue.
+     *
+     * @return  Maximum number of entries the queue can hold.
+     */
+    uint32_t Capacity() const { return mask + 1; }
+
+  private:
+
+    struct Slot {
+        volatile int32_t seq;
+        T val;
+        Slot(const T& val) : seq(0), val(val) { }
+    };
+
+    static uint32_t RoundUp(uint32_t n)
+    {
+        uint32_t cap = 1;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    /*
+     * The compare-and-exchange operations are full barriers.  Using them to
+     * read and write the slot sequence numbers orders the slot contents
+     * against the hand-off between producer and consumer.
+     */
+    static void Publish(volatile int32_t& seq, uint32_t from, uint32_t to)
+    {
+        CompareAndExchange(&seq, static_cast<int32_t>(from), static_cast<int32_t>(to));
+    }
+
+    bool IsReady(Slot& slot) const
+    {
+        int32_t ready = static_cast<int32_t>(head + 1);
+        return CompareAndExchange(&slot.seq, ready, ready);
+    }
+
+    /* Private copy constructor and assignment operator - do nothing */
+    LockFreeQueue(const LockFreeQueue& other);
+    LockFreeQueue& operator=(const LockFreeQueue& other);
+
+    uint32_t mask;                /**< Capacity - 1 */
+    std::vector<Slot> slots;      /**< Ring of slots */
+    const T emptyValue;           /**< Value stored in unused slots */
+    uint32_t head;                /**< Next position to pop (consumer only) */
+    volatile int32_t tail;        /**< Next position to push */
+    volatile int32_t count;       /**< Number of published entries */
+};
+
+}
+
+#endif
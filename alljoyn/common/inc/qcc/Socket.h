@@ -339,6 +339,22 @@ QStatus RecvWithFds(SocketFd sockfd, void* buf, size_t len, size_t& received, So
  */
 QStatus SendWithFds(SocketFd sockfd, const void* buf, size_t len, size_t& sent, SocketFd* fdList, size_t numFds, uint32_t pid);
 
+/**
+ * Send the contents of several buffers over a socket in a single call (gather write).
+ *
+ * @param sockfd    Socket descriptor.
+ * @param iov       Array of buffers to send in order.
+ * @param iovLen    Number of entries in iov, must not exceed the platform limit
+ *                  (#QCC_MAX_SG_ENTRIES on posix, #ER_MAX_SG_ENTRIES on Windows).
+ * @param[out] sent Number of octets sent, this may end part way through any of the buffers.
+ *
+ * @return
+ * - #ER_OK the send succeeded.
+ * - #ER_OS_ERROR the underlying send failed.
+ * - #ER_WOULDBLOCK sockfd is non-blocking and the underlying send would block.
+ */
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t iovLen, size_t& sent);
+
 /**
  * Set a socket to blocking or not blocking.
  *
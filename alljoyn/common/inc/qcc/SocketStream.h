@@ -201,6 +201,22 @@ class SocketStream : public Stream {
      */
     QStatus PushBytes(const void* buf, size_t numBytes, size_t& numSent);
 
+    /**
+     * Push the contents of several buffers into the sink with a single gather write.
+     *
+     * @param iov          Array of buffers to push in order.
+     * @param iovLen       Number of entries in iov, must not exceed the platform limit
+     *                     (#QCC_MAX_SG_ENTRIES on posix, #ER_MAX_SG_ENTRIES on Windows).
+     * @param[out] numSent Number of bytes actually consumed by sink.
+     *
+     * @return
+     * - #ER_OK if iovLen is 0 or the push succeeds.
+     * - #ER_WRITE_ERROR if the socket is not connected.
+     * - #ER_TIMEOUT if timeout is reached before pushing any bytes.
+     * - #ER_OS_ERROR if the underlying socket request fails.
+     */
+    QStatus PushBytesV(const IOVec* iov, size_t iovLen, size_t& numSent);
+
     /**
      * Push bytes accompanied by one or more file/socket descriptors to a sink.
      *
@@ -148,6 +148,25 @@ class Sink {
         return PushBytes(buf, numBytes, numSent);
     }
 
+    /**
+     * Push the contents of several buffers into the sink. Sinks that cannot do a gather write
+     * push the first non-empty buffer only so callers must always check numSent.
+     *
+     * @param iov          Array of buffers to push in order.
+     * @param iovLen       Number of entries in iov.
+     * @param numSent      Number of bytes actually consumed by sink.
+     * @return   ER_OK if successful.
+     */
+    virtual QStatus PushBytesV(const IOVec* iov, size_t iovLen, size_t& numSent) {
+        numSent = 0;
+        for (size_t i = 0; i < iovLen; ++i) {
+            if (iov[i].len > 0) {
+                return PushBytes(iov[i].buf, iov[i].len, numSent);
+            }
+        }
+        return ER_OK;
+    }
+
     /**
      * Push one or more byte accompanied by one or more file/socket descriptors to a sink.
      *
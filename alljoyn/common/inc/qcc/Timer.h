@@ -46,6 +46,15 @@ class Timer {
 
   public:
 
+    /**
+     * How a timer keeps track of its pending alarms.
+     */
+    typedef enum {
+        ORDERED_SET,    /**< Balanced tree sorted by alarm time. O(log n) insert and remove. */
+        TIMING_WHEEL    /**< Hierarchical timing wheel with millisecond ticks. O(1) insert and remove. Suited
+                             to timers with many outstanding alarms. */
+    } AlarmQueueType;
+
     /**
      * Constructor
      *
@@ -54,8 +63,10 @@ class Timer {
      * @param concurrency         Dispatch up to this number of alarms concurently (using multiple threads).
      * @param prevenReentrancy   Prevent re-entrant call of AlarmTriggered.
      * @param maxAlarms          Maximum number of outstanding alarms allowed before blocking calls to AddAlarm or 0 for infinite.
+     * @param queueType          Data structure used to hold the pending alarms.
      */
-    Timer(qcc::String name, bool expireOnExit = false, uint32_t concurrency = 1, bool preventReentrancy = false, uint32_t maxAlarms = 0);
+    Timer(qcc::String name, bool expireOnExit = false, uint32_t concurrency = 1, bool preventReentrancy = false, uint32_t maxAlarms = 0,
+          AlarmQueueType queueType = ORDERED_SET);
 
     /**
      * Destructor.
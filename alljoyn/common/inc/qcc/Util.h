@@ -268,6 +268,36 @@ QStatus ExecAs(const char* user, const char* exec, const ExecArgs& args, const q
  */
 void CRC16_Compute(const uint8_t* buffer, size_t bufLen, uint16_t*runningCrc);
 
+/**
+ * Reverse the byte order of every element of an array of 16 bit values. Uses vector
+ * instructions where the CPU supports them.
+ *
+ * @param dest   Array to receive the swapped values, may be the same as src.
+ * @param src    Array of values to swap.
+ * @param count  Number of elements in the arrays.
+ */
+void EndianSwapArray16(uint16_t* dest, const uint16_t* src, size_t count);
+
+/**
+ * Reverse the byte order of every element of an array of 32 bit values. Uses vector
+ * instructions where the CPU supports them.
+ *
+ * @param dest   Array to receive the swapped values, may be the same as src.
+ * @param src    Array of values to swap.
+ * @param count  Number of elements in the arrays.
+ */
+void EndianSwapArray32(uint32_t* dest, const uint32_t* src, size_t count);
+
+/**
+ * Reverse the byte order of every element of an array of 64 bit values. Uses vector
+ * instructions where the CPU supports them.
+ *
+ * @param dest   Array to receive the swapped values, may be the same as src.
+ * @param src    Array of values to swap.
+ * @param count  Number of elements in the arrays.
+ */
+void EndianSwapArray64(uint64_t* dest, const uint64_t* src, size_t count);
+
 /**
  * Resolves a hostname to its packed address representation.
  *
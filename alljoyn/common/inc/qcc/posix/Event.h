@@ -206,8 +206,30 @@ class Event {
      */
     uint32_t GetNumBlockedThreads() { return numThreads; }
 
+    /**
+     * Close a file descriptor that an Event may have been waited on.
+     * Multi-event waits keep the descriptors they wait on registered with the
+     * kernel between calls, so the close is recorded atomically with the
+     * close() itself to let waiting threads drop those registrations before the
+     * descriptor number can be reused.  A descriptor closed with a plain
+     * close() is only re-registered once it is waited on through a different
+     * Event.
+     * (This method should only be used within posix platform specific code.)
+     *
+     * @param fd   File descriptor to close.
+     *
+     * @return  The return value of close().
+     */
+    static int CloseFd(int fd);
+
   private:
 
+    /** Per-thread persistent kernel registration set used by multi-event Wait (Linux only) */
+    class EpollSet;
+
+    /** Multi-event Wait implemented with select() */
+    static QStatus SelectWait(const std::vector<Event*>& checkEvents, std::vector<Event*>& signaledEvents, uint32_t maxMs);
+
     static void Init();
     static void Shutdown();
     friend class StaticGlobals;
@@ -219,6 +241,7 @@ class Event {
     uint32_t timestamp;     /**< time for next triggering of TIMED Event */
     uint32_t period;        /**< Number of milliseconds between periodic timed events */
     volatile int32_t numThreads; /**< Number of threads currently waiting on this event */
+    uint32_t serial;        /**< Distinguishes I/O events that wrap a reused descriptor number */
 
     /**
      * Protected copy constructor.
@@ -161,6 +161,7 @@ class FileSink : public Sink {
         PRIVATE = 0,        /**< Private to the calling user */
         WORLD_READABLE = 1, /**< World readable */
         WORLD_WRITABLE = 2, /**< World writable */
+        APPEND = 4,         /**< Append to an existing file instead of creating a new one */
     } Mode;
 
     /**
@@ -24,11 +24,14 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
 #include <pthread.h>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
 
+#include <qcc/atomic.h>
 #include <qcc/Debug.h>
 #include <qcc/Event.h>
 
@@ -55,6 +58,22 @@
 #include <sys/time.h>
 #endif
 
+/*
+ * On Linux the multi-event Wait keeps its descriptors registered with a
+ * per-thread epoll instance across calls instead of rebuilding an fd_set (and
+ * being limited to FD_SETSIZE descriptors) every time.  Pre-define
+ * EVENT_USE_SELECT to fall back to the select() implementation.
+ */
+#if (defined(QCC_OS_LINUX) || defined(QCC_OS_ANDROID)) && !defined(EVENT_USE_SELECT)
+#define EVENT_USE_EPOLL
+#endif
+
+#if defined(EVENT_USE_EPOLL)
+#include <sys/epoll.h>
+#include <set>
+#include <qcc/STLContainer.h>
+#endif
+
 using namespace std;
 using namespace qcc;
 
@@ -68,11 +87,127 @@ static bool initialized = false;
 Event& Event::alwaysSet = (Event&)_alwaysSet;
 Event& Event::neverSet = (Event&)_neverSet;
 
+#if defined(EVENT_USE_EPOLL)
+/*
+ * Descriptors that are closed while they may still be registered in some
+ * thread's epoll set.  Every CloseFd() closes the descriptor, bumps closeEpoch
+ * and records the descriptor in a small ring while holding closedFdLock, so a
+ * thread that starts waiting on a reused descriptor number always sees the
+ * close first.  A waiting thread that sees the epoch move drops just those
+ * descriptors from its set, or starts over with an empty set if it fell more
+ * than a ring's worth behind.
+ */
+static const uint32_t CLOSED_FD_RING_SIZE = 64;
+static int closedFdRing[CLOSED_FD_RING_SIZE];
+static volatile uint32_t closeEpoch = 0;
+static Mutex* closedFdLock = NULL;
+
+static pthread_key_t epollSetKey;
+static bool epollSetKeyValid = false;
+
+class Event::EpollSet {
+  public:
+
+    /**
+     * Get the epoll set owned by the calling thread, creating it on first use.
+     *
+     * @return The calling thread's epoll set or NULL if one cannot be created.
+     */
+    static EpollSet* GetThreadSet()
+    {
+        if (!epollSetKeyValid) {
+            return NULL;
+        }
+        EpollSet* epollSet = reinterpret_cast<EpollSet*>(pthread_getspecific(epollSetKey));
+        if (!epollSet) {
+            epollSet = new EpollSet();
+            if ((epollSet->epfd < 0) || (pthread_setspecific(epollSetKey, epollSet) != 0)) {
+                QCC_LogError(ER_OS_ERROR, ("Unable to create per-thread epoll set (%d:\"%s\")", errno, strerror(errno)));
+                delete epollSet;
+                epollSet = NULL;
+            }
+        }
+        return epollSet;
+    }
+
+    /**
+     * Thread specific data destructor for the epoll set of an exiting thread.
+     *
+     * @param epollSet   The EpollSet to destroy (may be NULL).
+     */
+    static void Destroy(void* epollSet)
+    {
+        delete reinterpret_cast<EpollSet*>(epollSet);
+    }
+
+    EpollSet() : epfd(epoll_create1(EPOLL_CLOEXEC)), generation(0), epoch(closeEpoch)
+    {
+        closedFdLock->Lock();
+        liveSets->insert(this);
+        closedFdLock->Unlock();
+    }
+
+    ~EpollSet()
+    {
+        closedFdLock->Lock();
+        liveSets->erase(this);
+        closedFdLock->Unlock();
+        if (0 <= epfd) {
+            close(epfd);
+        }
+    }
+
+    QStatus Wait(const vector<Event*>& checkEvents, vector<Event*>& signaledEvents, uint32_t maxWaitMs);
+
+    /** Every live epoll set (protected by closedFdLock) so sets of threads still running at Shutdown are freed */
+    static std::set<EpollSet*>* liveSets;
+
+  private:
+
+    /** Kernel registration state of one descriptor */
+    struct Registration {
+        uint32_t registered;    /**< Interest mask currently registered with the kernel */
+        uint32_t wanted;        /**< Interest mask wanted by the current Wait */
+        uint32_t ready;         /**< Readiness reported by the current Wait */
+        uint32_t generation;    /**< Wait generation that last wanted this descriptor */
+        uint32_t owners;        /**< Sum of the serials of the events wanting this descriptor */
+        uint32_t registeredOwners; /**< owners when the kernel registration was last checked */
+        bool pollable;          /**< false for descriptors epoll refuses (e.g. regular files) */
+        Registration() : registered(0), wanted(0), ready(0), generation(0), owners(0), registeredOwners(0), pollable(true) { }
+    };
+
+    typedef std::unordered_map<int, Registration> RegistrationMap;
+
+    void Want(int fd, uint32_t interest, uint32_t serial, bool& alwaysReady);
+    bool IsReady(int fd, uint32_t interest);
+    void SyncClosedFds();
+    void Reset();
+
+    int epfd;                           /**< The epoll instance */
+    uint32_t generation;                /**< Incremented on every Wait */
+    uint32_t epoch;                     /**< Last closeEpoch this set was synced with */
+    RegistrationMap registrations;      /**< Descriptors registered (or known unpollable) */
+    vector<struct epoll_event> readyList;
+};
+
+std::set<Event::EpollSet*>* Event::EpollSet::liveSets = NULL;
+#endif
+
 void Event::Init()
 {
     if (!initialized) {
         new (&alwaysSet)Event(0, 0);
         new (&neverSet)Event(Event::WAIT_FOREVER, 0);
+#if defined(EVENT_USE_EPOLL)
+        closedFdLock = new Mutex();
+        EpollSet::liveSets = new std::set<EpollSet*>();
+        int ret = pthread_key_create(&epollSetKey, EpollSet::Destroy);
+        if (ret != 0) {
+            QCC_LogError(ER_OS_ERROR, ("Creating TLS key: %s", strerror(ret)));
+        } else {
+            epollSetKeyValid = true;
+        }
+#endif
         initialized = true;
     }
 }
@@ -80,12 +215,47 @@ void Event::Init()
 void Event::Shutdown()
 {
     if (initialized) {
+#if defined(EVENT_USE_EPOLL)
+        if (epollSetKeyValid) {
+            /*
+             * pthread_key_delete will not call EpollSet::Destroy for any thread
+             * so free the sets of this and any other thread still running.
+             */
+            pthread_key_delete(epollSetKey);
+            epollSetKeyValid = false;
+        }
+        while (!EpollSet::liveSets->empty()) {
+            delete *EpollSet::liveSets->begin();
+        }
+        delete EpollSet::liveSets;
+        EpollSet::liveSets = NULL;
+        delete closedFdLock;
+        closedFdLock = NULL;
+#endif
         neverSet.~Event();
         alwaysSet.~Event();
         initialized = false;
     }
 }
 
+int Event::CloseFd(int fd)
+{
+#if defined(EVENT_USE_EPOLL)
+    if (closedFdLock) {
+        closedFdLock->Lock();
+        int ret = close(fd);
+        closedFdRing[closeEpoch % CLOSED_FD_RING_SIZE] = fd;
+        closeEpoch = closeEpoch + 1;
+        closedFdLock->Unlock();
+        return ret;
+    }
+#endif
+    return close(fd);
+}
+
+/* Serial numbers start at 1 so a descriptor wanted by no I/O event has no owners */
+static volatile int32_t nextEventSerial = 0;
+
 #if defined(MECHANISM_PIPE) && !defined(DEBUG_EVENT_LEAKS)
 static Mutex* pipeLock = NULL;
 static vector<pair<int, int> >* freePipeList;
@@ -195,23 +365,12 @@ QStatus Event::Wait(Event& evt, uint32_t maxWaitMs)
 #else
 QStatus Event::Wait(Event& evt, uint32_t maxWaitMs)
 {
-    fd_set set;
-    fd_set stopSet;
-    int maxFd = -1;
-    struct timeval tval;
-    struct timeval* pTval = NULL;
+    struct pollfd fds[3];
+    nfds_t numFds = 0;
+    int timeoutMs = (maxWaitMs == WAIT_FOREVER) ? -1 : static_cast<int>(min(maxWaitMs, static_cast<uint32_t>(INT_MAX)));
 
     Thread* thread = Thread::GetThread();
 
-    FD_ZERO(&set);
-    FD_ZERO(&stopSet);
-
-    if (maxWaitMs != WAIT_FOREVER) {
-        tval.tv_sec = maxWaitMs / 1000;
-        tval.tv_usec = (maxWaitMs % 1000) * 1000;
-        pTval = &tval;
-    }
-
     if (evt.eventType == TIMED) {
         uint32_t now = GetTimestamp();
         if (evt.timestamp <= now) {
@@ -219,46 +378,56 @@ QStatus Event::Wait(Event& evt, uint32_t maxWaitMs)
                 evt.timestamp += (((now - evt.timestamp) / evt.period) + 1) * evt.period;
             }
             return ER_OK;
-        } else if (!pTval || ((evt.timestamp - now) < (uint32_t) (tval.tv_sec * 1000 + tval.tv_usec / 1000))) {
-            tval.tv_sec = (evt.timestamp - now) / 1000;
-            tval.tv_usec = 1000 * ((evt.timestamp - now) % 1000);
-            pTval = &tval;
+        } else if ((timeoutMs < 0) || ((evt.timestamp - now) < static_cast<uint32_t>(timeoutMs))) {
+            timeoutMs = static_cast<int>(min(evt.timestamp - now, static_cast<uint32_t>(INT_MAX)));
         }
     } else {
+        short ioEvents = (evt.eventType == IO_WRITE) ? POLLOUT : POLLIN;
         if (0 <= evt.fd) {
-            FD_SET(evt.fd, &set);
-            maxFd = max(maxFd, evt.fd);
+            fds[numFds].fd = evt.fd;
+            fds[numFds].events = ioEvents;
+            fds[numFds].revents = 0;
+            ++numFds;
         }
         if (0 <= evt.ioFd) {
-            FD_SET(evt.ioFd, &set);
-            maxFd = max(maxFd, evt.ioFd);
+            fds[numFds].fd = evt.ioFd;
+            fds[numFds].events = ioEvents;
+            fds[numFds].revents = 0;
+            ++numFds;
         }
     }
 
     int stopFd = -1;
     if (thread) {
         stopFd = thread->GetStopEvent().fd;
-        if (evt.eventType == IO_WRITE) {
-            FD_SET(stopFd, &stopSet);
-        } else {
-            FD_SET(stopFd, &set);
-        }
-        maxFd = max(maxFd, stopFd);
+        fds[numFds].fd = stopFd;
+        fds[numFds].events = POLLIN;
+        fds[numFds].revents = 0;
+        ++numFds;
     }
 
     evt.IncrementNumThreads();
 
-    int ret = select(maxFd + 1,
-                     (evt.eventType == IO_WRITE) ? &stopSet : &set,
-                     (evt.eventType == IO_WRITE) ? &set : NULL,
-                     NULL,
-                     pTval);
+    int ret = poll(fds, numFds, timeoutMs);
 
     evt.DecrementNumThreads();
 
-    if ((0 <= stopFd) && (FD_ISSET(stopFd, &set) || FD_ISSET(stopFd, &stopSet))) {
-        return thread->IsStopping() ? ER_STOPPING_THREAD : ER_ALERTED_THREAD;
-    } else if (evt.eventType == TIMED) {
+    bool ioSignaled = false;
+    bool ioInvalid = false;
+    for (nfds_t i = 0; (0 < ret) && (i < numFds); ++i) {
+        if (fds[i].revents == 0) {
+            continue;
+        }
+        if (fds[i].fd == stopFd) {
+            return thread->IsStopping() ? ER_STOPPING_THREAD : ER_ALERTED_THREAD;
+        } else if (fds[i].revents & POLLNVAL) {
+            ioInvalid = true;
+        } else {
+            ioSignaled = true;
+        }
+    }
+
+    if (evt.eventType == TIMED) {
         uint32_t now = GetTimestamp();
         if (now >= evt.timestamp) {
             if (0 < evt.period) {
@@ -268,9 +437,9 @@ QStatus Event::Wait(Event& evt, uint32_t maxWaitMs)
         } else {
             return ER_TIMEOUT;
         }
-    } else if ((0 < ret) && (((0 <= evt.fd) && FD_ISSET(evt.fd, &set)) || ((0 <= evt.ioFd) && FD_ISSET(evt.ioFd, &set)))) {
+    } else if (ioSignaled) {
         return ER_OK;
-    } else if (0 <= ret) {
+    } else if ((0 <= ret) && !ioInvalid) {
         return ER_TIMEOUT;
     } else {
         return ER_FAIL;
@@ -378,7 +547,227 @@ QStatus Event::Wait(const vector<Event*>& checkEvents, vector<Event*>& signaledE
     }
 }
 #else
+
+#if defined(EVENT_USE_EPOLL)
+void Event::EpollSet::Reset()
+{
+    if (0 <= epfd) {
+        close(epfd);
+    }
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    registrations.clear();
+}
+
+void Event::EpollSet::SyncClosedFds()
+{
+    if (epoch == closeEpoch) {
+        return;
+    }
+
+    int closedFds[CLOSED_FD_RING_SIZE];
+    uint32_t numClosed = 0;
+    bool overrun = false;
+
+    closedFdLock->Lock();
+    uint32_t current = closeEpoch;
+    if ((current - epoch) > CLOSED_FD_RING_SIZE) {
+        overrun = true;
+    } else {
+        for (uint32_t e = epoch; e != current; ++e) {
+            closedFds[numClosed++] = closedFdRing[e % CLOSED_FD_RING_SIZE];
+        }
+    }
+    closedFdLock->Unlock();
+    epoch = current;
+
+    if (overrun) {
+        Reset();
+        return;
+    }
+    for (uint32_t i = 0; i < numClosed; ++i) {
+        RegistrationMap::iterator it = registrations.find(closedFds[i]);
+        if (it != registrations.end()) {
+            if (it->second.registered) {
+                /* Fails harmlessly if the kernel already dropped the closed descriptor */
+                struct epoll_event ev;
+                epoll_ctl(epfd, EPOLL_CTL_DEL, it->first, &ev);
+            }
+            registrations.erase(it);
+        }
+    }
+}
+
+void Event::EpollSet::Want(int fd, uint32_t interest, uint32_t serial, bool& alwaysReady)
+{
+    Registration& reg = registrations[fd];
+    if (reg.generation != generation) {
+        reg.generation = generation;
+        reg.wanted = interest;
+        reg.owners = serial;
+        reg.ready = 0;
+    } else {
+        reg.wanted |= interest;
+        reg.owners += serial;
+    }
+    if (!reg.pollable) {
+        /* select() reports regular files as always ready so mimic that here */
+        alwaysReady = true;
+    }
+}
+
+bool Event::EpollSet::IsReady(int fd, uint32_t interest)
+{
+    RegistrationMap::const_iterator it = registrations.find(fd);
+    if (it == registrations.end()) {
+        return false;
+    }
+    if (!it->second.pollable) {
+        return true;
+    }
+    return (it->second.ready & (interest | EPOLLHUP | EPOLLERR)) != 0;
+}
+
+QStatus Event::EpollSet::Wait(const vector<Event*>& checkEvents, vector<Event*>& signaledEvents, uint32_t maxWaitMs)
+{
+    int timeoutMs = (maxWaitMs == WAIT_FOREVER) ? -1 : static_cast<int>(min(maxWaitMs, static_cast<uint32_t>(INT_MAX)));
+    bool alwaysReady = false;
+    vector<Event*>::const_iterator it;
+
+    SyncClosedFds();
+    if (epfd < 0) {
+        QCC_LogError(ER_OS_ERROR, ("epoll set unavailable (%d:\"%s\")", errno, strerror(errno)));
+        return ER_OS_ERROR;
+    }
+
+    /*
+     * Collect the interest of every descriptor referenced by checkEvents.  A
+     * descriptor shared by several events (e.g. a socket with both a read and a
+     * write event) gets the union of their interests.
+     */
+    ++generation;
+    for (it = checkEvents.begin(); it != checkEvents.end(); ++it) {
+        Event* evt = *it;
+        evt->IncrementNumThreads();
+        if ((evt->eventType == IO_READ) || (evt->eventType == GEN_PURPOSE) || (evt->eventType == IO_WRITE)) {
+            uint32_t interest = (evt->eventType == IO_WRITE) ? EPOLLOUT : EPOLLIN;
+            if (0 <= evt->fd) {
+                Want(evt->fd, interest, 0, alwaysReady);
+            }
+            if (0 <= evt->ioFd) {
+                Want(evt->ioFd, interest, evt->serial, alwaysReady);
+            }
+        } else if (evt->eventType == TIMED) {
+            uint32_t now = GetTimestamp();
+            if (evt->timestamp <= now) {
+                timeoutMs = 0;
+            } else if ((timeoutMs < 0) || ((evt->timestamp - now) < static_cast<uint32_t>(timeoutMs))) {
+                timeoutMs = static_cast<int>(min(evt->timestamp - now, static_cast<uint32_t>(INT_MAX)));
+            }
+        }
+    }
+
+    /*
+     * Bring the kernel registrations in line with what this Wait wants.  In the
+     * steady state (same events as the previous Wait) no system calls are made.
+     * Descriptors that are no longer wanted are removed so that, being level
+     * triggered, they cannot keep waking us up.  A descriptor wanted by a
+     * different set of I/O events than when it was registered is re-checked
+     * with the kernel in case it was closed with a plain close() and its number
+     * reused, which drops the kernel registration without our knowledge.
+     */
+    RegistrationMap::iterator rit = registrations.begin();
+    while (rit != registrations.end()) {
+        Registration& reg = rit->second;
+        if (reg.generation != generation) {
+            if (reg.registered) {
+                struct epoll_event ev;
+                epoll_ctl(epfd, EPOLL_CTL_DEL, rit->first, &ev);
+            }
+            registrations.erase(rit++);
+            continue;
+        }
+        if (reg.pollable && ((reg.wanted != reg.registered) || (reg.owners != reg.registeredOwners))) {
+            struct epoll_event ev;
+            ev.events = reg.wanted;
+            ev.data.fd = rit->first;
+            int op = reg.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+            int ret = epoll_ctl(epfd, op, rit->first, &ev);
+            if ((ret < 0) && (op == EPOLL_CTL_MOD) && (errno == ENOENT)) {
+                /* The kernel dropped the descriptor behind our back (it was closed and reopened) */
+                ret = epoll_ctl(epfd, EPOLL_CTL_ADD, rit->first, &ev);
+            }
+            if (ret == 0) {
+                reg.registered = reg.wanted;
+                reg.registeredOwners = reg.owners;
+            } else if (errno == EPERM) {
+                reg.pollable = false;
+                reg.registered = 0;
+                alwaysReady = true;
+            } else {
+                QCC_LogError(ER_OS_ERROR, ("epoll_ctl failed for fd %d with %d (%s)", rit->first, errno, strerror(errno)));
+            }
+        }
+        ++rit;
+    }
+
+    if (alwaysReady) {
+        timeoutMs = 0;
+    }
+    readyList.resize(max(registrations.size(), static_cast<size_t>(1)));
+
+    int ret = epoll_wait(epfd, &readyList[0], static_cast<int>(readyList.size()), timeoutMs);
+    if ((ret < 0) && (errno == EINTR)) {
+        ret = 0;
+    }
+
+    if (0 <= ret) {
+        for (int i = 0; i < ret; ++i) {
+            RegistrationMap::iterator rit = registrations.find(readyList[i].data.fd);
+            if (rit != registrations.end()) {
+                rit->second.ready = readyList[i].events;
+            }
+        }
+        for (it = checkEvents.begin(); it != checkEvents.end(); ++it) {
+            Event* evt = *it;
+            evt->DecrementNumThreads();
+            if ((evt->eventType == IO_READ) || (evt->eventType == GEN_PURPOSE) || (evt->eventType == IO_WRITE)) {
+                uint32_t interest = (evt->eventType == IO_WRITE) ? EPOLLOUT : EPOLLIN;
+                if (((0 <= evt->fd) && IsReady(evt->fd, interest)) || ((0 <= evt->ioFd) && IsReady(evt->ioFd, interest))) {
+                    signaledEvents.push_back(evt);
+                }
+            } else if (evt->eventType == TIMED) {
+                uint32_t now = GetTimestamp();
+                if (evt->timestamp <= now) {
+                    signaledEvents.push_back(evt);
+                    if (0 < evt->period) {
+                        evt->timestamp += (((now - evt->timestamp) / evt->period) + 1) * evt->period;
+                    }
+                }
+            }
+        }
+        return signaledEvents.empty() ? ER_TIMEOUT : ER_OK;
+    } else {
+        for (it = checkEvents.begin(); it != checkEvents.end(); ++it) {
+            (*it)->DecrementNumThreads();
+        }
+        QCC_LogError(ER_FAIL, ("epoll_wait failed with %d (%s)", errno, strerror(errno)));
+        return ER_FAIL;
+    }
+}
+#endif
+
 QStatus Event::Wait(const vector<Event*>& checkEvents, vector<Event*>& signaledEvents, uint32_t maxWaitMs)
+{
+#if defined(EVENT_USE_EPOLL)
+    EpollSet* epollSet = EpollSet::GetThreadSet();
+    if (epollSet) {
+        return epollSet->Wait(checkEvents, signaledEvents, maxWaitMs);
+    }
+#endif
+    return SelectWait(checkEvents, signaledEvents, maxWaitMs);
+}
+
+QStatus Event::SelectWait(const vector<Event*>& checkEvents, vector<Event*>& signaledEvents, uint32_t maxWaitMs)
 {
     fd_set rdset;
     fd_set wrset;
@@ -518,7 +907,7 @@ static void CreateMechanism(int* rdFd, int* wrFd)
 static void DestroyMechanism(int rdFd, int wrFd)
 {
 #ifdef DEBUG_EVENT_LEAKS
-    close(rdFd);
+    Event::CloseFd(rdFd);
     close(wrFd);
 #else
     pipeLock->Lock();
@@ -535,7 +924,7 @@ static void DestroyMechanism(int rdFd, int wrFd)
     while (it != usedPipeList->end()) {
         if (it->first == rdFd) {
             if (closePipe) {
-                close(rdFd);
+                Event::CloseFd(rdFd);
                 close(wrFd);
             } else {
                 freePipeList->push_back(*it);
@@ -552,7 +941,7 @@ static void DestroyMechanism(int rdFd, int wrFd)
             /* Empty the free list if this was the last pipe in use */
             vector<pair<int, int> >::iterator it = freePipeList->begin();
             while (it != freePipeList->end()) {
-                close(it->first);
+                Event::CloseFd(it->first);
                 close(it->second);
                 it = freePipeList->erase(it);
             }
@@ -560,7 +949,7 @@ static void DestroyMechanism(int rdFd, int wrFd)
             /* Trim freeList down to 2*used pipe */
             while (freePipeList->size() > (2 * usedPipeList->size())) {
                 pair<int, int> fdPair = freePipeList->back();
-                close(fdPair.first);
+                Event::CloseFd(fdPair.first);
                 close(fdPair.second);
                 freePipeList->pop_back();
             }
@@ -667,7 +1056,7 @@ static void DestroyMechanism(int readFd, int writeFd)
     QCC_UNUSED(writeFd);
     QCC_DbgTrace(("DestroyMechanism()"));
     assert(readFd == writeFd && "destroyMechanism(): expect readFd == writeFd for eventfd mechanism");
-    close(readFd);
+    Event::CloseFd(readFd);
 }
 
 /*
@@ -727,18 +1116,20 @@ static QStatus ResetMechanism(int efd)
 
 #endif // defined(MECHANISM_EVENTFD)
 
-Event::Event() : fd(-1), signalFd(-1), ioFd(-1), eventType(GEN_PURPOSE), numThreads(0)
+Event::Event() : fd(-1), signalFd(-1), ioFd(-1), eventType(GEN_PURPOSE), numThreads(0), serial(0)
 {
     CreateMechanism(&fd, &signalFd);
 }
 
 Event::Event(SocketFd ioFd, EventType eventType)
-    : fd(-1), signalFd(-1), ioFd(ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0)
+    : fd(-1), signalFd(-1), ioFd(ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0),
+    serial(static_cast<uint32_t>(IncrementAndFetch(&nextEventSerial)))
 {
 }
 
 Event::Event(Event& event, EventType eventType, bool genPurpose)
-    : fd(-1), signalFd(-1), ioFd(event.ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0)
+    : fd(-1), signalFd(-1), ioFd(event.ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0),
+    serial(static_cast<uint32_t>(IncrementAndFetch(&nextEventSerial)))
 {
     if (genPurpose) {
         CreateMechanism(&fd, &signalFd);
@@ -752,7 +1143,8 @@ Event::Event(uint32_t timestamp, uint32_t period)
     eventType(TIMED),
     timestamp(WAIT_FOREVER == timestamp ? WAIT_FOREVER : GetTimestamp() + timestamp),
     period(period),
-    numThreads(0)
+    numThreads(0),
+    serial(0)
 {
 }
 
@@ -81,7 +81,7 @@ FileSource FileSource::operator=(const FileSource& other)
 {
     if (&other != this) {
         if (ownsFd && (0 <= fd)) {
-            close(fd);
+            Event::CloseFd(fd);
         }
         fd = dup(other.fd);
         delete event;
@@ -95,7 +95,7 @@ FileSource FileSource::operator=(const FileSource& other)
 FileSource::~FileSource()
 {
     if (ownsFd && (0 <= fd)) {
-        close(fd);
+        Event::CloseFd(fd);
     }
     delete event;
 }
@@ -215,8 +215,12 @@ FileSink::FileSink(qcc::String fileName, Mode mode)
         begin = end + 1;
     }
 
-    /* Create and open the file */
-    fd = open(fileName.c_str(), O_CREAT | O_WRONLY | O_TRUNC, fileMode);
+    /* Create and open the file or open an existing file for appending */
+    if (APPEND & mode) {
+        fd = open(fileName.c_str(), O_WRONLY | O_APPEND);
+    } else {
+        fd = open(fileName.c_str(), O_CREAT | O_WRONLY | O_TRUNC, fileMode);
+    }
     if (0 > fd) {
         QCC_LogError(ER_OS_ERROR, ("open(%s) failed with '%s'", fileName.c_str(), strerror(errno)));
     }
@@ -236,7 +240,7 @@ FileSink FileSink::operator=(const FileSink& other)
 {
     if (&other != this) {
         if (ownsFd && (0 <= fd)) {
-            close(fd);
+            Event::CloseFd(fd);
         }
         fd = dup(other.fd);
         delete event;
@@ -250,7 +254,7 @@ FileSink FileSink::operator=(const FileSink& other)
 FileSink::~FileSink()
 {
     if (ownsFd && (0 <= fd)) {
-        close(fd);
+        Event::CloseFd(fd);
     }
     delete event;
 }
@@ -473,7 +473,7 @@ QStatus Shutdown(SocketFd sockfd)
 void Close(SocketFd sockfd)
 {
     assert(sockfd >= 0);
-    close(static_cast<int>(sockfd));
+    Event::CloseFd(static_cast<int>(sockfd));
 }
 
 QStatus SocketDup(SocketFd sockfd, SocketFd& dupSock)
@@ -799,6 +799,36 @@ QStatus RecvWithFds(SocketFd sockfd, void* buf, size_t len, size_t& received, So
     return status;
 }
 
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t iovLen, size_t& sent)
+{
+    QStatus status = ER_OK;
+    struct msghdr msg;
+
+    QCC_DbgTrace(("SendV(sockfd = %d, iov = <>, iovLen = %lu, sent = <>)", sockfd, iovLen));
+    assert(iov != NULL);
+
+    /*
+     * IOVec matches struct iovec, sendmsg() is used rather than writev() so that we can pass
+     * MSG_NOSIGNAL.
+     */
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = reinterpret_cast<struct iovec*>(const_cast<IOVec*>(iov));
+    msg.msg_iovlen = iovLen;
+
+    ssize_t ret = sendmsg(static_cast<int>(sockfd), &msg, MSG_NOSIGNAL);
+    if (ret == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            status = ER_WOULDBLOCK;
+        } else {
+            status = ER_OS_ERROR;
+            QCC_DbgHLPrintf(("SendV (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+        }
+    } else {
+        sent = static_cast<size_t>(ret);
+    }
+    return status;
+}
+
 QStatus SendWithFds(SocketFd sockfd, const void* buf, size_t len, size_t& sent, SocketFd* fdList, size_t numFds, uint32_t pid)
 {
     QCC_UNUSED(pid);
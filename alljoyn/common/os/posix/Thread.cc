@@ -58,6 +58,39 @@ map<ThreadId, Thread*>* Thread::threadList = NULL;
 static pthread_key_t cleanExternalThreadKey;
 static bool initialized = false;
 
+/*
+ * The Thread object of the calling thread is kept in thread local storage so
+ * that GetThread() does not need to take threadListLock and search
+ * threadList.  threadList is still maintained for CleanExternalThreads() and
+ * for debugging.
+ *
+ * CleanExternalThreads() can delete external Thread objects out from under
+ * other threads.  The epoch recorded alongside an external thread's entry
+ * lets GetThread() detect that and fall back to the thread list.
+ */
+static pthread_key_t currentThreadKey;
+static pthread_key_t currentThreadEpochKey;
+static volatile int32_t externalThreadEpoch = 0;
+
+static inline void SetCurrentThread(Thread* thread, bool isExternal)
+{
+    pthread_setspecific(currentThreadKey, thread);
+    pthread_setspecific(currentThreadEpochKey, isExternal ? reinterpret_cast<void*>(static_cast<intptr_t>(externalThreadEpoch) + 1) : NULL);
+}
+
+static inline Thread* GetCurrentThread()
+{
+    Thread* thread = reinterpret_cast<Thread*>(pthread_getspecific(currentThreadKey));
+    if (thread) {
+        intptr_t epoch = reinterpret_cast<intptr_t>(pthread_getspecific(currentThreadEpochKey));
+        if (epoch && (epoch != (static_cast<intptr_t>(externalThreadEpoch) + 1))) {
+            /* External thread object may have been deleted by CleanExternalThreads() */
+            thread = NULL;
+        }
+    }
+    return thread;
+}
+
 void Thread::CleanExternalThread(void* t)
 {
     /* This function will not be called if value of key is NULL */
@@ -89,6 +122,20 @@ QStatus Thread::Init()
             delete threadListLock;
             return ER_OS_ERROR;
         }
+        ret = pthread_key_create(&currentThreadKey, NULL);
+        if (ret == 0) {
+            ret = pthread_key_create(&currentThreadEpochKey, NULL);
+            if (ret != 0) {
+                pthread_key_delete(currentThreadKey);
+            }
+        }
+        if (ret != 0) {
+            QCC_LogError(ER_OS_ERROR, ("Creating TLS key: %s", strerror(ret)));
+            pthread_key_delete(cleanExternalThreadKey);
+            delete threadList;
+            delete threadListLock;
+            return ER_OS_ERROR;
+        }
         initialized = true;
     }
     return ER_OK;
@@ -105,6 +152,8 @@ QStatus Thread::Shutdown()
         if (ret != 0) {
             QCC_LogError(ER_OS_ERROR, ("Deleting TLS key: %s", strerror(ret)));
         }
+        pthread_key_delete(currentThreadKey);
+        pthread_key_delete(currentThreadEpochKey);
         delete Thread::threadList;
         delete Thread::threadListLock;
         initialized = false;
@@ -119,13 +168,17 @@ QStatus Sleep(uint32_t ms) {
 
 Thread* Thread::GetThread()
 {
-    Thread* ret = NULL;
+    Thread* ret = GetCurrentThread();
+    if (ret) {
+        return ret;
+    }
 
     /* Find thread on Thread::threadList */
     threadListLock->Lock();
     map<ThreadHandle, Thread*>::const_iterator iter = threadList->find(pthread_self());
     if (iter != threadList->end()) {
         ret = iter->second;
+        SetCurrentThread(ret, ret->isExternal);
     }
     threadListLock->Unlock();
 
@@ -139,15 +192,17 @@ Thread* Thread::GetThread()
 
 const char* Thread::GetThreadName()
 {
-    Thread* thread = NULL;
+    Thread* thread = GetCurrentThread();
 
-    /* Find thread on Thread::threadList */
-    threadListLock->Lock();
-    map<ThreadId, Thread*>::const_iterator iter = threadList->find(pthread_self());
-    if (iter != threadList->end()) {
-        thread = iter->second;
+    if (thread == NULL) {
+        /* Find thread on Thread::threadList */
+        threadListLock->Lock();
+        map<ThreadId, Thread*>::const_iterator iter = threadList->find(pthread_self());
+        if (iter != threadList->end()) {
+            thread = iter->second;
+        }
+        threadListLock->Unlock();
     }
-    threadListLock->Unlock();
 
     /* If the current thread isn't on the list, then don't create an external (wrapper) thread */
     if (thread == NULL) {
@@ -160,6 +215,7 @@ const char* Thread::GetThreadName()
 void Thread::CleanExternalThreads()
 {
     threadListLock->Lock();
+    IncrementAndFetch(&externalThreadEpoch);
     map<ThreadId, Thread*>::iterator it = threadList->begin();
     while (it != threadList->end()) {
         if (it->second->isExternal) {
@@ -200,6 +256,7 @@ Thread::Thread(qcc::String name, Thread::ThreadFunction func, bool isExternal) :
         assert(func == NULL);
         threadListLock->Lock();
         (*threadList)[handle] = this;
+        SetCurrentThread(this, true);
         if (pthread_getspecific(cleanExternalThreadKey) == NULL) {
             int ret = pthread_setspecific(cleanExternalThreadKey, this);
             if (ret != 0) {
@@ -222,6 +279,11 @@ Thread::~Thread(void)
         Join();
     }
 
+    /* Don't leave a dangling current thread behind for an external thread object */
+    if (pthread_getspecific(currentThreadKey) == this) {
+        SetCurrentThread(NULL, false);
+    }
+
     /* Keep object alive until waitCount goes to zero */
     while (waitCount) {
         qcc::Sleep(2);
@@ -255,6 +317,7 @@ ThreadInternalReturn Thread::RunInternal(void* arg)
     /* Add this Thread to list of running threads */
     threadListLock->Lock();
     (*threadList)[thread->handle] = thread;
+    SetCurrentThread(thread, false);
     thread->state = RUNNING;
     pthread_sigmask(SIG_UNBLOCK, &newmask, NULL);
     threadListLock->Unlock();
@@ -299,6 +362,7 @@ ThreadInternalReturn Thread::RunInternal(void* arg)
     threadListLock->Lock();
     threadList->erase(handle);
     threadListLock->Unlock();
+    SetCurrentThread(NULL, false);
 
     return reinterpret_cast<ThreadInternalReturn>(retVal);
 }
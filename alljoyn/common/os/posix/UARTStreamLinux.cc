@@ -298,7 +298,7 @@ void UARTStream::Close()
     if (fd != -1) {
         /* Release the lock on this FD */
         flock(fd, LOCK_UN);
-        close(fd);
+        Event::CloseFd(fd);
         fd = -1;
     }
 }
@@ -46,6 +46,19 @@ int32_t DecrementAndFetch(volatile int32_t* mem)
     return ret;
 }
 
+bool CompareAndExchange(volatile int32_t* mem, int32_t expectedValue, int32_t newValue)
+{
+    bool ret = false;
+
+    pthread_mutex_lock(&atomicLock);
+    if (*mem == expectedValue) {
+        *mem = newValue;
+        ret = true;
+    }
+    pthread_mutex_unlock(&atomicLock);
+    return ret;
+}
+
 }
 
 #endif
@@ -206,7 +206,7 @@ FileSink::FileSink(qcc::String fileName, Mode mode) : handle(INVALID_HANDLE_VALU
     ReSlash(fileName);
 
     DWORD attributes;
-    switch (mode) {
+    switch (mode & ~APPEND) {
     case PRIVATE:
         attributes = FILE_ATTRIBUTE_HIDDEN;
         break;
@@ -264,17 +264,21 @@ FileSink::FileSink(qcc::String fileName, Mode mode) : handle(INVALID_HANDLE_VALU
         begin = end + 1;
     }
 
-    /* Create and open the file */
+    /* Create and open the file or open an existing file for appending */
     handle = CreateFileA(fileName.substr(skip).c_str(),
                          GENERIC_WRITE,
                          FILE_SHARE_READ,
                          NULL,
-                         CREATE_ALWAYS,
+                         (APPEND & mode) ? OPEN_EXISTING : CREATE_ALWAYS,
                          attributes,
                          INVALID_HANDLE_VALUE);
 
     if (INVALID_HANDLE_VALUE == handle) {
         QCC_LogError(ER_OS_ERROR, ("CreateFile(GENERIC_WRITE) %s failed (%d)", fileName.c_str(), ::GetLastError()));
+    } else if ((APPEND & mode) && (INVALID_SET_FILE_POINTER == SetFilePointer(handle, 0, NULL, FILE_END))) {
+        QCC_LogError(ER_OS_ERROR, ("SetFilePointer() %s failed (%d)", fileName.c_str(), ::GetLastError()));
+        CloseHandle(handle);
+        handle = INVALID_HANDLE_VALUE;
     }
 }
 
@@ -727,6 +727,32 @@ QStatus RecvWithFds(SocketFd sockfd, void* buf, size_t len, size_t& received, So
     return status;
 }
 
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t iovLen, size_t& sent)
+{
+    QStatus status = ER_OK;
+    DWORD numSent = 0;
+
+    QCC_DbgTrace(("SendV(sockfd = %d, iov = <>, iovLen = %lu, sent = <>)", sockfd, iovLen));
+    assert(iov != NULL);
+
+    /*
+     * IOVec matches WSABUF
+     */
+    int ret = WSASend(static_cast<SOCKET>(sockfd), reinterpret_cast<LPWSABUF>(const_cast<IOVec*>(iov)), static_cast<DWORD>(iovLen), &numSent, 0, NULL, NULL);
+    if (ret == SOCKET_ERROR) {
+        if (WSAGetLastError() == WSAEWOULDBLOCK) {
+            sent = 0;
+            status = ER_WOULDBLOCK;
+        } else {
+            status = ER_OS_ERROR;
+            QCC_DbgHLPrintf(("SendV: %s", GetLastErrorString().c_str()));
+        }
+    } else {
+        sent = static_cast<size_t>(numSent);
+    }
+    return status;
+}
+
 QStatus SendWithFds(SocketFd sockfd, const void* buf, size_t len, size_t& sent, SocketFd* fdList, size_t numFds, uint32_t pid)
 {
     QStatus status = ER_OK;
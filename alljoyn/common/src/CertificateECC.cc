@@ -20,8 +20,11 @@
  ******************************************************************************/
 
 #include <qcc/platform.h>
+#include <set>
+#include <deque>
 #include <qcc/Crypto.h>
 #include <qcc/CertificateECC.h>
+#include <qcc/Mutex.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Util.h>
@@ -1095,14 +1098,116 @@ QStatus CertificateX509::Verify() const
     return Verify(&publickey);
 }
 
+/**
+ * Bounded cache of successful certificate signature verifications.  An entry
+ * is the SHA-256 digest of the issuer public key, the TBS bytes and the
+ * signature, so a hit means this exact certificate was already verified with
+ * this exact key.  Entries are evicted oldest first.
+ */
+class VerifiedCertificateCache {
+  public:
+    /**
+     * The maximum number of verifications remembered
+     */
+    static const size_t MAX_ENTRIES = 1024;
+
+    struct Entry {
+        uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+
+        bool operator<(const Entry& other) const
+        {
+            return memcmp(digest, other.digest, sizeof(digest)) < 0;
+        }
+    };
+
+    static void ComputeEntry(const ECCPublicKey* key, const String& tbs, const ECCSignature& signature, Entry& entry)
+    {
+        Crypto_SHA256 sha;
+        sha.Init();
+        sha.Update(key->GetX(), key->GetCoordinateSize());
+        sha.Update(key->GetY(), key->GetCoordinateSize());
+        sha.Update((const uint8_t*) tbs.data(), tbs.size());
+        sha.Update(signature.r, sizeof(signature.r));
+        sha.Update(signature.s, sizeof(signature.s));
+        sha.GetDigest(entry.digest);
+    }
+
+    bool Contains(const Entry& entry)
+    {
+        lock.Lock(MUTEX_CONTEXT);
+        bool found = (entries.find(entry) != entries.end());
+        lock.Unlock(MUTEX_CONTEXT);
+        return found;
+    }
+
+    void Add(const Entry& entry)
+    {
+        lock.Lock(MUTEX_CONTEXT);
+        if (entries.insert(entry).second) {
+            order.push_back(entry);
+            if (order.size() > MAX_ENTRIES) {
+                entries.erase(order.front());
+                order.pop_front();
+            }
+        }
+        lock.Unlock(MUTEX_CONTEXT);
+    }
+
+  private:
+    Mutex lock;
+    std::set<Entry> entries;
+    std::deque<Entry> order;
+};
+
+static VerifiedCertificateCache* verifiedCertificateCache = NULL;
+
+void CertificateX509::Init()
+{
+    if (verifiedCertificateCache == NULL) {
+        verifiedCertificateCache = new VerifiedCertificateCache();
+    }
+}
+
+void CertificateX509::Shutdown()
+{
+    delete verifiedCertificateCache;
+    verifiedCertificateCache = NULL;
+}
+
 QStatus CertificateX509::Verify(const ECCPublicKey* key) const
 {
     if (key->empty()) {
         return ER_FAIL;
     }
+    VerifiedCertificateCache::Entry entry;
+    if (verifiedCertificateCache) {
+        VerifiedCertificateCache::ComputeEntry(key, tbs, signature, entry);
+        if (verifiedCertificateCache->Contains(entry)) {
+            return ER_OK;
+        }
+    }
     Crypto_ECC ecc;
     ecc.SetDSAPublicKey(key);
-    return ecc.DSAVerify((const uint8_t*) tbs.data(), tbs.size(), &signature);
+    QStatus status = ecc.DSAVerify((const uint8_t*) tbs.data(), tbs.size(), &signature);
+    if ((ER_OK == status) && verifiedCertificateCache) {
+        verifiedCertificateCache->Add(entry);
+    }
+    return status;
+}
+
+QStatus AJ_CALL CertificateX509::VerifyCertChain(const CertificateX509* certChain, size_t count)
+{
+    if ((NULL == certChain) || (0 == count)) {
+        return ER_INVALID_DATA;
+    }
+    for (size_t cnt = 0; cnt < (count - 1); cnt++) {
+        /* Identical links in the chain, and links verified earlier, hit the cache. */
+        QStatus status = certChain[cnt].Verify(certChain[cnt + 1].GetSubjectPublicKey());
+        if (ER_OK != status) {
+            return status;
+        }
+    }
+    return ER_OK;
 }
 
 QStatus CertificateX509::Verify(const KeyInfoNISTP256& ta) const
@@ -221,7 +221,23 @@ uint64_t software_umul128(uint64_t u, uint64_t v, uint64_t* high)
     return (t << 32) + w3;
 }
 
-#ifndef _umul128
+#if defined(__SIZEOF_INT128__)
+/* The compiler has a native 128-bit type, let it pick the best instructions. */
+#define P256_HAVE_INT128
+static inline uint64_t native_umul128(uint64_t u, uint64_t v, uint64_t* high)
+{
+    unsigned __int128 product = (unsigned __int128)u * v;
+    *high = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+}
+#define _umul128 native_umul128
+#elif defined(_M_X64)
+/* _umul128 is an intrinsic function on x64 Windows */
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+#if !defined(_umul128) && !defined(_M_X64)
 #define _umul128 software_umul128
 #endif
 
@@ -263,6 +279,31 @@ uint64_t software_umul128(uint64_t u, uint64_t v, uint64_t* high)
         ADDC(carry, c1, c1, 0, carry); \
 }
 
+#ifdef P256_HAVE_INT128
+
+/* Carry propagating addition and subtraction using the native 128-bit type. These are branch-free. */
+#define ADD(carryOut, sumOut, addend1, addend2) { \
+        unsigned __int128 _sum = (unsigned __int128)(addend1) + (digit_t)(addend2); \
+        (sumOut) = (digit_t)_sum; \
+        carryOut = (digit_t)(_sum >> 64); }
+
+#define ADDC(carryOut, sumOut, addend1, addend2, carryIn) { \
+        unsigned __int128 _sum = (unsigned __int128)(addend1) + (digit_t)(addend2) + (digit_t)(carryIn); \
+        (sumOut) = (digit_t)_sum; \
+        (carryOut) = (digit_t)(_sum >> 64); }
+
+#define SUB(borrowOut, differenceOut, minuend, subtrahend) { \
+        unsigned __int128 _diff = (unsigned __int128)(minuend) - (digit_t)(subtrahend); \
+        (differenceOut) = (digit_t)_diff; \
+        (borrowOut) = (digit_t)(_diff >> 127); }
+
+#define SUBC(borrowOut, differenceOut, minuend, subtrahend, borrowIn) { \
+        unsigned __int128 _diff = (unsigned __int128)(minuend) - (digit_t)(subtrahend) - (digit_t)(borrowIn); \
+        (differenceOut) = (digit_t)_diff; \
+        (borrowOut) = (digit_t)(_diff >> 127); }
+
+#else
+
 /* Adds two operands, and produces sum of the two inputs and the carry bit.
  * This is ideally an intrinsic, but is emulated when an intrinsic is not available. */
 #define ADD(carryOut, sumOut, addend1, addend2) { \
@@ -292,6 +333,8 @@ uint64_t software_umul128(uint64_t u, uint64_t v, uint64_t* high)
         (differenceOut) = tempReg - (digit_t)(borrowIn); \
         (borrowOut) = borrowReg; }
 
+#endif
+
 /* Move if carry is set. */
 #define CMOVC(dest, src, selector) { \
         digit_t mask = (digit_t)is_digit_nonzero_ct(selector) - 1; \
@@ -398,104 +441,140 @@ static void mul_p256(
 
 }
 
+/* Compute c = a^2 for 256-bit a
+ * Private function used to implement fpsqr_p256. The cross products are only computed once. */
+static void sqr_p256(
+    digit256_tc a,
+    digit_t* c)             /* Note this must have size at least 2*P256_DIGITS */
+{
+    digit_t t, s0, s1, s2, s3, s4, s5, s6, s7;
+
+    assert(a != NULL);
+    assert(c != NULL);
+
+    /* Cross products a[i]*a[j] for i < j */
+    mul(c[1], c[2], a[0], a[1]);
+    muladd(c[2], c[3], a[0], a[2]);
+    muladd(c[3], c[4], a[0], a[3]);
+
+    muladd(c[3], t, a[1], a[2]);
+    muladdadd(c[4], t, a[1], a[3]);
+    c[5] = t;
+
+    muladd(c[5], t, a[2], a[3]);
+    c[6] = t;
+
+    /* Double them */
+    c[7] = c[6] >> (RADIX_BITS - 1);
+    c[6] = (c[6] << 1) | (c[5] >> (RADIX_BITS - 1));
+    c[5] = (c[5] << 1) | (c[4] >> (RADIX_BITS - 1));
+    c[4] = (c[4] << 1) | (c[3] >> (RADIX_BITS - 1));
+    c[3] = (c[3] << 1) | (c[2] >> (RADIX_BITS - 1));
+    c[2] = (c[2] << 1) | (c[1] >> (RADIX_BITS - 1));
+    c[1] = (c[1] << 1);
+
+    /* Add the squares a[i]^2 */
+    mul(s0, s1, a[0], a[0]);
+    mul(s2, s3, a[1], a[1]);
+    mul(s4, s5, a[2], a[2]);
+    mul(s6, s7, a[3], a[3]);
+
+    c[0] = s0;
+    ADD(t, c[1], c[1], s1);
+    ADDC(t, c[2], c[2], s2, t);
+    ADDC(t, c[3], c[3], s3, t);
+    ADDC(t, c[4], c[4], s4, t);
+    ADDC(t, c[5], c[5], s5, t);
+    ADDC(t, c[6], c[6], s6, t);
+    ADDC(t, c[7], c[7], s7, t);
+}
+
 /* Compute c = a mod 2^256-2^224+2^192+2^96-1
  * such that 0 <= c < 2^256-2^224+2^192+2^96-1
- * Private function used to implement fpmul_p256. */
+ * Private function used to implement fpmul_p256.
+ *
+ * This is the fast reduction for NIST primes from FIPS 186-4 Appendix D.2.3. Writing
+ * the input as 32-bit words a15..a0 the result is s1 + 2s2 + 2s3 + s4 + s5 - s6 - s7 - s8 - s9
+ * which is accumulated a word at a time in a signed 64-bit accumulator. The small
+ * multiple of 2^256 left over is folded back using 2^256 = 2^224 - 2^192 - 2^96 + 1 (mod p)
+ * followed by a constant-time conditional subtraction of p. */
 static void reduce_p256(
     digit_t*   a,
     digit256_t c)
 {
-    /* 4*p = 0x 3 FFFFFFFC00000004 0000000000000000 00000003FFFFFFFF FFFFFFFFFFFFFFFC */
-    digit_t c0, c1, c2, c3, c4, c5, c6, c7;
-    digit_t r0, r1, r2, r3, r4;
-    digit_t p0, p1, p2, p3, p4;
-    digit_t q0, q1, q2, q3, q4;
-    digit_t t;
+    int64_t a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15;
+    int64_t acc;
+    int64_t carry;
+    uint32_t r0, r1, r2, r3, r4, r5, r6, r7;
+    digit_t q0, q1, q2, q3, borrow;
+    int i;
 
     assert(a != NULL);
     assert(c != NULL);
 
-    c0 = a[0]; c1 = a[1]; c2 = a[2]; c3 = a[3];
-    c4 = a[4]; c5 = a[5]; c6 = a[6]; c7 = a[7];
-
-    /* compute s2 + s2  = [r4, r3, r2, r1, 0] */
-    t = gethigh_tohigh(c5);
-    add3(r1, r2, r3, r4, t, c6, c7, t, c6, c7);
-
-    /* compute s3 + s3  = [p3, p2, p1, 0] */
-    p1 = getlow_tohigh(c6);
-    p2 = (gethigh_tolow(c6) | getlow_tohigh(c7));
-    p3 = gethigh_tolow(c7);
-    add3_ncout(p1, p2, p3, p1, p2, p3, p1, p2, p3);
-
-    /* Compute 2s_2 + 2s_3 = [p4, p3, p2, p1, 0] */
-    add4_ncout(p1, p2, p3, p4, p1, p2, p3, 0, r1, r2, r3, r4);
-
-    /* Compute s_1+s_4 = [q4, q3, q2, q1, q0] */
-    q1 = getlow_tolow(c5);
-    add4(q0, q1, q2, q3, q4, c0, c1, c2, c3, c4, q1, 0, c7);
-
-    /* Compute s_1+s_4+2s_2+2s_3 = [q4,q3,q2,q1,q0] */
-    add4_ncout(q1, q2, q3, q4, q1, q2, q3, q4, p1, p2, p3, p4);
-
-    /* Compute s_1+s_4+2s_2+2s_3+s_5 = [q4,q3,q2,q1,q0] */
-    p0 = (gethigh_tolow(c4) | getlow_tohigh(c5));
-    p1 = (gethigh_tolow(c5) | gethigh_tohigh(c6));
-    p3 = (gethigh_tolow(c6) | getlow_tohigh(c4));
-    add4(q0, q1, q2, q3, p4, q0, q1, q2, q3, p0, p1, c7, p3);
-    q4 += p4;
-
-    /* Compute s_1+s_4+2s_2+2s_3+s_5+4p_256 = [q4,q3,q2,q1,q0] */
-    add5_ncout(q0, q1, q2, q3, q4, q0, q1, q2, q3, q4, \
-               0xFFFFFFFFFFFFFFFC, 0x3FFFFFFFF, 0x0, 0xFFFFFFFC00000004, 0x3);
-
-    /* Compute s_6+s_7 = [p4,p3,p2,p1,p0] */
-    t = (gethigh_tolow(c4) | gethigh_tohigh(c5));
-    p0 = (gethigh_tolow(c5) | getlow_tohigh(c6));
-    p1 = gethigh_tolow(c6);
-    p2 = 0;
-    p3 = (getlow_tolow(c4) | getlow_tohigh(c5));
-    add4(p0, p1, p2, p3, p4, c6, c7, 0, t, p0, p1, p2, p3);
-
-
-    /* Compute s_6+s_7+s_8 = [p4,p3,p2,p1,p0] */
-    r0 = (gethigh_tolow(c6) | getlow_tohigh(c7));
-    r1 = (gethigh_tolow(c7) | getlow_tohigh(c4));
-    r2 = (gethigh_tolow(c4) | getlow_tohigh(c5));
-    r3 = getlow_tohigh(c6);
-    add4(p0, p1, p2, p3, r4, r0, r1, r2, r3, p0, p1, p2, p3);
-    p4 += r4;
-
-    /* Compute s_6+s_7+s_8+s_9 = [p4,p3,p2,p1,p0] */
-    r1 = gethigh_tohigh(c4);
-    r3 = gethigh_tohigh(c6);
-    add4(p0, p1, p2, p3, r4, c7, r1, c5, r3, p0, p1, p2, p3);
-    p4 += r4;
-
-    /* Compute d = s_1+2s_2+2s_3+s_4+s_5 - (s_6+s_7+s_8+s_9) */
-    sub5_nborrow(q0, q1, q2, q3, q4, q0, q1, q2, q3, q4, p0, p1, p2, p3, p4);
-
-    /* [q0+q4], [q1-q4*2^32], [q2], [q3-d+d*2^32] */
-    p4 = 0;
-    add4(q0, q1, q2, q3, p4, q0, q1, q2, q3, q4, 0, 0, 0);
-    p0 = (q4 << (digit_t)32);
-    sub4_nborrow(q1, q2, q3, p4, q1, q2, q3, p4, p0, 0, 0, 0);
-    p0 = p0 - q4;
-    add2_ncout(q3, p4, q3, p4, p0, 0);
+    a0 = (int64_t)getlow_tolow(a[0]);  a1 = (int64_t)gethigh_tolow(a[0]);
+    a2 = (int64_t)getlow_tolow(a[1]);  a3 = (int64_t)gethigh_tolow(a[1]);
+    a4 = (int64_t)getlow_tolow(a[2]);  a5 = (int64_t)gethigh_tolow(a[2]);
+    a6 = (int64_t)getlow_tolow(a[3]);  a7 = (int64_t)gethigh_tolow(a[3]);
+    a8 = (int64_t)getlow_tolow(a[4]);  a9 = (int64_t)gethigh_tolow(a[4]);
+    a10 = (int64_t)getlow_tolow(a[5]); a11 = (int64_t)gethigh_tolow(a[5]);
+    a12 = (int64_t)getlow_tolow(a[6]); a13 = (int64_t)gethigh_tolow(a[6]);
+    a14 = (int64_t)getlow_tolow(a[7]); a15 = (int64_t)gethigh_tolow(a[7]);
+
+    acc = a0 + a8 + a9 - a11 - a12 - a13 - a14;
+    r0 = (uint32_t)acc; acc >>= 32;
+    acc += a1 + a9 + a10 - a12 - a13 - a14 - a15;
+    r1 = (uint32_t)acc; acc >>= 32;
+    acc += a2 + a10 + a11 - a13 - a14 - a15;
+    r2 = (uint32_t)acc; acc >>= 32;
+    acc += a3 + 2 * (a11 + a12) + a13 - a15 - a8 - a9;
+    r3 = (uint32_t)acc; acc >>= 32;
+    acc += a4 + 2 * (a12 + a13) + a14 - a9 - a10;
+    r4 = (uint32_t)acc; acc >>= 32;
+    acc += a5 + 2 * (a13 + a14) + a15 - a10 - a11;
+    r5 = (uint32_t)acc; acc >>= 32;
+    acc += a6 + 3 * a14 + 2 * a15 + a13 - a8 - a9;
+    r6 = (uint32_t)acc; acc >>= 32;
+    acc += a7 + 3 * a15 + a8 - a10 - a11 - a12 - a13;
+    r7 = (uint32_t)acc; acc >>= 32;
+    carry = acc;
+
+    /* Two folds bring the carry to zero and the value into [0, 2^256) */
+    for (i = 0; i < 2; i++) {
+        acc = (int64_t)r0 + carry;
+        r0 = (uint32_t)acc; acc >>= 32;
+        acc += (int64_t)r1;
+        r1 = (uint32_t)acc; acc >>= 32;
+        acc += (int64_t)r2;
+        r2 = (uint32_t)acc; acc >>= 32;
+        acc += (int64_t)r3 - carry;
+        r3 = (uint32_t)acc; acc >>= 32;
+        acc += (int64_t)r4;
+        r4 = (uint32_t)acc; acc >>= 32;
+        acc += (int64_t)r5;
+        r5 = (uint32_t)acc; acc >>= 32;
+        acc += (int64_t)r6 - carry;
+        r6 = (uint32_t)acc; acc >>= 32;
+        acc += (int64_t)r7 + carry;
+        r7 = (uint32_t)acc; acc >>= 32;
+        carry = acc;
+    }
+
+    q0 = (digit_t)r0 | getlow_tohigh((digit_t)r1);
+    q1 = (digit_t)r2 | getlow_tohigh((digit_t)r3);
+    q2 = (digit_t)r4 | getlow_tohigh((digit_t)r5);
+    q3 = (digit_t)r6 | getlow_tohigh((digit_t)r7);
 
     /* Compute the conditional subtraction. */
-    sub5(p0, c0, c1, c2, c3, c4, q0, q1, q2, q3, p4, \
-         0xFFFFFFFFFFFFFFFF, 0x00000000FFFFFFFF, 0x0000000000000000, 0xFFFFFFFF00000001, 0);
-
-    CMOVC(c0, q0, p0);
-    CMOVC(c1, q1, p0);
-    CMOVC(c2, q2, p0);
-    CMOVC(c3, q3, p0);
-
-    c[0] = c0;
-    c[1] = c1;
-    c[2] = c2;
-    c[3] = c3;
+    SUBC(borrow, c[0], q0, P256_MODULUS[0], 0);
+    SUBC(borrow, c[1], q1, P256_MODULUS[1], borrow);
+    SUBC(borrow, c[2], q2, P256_MODULUS[2], borrow);
+    SUBC(borrow, c[3], q3, P256_MODULUS[3], borrow);
+
+    CMOVC(c[0], q0, borrow);
+    CMOVC(c[1], q1, borrow);
+    CMOVC(c[2], q2, borrow);
+    CMOVC(c[3], q3, borrow);
 }
 
 void fpmul_p256(
@@ -522,7 +601,8 @@ void fpsqr_p256(
     assert(product != NULL);
     assert(temps != NULL);
 
-    fpmul_p256(multiplier, multiplier, product, temps);
+    sqr_p256(multiplier, temps);
+    reduce_p256(temps, product);
 }
 
 void fpadd_p256(
@@ -677,23 +757,12 @@ void fpset_p256(digit_t dig0, digit256_t a)
     a[0] = dig0;
 }
 
-/* Exponentiation via square-and-multiply.  Not constant time, should not be used when e is private. */
-static void fpexp_naive_p256(digit256_tc a, digit256_tc e, digit256_t out, digit_t* temps)
+/* Square a field element n times. */
+static void fpsqrn_p256(digit256_t a, size_t n, digit_t* temps)
 {
-    size_t digIdx = 0, bitIdx = 0, bitI = 0;
-    size_t i = 0;
-
-    fpset_p256((digit_t)1, out);      /* out = 1; */
-    for (i = 0; i < 256; i++) {
-        digIdx = (255 - i) / RADIX_BITS;
-        bitIdx = (255 - i) % RADIX_BITS;
-        bitI = (e[digIdx] >> bitIdx) & 1;
-        fpsqr_p256(out, out, temps);
-        if (bitI) {
-            fpmul_p256(out, a, out, temps);
-        }
+    while (n--) {
+        fpsqr_p256(a, a, temps);
     }
-
 }
 
 void fpinv_p256(
@@ -702,11 +771,53 @@ void fpinv_p256(
     digit_t*    temps)
 {
     /*
-     * Inverse modulo P256 is done by exponentiation by (P256-2).
-     * The constant P256m2 is P256_MODULUS - 2.
+     * Inverse modulo P256 is done by exponentiation by (P256-2) using a fixed addition chain,
+     * 255 squarings and 12 multiplications.
+     * P256-2 = FFFFFFFF 00000001 00000000 00000000 00000000 FFFFFFFF FFFFFFFF FFFFFFFD
+     * xn below is a^(2^n - 1).
      */
-    digit256_tc P256m2 = { 0xFFFFFFFFFFFFFFFDULL, 0x00000000FFFFFFFFULL, 0x0000000000000000ULL, 0xFFFFFFFF00000001ULL };
-    fpexp_naive_p256(a, P256m2, inv, temps);
+    digit256_t x2, x3, x6, x12, x15, x30, x32, t;
+
+    fpsqr_p256(a, t, temps);
+    fpmul_p256(t, a, x2, temps);
+    fpsqr_p256(x2, t, temps);
+    fpmul_p256(t, a, x3, temps);
+    fpcopy_p256(x3, t);
+    fpsqrn_p256(t, 3, temps);
+    fpmul_p256(t, x3, x6, temps);
+    fpcopy_p256(x6, t);
+    fpsqrn_p256(t, 6, temps);
+    fpmul_p256(t, x6, x12, temps);
+    fpcopy_p256(x12, t);
+    fpsqrn_p256(t, 3, temps);
+    fpmul_p256(t, x3, x15, temps);
+    fpcopy_p256(x15, t);
+    fpsqrn_p256(t, 15, temps);
+    fpmul_p256(t, x15, x30, temps);
+    fpcopy_p256(x30, t);
+    fpsqrn_p256(t, 2, temps);
+    fpmul_p256(t, x2, x32, temps);
+
+    fpcopy_p256(x32, t);                    /* FFFFFFFF */
+    fpsqrn_p256(t, 32, temps);
+    fpmul_p256(t, a, t, temps);             /* FFFFFFFF 00000001 */
+    fpsqrn_p256(t, 96 + 32, temps);
+    fpmul_p256(t, x32, t, temps);           /* ... 00000000 00000000 00000000 FFFFFFFF */
+    fpsqrn_p256(t, 32, temps);
+    fpmul_p256(t, x32, t, temps);           /* ... FFFFFFFF */
+    fpsqrn_p256(t, 30, temps);
+    fpmul_p256(t, x30, t, temps);           /* ... FFFFFFFC */
+    fpsqrn_p256(t, 2, temps);
+    fpmul_p256(t, a, inv, temps);           /* ... FFFFFFFD */
+
+    fpzero_p256(x2);
+    fpzero_p256(x3);
+    fpzero_p256(x6);
+    fpzero_p256(x12);
+    fpzero_p256(x15);
+    fpzero_p256(x30);
+    fpzero_p256(x32);
+    fpzero_p256(t);
 }
 
 /* Swaps the byte order of the digits in a. The order of digits is not changed.
@@ -18,12 +18,15 @@
  ******************************************************************************/
 
 #include <qcc/Util.h>
+#include <qcc/atomic.h>
 #include <qcc/CryptoECC.h>
 #include <qcc/CryptoECCp256.h>
 
 namespace qcc {
 
 #define W_VARBASE 6     /* Parameter for scalar multiplication.  Should use 2-2.5 KB.  Must be >= 2. */
+#define W_FIXEDBASE 6   /* Parameter for fixed-base scalar multiplication.  The table uses 53 rows of 2^(W_FIXEDBASE-2) affine points (~54 KB). */
+#define W_WNAF 5        /* Window width of the NAF used for variable-time scalar multiplication.  Must be >= 2. */
 
 /*
  * Parameters for the NIST curve P-256.  P256_A and P256_B are the constants
@@ -843,4 +846,375 @@ QStatus ec_scalarmul(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve
     return status;
 }
 
+/* Mixed point addition P = P+Q
+ * Weierstrass a=-3 curve
+ * Inputs: P = (X1,Y1,Z1) in Jacobian coordinates
+ *         Q = (x2,y2) in affine coordinates
+ * Output: P = P+Q = (X1,Y1,Z1) in Jacobian coordinates
+ */
+static void ec_add_mixed(const ecpoint_t* Q, ecpoint_jacobian_t* P)
+{
+    digit256_t t1, t2, t3, t4, t5;
+    digit_t temps[P256_TEMPS];
+
+    /* SECURITY NOTE: this function does not produce exceptions when P!=inf, P!=Q and P!=-Q.
+     *                In particular, it is exception-free when called from ec_scalarmul_base().
+     */
+
+    fpsqr_p256(P->Z, t1, temps);            /* t1 = z1^2  */
+    fpmul_p256(P->Z, t1, t2, temps);        /* t2 = z1^3  */
+    fpmul_p256(t1, Q->x, t3, temps);        /* t3 = z1^2*x2  */
+    fpmul_p256(t2, Q->y, t4, temps);        /* t4 = z1^3*y2  */
+    fpsub_p256(t3, P->X, t3);               /* t3 = beta = z1^2*x2-x1  */
+    fpsub_p256(t4, P->Y, t4);               /* t4 = alpha = z1^3*y2-y1  */
+    fpmul_p256(P->Z, t3, t5, temps);        /* t5 = z1*beta  */
+    fpcopy_p256(t5, P->Z);                  /* Zfinal = z1*beta  */
+    fpsqr_p256(t3, t1, temps);              /* t1 = beta^2  */
+    fpmul_p256(t1, t3, t2, temps);          /* t2 = beta^3  */
+    fpmul_p256(P->X, t1, t5, temps);        /* t5 = x1*beta^2  */
+    fpsqr_p256(t4, t1, temps);              /* t1 = alpha^2  */
+    fpsub_p256(t1, t2, t1);                 /* t1 = alpha^2 - beta^3  */
+    fpsub_p256(t1, t5, t1);                 /* t1 = alpha^2 - beta^3 - x1*beta^2  */
+    fpsub_p256(t1, t5, P->X);               /* Xfinal = alpha^2 - beta^3 - 2*x1*beta^2  */
+    fpsub_p256(t5, P->X, t5);               /* t5 = x1*beta^2 - Xfinal  */
+    fpmul_p256(t4, t5, t3, temps);          /* t3 = alpha.(x1*beta^2 - Xfinal)  */
+    fpmul_p256(P->Y, t2, t5, temps);        /* t5 = y1*beta^3  */
+    fpsub_p256(t3, t5, P->Y);               /* Yfinal = alpha.(x1*beta^2 - Xfinal) - y1*beta^3  */
+
+    /* cleanup */
+    fpzero_p256(t1);
+    fpzero_p256(t2);
+    fpzero_p256(t3);
+    fpzero_p256(t4);
+    fpzero_p256(t5);
+    ClearMemory(temps, sizeof(temps));
+}
+
+/* Constant-time table lookup to extract an affine point (x,y) from a row of the fixed-base table
+ * Weierstrass a=-3 curve
+ * Operation: P = sign * table[(|digit|-1)/2], where sign=1 if digit>0 and sign=-1 if digit<0
+ */
+static void lut_affine(const ecpoint_t* table, ecpoint_t* P, int digit, unsigned int npoints, ec_t* curve)
+{
+    unsigned int i, j;
+    size_t nwords = NBITS_TO_NDIGITS(curve->pbits);
+    digit_t sign, mask, pos;
+    digit256_t y;
+
+    sign = ((digit_t)digit >> (RADIX_BITS - 1)) - 1;                            /* if digit<0 then sign = 0x00...0 else sign = 0xFF...F */
+    pos = ((sign & ((digit_t)digit ^ (digit_t)-digit)) ^ (digit_t)-digit) >> 1; /* position = (|digit|-1)/2  */
+    fpcopy_p256(table[0].x, P->x);                                              /* P = table[0]  */
+    fpcopy_p256(table[0].y, P->y);
+
+    for (i = 1; i < npoints; i++) {
+        pos--;
+        /* If match then mask = 0xFF...F else mask = 0x00...0 */
+        mask = (digit_t)is_digit_nonzero_ct(pos) - 1;
+        /* If mask = 0x00...0 then P = P, else if mask = 0xFF...F then P = table[i] */
+        for (j = 0; j < nwords; j++) {
+            P->x[j] = (mask & (P->x[j] ^ table[i].x[j])) ^ P->x[j];
+            P->y[j] = (mask & (P->y[j] ^ table[i].y[j])) ^ P->y[j];
+        }
+    }
+
+    fpcopy_p256(P->y, y);
+    fpneg_p256(y);                                                      /* y: -y coordinate  */
+    for (j = 0; j < nwords; j++) {                                      /* if sign = 0x00...0 then choose negative of the point  */
+        P->y[j] = (sign & (P->y[j] ^ y[j])) ^ y[j];
+    }
+
+    /* cleanup */
+    fpzero_p256(y);
+}
+
+/* Number of rows in the fixed-base table, one per digit of the fixed window representation. */
+#define FIXEDBASE_ROWS (((sizeof(digit256_t) * 8) + W_FIXEDBASE - 2) / (W_FIXEDBASE - 1) + 1)
+#define FIXEDBASE_POINTS (1 << (W_FIXEDBASE - 2))
+
+/*
+ * Fixed-base table: fixedbase_table[i][j] = (2j+1) * 2^((W_FIXEDBASE-1)*i) * G in affine coordinates.
+ * It only holds public values and is built on first use; fixedbase_state is 0 (not built),
+ * 1 (being built) or 2 (ready).
+ */
+static ecpoint_t fixedbase_table[FIXEDBASE_ROWS][FIXEDBASE_POINTS];
+static volatile int32_t fixedbase_state = 0;
+
+static void ec_fixedbase_build(ec_t* curve)
+{
+    ecpoint_chudnovsky_t T[FIXEDBASE_POINTS];
+    digit256_t acc[FIXEDBASE_POINTS];
+    digit256_t inv, zinv, t1;
+    ecpoint_t B;
+    ecpoint_jacobian_t BB;
+    digit_t temps[P256_TEMPS];
+    size_t i, j;
+
+    ec_get_generator(&B, curve);
+    for (i = 0; i < FIXEDBASE_ROWS; i++) {
+        ec_precomp(&B, T, FIXEDBASE_POINTS, curve);     /* T[j] = (2j+1)*B  */
+
+        /* Simultaneous inversion of the Z-coordinates of the row */
+        fpcopy_p256(T[0].Z, acc[0]);
+        for (j = 1; j < FIXEDBASE_POINTS; j++) {
+            fpmul_p256(acc[j - 1], T[j].Z, acc[j], temps);
+        }
+        fpinv_p256(acc[FIXEDBASE_POINTS - 1], inv, temps);
+        for (j = FIXEDBASE_POINTS; j-- > 0;) {
+            if (j > 0) {
+                fpmul_p256(inv, acc[j - 1], zinv, temps);   /* zinv = Z_j^-1  */
+                fpmul_p256(inv, T[j].Z, inv, temps);        /* inv = (Z_0*...*Z_(j-1))^-1  */
+            } else {
+                fpcopy_p256(inv, zinv);
+            }
+            fpsqr_p256(zinv, t1, temps);                                /* t1 = Z^-2  */
+            fpmul_p256(T[j].X, t1, fixedbase_table[i][j].x, temps);     /* x = X/Z^2  */
+            fpmul_p256(t1, zinv, t1, temps);                            /* t1 = Z^-3  */
+            fpmul_p256(T[j].Y, t1, fixedbase_table[i][j].y, temps);     /* y = Y/Z^3  */
+        }
+
+        /* B = 2^(W_FIXEDBASE-1) * B  */
+        ec_affine_tojacobian(&B, &BB);
+        for (j = 0; j < (W_FIXEDBASE - 1); j++) {
+            ec_double_jacobian(&BB);
+        }
+        ec_toaffine(&BB, &B, curve);
+    }
+}
+
+/* Returns true if the fixed-base table can be used. The first caller builds it; callers racing
+ * with the build get false and use the variable-base path instead of waiting. */
+static bool ec_fixedbase_ready(ec_t* curve)
+{
+    if (CompareAndExchange(&fixedbase_state, 2, 2)) {
+        return true;
+    }
+    if (!CompareAndExchange(&fixedbase_state, 0, 1)) {
+        return false;
+    }
+    ec_fixedbase_build(curve);
+    CompareAndExchange(&fixedbase_state, 1, 2);
+    return true;
+}
+
+/*
+ * Fixed-base scalar multiplication T = k.G using the fixed-base table
+ * Weierstrass a=-3 curve
+ * k must be in [1,r-1] and the table must be ready.
+ */
+static void ec_scalarmul_base_jacobian(digit256_t k, ecpoint_jacobian_t* T, ec_t* curve)
+{
+    size_t num_digits = NBITS_TO_NDIGITS(curve->pbits);
+    int digits[FIXEDBASE_ROWS] = { 0 };
+    size_t t = (curve->rbits + (W_FIXEDBASE - 2)) / (W_FIXEDBASE - 1); /* Fixed length of the fixed window representation   */
+    size_t i = 0;
+    size_t j = 0;
+    sdigit_t odd = 0;
+    ecpoint_t R;
+    ecpoint_jacobian_t TT;
+    digit256_t temp;
+
+    /* SECURITY NOTE: this function runs in constant-time.  Every digit of the recoded (odd) scalar is odd and
+     *                nonzero, so the running sum after i windows is an integer multiple m.G with |m| < 2^(5i) that can
+     *                neither be the point at infinity nor equal to +-(digit i).2^(5i).G as long as both stay below the
+     *                group order.  This holds for i <= t-2, so ec_add_mixed() is exception-free there.  The last two
+     *                windows use the complete addition.
+     */
+
+    odd = -((sdigit_t)k[0] & 1);
+    fpsub_p256(curve->order, k, temp);                  /* Converting scalar to odd (r-k if even)  */
+    for (j = 0; j < num_digits; j++) {                  /* If (even) then k = k_temp else k = k   */
+        temp[j] = (odd & (k[j] ^ temp[j])) ^ temp[j];
+    }
+
+    fixed_window_recode(temp, (unsigned int)curve->rbits, W_FIXEDBASE, digits);
+
+    lut_affine(fixedbase_table[0], &R, digits[0], FIXEDBASE_POINTS, curve);
+    ec_affine_tojacobian(&R, T);                        /* Initialize T with digits[0]*G */
+
+    for (i = 1; i < (t - 1); i++) {
+        lut_affine(fixedbase_table[i], &R, digits[i], FIXEDBASE_POINTS, curve);
+        ec_add_mixed(&R, T);                            /* T = T + digits[i]*2^(5i)*G */
+    }
+    for (; i <= t; i++) {
+        lut_affine(fixedbase_table[i], &R, digits[i], FIXEDBASE_POINTS, curve);
+        ec_affine_tojacobian(&R, &TT);
+        ec_add_jacobian(&TT, T, curve);                 /* Complete addition T = T + digits[i]*2^(5i)*G */
+    }
+
+    fpcopy_p256(T->Y, temp);
+    fpneg_p256(temp);                                   /* Correcting scalar (-Ty if even)  */
+    for (j = 0; j < num_digits; j++) {                  /* If (even) then Ty = -Ty   */
+        T->Y[j] = (odd & (T->Y[j] ^ temp[j])) ^ temp[j];
+    }
+
+    ClearMemory(digits, sizeof(digits));
+    fpzero_p256(R.x);
+    fpzero_p256(R.y);
+    ecpoint_jacobian_zero(&TT);
+    fpzero_p256(temp);
+}
+
+/*
+ * Fixed-base scalar multiplication Q = k.G using a precomputed table of multiples of G
+ * Weierstrass a=-3 curve
+ */
+QStatus ec_scalarmul_base(digit256_t k, ecpoint_t* Q, ec_t* curve)
+{
+    ecpoint_jacobian_t T;
+
+    if (k == NULL || Q == NULL || curve == NULL) {
+        return ER_INVALID_ADDRESS;
+    }
+
+    /* Is scalar k in [1,r-1]?  */
+    if ((fpiszero_p256(k) == true) || (validate_256(k, curve->order) == false)) {
+        return ER_INVALID_DATA;
+    }
+
+    if (!ec_fixedbase_ready(curve)) {
+        return ec_scalarmul(&(curve->generator), k, Q, curve);
+    }
+
+    ec_scalarmul_base_jacobian(k, &T, curve);
+    ec_toaffine(&T, Q, curve);                          /* Output Q = (x,y)  */
+
+    ecpoint_jacobian_zero(&T);
+
+    return ER_OK;
+}
+
+/* Computes the width-W_WNAF non-adjacent form of scalar, least significant digit first.
+ * Nonzero digits are odd and in {+-1,+-3,...,+-(2^(W_WNAF-1)-1)}.  Returns the number of digits.
+ * This function is NOT constant time.
+ */
+static size_t wnaf_recode(digit256_tc scalar, int* naf)
+{
+    digit_t k[NBITS_TO_NDIGITS(256) + 1];
+    size_t nwords = NBITS_TO_NDIGITS(256) + 1;
+    size_t len = 0;
+    size_t j;
+    digit_t carry, nonzero;
+    int d;
+
+    fpcopy_p256(scalar, k);
+    k[nwords - 1] = 0;
+
+    for (;;) {
+        nonzero = 0;
+        for (j = 0; j < nwords; j++) {
+            nonzero |= k[j];
+        }
+        if (nonzero == 0) {
+            break;
+        }
+
+        d = 0;
+        if (k[0] & 1) {
+            d = (int)(k[0] & ((1 << W_WNAF) - 1));
+            if (d >= (1 << (W_WNAF - 1))) {
+                d -= (1 << W_WNAF);
+            }
+            if (d > 0) {
+                k[0] -= (digit_t)d;             /* The low bits of k are d, no borrow */
+            } else {
+                k[0] += (digit_t)-d;            /* k = k - d, d negative  */
+                carry = (k[0] < (digit_t)-d);
+                for (j = 1; j < nwords && carry; j++) {
+                    k[j] += 1;
+                    carry = (k[j] == 0);
+                }
+            }
+        }
+        naf[len++] = d;
+
+        for (j = 0; j < nwords - 1; j++) {      /* k = k / 2  */
+            SHIFTR(k[j + 1], k[j], 1, k[j]);
+        }
+        k[nwords - 1] >>= 1;
+    }
+
+    return len;
+}
+
+/*
+ * Double scalar multiplication Q = k.G + l.P for public scalars
+ * Weierstrass a=-3 curve
+ * k.G uses the fixed-base table, l.P uses a width-W_WNAF NAF.
+ */
+QStatus ec_scalarmul_double_vartime(digit256_t k, const ecpoint_t* P, digit256_t l, ecpoint_t* Q, ec_t* curve)
+{
+    int naf[(sizeof(digit256_t) * 8) + 1];
+    ecpoint_chudnovsky_t table[1 << (W_WNAF - 2)];
+    ecpoint_jacobian_t T, R;
+    ecpoint_t kG;
+    size_t len, i;
+    int d;
+    QStatus status;
+
+    /* SECURITY NOTE: this function is not constant time.  It must only be called with public inputs, such as
+     *                when verifying a signature.
+     */
+
+    if (P == NULL || k == NULL || l == NULL || Q == NULL || curve == NULL) {
+        return ER_INVALID_ADDRESS;
+    }
+
+    /* Are k and l in [0,r-1]?  */
+    if (validate_256(k, curve->order) == false || validate_256(l, curve->order) == false) {
+        return ER_INVALID_DATA;
+    }
+    /* Is P a point other than the point at infinity with (x,y) in [0,p-1]? */
+    if (ec_is_infinity(P, curve) == B_TRUE) {
+        return ER_INVALID_DATA;
+    }
+    if (fpvalidate_p256(P->x) == false || fpvalidate_p256(P->y) == false) {
+        return ER_INVALID_DATA;
+    }
+
+    ecpoint_jacobian_zero(&T);
+    T.Y[0] = 1;                                         /* T = (0:1:0), the point at infinity  */
+
+    if (fpiszero_p256(l) == false) {
+        ec_precomp(P, table, 1 << (W_WNAF - 2), curve);  /* table[j] = (2j+1)*P  */
+        len = wnaf_recode(l, naf);
+
+        /* The most significant digit is positive */
+        d = naf[len - 1];
+        fpcopy_p256(table[(d - 1) / 2].X, T.X);
+        fpcopy_p256(table[(d - 1) / 2].Y, T.Y);
+        fpcopy_p256(table[(d - 1) / 2].Z, T.Z);
+
+        for (i = len - 1; i-- > 0;) {
+            ec_double_jacobian(&T);
+            d = naf[i];
+            if (d != 0) {
+                fpcopy_p256(table[((d < 0 ? -d : d) - 1) / 2].X, R.X);
+                fpcopy_p256(table[((d < 0 ? -d : d) - 1) / 2].Y, R.Y);
+                fpcopy_p256(table[((d < 0 ? -d : d) - 1) / 2].Z, R.Z);
+                if (d < 0) {
+                    fpneg_p256(R.Y);
+                }
+                ec_add_jacobian(&R, &T, curve);         /* Complete addition T = T +- table[(|d|-1)/2]  */
+            }
+        }
+    }
+
+    if (fpiszero_p256(k) == false) {
+        if (ec_fixedbase_ready(curve)) {
+            ec_scalarmul_base_jacobian(k, &R, curve);
+        } else {
+            status = ec_scalarmul(&(curve->generator), k, &kG, curve);
+            if (status != ER_OK) {
+                return status;
+            }
+            ec_affine_tojacobian(&kG, &R);
+        }
+        ec_add_jacobian(&R, &T, curve);                 /* T = k.G + l.P  */
+    }
+
+    ec_toaffine(&T, Q, curve);                          /* Output Q = (x,y), or (0,0) if T is the point at infinity  */
+
+    return ER_OK;
+}
+
 }
\ No newline at end of file
@@ -300,6 +300,34 @@ QStatus SocketStream::PushBytes(const void* buf, size_t numBytes, size_t& numSen
     return status;
 }
 
+QStatus SocketStream::PushBytesV(const IOVec* iov, size_t iovLen, size_t& numSent)
+{
+    if (iovLen == 0) {
+        numSent = 0;
+        return ER_OK;
+    }
+    QStatus status;
+    for (;;) {
+        if (!isConnected) {
+            return ER_WRITE_ERROR;
+        }
+        status = qcc::SendV(sock, iov, iovLen, numSent);
+        if (ER_WOULDBLOCK == status) {
+            if (sendTimeout == Event::WAIT_FOREVER) {
+                status = Event::Wait(*sinkEvent);
+            } else {
+                status = Event::Wait(*sinkEvent, sendTimeout);
+            }
+            if (ER_OK != status) {
+                break;
+            }
+        } else {
+            break;
+        }
+    }
+    return status;
+}
+
 QStatus SocketStream::PushBytesAndFds(const void* buf, size_t numBytes, size_t& numSent, SocketFd* fdList, size_t numFds, uint32_t pid)
 {
     if (numBytes == 0) {
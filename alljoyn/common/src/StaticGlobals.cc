@@ -23,6 +23,7 @@
 #ifdef CRYPTO_CNG
 #include <qcc/CngCache.h>
 #endif
+#include <qcc/CertificateECC.h>
 #include <qcc/Logger.h>
 #include <qcc/String.h>
 #include <qcc/Thread.h>
@@ -68,11 +69,13 @@ class StaticGlobals {
             Shutdown();
             return status;
         }
+        CertificateX509::Init();
         return ER_OK;
     }
 
     static QStatus Shutdown()
     {
+        CertificateX509::Shutdown();
         Crypto::Shutdown();
         Thread::Shutdown();
         LoggerSetting::Shutdown();
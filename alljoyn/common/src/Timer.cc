@@ -26,6 +26,7 @@
 #include <qcc/Thread.h>
 #include <qcc/Timer.h>
 #include <qcc/StringUtil.h>
+#include <qcc/STLContainer.h>
 #include <Status.h>
 #include <algorithm>
 
@@ -42,6 +43,440 @@ using namespace qcc;
 
 namespace qcc {
 
+/**
+ * The set of alarms pending on a timer.  Not thread safe; the timer lock
+ * serializes all access.
+ */
+class AlarmQueue {
+  public:
+    virtual ~AlarmQueue() { }
+
+    /** Return true if there are no pending alarms */
+    virtual bool Empty() const = 0;
+
+    /** Add an alarm.  Adding an alarm that is already pending has no effect. */
+    virtual void Insert(const Alarm& alarm) = 0;
+
+    /** Return the alarm that is due first.  Must not be called on an empty queue. */
+    virtual Alarm Front() = 0;
+
+    /** Remove the pending alarm equal to (same time and id as) alarm */
+    virtual bool Remove(const Alarm& alarm, Alarm& removed) = 0;
+
+    /** Remove the pending alarm with the given id */
+    virtual bool RemoveId(int32_t id, Alarm& removed) = 0;
+
+    /** Remove any one pending alarm for the given listener */
+    virtual bool RemoveListener(const AlarmListener* listener, Alarm& removed) = 0;
+
+    /** Return true if an alarm equal to alarm is pending */
+    virtual bool Contains(const Alarm& alarm) const = 0;
+
+  protected:
+    static uint64_t AlarmTime(const Alarm& alarm) { return alarm->alarmTime.GetAbsoluteMillis(); }
+    static int32_t AlarmId(const Alarm& alarm) { return alarm->id; }
+    static const AlarmListener* AlarmListenerOf(const Alarm& alarm) { return alarm->listener; }
+};
+
+/**
+ * Alarm queue kept in a std::set ordered by alarm time.
+ */
+class OrderedAlarmQueue : public AlarmQueue {
+  public:
+    bool Empty() const { return alarms.empty(); }
+
+    void Insert(const Alarm& alarm) { alarms.insert(alarm); }
+
+    Alarm Front() { return *alarms.begin(); }
+
+    bool Remove(const Alarm& alarm, Alarm& removed)
+    {
+        set<Alarm>::iterator it = alarms.find(alarm);
+        if (it == alarms.end()) {
+            return false;
+        }
+        removed = *it;
+        alarms.erase(it);
+        return true;
+    }
+
+    bool RemoveId(int32_t id, Alarm& removed)
+    {
+        for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
+            if (AlarmId(*it) == id) {
+                removed = *it;
+                alarms.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RemoveListener(const AlarmListener* listener, Alarm& removed)
+    {
+        for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
+            if (AlarmListenerOf(*it) == listener) {
+                removed = *it;
+                alarms.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Contains(const Alarm& alarm) const { return alarms.count(alarm) != 0; }
+
+  private:
+    std::set<Alarm, std::less<Alarm> > alarms;
+};
+
+/**
+ * Alarm queue kept in a hierarchical timing wheel with a 1ms tick.
+ *
+ * Level 0 has a slot for each of the next 256 ticks.  Levels 1, 2 and 3 have
+ * 64 slots each, covering 2^8, 2^14 and 2^20 ticks per slot; alarms more than
+ * 2^26ms (about 18 hours) out go on an overflow list.  Each time the current
+ * tick crosses a slot boundary of a level the alarms in that slot are moved
+ * down to the finer levels ("cascaded"), so every alarm is moved at most four
+ * times before it becomes due.  Due alarms are moved to a ready list that is
+ * kept in (time, id) order, the same order the ordered set uses.
+ *
+ * Alarms are found by id through a hash table, so insert and remove are O(1).
+ * Finding the next alarm when none are due may look at every level-0 slot and
+ * one slot per higher level; the result is cached until that alarm is
+ * removed or becomes due.
+ */
+class TimingWheelAlarmQueue : public AlarmQueue {
+  public:
+    TimingWheelAlarmQueue() : current(0), level0Count(0), wheelCount(0), next(NULL)
+    {
+        InitList(&ready);
+        InitList(&overflow);
+        for (uint32_t i = 0; i < LEVEL0_SLOTS; ++i) {
+            InitList(&level0[i]);
+        }
+        for (uint32_t l = 0; l < NUM_LEVELS - 1; ++l) {
+            for (uint32_t i = 0; i < LEVELN_SLOTS; ++i) {
+                InitList(&levels[l][i]);
+            }
+        }
+    }
+
+    ~TimingWheelAlarmQueue()
+    {
+        for (EntryMap::iterator it = entries.begin(); it != entries.end(); ++it) {
+            delete it->second;
+        }
+    }
+
+    bool Empty() const { return entries.empty(); }
+
+    void Insert(const Alarm& alarm)
+    {
+        if (entries.find(AlarmId(alarm)) != entries.end()) {
+            return;
+        }
+        if (entries.empty()) {
+            /* Nothing is pending so the wheel can simply be moved to the present */
+            current = Now();
+        }
+        Entry* entry = new Entry(alarm);
+        entries[entry->id] = entry;
+        Place(entry);
+        if (next && (entry->level != LEVEL_READY) && Less(entry, next)) {
+            next = entry;
+        }
+    }
+
+    Alarm Front()
+    {
+        Advance(Now());
+        if (ready.next != &ready) {
+            return static_cast<Entry*>(ready.next)->alarm;
+        }
+        if (!next) {
+            next = FindNext();
+        }
+        return next->alarm;
+    }
+
+    bool Remove(const Alarm& alarm, Alarm& removed)
+    {
+        EntryMap::iterator it = entries.find(AlarmId(alarm));
+        if ((it == entries.end()) || !(it->second->alarm == alarm)) {
+            return false;
+        }
+        Erase(it, removed);
+        return true;
+    }
+
+    bool RemoveId(int32_t id, Alarm& removed)
+    {
+        EntryMap::iterator it = entries.find(id);
+        if (it == entries.end()) {
+            return false;
+        }
+        Erase(it, removed);
+        return true;
+    }
+
+    bool RemoveListener(const AlarmListener* listener, Alarm& removed)
+    {
+        for (EntryMap::iterator it = entries.begin(); it != entries.end(); ++it) {
+            if (AlarmListenerOf(it->second->alarm) == listener) {
+                Erase(it, removed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Contains(const Alarm& alarm) const
+    {
+        EntryMap::const_iterator it = entries.find(AlarmId(alarm));
+        return (it != entries.end()) && (it->second->alarm == alarm);
+    }
+
+  private:
+    static const uint32_t LEVEL0_BITS = 8;
+    static const uint32_t LEVELN_BITS = 6;
+    static const uint32_t NUM_LEVELS = 4;
+    static const uint32_t LEVEL0_SLOTS = 1 << LEVEL0_BITS;
+    static const uint32_t LEVELN_SLOTS = 1 << LEVELN_BITS;
+
+    /* Values of Entry::level for alarms that are not in a wheel slot */
+    static const uint8_t LEVEL_OVERFLOW = NUM_LEVELS;
+    static const uint8_t LEVEL_READY = NUM_LEVELS + 1;
+
+    struct Link {
+        Link* prev;
+        Link* next;
+    };
+
+    struct Entry : public Link {
+        Entry(const Alarm& alarm) : alarm(alarm), when(AlarmTime(alarm)), id(AlarmId(alarm)), level(LEVEL_READY) { }
+        Alarm alarm;
+        uint64_t when;
+        int32_t id;
+        uint8_t level;
+    };
+
+    typedef std::unordered_map<int32_t, Entry*> EntryMap;
+
+    static void InitList(Link* head) { head->prev = head->next = head; }
+
+    static void Unlink(Link* link)
+    {
+        link->prev->next = link->next;
+        link->next->prev = link->prev;
+    }
+
+    static void InsertAfter(Link* pos, Link* link)
+    {
+        link->prev = pos;
+        link->next = pos->next;
+        pos->next->prev = link;
+        pos->next = link;
+    }
+
+    static bool Less(const Entry* a, const Entry* b)
+    {
+        return (a->when < b->when) || ((a->when == b->when) && (a->id < b->id));
+    }
+
+    static bool IdLess(const Entry* a, const Entry* b) { return a->id < b->id; }
+
+    static uint64_t Now()
+    {
+        Timespec now;
+        GetTimeNow(&now);
+        return now.GetAbsoluteMillis();
+    }
+
+    /* Number of ticks covered by one slot of level l (l > 0) */
+    static uint32_t Shift(uint32_t l) { return LEVEL0_BITS + (l - 1) * LEVELN_BITS; }
+
+    /* Put an entry in the slot for its time relative to the current tick */
+    void Place(Entry* entry)
+    {
+        if (entry->when < current) {
+            /* Already due.  Typically it sorts after everything on the ready list. */
+            Link* pos = ready.prev;
+            while ((pos != &ready) && Less(entry, static_cast<Entry*>(pos))) {
+                pos = pos->prev;
+            }
+            InsertAfter(pos, entry);
+            entry->level = LEVEL_READY;
+            return;
+        }
+
+        uint64_t delta = entry->when - current;
+        Link* slot;
+        if (delta < LEVEL0_SLOTS) {
+            slot = &level0[entry->when & (LEVEL0_SLOTS - 1)];
+            entry->level = 0;
+            ++level0Count;
+        } else {
+            uint32_t l = 1;
+            while ((l < NUM_LEVELS) && (delta >= (static_cast<uint64_t>(1) << (Shift(l) + LEVELN_BITS)))) {
+                ++l;
+            }
+            if (l < NUM_LEVELS) {
+                slot = &levels[l - 1][(entry->when >> Shift(l)) & (LEVELN_SLOTS - 1)];
+                entry->level = l;
+            } else {
+                slot = &overflow;
+                entry->level = LEVEL_OVERFLOW;
+            }
+        }
+        InsertAfter(slot->prev, entry);
+        ++wheelCount;
+    }
+
+    /* Take an entry out of whichever list it is on */
+    void Detach(Entry* entry)
+    {
+        Unlink(entry);
+        if (entry->level != LEVEL_READY) {
+            --wheelCount;
+            if (entry->level == 0) {
+                --level0Count;
+            }
+        }
+    }
+
+    void Erase(EntryMap::iterator it, Alarm& removed)
+    {
+        Entry* entry = it->second;
+        if (entry == next) {
+            next = NULL;
+        }
+        Detach(entry);
+        removed = entry->alarm;
+        entries.erase(it);
+        delete entry;
+    }
+
+    /* Re-place every entry of a list relative to the current tick */
+    void Cascade(Link* head)
+    {
+        Link* link = head->next;
+        InitList(head);
+        while (link != head) {
+            Entry* entry = static_cast<Entry*>(link);
+            link = link->next;
+            --wheelCount;
+            Place(entry);
+        }
+    }
+
+    /* Move every alarm due at or before tick "to" onto the ready list */
+    void Advance(uint64_t to)
+    {
+        while (current <= to) {
+            if (wheelCount == 0) {
+                current = to + 1;
+                break;
+            }
+            uint32_t idx = current & (LEVEL0_SLOTS - 1);
+            if (idx == 0) {
+                /* Crossed a level 1 slot boundary, and possibly boundaries of higher levels too */
+                uint32_t l = 1;
+                uint32_t i;
+                do {
+                    i = (current >> Shift(l)) & (LEVELN_SLOTS - 1);
+                    Cascade(&levels[l - 1][i]);
+                } while ((i == 0) && (++l < NUM_LEVELS));
+                if (l == NUM_LEVELS) {
+                    Cascade(&overflow);
+                }
+            } else if (level0Count == 0) {
+                /* Nothing can become due before the next level 1 boundary */
+                current = (std::min)((current | (LEVEL0_SLOTS - 1)) + 1, to + 1);
+                continue;
+            }
+
+            Link* slot = &level0[idx];
+            if (slot->next != slot) {
+                /* Everything in this slot is due at this tick; order it by id */
+                due.clear();
+                for (Link* link = slot->next; link != slot; link = link->next) {
+                    due.push_back(static_cast<Entry*>(link));
+                }
+                InitList(slot);
+                std::sort(due.begin(), due.end(), IdLess);
+                for (size_t i = 0; i < due.size(); ++i) {
+                    InsertAfter(ready.prev, due[i]);
+                    due[i]->level = LEVEL_READY;
+                }
+                level0Count -= due.size();
+                wheelCount -= due.size();
+            }
+            ++current;
+        }
+        if (next && (next->level == LEVEL_READY)) {
+            next = NULL;
+        }
+    }
+
+    /* Return the earliest entry in the first occupied slot at or after start */
+    Entry* FirstInSlots(Link* slots, uint32_t numSlots, uint32_t start)
+    {
+        for (uint32_t i = 0; i < numSlots; ++i) {
+            Link* slot = &slots[(start + i) & (numSlots - 1)];
+            if (slot->next != slot) {
+                return EarliestIn(slot);
+            }
+        }
+        return NULL;
+    }
+
+    static Entry* EarliestIn(Link* head)
+    {
+        Entry* best = NULL;
+        for (Link* link = head->next; link != head; link = link->next) {
+            Entry* entry = static_cast<Entry*>(link);
+            if (!best || Less(entry, best)) {
+                best = entry;
+            }
+        }
+        return best;
+    }
+
+    /*
+     * Find the earliest alarm still in the wheel.  The first occupied slot of
+     * each level, scanning forward from the current tick, holds that level's
+     * earliest alarm; the overall earliest is the least of those.
+     */
+    Entry* FindNext()
+    {
+        Entry* best = FirstInSlots(level0, LEVEL0_SLOTS, current & (LEVEL0_SLOTS - 1));
+        for (uint32_t l = 1; l < NUM_LEVELS; ++l) {
+            uint32_t start = ((current >> Shift(l)) + 1) & (LEVELN_SLOTS - 1);
+            Entry* entry = FirstInSlots(levels[l - 1], LEVELN_SLOTS, start);
+            if (entry && (!best || Less(entry, best))) {
+                best = entry;
+            }
+        }
+        Entry* entry = EarliestIn(&overflow);
+        if (entry && (!best || Less(entry, best))) {
+            best = entry;
+        }
+        return best;
+    }
+
+    uint64_t current;                            /**< Next tick to be processed; alarms before it are on the ready list */
+    Link ready;                                  /**< Due alarms in (time, id) order */
+    Link level0[LEVEL0_SLOTS];                   /**< One slot per tick for the next 256 ticks */
+    Link levels[NUM_LEVELS - 1][LEVELN_SLOTS];   /**< Coarser levels 1 to 3 */
+    Link overflow;                               /**< Alarms beyond the range of level 3 */
+    size_t level0Count;                          /**< Number of alarms in level 0 */
+    size_t wheelCount;                           /**< Number of alarms in levels 0-3 and overflow */
+    Entry* next;                                 /**< Cached earliest alarm in the wheel, or NULL if unknown */
+    EntryMap entries;                            /**< Every pending alarm by id */
+    std::vector<Entry*> due;                     /**< Scratch space for Advance() */
+};
+
 class TimerThread : public Thread {
   public:
 
@@ -95,8 +530,10 @@ class TimerImpl : public ThreadListener {
      * @param concurrency        Dispatch up to this number of alarms concurrently (using multiple threads).
      * @param prevenReentrancy   Prevent re-entrant call of AlarmTriggered.
      * @param maxAlarms          Maximum number of outstanding alarms allowed before blocking calls to AddAlarm or 0 for infinite.
+     * @param queueType          Data structure used to hold the pending alarms.
      */
-    TimerImpl(qcc::String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms);
+    TimerImpl(qcc::String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms,
+              Timer::AlarmQueueType queueType);
 
     /**
      * Destructor.
@@ -259,7 +696,7 @@ class TimerImpl : public ThreadListener {
     TimerImpl& operator=(const TimerImpl&);
 
     mutable Mutex lock;
-    std::set<Alarm, std::less<Alarm> >  alarms;
+    AlarmQueue* alarms;
     Alarm* currentAlarm;
     bool expireOnExit;
     std::vector<TimerThread*> timerThreads;
@@ -277,7 +714,9 @@ class TimerImpl : public ThreadListener {
 
 }
 
-TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms) :
+TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms,
+                     Timer::AlarmQueueType queueType) :
+    alarms(NULL),
     currentAlarm(NULL),
     expireOnExit(expireOnExit),
     timerThreads(concurrency),
@@ -288,6 +727,11 @@ TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool
     maxAlarms(maxAlarms),
     numLimitableAlarms(0)
 {
+    if (queueType == Timer::TIMING_WHEEL) {
+        alarms = new TimingWheelAlarmQueue();
+    } else {
+        alarms = new OrderedAlarmQueue();
+    }
     /* TimerImpl thread objects will be created when required */
 }
 
@@ -301,6 +745,7 @@ TimerImpl::~TimerImpl()
             timerThreads[i] = NULL;
         }
     }
+    delete alarms;
 }
 
 QStatus TimerImpl::Start()
@@ -405,8 +850,8 @@ QStatus TimerImpl::AddAlarm(const Alarm& alarm)
         /* Ensure timer is still running */
         if (isRunning) {
             /* Insert the alarm and alert the TimerImpl thread if necessary */
-            bool alertThread = alarms.empty() || (alarm < *alarms.begin());
-            alarms.insert(alarm);
+            bool alertThread = alarms->Empty() || (alarm < alarms->Front());
+            alarms->Insert(alarm);
             if (alarm->limitable) {
                 numLimitableAlarms++;
             }
@@ -440,8 +885,8 @@ QStatus TimerImpl::AddAlarmNonBlocking(const Alarm& alarm)
         }
 
         /* Insert the alarm and alert the TimerImpl thread if necessary */
-        bool alertThread = alarms.empty() || (alarm < *alarms.begin());
-        alarms.insert(alarm);
+        bool alertThread = alarms->Empty() || (alarm < alarms->Front());
+        alarms->Insert(alarm);
         if (alarm->limitable) {
             numLimitableAlarms++;
         }
@@ -464,28 +909,14 @@ bool TimerImpl::RemoveAlarm(const Alarm& alarm, bool blockIfTriggered)
     bool foundAlarm = false;
     lock.Lock();
     if (isRunning || expireOnExit) {
+        Alarm removed(alarm);
         if (alarm->periodMs) {
-            set<Alarm>::iterator it = alarms.begin();
-            while (it != alarms.end()) {
-                if ((*it)->id == alarm->id) {
-                    foundAlarm = true;
-                    if ((*it)->limitable) {
-                        numLimitableAlarms--;
-                    }
-                    alarms.erase(it);
-                    break;
-                }
-                ++it;
-            }
+            foundAlarm = alarms->RemoveId(alarm->id, removed);
         } else {
-            set<Alarm>::iterator it = alarms.find(alarm);
-            if (it != alarms.end()) {
-                foundAlarm = true;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
-            }
+            foundAlarm = alarms->Remove(alarm, removed);
+        }
+        if (foundAlarm && removed->limitable) {
+            numLimitableAlarms--;
         }
         if (blockIfTriggered && !foundAlarm) {
             /*
@@ -518,28 +949,14 @@ bool TimerImpl::ForceRemoveAlarm(const Alarm& alarm, bool blockIfTriggered)
     bool foundAlarm = false;
     lock.Lock();
     if (isRunning || expireOnExit) {
+        Alarm removed(alarm);
         if (alarm->periodMs) {
-            set<Alarm>::iterator it = alarms.begin();
-            while (it != alarms.end()) {
-                if ((*it)->id == alarm->id) {
-                    foundAlarm = true;
-                    if ((*it)->limitable) {
-                        numLimitableAlarms--;
-                    }
-                    alarms.erase(it);
-                    break;
-                }
-                ++it;
-            }
+            foundAlarm = alarms->RemoveId(alarm->id, removed);
         } else {
-            set<Alarm>::iterator it = alarms.find(alarm);
-            if (it != alarms.end()) {
-                foundAlarm = true;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
-            }
+            foundAlarm = alarms->Remove(alarm, removed);
+        }
+        if (foundAlarm && removed->limitable) {
+            numLimitableAlarms--;
         }
         if (blockIfTriggered && !foundAlarm) {
             /*
@@ -573,12 +990,11 @@ QStatus TimerImpl::ReplaceAlarm(const Alarm& origAlarm, const Alarm& newAlarm, b
     QStatus status = ER_NO_SUCH_ALARM;
     lock.Lock();
     if (isRunning) {
-        set<Alarm>::iterator it = alarms.find(origAlarm);
-        if (it != alarms.end()) {
-            if ((*it)->limitable) {
+        Alarm removed(origAlarm);
+        if (alarms->Remove(origAlarm, removed)) {
+            if (removed->limitable) {
                 numLimitableAlarms--;
             }
-            alarms.erase(it);
             status = AddAlarm(newAlarm);
         } else if (blockIfTriggered) {
             /*
@@ -611,16 +1027,11 @@ bool TimerImpl::RemoveAlarm(const AlarmListener& listener, Alarm& alarm)
     bool removedOne = false;
     lock.Lock();
     if (isRunning || expireOnExit) {
-        for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
-            if ((*it)->listener == &listener) {
-                alarm = *it;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
-                removedOne = true;
-                break;
+        if (alarms->RemoveListener(&listener, alarm)) {
+            if (alarm->limitable) {
+                numLimitableAlarms--;
             }
+            removedOne = true;
         }
         /*
          * This function is most likely being called because the listener is about to be freed. If there
@@ -661,7 +1072,7 @@ bool TimerImpl::HasAlarm(const Alarm& alarm) const
     bool ret = false;
     lock.Lock();
     if (isRunning) {
-        ret = alarms.count(alarm) != 0;
+        ret = alarms->Contains(alarm);
     }
     lock.Unlock();
     return ret;
@@ -731,9 +1142,9 @@ ThreadReturn STDCALL TimerThread::Run(void* arg)
          * Check for something to do, either now or at some (alarm) time in the
          * future.
          */
-        if (!timer->alarms.empty()) {
+        if (!timer->alarms->Empty()) {
             QCC_DbgPrintf(("TimerThread::Run(): Alarms pending"));
-            const Alarm topAlarm = *(timer->alarms.begin());
+            const Alarm topAlarm = timer->alarms->Front();
             int64_t delay = topAlarm->alarmTime - now;
 
             /*
@@ -945,13 +1356,11 @@ ThreadReturn STDCALL TimerThread::Run(void* arg)
                  * If it has already been serviced by another thread, just ignore
                  * and go back to the top of the loop.
                  */
-                set<Alarm>::iterator it = timer->alarms.find(topAlarm);
-                if (it != timer->alarms.end()) {
-                    Alarm top = *it;
+                Alarm top(topAlarm);
+                if (timer->alarms->Remove(topAlarm, top)) {
                     if (top->limitable) {
                         timer->numLimitableAlarms--;
                     }
-                    timer->alarms.erase(it);
                     currentAlarm = &top;
                     if (0 < timer->addWaitQueue.size()) {
                         Thread* wakeMe = timer->addWaitQueue.back();
@@ -1088,16 +1497,15 @@ void TimerImpl::ThreadExit(Thread* thread)
     lock.Lock();
     if ((!isRunning) && expireOnExit) {
         /* Call all alarms */
-        while (!alarms.empty()) {
+        while (!alarms->Empty()) {
             /*
              * Note it is possible that the callback will call RemoveAlarm()
              */
-            set<Alarm>::iterator it = alarms.begin();
-            Alarm alarm = *it;
+            Alarm alarm = alarms->Front();
+            alarms->Remove(alarm, alarm);
             if (alarm->limitable) {
                 numLimitableAlarms--;
             }
-            alarms.erase(it);
             tt->SetCurrentAlarm(&alarm);
             lock.Unlock();
             tt->hasTimerLock = preventReentrancy;
@@ -1174,8 +1582,9 @@ bool TimerImpl::ThreadHoldsLock() const
     return false;
 }
 
-Timer::Timer(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms) :
-    timerImpl(new TimerImpl(name, expireOnExit, concurrency, preventReentrancy, maxAlarms))
+Timer::Timer(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms,
+             AlarmQueueType queueType) :
+    timerImpl(new TimerImpl(name, expireOnExit, concurrency, preventReentrancy, maxAlarms, queueType))
 {
     /* Timer thread objects will be created when required */
 }
@@ -29,6 +29,26 @@
 #include <qcc/Util.h>
 #include <qcc/Crypto.h>
 
+/*
+ * Byte swapping of arrays uses PSHUFB on x86-64 when the CPU supports SSSE3. The intrinsics are
+ * compiled per function so the rest of the library does not require -mssse3. NEON is part of the
+ * baseline on the ARM targets that define __ARM_NEON.
+ */
+#if (defined(__x86_64__) && defined(__GNUC__)) || defined(_M_X64)
+#define QCC_SSSE3_SWAP
+#include <tmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SSSE3_TARGET
+#else
+#include <cpuid.h>
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define QCC_NEON_SWAP
+#include <arm_neon.h>
+#endif
+
 #define QCC_MODULE  "UTIL"
 
 using namespace std;
@@ -142,3 +162,102 @@ void qcc::CRC16_Compute(const uint8_t* buffer, size_t bufLen, uint16_t*runningCr
     }
     *runningCrc = crc;
 }
+
+#ifdef QCC_SSSE3_SWAP
+
+static bool DetectSSSE3()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    unsigned int ecx = (unsigned int)info[2];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+#endif
+    /* SSSE3 is bit 9 */
+    return (ecx & (1 << 9)) != 0;
+}
+
+static bool HaveSSSE3()
+{
+    static const bool ssse3 = DetectSSSE3();
+    return ssse3;
+}
+
+static const uint8_t swapMask16[16] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+static const uint8_t swapMask32[16] = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+static const uint8_t swapMask64[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+/*
+ * Swaps whole 16 byte blocks and returns the number of bytes swapped.
+ */
+SSSE3_TARGET static size_t SwapBlocks(uint8_t* dest, const uint8_t* src, size_t len, const uint8_t* swapMask)
+{
+    const __m128i mask = _mm_loadu_si128((const __m128i*)swapMask);
+    size_t pos = 0;
+    for (; (pos + 32) <= len; pos += 32) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + pos));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + pos + 16));
+        _mm_storeu_si128((__m128i*)(dest + pos), _mm_shuffle_epi8(a, mask));
+        _mm_storeu_si128((__m128i*)(dest + pos + 16), _mm_shuffle_epi8(b, mask));
+    }
+    if ((pos + 16) <= len) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + pos));
+        _mm_storeu_si128((__m128i*)(dest + pos), _mm_shuffle_epi8(a, mask));
+        pos += 16;
+    }
+    return pos;
+}
+
+#define SWAP_BLOCKS(_dest, _src, _len, _width) (HaveSSSE3() ? SwapBlocks((uint8_t*)(_dest), (const uint8_t*)(_src), (_len), swapMask ## _width) : 0)
+
+#elif defined(QCC_NEON_SWAP)
+
+#define NEON_SWAP_BLOCKS(_width) \
+    static size_t SwapBlocks ## _width(uint8_t * dest, const uint8_t * src, size_t len) \
+    { \
+        size_t pos = 0; \
+        for (; (pos + 16) <= len; pos += 16) { \
+            vst1q_u8(dest + pos, vrev ## _width ## q_u8(vld1q_u8(src + pos))); \
+        } \
+        return pos; \
+    }
+
+NEON_SWAP_BLOCKS(16)
+NEON_SWAP_BLOCKS(32)
+NEON_SWAP_BLOCKS(64)
+
+#define SWAP_BLOCKS(_dest, _src, _len, _width) SwapBlocks ## _width((uint8_t*)(_dest), (const uint8_t*)(_src), (_len))
+
+#else
+
+#define SWAP_BLOCKS(_dest, _src, _len, _width) 0
+
+#endif
+
+void qcc::EndianSwapArray16(uint16_t* dest, const uint16_t* src, size_t count)
+{
+    size_t i = SWAP_BLOCKS(dest, src, count * sizeof(uint16_t), 16) / sizeof(uint16_t);
+    for (; i < count; ++i) {
+        dest[i] = EndianSwap16(src[i]);
+    }
+}
+
+void qcc::EndianSwapArray32(uint32_t* dest, const uint32_t* src, size_t count)
+{
+    size_t i = SWAP_BLOCKS(dest, src, count * sizeof(uint32_t), 32) / sizeof(uint32_t);
+    for (; i < count; ++i) {
+        dest[i] = EndianSwap32(src[i]);
+    }
+}
+
+void qcc::EndianSwapArray64(uint64_t* dest, const uint64_t* src, size_t count)
+{
+    size_t i = SWAP_BLOCKS(dest, src, count * sizeof(uint64_t), 64) / sizeof(uint64_t);
+    for (; i < count; ++i) {
+        dest[i] = EndianSwap64(src[i]);
+    }
+}
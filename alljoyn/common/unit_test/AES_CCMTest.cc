@@ -28,6 +28,7 @@
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Util.h>
+#include <qcc/time.h>
 
 #include <Status.h>
 
@@ -320,3 +321,84 @@ TEST(AES_CCMTest, AES_CCM_Test_Vecter) {
     }
 }
 
+
+TEST(AES_CCMTest, AES_CCM_Round_Trip) {
+    uint8_t key[16];
+    uint8_t msg[512];
+    uint8_t orig[512];
+    const size_t hdrLens[] = { 0, 1, 13, 14, 15, 16, 31, 300 };
+
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (uint8_t)(0x40 + i);
+    }
+    for (size_t i = 0; i < sizeof(orig); i++) {
+        orig[i] = (uint8_t)(i * 7 + 3);
+    }
+    KeyBlob kb(key, sizeof(key), KeyBlob::AES);
+    Crypto_AES aes(kb, Crypto_AES::CCM);
+    KeyBlob nonce(HexStringToByteString("00 00 00 03 02 01 00 A0 A1 A2 A3 A4 A5", ' '), KeyBlob::GENERIC);
+
+    for (size_t h = 0; h < ArraySize(hdrLens); h++) {
+        for (size_t bodyLen = 0; bodyLen <= 80; bodyLen++) {
+            size_t hdrLen = hdrLens[h];
+            memcpy(msg, orig, hdrLen + bodyLen);
+            size_t len = hdrLen + bodyLen;
+            ASSERT_EQ(ER_OK, aes.Encrypt_CCM(msg, len, hdrLen, nonce, 16));
+            ASSERT_EQ(hdrLen + bodyLen + 16, len);
+            /*
+             * A modified ciphertext must fail to authenticate.
+             */
+            uint8_t tampered[512];
+            size_t tamperedLen = len;
+            memcpy(tampered, msg, len);
+            tampered[len - 1] ^= 0x01;
+            EXPECT_EQ(ER_AUTH_FAIL, aes.Decrypt_CCM(tampered, tamperedLen, hdrLen, nonce, 16));
+
+            ASSERT_EQ(ER_OK, aes.Decrypt_CCM(msg, len, hdrLen, nonce, 16)) << "hdrLen " << hdrLen << " bodyLen " << bodyLen;
+            ASSERT_EQ(hdrLen + bodyLen, len);
+            EXPECT_EQ(0, memcmp(msg, orig, len)) << "hdrLen " << hdrLen << " bodyLen " << bodyLen;
+        }
+    }
+}
+
+/*
+ * Reports the AES-CCM throughput for small, typical and large messages.
+ */
+TEST(AES_CCMTest, AES_CCM_Throughput) {
+    const size_t msgSizes[] = { 64, 1024, 65536 };
+    const size_t hdrLen = 64;
+    const size_t authLen = 8;
+    const size_t totalBytes = 8 * 1024 * 1024;
+    uint8_t key[16];
+
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (uint8_t)i;
+    }
+    KeyBlob kb(key, sizeof(key), KeyBlob::AES);
+    Crypto_AES aes(kb, Crypto_AES::CCM);
+    /*
+     * A 12 byte nonce leaves 3 octets for the message length.
+     */
+    KeyBlob nonce(HexStringToByteString("00 00 00 03 02 01 00 A0 A1 A2 A3 A4", ' '), KeyBlob::GENERIC);
+
+    for (size_t s = 0; s < ArraySize(msgSizes); s++) {
+        size_t bodyLen = msgSizes[s];
+        uint8_t* msg = new uint8_t[hdrLen + bodyLen + authLen];
+        for (size_t i = 0; i < hdrLen + bodyLen; i++) {
+            msg[i] = (uint8_t)i;
+        }
+        size_t iterations = max(totalBytes / bodyLen, (size_t)1);
+
+        uint64_t start = GetTimestamp64();
+        for (size_t i = 0; i < iterations; i++) {
+            size_t len = hdrLen + bodyLen;
+            ASSERT_EQ(ER_OK, aes.Encrypt_CCM(msg, len, hdrLen, nonce, authLen));
+            ASSERT_EQ(ER_OK, aes.Decrypt_CCM(msg, len, hdrLen, nonce, authLen));
+        }
+        uint64_t elapsed = max(GetTimestamp64() - start, (uint64_t)1);
+        delete [] msg;
+
+        double mbytes = (2.0 * iterations * bodyLen) / (1024.0 * 1024.0);
+        printf("AES-CCM %6u byte messages: %8.2f MB/s\n", static_cast<unsigned int>(bodyLen), (mbytes * 1000.0) / elapsed);
+    }
+}
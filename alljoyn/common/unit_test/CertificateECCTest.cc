@@ -1580,3 +1580,47 @@ TEST_F(CertificateECCTest, TestGetSetAKI)
     ASSERT_EQ(sizeof(charWithNull), cert2.GetAuthorityKeyId().size()) << " AKI mismatch.";
     ASSERT_EQ(akiWithNull, cert2.GetAuthorityKeyId()) << " AKI mismatch.";
 }
+
+/**
+ * Verify a chain of three certs with the batch API, including repeated
+ * verifications that are answered from the verified certificate cache.
+ */
+TEST_F(CertificateECCTest, VerifyCertChain)
+{
+    CertificateX509::ValidPeriod validity;
+    validity.validFrom = qcc::GetEpochTimestamp() / 1000;
+    validity.validTo = validity.validFrom + 24 * 3600;
+
+    qcc::GUID128 subject0, subject1, subject2;
+    Crypto_ECC ecc0, ecc1, ecc2;
+    ecc0.GenerateDSAKeyPair();
+    ecc1.GenerateDSAKeyPair();
+    ecc2.GenerateDSAKeyPair();
+
+    CertificateX509 certs[3];
+    /* self signed root, intermediate signed by the root, leaf signed by the intermediate */
+    ASSERT_EQ(ER_OK, CreateCert("serial2", subject2, "organization", ecc2.GetDSAPrivateKey(), ecc2.GetDSAPublicKey(), subject2, ecc2.GetDSAPublicKey(), validity, certs[2]));
+    ASSERT_EQ(ER_OK, CreateCert("serial1", subject2, "organization", ecc2.GetDSAPrivateKey(), ecc2.GetDSAPublicKey(), subject1, ecc1.GetDSAPublicKey(), validity, certs[1]));
+    ASSERT_EQ(ER_OK, CreateCert("serial0", subject1, "organization", ecc1.GetDSAPrivateKey(), ecc1.GetDSAPublicKey(), subject0, ecc0.GetDSAPublicKey(), validity, certs[0]));
+
+    EXPECT_EQ(ER_OK, CertificateX509::VerifyCertChain(certs, 3));
+    EXPECT_EQ(ER_OK, CertificateX509::VerifyCertChain(certs, 1));
+    EXPECT_EQ(ER_INVALID_DATA, CertificateX509::VerifyCertChain(certs, 0));
+
+    /* A cached verification must not make the cert verify with another key */
+    EXPECT_EQ(ER_OK, certs[0].Verify(ecc1.GetDSAPublicKey()));
+    EXPECT_NE(ER_OK, certs[0].Verify(ecc2.GetDSAPublicKey()));
+
+    CertificateX509 reversed[3];
+    reversed[0] = certs[1];
+    reversed[1] = certs[0];
+    reversed[2] = certs[2];
+    EXPECT_NE(ER_OK, CertificateX509::VerifyCertChain(reversed, 3));
+
+    const uint32_t iterations = 1000;
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ASSERT_EQ(ER_OK, CertificateX509::VerifyCertChain(certs, 3));
+    }
+    printf("Verified %u cached chains in %u ms\n", iterations, (uint32_t) (GetTimestamp64() - start));
+}
@@ -20,6 +20,8 @@
 #include <qcc/Crypto.h>
 #include <qcc/CryptoECC.h>
 #include <qcc/CryptoECCMath.h>
+#include <qcc/CryptoECCp256.h>
+#include <qcc/time.h>
 
 using namespace qcc;
 using namespace std;
@@ -342,3 +344,151 @@ TEST_F(CryptoECCTest, ECDHE_ECDSA)
     }
 }
 
+/* Pick a random scalar in [1, r-1]. */
+static void RandomScalar(digit256_t k, ec_t* curve)
+{
+    do {
+        ASSERT_EQ(ER_OK, Crypto_GetRandomBytes((uint8_t*)k, sizeof(digit256_t)));
+    } while (fpiszero_p256(k) || !validate_256(k, curve->order));
+}
+
+static void ExpectPointEqual(const ecpoint_t& P, const ecpoint_t& Q)
+{
+    EXPECT_TRUE(fpequal_p256(P.x, Q.x));
+    EXPECT_TRUE(fpequal_p256(P.y, Q.y));
+}
+
+TEST_F(CryptoECCTest, FixedBaseScalarMul)
+{
+    ec_t curve;
+    ecpoint_t G, Q1, Q2;
+    digit256_t k;
+
+    ASSERT_EQ(ER_OK, ec_getcurve(&curve, NISTP256r1));
+    ec_get_generator(&G, &curve);
+
+    for (int i = 0; i < 64; i++) {
+        switch (i) {
+        case 0:
+            fpset_p256(1, k);
+            break;
+
+        case 1:
+            fpset_p256(2, k);
+            break;
+
+        case 2:
+        case 3:
+            fpset_p256(i - 1, k);
+            fpsub_p256(curve.order, k, k);      /* k = r-1, r-2 */
+            break;
+
+        default:
+            RandomScalar(k, &curve);
+            break;
+        }
+        ASSERT_EQ(ER_OK, ec_scalarmul_base(k, &Q1, &curve));
+        ASSERT_EQ(ER_OK, ec_scalarmul(&G, k, &Q2, &curve));
+        ExpectPointEqual(Q1, Q2);
+    }
+
+    fpzero_p256(k);
+    EXPECT_EQ(ER_INVALID_DATA, ec_scalarmul_base(k, &Q1, &curve));
+    ec_freecurve(&curve);
+}
+
+TEST_F(CryptoECCTest, DoubleScalarMul)
+{
+    ec_t curve;
+    ecpoint_t G, P, Q1, Q2, T;
+    digit256_t k, l, m;
+
+    ASSERT_EQ(ER_OK, ec_getcurve(&curve, NISTP256r1));
+    ec_get_generator(&G, &curve);
+
+    for (int i = 0; i < 32; i++) {
+        RandomScalar(k, &curve);
+        RandomScalar(l, &curve);
+        RandomScalar(m, &curve);
+        ASSERT_EQ(ER_OK, ec_scalarmul_base(m, &P, &curve));
+
+        ASSERT_EQ(ER_OK, ec_scalarmul_double_vartime(k, &P, l, &Q1, &curve));
+        ASSERT_EQ(ER_OK, ec_scalarmul(&G, k, &Q2, &curve));
+        ASSERT_EQ(ER_OK, ec_scalarmul(&P, l, &T, &curve));
+        ec_add(&Q2, &T, &curve);
+        ExpectPointEqual(Q1, Q2);
+    }
+
+    /* One of the scalars is zero */
+    fpzero_p256(k);
+    ASSERT_EQ(ER_OK, ec_scalarmul_double_vartime(k, &P, l, &Q1, &curve));
+    ASSERT_EQ(ER_OK, ec_scalarmul(&P, l, &Q2, &curve));
+    ExpectPointEqual(Q1, Q2);
+    ASSERT_EQ(ER_OK, ec_scalarmul_double_vartime(l, &P, k, &Q1, &curve));
+    ASSERT_EQ(ER_OK, ec_scalarmul_base(l, &Q2, &curve));
+    ExpectPointEqual(Q1, Q2);
+
+    /* k.G + l.G where l = k (doubling) and l = r-k (point at infinity) */
+    RandomScalar(k, &curve);
+    ASSERT_EQ(ER_OK, ec_scalarmul_double_vartime(k, &G, k, &Q1, &curve));
+    ASSERT_EQ(ER_OK, ec_scalarmul(&G, k, &Q2, &curve));
+    ec_add(&Q2, &Q2, &curve);
+    ExpectPointEqual(Q1, Q2);
+    fpsub_p256(curve.order, k, l);
+    ASSERT_EQ(ER_OK, ec_scalarmul_double_vartime(k, &G, l, &Q1, &curve));
+    EXPECT_TRUE(ec_is_infinity(&Q1, &curve));
+
+    ec_freecurve(&curve);
+}
+
+/**
+ * Report the number of key generations, key agreements, signatures and
+ * verifications per second.
+ */
+TEST_F(CryptoECCTest, ECC_Operations_Per_Second)
+{
+    const uint32_t iterations = 200;
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    ECCSignature sig;
+    ECCSecret secret;
+    Crypto_ECC local;
+    Crypto_ECC peer;
+    uint64_t start;
+    uint64_t keygenTime;
+    uint64_t ecdhTime;
+    uint64_t signTime;
+    uint64_t verifyTime;
+
+    memset(digest, 0xA5, sizeof(digest));
+    ASSERT_EQ(ER_OK, peer.GenerateDHKeyPair());
+    ASSERT_EQ(ER_OK, local.GenerateDSAKeyPair());
+
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ASSERT_EQ(ER_OK, local.GenerateDHKeyPair());
+    }
+    keygenTime = GetTimestamp64() - start;
+
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ASSERT_EQ(ER_OK, local.GenerateSharedSecret(peer.GetDHPublicKey(), &secret));
+    }
+    ecdhTime = GetTimestamp64() - start;
+
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ASSERT_EQ(ER_OK, local.DSASignDigest(digest, sizeof(digest), &sig));
+    }
+    signTime = GetTimestamp64() - start;
+
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ASSERT_EQ(ER_OK, local.DSAVerifyDigest(digest, sizeof(digest), &sig));
+    }
+    verifyTime = GetTimestamp64() - start;
+
+    printf("P-256 keygen %8.1f ops/sec\n", (iterations * 1000.0) / max(keygenTime, (uint64_t)1));
+    printf("P-256 ECDH   %8.1f ops/sec\n", (iterations * 1000.0) / max(ecdhTime, (uint64_t)1));
+    printf("P-256 sign   %8.1f ops/sec\n", (iterations * 1000.0) / max(signTime, (uint64_t)1));
+    printf("P-256 verify %8.1f ops/sec\n", (iterations * 1000.0) / max(verifyTime, (uint64_t)1));
+}
@@ -16,8 +16,13 @@
 #include <gtest/gtest.h>
 
 #include <qcc/Event.h>
+#include <qcc/Socket.h>
 #include <qcc/time.h>
 
+#if defined(QCC_OS_GROUP_POSIX)
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace qcc;
 
@@ -163,3 +168,94 @@ TEST(EventTest, Above64HandlesTO)
     RunEventTest(1000, 1, T2, T1);
 #endif
 }
+
+TEST(EventTest, RepeatedWaitOnSameEvents)
+{
+    std::vector<Event*> checkEvents;
+    for (uint32_t i = 0; i < 10; ++i) {
+        checkEvents.push_back(new Event());
+    }
+
+    /* Waiting on an unchanged set must track set/reset of each member */
+    for (uint32_t i = 0; i < checkEvents.size(); ++i) {
+        std::vector<Event*> signalEvents;
+        checkEvents[i]->SetEvent();
+        ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, T1));
+        ASSERT_EQ(1U, signalEvents.size());
+        ASSERT_EQ(checkEvents[i], signalEvents[0]);
+        checkEvents[i]->ResetEvent();
+
+        signalEvents.clear();
+        ASSERT_EQ(ER_TIMEOUT, Event::Wait(checkEvents, signalEvents, 0));
+        ASSERT_EQ(0U, signalEvents.size());
+    }
+
+    /* Shrinking the set must stop reporting events that were dropped from it */
+    checkEvents.back()->SetEvent();
+    std::vector<Event*> subset(checkEvents.begin(), checkEvents.end() - 1);
+    std::vector<Event*> signalEvents;
+    ASSERT_EQ(ER_TIMEOUT, Event::Wait(subset, signalEvents, 0));
+    ASSERT_EQ(0U, signalEvents.size());
+
+    for (auto event : checkEvents) {
+        delete event;
+    }
+}
+
+TEST(EventTest, WaitAfterDescriptorReuse)
+{
+    Event* other = new Event();
+    for (uint32_t i = 0; i < 5; ++i) {
+        /* Each new event is likely to get the descriptor number of the one just deleted */
+        Event* event = new Event();
+        std::vector<Event*> checkEvents;
+        checkEvents.push_back(other);
+        checkEvents.push_back(event);
+
+        std::vector<Event*> signalEvents;
+        ASSERT_EQ(ER_TIMEOUT, Event::Wait(checkEvents, signalEvents, 0));
+
+        event->SetEvent();
+        ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, T1));
+        ASSERT_EQ(1U, signalEvents.size());
+        ASSERT_EQ(event, signalEvents[0]);
+        delete event;
+    }
+    delete other;
+}
+
+#if defined(QCC_OS_GROUP_POSIX)
+TEST(EventTest, WaitAfterRawCloseAndDescriptorReuse)
+{
+    SocketFd sockets[2];
+    ASSERT_EQ(ER_OK, SocketPair(sockets));
+    Event* event = new Event(sockets[0], Event::IO_READ);
+    std::vector<Event*> checkEvents;
+    checkEvents.push_back(event);
+    std::vector<Event*> signalEvents;
+    ASSERT_EQ(ER_TIMEOUT, Event::Wait(checkEvents, signalEvents, 0));
+
+    /* Close behind the event subsystem's back so the registration is not dropped */
+    delete event;
+    close(sockets[0]);
+    close(sockets[1]);
+
+    /* The new pair is likely to reuse the descriptor numbers of the old one */
+    ASSERT_EQ(ER_OK, SocketPair(sockets));
+    event = new Event(sockets[0], Event::IO_READ);
+    checkEvents.clear();
+    checkEvents.push_back(event);
+    ASSERT_EQ(ER_TIMEOUT, Event::Wait(checkEvents, signalEvents, 0));
+
+    uint8_t byte = 0;
+    size_t sent = 0;
+    ASSERT_EQ(ER_OK, Send(sockets[1], &byte, sizeof(byte), sent));
+    ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, T1));
+    ASSERT_EQ(1U, signalEvents.size());
+    ASSERT_EQ(event, signalEvents[0]);
+
+    delete event;
+    Close(sockets[0]);
+    Close(sockets[1]);
+}
+#endif
@@ -0,0 +1,143 @@
+/******************************************************************************
+ *
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <qcc/LockFreeQueue.h>
+#include <qcc/Thread.h>
+
+#include <Status.h>
+
+using namespace qcc;
+
+TEST(LockFreeQueueTest, fifo_order_and_capacity)
+{
+    LockFreeQueue<uint32_t> q(3, 0);
+    EXPECT_EQ(4U, q.Capacity());
+    EXPECT_TRUE(q.Empty());
+
+    uint32_t val;
+    EXPECT_FALSE(q.Peek(val));
+    EXPECT_FALSE(q.Pop());
+
+    /* Wrap around the ring a few times */
+    uint32_t next = 1;
+    uint32_t expect = 1;
+    for (uint32_t round = 0; round < 5; ++round) {
+        int32_t depth = 0;
+        while (q.TryPush(next, &depth)) {
+            EXPECT_EQ(q.Size(), static_cast<uint32_t>(depth));
+            ++next;
+        }
+        EXPECT_EQ(q.Capacity(), q.Size());
+        for (uint32_t i = 0; i < 2; ++i) {
+            ASSERT_TRUE(q.Peek(val));
+            EXPECT_EQ(expect, val);
+            EXPECT_TRUE(q.Pop());
+            ++expect;
+        }
+    }
+    while (q.Peek(val)) {
+        EXPECT_EQ(expect, val);
+        EXPECT_TRUE(q.Pop());
+        ++expect;
+    }
+    EXPECT_EQ(next, expect);
+    EXPECT_TRUE(q.Empty());
+}
+
+TEST(LockFreeQueueTest, reset)
+{
+    LockFreeQueue<uint32_t> q(4, 0);
+    EXPECT_TRUE(q.TryPush(1));
+    EXPECT_TRUE(q.TryPush(2));
+
+    q.Reset(100);
+    EXPECT_EQ(128U, q.Capacity());
+    EXPECT_TRUE(q.Empty());
+    uint32_t val;
+    EXPECT_FALSE(q.Peek(val));
+    for (uint32_t i = 0; i < q.Capacity(); ++i) {
+        EXPECT_TRUE(q.TryPush(i));
+    }
+    EXPECT_FALSE(q.TryPush(0));
+    ASSERT_TRUE(q.Peek(val));
+    EXPECT_EQ(0U, val);
+}
+
+class LockFreeQueueProducer : public qcc::Thread {
+  public:
+    LockFreeQueueProducer(LockFreeQueue<uint32_t>& q, uint32_t id, uint32_t count)
+        : qcc::Thread(qcc::String("P")), q(q), id(id), count(count) { }
+  protected:
+    qcc::ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            /* Producer id in the top byte, sequence number in the rest */
+            while (!q.TryPush((id << 24) | i)) {
+                qcc::Sleep(0);
+            }
+        }
+        return 0;
+    }
+  private:
+    LockFreeQueue<uint32_t>& q;
+    uint32_t id;
+    uint32_t count;
+};
+
+TEST(LockFreeQueueTest, multiple_producers)
+{
+    const uint32_t numProducers = 4;
+    const uint32_t perProducer = 20000;
+
+    LockFreeQueue<uint32_t> q(16, 0);
+    std::vector<LockFreeQueueProducer*> producers;
+    for (uint32_t p = 0; p < numProducers; ++p) {
+        producers.push_back(new LockFreeQueueProducer(q, p, perProducer));
+    }
+    for (uint32_t p = 0; p < numProducers; ++p) {
+        producers[p]->Start();
+    }
+
+    /* Each producer's entries must come out in the order they went in */
+    std::vector<uint32_t> nextSeq(numProducers, 0);
+    uint32_t received = 0;
+    while (received < numProducers * perProducer) {
+        uint32_t val;
+        if (!q.Peek(val)) {
+            qcc::Sleep(0);
+            continue;
+        }
+        EXPECT_TRUE(q.Pop());
+        uint32_t id = val >> 24;
+        ASSERT_LT(id, numProducers);
+        EXPECT_EQ(nextSeq[id], val & 0xffffff);
+        nextSeq[id] = (val & 0xffffff) + 1;
+        ++received;
+    }
+
+    for (uint32_t p = 0; p < numProducers; ++p) {
+        producers[p]->Join();
+        delete producers[p];
+        EXPECT_EQ(perProducer, nextSeq[p]);
+    }
+    EXPECT_TRUE(q.Empty());
+}
@@ -157,6 +157,65 @@ TEST_F(SocketStreamTestErrors, PushBytesTimeout)
     EXPECT_EQ(ER_TIMEOUT, status);
 }
 
+TEST_F(SocketStreamTestErrors, PushBytesVZero)
+{
+    SocketStream connected(acceptedFd); acceptedFd = INVALID_SOCKET_FD;
+    EXPECT_EQ(ER_OK, connected.PushBytesV(NULL, 0, numBytes));
+    EXPECT_EQ(0U, numBytes);
+}
+
+TEST_F(SocketStreamTestErrors, PushBytesVDisconnected)
+{
+    SocketStream unconnected(QCC_AF_INET, QCC_SOCK_STREAM);
+    IOVec iov[1];
+    iov[0].buf = reinterpret_cast<char*>(buf);
+    iov[0].len = 1;
+    EXPECT_EQ(ER_WRITE_ERROR, unconnected.PushBytesV(iov, ArraySize(iov), numBytes));
+}
+
+TEST_F(SocketStreamTestErrors, PushBytesVGathersInOrder)
+{
+    SocketStream client(clientFd); clientFd = INVALID_SOCKET_FD;
+    SocketStream connected(acceptedFd); acceptedFd = INVALID_SOCKET_FD;
+    char a[] = "header";
+    char b[] = "";
+    char c[] = "body";
+    IOVec iov[3];
+    iov[0].buf = a;
+    iov[0].len = strlen(a);
+    iov[1].buf = b;
+    iov[1].len = 0;
+    iov[2].buf = c;
+    iov[2].len = strlen(c);
+    EXPECT_EQ(ER_OK, client.PushBytesV(iov, ArraySize(iov), numBytes));
+    EXPECT_EQ(strlen(a) + strlen(c), numBytes);
+
+    char received[16];
+    size_t total = 0;
+    while (total < numBytes) {
+        size_t got = 0;
+        ASSERT_EQ(ER_OK, connected.PullBytes(received + total, numBytes - total, got));
+        total += got;
+    }
+    EXPECT_EQ(0, memcmp("headerbody", received, total));
+}
+
+TEST_F(SocketStreamTestErrors, PushBytesVTimeout)
+{
+    SocketStream connected(acceptedFd); acceptedFd = INVALID_SOCKET_FD;
+    EXPECT_EQ(ER_OK, SetSndBuf(connected.GetSocketFd(), 8192));
+    EXPECT_EQ(ER_OK, SetBlocking(connected.GetSocketFd(), false));
+    connected.SetSendTimeout(0);
+    IOVec iov[2];
+    iov[0].buf = reinterpret_cast<char*>(buf);
+    iov[0].len = ArraySize(buf) / 2;
+    iov[1].buf = reinterpret_cast<char*>(buf) + ArraySize(buf) / 2;
+    iov[1].len = ArraySize(buf) / 2;
+    while ((status = connected.PushBytesV(iov, ArraySize(iov), numBytes)) == ER_OK)
+        ;
+    EXPECT_EQ(ER_TIMEOUT, status);
+}
+
 TEST_F(SocketStreamTestErrors, PushBytesAfterAbortiveRelease)
 {
     SocketStream client(clientFd); clientFd = INVALID_SOCKET_FD;
@@ -16,6 +16,9 @@
 #include <gtest/gtest.h>
 
 #include <qcc/Thread.h>
+#include <qcc/time.h>
+
+#include <vector>
 
 using namespace std;
 using namespace qcc;
@@ -46,3 +49,51 @@ TEST(ThreadTest, CleanExternalThread) {
     ASSERT_NE(0, CloseHandle(reinterpret_cast<HANDLE>(handle)));
 #endif
 }
+
+class GetThreadCaller : public Thread {
+  public:
+    GetThreadCaller(uint32_t calls) : Thread("GetThreadCaller"), calls(calls), mismatches(0) { }
+    uint32_t calls;
+    uint32_t mismatches;
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < calls; ++i) {
+            if (Thread::GetThread() != this) {
+                ++mismatches;
+            }
+        }
+        return 0;
+    }
+};
+
+/*
+ * GetThread() is called for every message a blocked publisher pushes, so
+ * measure what it costs with several threads calling it at once.
+ */
+TEST(ThreadTest, GetThreadManyThreads) {
+    const uint32_t numThreads = 8;
+    const uint32_t calls = 200000;
+
+    std::vector<GetThreadCaller*> threads;
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads.push_back(new GetThreadCaller(calls));
+    }
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        ASSERT_EQ(ER_OK, threads[i]->Start());
+    }
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads[i]->Join();
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        EXPECT_EQ(0U, threads[i]->mismatches);
+        delete threads[i];
+    }
+    printf("GetThread(): %u threads x %u calls in %u ms (%.1f ns/call)\n",
+           numThreads, calls, static_cast<uint32_t>(elapsed),
+           (elapsed * 1000000.0) / (static_cast<double>(numThreads) * calls));
+}
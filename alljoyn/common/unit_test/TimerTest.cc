@@ -16,9 +16,14 @@
 #include <gtest/gtest.h>
 
 #include <deque>
+#include <vector>
 
+#include <stdio.h>
+
+#include <qcc/atomic.h>
 #include <qcc/Thread.h>
 #include <qcc/Timer.h>
+#include <qcc/Util.h>
 #include <Status.h>
 
 using namespace std;
@@ -488,3 +493,153 @@ TEST(TimerTest, TestMaxAlarms) {
     ASSERT_EQ(triggeredAlarms.size(), (size_t)3);
     triggeredAlarmsLock.Unlock();
 }
+
+static void* DelayContext(uint32_t delay)
+{
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(delay + 1));
+}
+
+TEST(TimerTest, TimingWheelOrdering) {
+    /* Reset the counts */
+    triggeredAlarmsLock.Lock();
+    triggeredAlarms.clear();
+    triggeredAlarmsLock.Unlock();
+
+    MyAlarmListener listener(0);
+    AlarmListener* al = &listener;
+    Timer timer("testTimer", false, 1, false, 0, Timer::TIMING_WHEEL);
+    QStatus status = timer.Start();
+    ASSERT_EQ(ER_OK, status) << "Status: " << QCC_StatusText(status);
+
+    /*
+     * Add alarms out of order, including ones that land in the coarser levels
+     * of the wheel and one that is removed before it fires.
+     */
+    Timespec ts;
+    GetTimeNow(&ts);
+    const uint32_t delays[] = { 1200, 300, 0, 600, 50 };
+    for (size_t i = 0; i < ArraySize(delays); ++i) {
+        Timespec when = ts + delays[i];
+        void* context = DelayContext(delays[i]);
+        Alarm a(when, al, context);
+        ASSERT_EQ(ER_OK, timer.AddAlarm(a));
+    }
+    Timespec removedWhen = ts + 400;
+    void* removedContext = DelayContext(400);
+    Alarm removed(removedWhen, al, removedContext);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(removed));
+    uint32_t tomorrow = 24 * 60 * 60 * 1000;
+    Alarm later(tomorrow, al);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(later));
+    ASSERT_TRUE(timer.HasAlarm(removed));
+    ASSERT_TRUE(timer.RemoveAlarm(removed));
+    ASSERT_FALSE(timer.HasAlarm(removed));
+
+    ASSERT_TRUE(testNextAlarm(ts + 0, DelayContext(0)));
+    ASSERT_TRUE(testNextAlarm(ts + 50, DelayContext(50)));
+    ASSERT_TRUE(testNextAlarm(ts + 300, DelayContext(300)));
+    ASSERT_TRUE(testNextAlarm(ts + 600, DelayContext(600)));
+    ASSERT_TRUE(testNextAlarm(ts + 1200, DelayContext(1200)));
+
+    /* Recurring alarm */
+    GetTimeNow(&ts);
+    uint32_t period = 500;
+    void* noContext = NULL;
+    Alarm periodic(period, al, noContext, period);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(periodic));
+    ASSERT_TRUE(testNextAlarm(ts + 500, NULL));
+    ASSERT_TRUE(testNextAlarm(ts + 1000, NULL));
+    ASSERT_TRUE(timer.RemoveAlarm(periodic));
+
+    ASSERT_TRUE(timer.HasAlarm(later));
+    ASSERT_TRUE(timer.RemoveAlarm(later));
+
+    timer.Stop();
+    timer.Join();
+    triggeredAlarmsLock.Lock();
+    ASSERT_TRUE(triggeredAlarms.empty());
+    triggeredAlarmsLock.Unlock();
+}
+
+class CountingAlarmListener : public AlarmListener {
+  public:
+    CountingAlarmListener() : AlarmListener(), count(0) { }
+    void AlarmTriggered(const Alarm& alarm, QStatus reason)
+    {
+        QCC_UNUSED(alarm);
+        QCC_UNUSED(reason);
+        IncrementAndFetch(&count);
+    }
+    volatile int32_t count;
+};
+
+/*
+ * Measure the cost of adding, removing and firing alarms while 100,000
+ * other alarms are outstanding, for each kind of alarm queue.
+ */
+static void AlarmQueueBenchmark(Timer::AlarmQueueType queueType, const char* name)
+{
+    const uint32_t outstanding = 100000;
+    const uint32_t operations = 100000;
+
+    CountingAlarmListener listener;
+    AlarmListener* al = &listener;
+    Timer timer("benchTimer", false, 1, false, 0, queueType);
+    ASSERT_EQ(ER_OK, timer.Start());
+
+    /* Alarms spread out over the next hour that never fire during the test */
+    std::vector<Alarm> background;
+    background.reserve(outstanding);
+    for (uint32_t i = 0; i < outstanding; ++i) {
+        uint32_t delay = 60000 + (i * 37) % 3540000;
+        background.push_back(Alarm(delay, al));
+        ASSERT_EQ(ER_OK, timer.AddAlarm(background.back()));
+    }
+
+    std::vector<Alarm> alarms;
+    alarms.reserve(operations);
+    for (uint32_t i = 0; i < operations; ++i) {
+        uint32_t delay = 10000 + (i * 7919) % 50000;
+        alarms.push_back(Alarm(delay, al));
+    }
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < operations; ++i) {
+        timer.AddAlarm(alarms[i]);
+    }
+    uint64_t addMs = GetTimestamp64() - start;
+
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < operations; ++i) {
+        timer.RemoveAlarm(alarms[i], false);
+    }
+    uint64_t removeMs = GetTimestamp64() - start;
+
+    /* Alarms that are already due, fired as fast as the timer thread can go */
+    alarms.clear();
+    Timespec now;
+    GetTimeNow(&now);
+    for (uint32_t i = 0; i < operations; ++i) {
+        alarms.push_back(Alarm(now, al));
+    }
+    start = GetTimestamp64();
+    for (uint32_t i = 0; i < operations; ++i) {
+        timer.AddAlarm(alarms[i]);
+    }
+    while ((listener.count < static_cast<int32_t>(operations)) && ((GetTimestamp64() - start) < 60000)) {
+        qcc::Sleep(1);
+    }
+    uint64_t fireMs = GetTimestamp64() - start;
+    EXPECT_EQ(static_cast<int32_t>(operations), listener.count);
+
+    printf("%-13s %u outstanding: %u adds %llu ms, %u removes %llu ms, %u fires %llu ms\n", name, outstanding,
+           operations, (unsigned long long)addMs, operations, (unsigned long long)removeMs,
+           operations, (unsigned long long)fireMs);
+
+    timer.Stop();
+    timer.Join();
+}
+
+TEST(TimerTest, AlarmQueuePerformance) {
+    AlarmQueueBenchmark(Timer::ORDERED_SET, "ORDERED_SET");
+    AlarmQueueBenchmark(Timer::TIMING_WHEEL, "TIMING_WHEEL");
+}
@@ -16,6 +16,8 @@
  ******************************************************************************/
 #include <gtest/gtest.h>
 #include <qcc/Util.h>
+#include <qcc/time.h>
+#include <vector>
 
 using namespace qcc;
 
@@ -115,3 +117,62 @@ TEST(UtilTest, crc16_computation_stress) {
             expected_crc_value << ".";
     }
 }
+
+TEST(UtilTest, endian_swap_array) {
+    /* cover the vector blocks, the scalar tail and in-place swapping */
+    for (size_t count = 0; count < 70; count++) {
+        std::vector<uint16_t> a16(count), s16(count);
+        std::vector<uint32_t> a32(count), s32(count);
+        std::vector<uint64_t> a64(count), s64(count);
+        for (size_t i = 0; i < count; i++) {
+            a16[i] = Rand16();
+            a32[i] = Rand32();
+            a64[i] = Rand64();
+        }
+        EndianSwapArray16(s16.data(), a16.data(), count);
+        EndianSwapArray32(s32.data(), a32.data(), count);
+        EndianSwapArray64(s64.data(), a64.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(EndianSwap16(a16[i]), s16[i]);
+            ASSERT_EQ(EndianSwap32(a32[i]), s32[i]);
+            ASSERT_EQ(EndianSwap64(a64[i]), s64[i]);
+        }
+        EndianSwapArray16(s16.data(), s16.data(), count);
+        EndianSwapArray32(s32.data(), s32.data(), count);
+        EndianSwapArray64(s64.data(), s64.data(), count);
+        EXPECT_TRUE(a16 == s16);
+        EXPECT_TRUE(a32 == s32);
+        EXPECT_TRUE(a64 == s64);
+    }
+}
+
+TEST(UtilTest, endian_swap_array_throughput) {
+    const size_t numBytes = 1024 * 1024;
+    const uint32_t iterations = 200;
+    std::vector<uint64_t> src(numBytes / sizeof(uint64_t));
+    std::vector<uint64_t> dest(numBytes / sizeof(uint64_t));
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = Rand64();
+    }
+    for (int width = 16; width <= 64; width *= 2) {
+        size_t count = numBytes / (width / 8);
+        uint64_t start = GetTimestamp64();
+        for (uint32_t j = 0; j < iterations; j++) {
+            switch (width) {
+            case 16:
+                EndianSwapArray16((uint16_t*)dest.data(), (const uint16_t*)src.data(), count);
+                break;
+
+            case 32:
+                EndianSwapArray32((uint32_t*)dest.data(), (const uint32_t*)src.data(), count);
+                break;
+
+            default:
+                EndianSwapArray64(dest.data(), src.data(), count);
+                break;
+            }
+        }
+        uint64_t elapsed = GetTimestamp64() - start;
+        printf("EndianSwapArray%d: %.0f MB/s\n", width, (elapsed > 0) ? (double)iterations * 1000.0 / elapsed : 0.0);
+    }
+}